@@ -94,7 +94,6 @@ void ControlMapEditor::addFloor(Position& p, MapEditorSubSelectionKind kind,
                                 int specialID)
 {
     FloorDatas* floor;
-    QRect* shortTexture;
     bool up = m_camera->cameraUp();
 
     // Pencil
@@ -104,11 +103,7 @@ void ControlMapEditor::addFloor(Position& p, MapEditorSubSelectionKind kind,
             QList<Position> positions;
             traceLine(m_previousMouseCoords, p, positions);
             for (int i = 0; i < positions.size(); i++){
-                QRect* rect = new QRect(tileset.x(),
-                                        tileset.y(),
-                                        tileset.width(),
-                                        tileset.height());
-                floor = new FloorDatas(rect, up);
+                floor = new FloorDatas(tileset, up);
                 stockLand(positions[i], floor, kind, layerOn);
             }
         }
@@ -121,9 +116,8 @@ void ControlMapEditor::addFloor(Position& p, MapEditorSubSelectionKind kind,
                     break;
 
                 Position shortPosition(p.x() + i, 0, 0, p.z() + j, p.layer());
-                shortTexture = new QRect(tileset.x() + i, tileset.y() + j,
-                                         1, 1);
-                floor = new FloorDatas(shortTexture, up);
+                floor = new FloorDatas(QRect(tileset.x() + i,
+                                             tileset.y() + j, 1, 1), up);
                 stockLand(shortPosition, floor, kind, layerOn);
             }
         }
@@ -76,7 +76,7 @@ void ControlMapEditor::updatePreviewFloors(MapEditorSelectionKind kind,
                 shortPosition.setLayer(layer);
 
                 MapElement* element = new FloorDatas(
-                            new QRect(tileset.x() + i, tileset.y() + j, 1, 1),
+                            QRect(tileset.x() + i, tileset.y() + j, 1, 1),
                             up);
                 updatePreviewElement(shortPosition, shortPortion, element);
             }
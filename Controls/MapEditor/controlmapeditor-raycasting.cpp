@@ -21,11 +21,21 @@ void ControlMapEditor::updateRaycasting(bool layerOn){
                              m_camera->positionZ());
     m_ray.setOrigin(cameraPosition);
     m_ray.setDirection(rayDirection);
-    getPortionsInRay(portions);
 
     // Others
     m_distanceLand = 0;
     m_distanceSprite = 0;
+    if (m_isPickingGPU && m_picking->pick(m_map, m_ray, projection, view,
+                                          m_mouse, m_width, m_height,
+                                          layerOn))
+    {
+        m_elementOnLand = m_picking->getLand(m_map, m_positionOnLand,
+                                             m_distanceLand);
+        m_elementOnSprite = m_picking->getSprite(m_map, m_positionOnSprite,
+                                                 m_distanceSprite);
+    }
+    else
+        getPortionsInRay(portions);
     for (int i = portions.size() - 1; i >= 0; i--) {
         Portion portion = portions.at(i);
         MapPortion* mapPortion = m_map->mapPortion(portion);
@@ -67,7 +77,7 @@ void ControlMapEditor::updateRaycasting(bool layerOn){
         }
         else {
             m_distanceSprite = ((SpriteDatas*) element)->intersectionPlane(
-                        positionLayerZero.angle(), m_ray);
+                        m_map->squareSize(), positionLayerZero, m_ray);
         }
         getCorrectPositionOnRay(m_positionRealOnSprite, rayDirection,
                                 m_distanceSprite);
@@ -42,6 +42,7 @@ ControlMapEditor::ControlMapEditor() :
     m_endWallIndicator(nullptr),
     m_cursorObject(nullptr),
     m_camera(new Camera),
+    m_picking(nullptr),
     m_elementOnLand(nullptr),
     m_elementOnSprite(nullptr),
     m_positionPreviousPreview(-1, 0, 0, -1, 0),
@@ -49,6 +50,7 @@ ControlMapEditor::ControlMapEditor() :
     m_needMapObjectsUpdate(false),
     m_displayGrid(true),
     m_displaySquareInformations(true),
+    m_isPickingGPU(false),
     m_treeMapNode(nullptr),
     m_isDrawingWall(false),
     m_isDeletingWall(false),
@@ -76,6 +78,10 @@ bool ControlMapEditor::displaySquareInformations() const {
     return m_displaySquareInformations;
 }
 
+const MapMemoryUsage& ControlMapEditor::memoryUsage() const {
+    return m_memoryUsage;
+}
+
 void ControlMapEditor::setContextMenu(ContextMenuList* m){
     m_contextMenu = m;
 }
@@ -119,8 +125,10 @@ Map* ControlMapEditor::loadMap(int idMap, QVector3D* position,
     Wanok::get()->project()->setCurrentMap(m_map);
     m_map->initializeCursor(position);
     m_map->initializeGL();
-    // Update current portion and load all the local portions
+    // Update current portion and load all the local portions that fit in
+    // the memory budget
     m_currentPortion = cursor()->getPortion();
+    m_map->updatePortionsRay(m_currentPortion);
     m_map->loadPortions(m_currentPortion);
 
     // Grid
@@ -130,6 +138,10 @@ Map* ControlMapEditor::loadMap(int idMap, QVector3D* position,
                                m_map->squareSize());
     m_grid->initializeGL();
 
+    // GPU picking
+    m_picking = new MapPicking;
+    m_picking->initializeGL();
+
     // Cursor object
     m_cursorObject = new Cursor(positionObject);
     m_cursorObject->initializeSquareSize(m_map->squareSize());
@@ -161,6 +173,8 @@ Map* ControlMapEditor::loadMap(int idMap, QVector3D* position,
     m_camera->setVerticalAngle(cameraVerticalAngle);
     m_camera->update(cursor(), m_map->squareSize());
 
+    updateMemoryUsage();
+
     return m_map;
 }
 
@@ -190,11 +204,18 @@ void ControlMapEditor::deleteMap(bool updateCamera){
         m_grid = nullptr;
     }
 
+    // GPU picking
+    if (m_picking != nullptr){
+        delete m_picking;
+        m_picking = nullptr;
+    }
+
     // Map
     if (m_map != nullptr){
         delete m_map;
         m_map = nullptr;
     }
+    m_memoryUsage.clear();
 
     // Update camera node
     if (updateCamera && m_treeMapNode != nullptr) {
@@ -214,6 +235,9 @@ void ControlMapEditor::onResize(int width, int height){
 // -------------------------------------------------------
 
 void ControlMapEditor::updateCameraTreeNode(){
+    if (m_treeMapNode == nullptr)
+        return;
+
     TreeMapTag* tag = (TreeMapTag*) m_treeMapNode->data().value<quintptr>();
     tag->setCameraDistance(m_camera->distance());
     tag->setCameraHorizontalAngle(m_camera->horizontalAngle());
@@ -290,6 +314,11 @@ void ControlMapEditor::updatePortions() {
         MapPortion* mapPortion = *i;
         m_map->updatePortion(mapPortion);
     }
+    if (!m_portionsToUpdate.isEmpty()) {
+        if (m_picking != nullptr)
+            m_picking->invalidate();
+        updateMemoryUsage();
+    }
 }
 
 // -------------------------------------------------------
@@ -297,13 +326,46 @@ void ControlMapEditor::updatePortions() {
 void ControlMapEditor::updateMovingPortions() {
     Portion newPortion = cursor()->getPortion();
 
-    updateMovingPortionsEastWest(newPortion);
-    updateMovingPortionsNorthSouth(newPortion);
-    updateMovingPortionsUpDown(newPortion);
+    // The memory around the new portion can change the ray, all the local
+    // portions are then loaded again
+    if (newPortion != m_currentPortion &&
+        m_map->updatePortionsRay(newPortion))
+    {
+        m_map->loadPortions(newPortion);
+    }
+    else {
+        updateMovingPortionsEastWest(newPortion);
+        updateMovingPortionsNorthSouth(newPortion);
+        updateMovingPortionsUpDown(newPortion);
+    }
 
+    if (newPortion != m_currentPortion) {
+        if (m_picking != nullptr)
+            m_picking->invalidate();
+        updateMemoryUsage();
+    }
     m_currentPortion = newPortion;
 }
 
+// -------------------------------------------------------
+//  teleportCursor: the cursor can move several portions at once, so all the
+//  local portions are loaded again
+
+void ControlMapEditor::teleportCursor(int x, int z) {
+    updatePortions();
+    saveTempPortions();
+    clearPortionsToUpdate();
+
+    cursor()->setX(x);
+    cursor()->setZ(z);
+    m_currentPortion = cursor()->getPortion();
+    m_map->updatePortionsRay(m_currentPortion);
+    m_map->loadPortions(m_currentPortion);
+    if (m_picking != nullptr)
+        m_picking->invalidate();
+    updateMemoryUsage();
+}
+
 // -------------------------------------------------------
 
 void ControlMapEditor::updateMovingPortionsEastWest(Portion& newPortion){
@@ -439,16 +501,24 @@ void ControlMapEditor::clearPortionsToUpdate(){
 
 // -------------------------------------------------------
 
+void ControlMapEditor::updateMemoryUsage() {
+    m_map->updateMemoryUsage(m_memoryUsage);
+}
+
+// -------------------------------------------------------
+
 void ControlMapEditor::setToNotSaved(){
     m_map->setSaved(false);
     Wanok::mapsToSave.insert(m_map->mapProperties()->id());
-    m_treeMapNode->setText(m_map->mapProperties()->name() + " *");
+    if (m_treeMapNode != nullptr)
+        m_treeMapNode->setText(m_map->mapProperties()->name() + " *");
 }
 
 // -------------------------------------------------------
 
 void ControlMapEditor::save(){
-    m_treeMapNode->setText(m_map->mapProperties()->name());
+    if (m_treeMapNode != nullptr)
+        m_treeMapNode->setText(m_map->mapProperties()->name());
 }
 
 // -------------------------------------------------------
@@ -547,7 +617,7 @@ bool ControlMapEditor::areLandsEquals(LandDatas* landBefore,
         if (landBefore->getSubKind() == kindAfter){
             switch (kindAfter){
             case MapEditorSubSelectionKind::Floors:
-                return (*(((FloorDatas*) landBefore)->textureRect())) ==
+                return ((FloorDatas*) landBefore)->textureRect() ==
                         textureAfter;
             case MapEditorSubSelectionKind::Autotiles:
                 return false; // TODO
@@ -567,13 +637,9 @@ bool ControlMapEditor::areLandsEquals(LandDatas* landBefore,
 LandDatas* ControlMapEditor::getLandAfter(MapEditorSubSelectionKind kindAfter,
                                           QRect &textureAfter)
 {
-    QRect* texture = new QRect(textureAfter.x(),
-                               textureAfter.y(),
-                               textureAfter.width(),
-                               textureAfter.height());
     switch (kindAfter) {
     case MapEditorSubSelectionKind::Floors:
-        return new FloorDatas(texture);
+        return new FloorDatas(textureAfter);
     case MapEditorSubSelectionKind::Autotiles:
         return nullptr;
     case MapEditorSubSelectionKind::Water:
@@ -591,10 +657,7 @@ void ControlMapEditor::getLandTexture(QRect& rect, LandDatas* land){
     switch (land->getSubKind()) {
     case MapEditorSubSelectionKind::Floors:
         floor = (FloorDatas*) land;
-        rect.setX(floor->textureRect()->x());
-        rect.setY(floor->textureRect()->y());
-        rect.setWidth(floor->textureRect()->width());
-        rect.setHeight(floor->textureRect()->height());
+        rect = floor->textureRect();
         break;
     case MapEditorSubSelectionKind::Autotiles:
         break;
@@ -611,7 +674,7 @@ SpriteDatas* ControlMapEditor::getCompleteSprite(MapEditorSubSelectionKind kind,
         int xOffset, int yOffset, int zOffset, QRect& tileset, bool front,
         bool layerOn) const
 {
-    SpriteDatas* sprite = new SpriteDatas(kind, new QRect(tileset), front);
+    SpriteDatas* sprite = new SpriteDatas(kind, tileset, front);
     if (layerOn) {
         sprite->setXOffset(xOffset);
         sprite->setYOffset(yOffset);
@@ -1060,6 +1123,28 @@ void ControlMapEditor::showHideSquareInformations() {
 
 // -------------------------------------------------------
 
+void ControlMapEditor::switchPicking() {
+    m_isPickingGPU = !m_isPickingGPU;
+    if (m_picking != nullptr)
+        m_picking->invalidate();
+}
+
+// -------------------------------------------------------
+//  checkPicking: GPU picking support is only known once a map is loaded in
+//  the OpenGL context. If not supported, the raycasting is used again
+
+bool ControlMapEditor::checkPicking() {
+    if (m_isPickingGPU && m_picking != nullptr && !m_picking->isSupported())
+    {
+        m_isPickingGPU = false;
+        return false;
+    }
+
+    return true;
+}
+
+// -------------------------------------------------------
+
 QString ControlMapEditor::getSquareInfos(MapEditorSelectionKind kind,
                                          MapEditorSubSelectionKind subKind,
                                          bool layerOn)
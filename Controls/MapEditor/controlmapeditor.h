@@ -30,6 +30,7 @@
 #include "contextmenulist.h"
 #include "wallindicator.h"
 #include "controlundoredo.h"
+#include "mappicking.h"
 
 // -------------------------------------------------------
 //
@@ -52,6 +53,7 @@ public:
     Cursor* cursorObject() const;
     Camera* camera() const;
     bool displaySquareInformations() const;
+    const MapMemoryUsage& memoryUsage() const;
     void setContextMenu(ContextMenuList* m);
     void setTreeMapNode(QStandardItem* item);
     void moveCursorToMousePosition(QPoint point, bool layerOn);
@@ -106,6 +108,7 @@ public:
     void updatePreviewElementGrid(Position &p, Portion &portion,
                                   MapElement* element);
     void updateMovingPortions();
+    void teleportCursor(int x, int z);
     void updateMovingPortionsEastWest(Portion& newPortion);
     void updateMovingPortionsNorthSouth(Portion& newPortion);
     void updateMovingPortionsUpDown(Portion&);
@@ -115,6 +118,7 @@ public:
     void updatePortions();
     void saveTempPortions();
     void clearPortionsToUpdate();
+    void updateMemoryUsage();
     void setToNotSaved();
     void save();
 
@@ -189,6 +193,8 @@ public:
                             QString& messageError) const;
     void showHideGrid();
     void showHideSquareInformations();
+    void switchPicking();
+    bool checkPicking();
     void undo();
     void redo();
     void undoRedo(QJsonArray& states, bool reverseAction);
@@ -228,6 +234,7 @@ private:
     WallIndicator* m_endWallIndicator;
     Cursor* m_cursorObject;
     Camera* m_camera;
+    MapPicking* m_picking;
 
     // Others
     int m_width;
@@ -258,6 +265,8 @@ private:
     bool m_needMapObjectsUpdate;
     bool m_displayGrid;
     bool m_displaySquareInformations;
+    bool m_isPickingGPU;
+    MapMemoryUsage m_memoryUsage;
     QStandardItem* m_treeMapNode;
     SystemCommonObject* m_selectedObject;
     ContextMenuList* m_contextMenu;
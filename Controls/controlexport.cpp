@@ -20,6 +20,24 @@
 #include "controlexport.h"
 #include "wanok.h"
 #include <QDirIterator>
+#include <QtConcurrent>
+#include <QPainter>
+#include <QCryptographicHash>
+#include <QImageReader>
+#include "portiongeometry.h"
+#include "systemspecialelement.h"
+#ifdef __linux__
+    #include <sys/ioctl.h>
+    #include <linux/fs.h>
+#endif
+
+const QString ControlExport::FILE_MANIFEST = "export.json";
+const int ControlExport::ATLAS_SIZE = 2048;
+const QString ControlExport::PATH_ATLASES =
+        Wanok::pathCombine(Wanok::pathCombine("Content", "Pictures"),
+                           "Atlases");
+const QString ControlExport::PATH_BUNDLES = Wanok::pathCombine("Content",
+                                                               "Bundles");
 
 // -------------------------------------------------------
 //
@@ -58,14 +76,23 @@ QString ControlExport::createDesktop(QString location, OSKind os, bool){
     QString path = Wanok::pathCombine(location, projectName);
 
     // Copying all the project
-    message = copyAllProject(location, projectName, path, dirLocation);
+    message = copyAllProject(location, projectName, path, dirLocation, false);
     if (message != NULL)
         return message;
 
-    // Remove all the files that are no longer needed here
-    removeDesktopNoNeed(path);
+    // Maps geometry
+    message = bakeMapsGeometry(path);
+    if (message != NULL)
+        return message;
+
+    message = generateDesktopStuff(path, os);
+    if (message != NULL)
+        return message;
+
+    // Remove what a previous export left and is not needed anymore
+    removeExportStale(path);
 
-    return generateDesktopStuff(path, os);
+    return NULL;
 }
 
 // -------------------------------------------------------
@@ -78,33 +105,54 @@ QString ControlExport::createBrowser(QString location){
     QString path = Wanok::pathCombine(location, projectName);
 
     // Copying all the project
-    message = copyAllProject(location, projectName, path, dirLocation);
+    message = copyAllProject(location, projectName, path, dirLocation, true);
+    if (message != NULL)
+        return message;
+
+    // Maps geometry
+    message = bakeMapsGeometry(path);
+    if (message != NULL)
+        return message;
+
+    message = generateWebStuff(path);
     if (message != NULL)
         return message;
 
-    // Remove all the files that are no longer needed here
-    removeWebNoNeed(path);
+    // Remove what a previous export left and is not needed anymore
+    removeExportStale(path);
 
-    return generateWebStuff(path);
+    return NULL;
 }
 
 // -------------------------------------------------------
 
 QString ControlExport::copyAllProject(QString location, QString projectName,
-                                      QString path, QDir dirLocation){
+                                      QString path, QDir dirLocation,
+                                      bool isWeb)
+{
     if (!QDir::isAbsolutePath(location))
         return "The path location needs to be absolute.";
     if (!dirLocation.exists())
         return "The path location doesn't exists.";
-    if (!dirLocation.mkdir(projectName))
-        return "The directory " + projectName + " already exists.";
 
-    // Copy Content
+    // If the directory already exists, only the changes are exported
+    if (!dirLocation.mkpath(projectName))
+        return "Could not create the directory " + projectName + ".";
+
+    // Plan all the Content files that are needed
     QDir(m_project->pathCurrentProject()).mkdir("Content");
     QString pathContentProject =
             Wanok::pathCombine(m_project->pathCurrentProject(), "Content");
-    QString pathContent = Wanok::pathCombine(path, "Content");
-    if (!Wanok::copyPath(pathContentProject, pathContent))
+    QStringList dirs, files;
+    getExportFiles(pathContentProject, "Content", isWeb, dirs, files);
+    m_exportedFiles = files;
+
+    // Copy Content
+    for (int i = 0; i < dirs.size(); i++) {
+        if (!QDir(path).mkpath(dirs.at(i)))
+            return "Error while copying Content directory. Please retry.";
+    }
+    if (!copyFilesExport(m_project->pathCurrentProject(), path, files))
         return "Error while copying Content directory. Please retry.";
 
     return NULL;
@@ -112,27 +160,220 @@ QString ControlExport::copyAllProject(QString location, QString projectName,
 
 // -------------------------------------------------------
 
-void ControlExport::removeWebNoNeed(QString path){
+void ControlExport::getExportFiles(QString pathDir, QString relativeDir,
+                                   bool isWeb, QStringList& dirs,
+                                   QStringList& files)
+{
+    QDir dir(pathDir);
+    dirs.append(relativeDir);
+
+    foreach (QString d, dir.entryList(QDir::Dirs | QDir::NoDotAndDotDot)) {
+        QString relative = Wanok::pathCombine(relativeDir, d);
+        if (!isNoNeedDir(relative, isWeb)) {
+            getExportFiles(Wanok::pathCombine(pathDir, d), relative, isWeb,
+                           dirs, files);
+        }
+    }
+
+    foreach (QString f, dir.entryList(QDir::Files)) {
+        QString relative = Wanok::pathCombine(relativeDir, f);
+        if (!isNoNeedFile(relative, isWeb))
+            files.append(relative);
+    }
+}
+
+// -------------------------------------------------------
+
+bool ControlExport::isNoNeedDir(QString relativeDir, bool isWeb) const {
+    QFileInfo info(relativeDir);
+
+    // Maps temp folders
+    if (QFileInfo(info.path()).path() == Wanok::pathMaps &&
+        (info.fileName() == Wanok::TEMP_MAP_FOLDER_NAME ||
+         info.fileName() == Wanok::TEMP_UNDOREDO_MAP_FOLDER_NAME))
+    {
+        return true;
+    }
+
+    // Editor minimaps cache
+    if (relativeDir == Wanok::PATH_MINIMAPS)
+        return true;
+
+    // Desktop scripts
+    if (isWeb) {
+        return relativeDir == Wanok::pathCombine(Wanok::pathScriptsSystemDir,
+                                                 "desktop");
+    }
 
-    // Remove useless datas
-    QString pathDatas = Wanok::pathCombine(path, Wanok::pathDatas);
-    QFile(Wanok::pathCombine(pathDatas, "treeMap.json")).remove();
-    QFile(Wanok::pathCombine(pathDatas, "scripts.json")).remove();
-    QString pathScripts = Wanok::pathCombine(path, Wanok::pathScriptsSystemDir);
-    QDir(Wanok::pathCombine(pathScripts, "desktop")).removeRecursively();
-    removeMapsTemp(pathDatas);
+    return false;
 }
 
 // -------------------------------------------------------
 
-void ControlExport::removeDesktopNoNeed(QString path){
+bool ControlExport::isNoNeedFile(QString relativeFile, bool isWeb) const {
+    if (relativeFile == Wanok::pathTreeMap ||
+        relativeFile == Wanok::pathScripts ||
+        relativeFile == Wanok::PATH_USAGES)
+    {
+        return true;
+    }
 
-    // Remove useless datas
-    QString pathDatas = Wanok::pathCombine(path, Wanok::pathDatas);
-    QFile(Wanok::pathCombine(pathDatas, "treeMap.json")).remove();
-    QFile(Wanok::pathCombine(pathDatas, "scripts.json")).remove();
-    QFile(Wanok::pathCombine(pathDatas, "pictures.json")).remove();
-    removeMapsTemp(pathDatas);
+    // pictures.json is generated by copyBRPictures
+    return relativeFile == Wanok::pathPicturesDatas;
+}
+
+// -------------------------------------------------------
+//  Only the files written by the previous export (listed in its manifest) and
+//  not by this one are removed, so that the files added by the user are kept
+
+void ControlExport::removeExportStale(QString path) {
+    QString pathManifest = Wanok::pathCombine(path, FILE_MANIFEST);
+    QSet<QString> exported = m_exportedFiles.toSet();
+
+    if (QFile(pathManifest).exists()) {
+        QJsonDocument document;
+        Wanok::readOtherJSON(pathManifest, document);
+        QJsonArray tabPrevious = document.object()["files"].toArray();
+        for (int i = 0; i < tabPrevious.size(); i++) {
+            QString relative = QDir::cleanPath(tabPrevious.at(i).toString());
+            if (relative.startsWith("Content/") && !exported.contains(relative))
+                QFile(Wanok::pathCombine(path, relative)).remove();
+        }
+    }
+
+    QJsonArray tabFiles;
+    for (int i = 0; i < m_exportedFiles.size(); i++)
+        tabFiles.append(m_exportedFiles.at(i));
+    QJsonObject obj;
+    obj["files"] = tabFiles;
+    Wanok::writeOtherJSON(pathManifest, obj);
+}
+
+// -------------------------------------------------------
+//  Run the map editor geometry code once for each portion so that the
+//  runtime only has to upload buffers when entering a map
+
+QString ControlExport::bakeMapsGeometry(QString path) {
+    QString pathMaps = Wanok::pathCombine(path, Wanok::pathMaps);
+    int squareSize = m_project->gameDatas()->systemDatas()->squareSize();
+    QDirIterator directories(pathMaps, QDir::Dirs | QDir::NoDotAndDotDot);
+
+    while (directories.hasNext()) {
+        directories.next();
+        QString message = bakeMapGeometry(path, directories.filePath(),
+                                          squareSize);
+        if (message != NULL)
+            return message;
+    }
+
+    return NULL;
+}
+
+// -------------------------------------------------------
+
+QString ControlExport::bakeMapGeometry(QString path, QString pathMap,
+                                       int squareSize)
+{
+    MapProperties properties(pathMap);
+    SystemTileset* tileset = properties.tileset();
+    QString pathTileset = tileset->picture()->getPath(PictureKind::Tilesets);
+    QSize sizeTileset = QImageReader(pathTileset).size();
+    if (!sizeTileset.isValid())
+        sizeTileset = QSize(1, 1);
+
+    // A portion geometry needs to be baked again if the portion, the map
+    // properties or one of the textures changed since
+    QDateTime lastModified = QFileInfo(Wanok::pathCombine(
+                                           pathMap, Wanok::fileMapInfos))
+            .lastModified();
+    lastModified = qMax(lastModified, QFileInfo(pathTileset).lastModified());
+    QHash<int, QSize> sizesWalls;
+    getSizesWalls(tileset, sizesWalls, lastModified);
+
+    QStringList portions = QDir(pathMap).entryList(
+                QStringList() << "*_*_*.json", QDir::Files);
+    QVector<bool> baked(portions.size(), false);
+    bool* bakedDatas = baked.data();
+    QList<int> indexes;
+    for (int i = 0; i < portions.size(); i++)
+        indexes.append(i);
+    QAtomicInt errors(0);
+
+    // Each worker reads its own copy of the portion file and only the lands
+    // and sprites: nothing of the opened project is used outside this thread
+    QtConcurrent::blockingMap(indexes, [&](const int& index) {
+        const QString& name = portions.at(index);
+        QStringList list = QFileInfo(name).completeBaseName().split("_");
+        Portion portion(list.at(0).toInt(), list.at(1).toInt(),
+                        list.at(2).toInt());
+        QString pathPortion = Wanok::pathCombine(pathMap, name);
+        QString pathGeometry = Wanok::pathCombine(
+                    pathMap, PortionGeometry::getPortionPathGeometry(
+                        portion.x(), portion.y(), portion.z()));
+        QFileInfo infoGeometry(pathGeometry);
+        if (infoGeometry.exists() &&
+            infoGeometry.lastModified() >= qMax(lastModified,
+                QFileInfo(pathPortion).lastModified()))
+        {
+            bakedDatas[index] = true;
+            return;
+        }
+
+        QJsonDocument document;
+        Wanok::readOtherJSON(pathPortion, document);
+        MapPortion mapPortion(portion);
+        mapPortion.readGeometry(document.object());
+        PortionGeometry geometry;
+        mapPortion.bakeVertices(geometry, squareSize, sizeTileset.width(),
+                                sizeTileset.height(), sizesWalls);
+        if (geometry.isEmpty())
+            QFile::remove(pathGeometry);
+        else if (geometry.write(pathGeometry, portion, squareSize))
+            bakedDatas[index] = true;
+        else
+            errors.ref();
+    });
+
+    if (errors.load() != 0)
+        return "Could not write the geometry of " + pathMap + ".";
+
+    // Keep the baked files in this export
+    QDir dir(path);
+    for (int i = 0; i < portions.size(); i++) {
+        if (baked.at(i)) {
+            QString name = portions.at(i);
+            name.chop(4);
+            m_exportedFiles.append(dir.relativeFilePath(
+                Wanok::pathCombine(pathMap, name + "geo")));
+        }
+    }
+
+    return NULL;
+}
+
+// -------------------------------------------------------
+
+void ControlExport::getSizesWalls(SystemTileset* tileset,
+                                  QHash<int, QSize>& sizesWalls,
+                                  QDateTime& lastModified)
+{
+    QStandardItemModel* model = tileset->model(PictureKind::Walls);
+    QStandardItemModel* modelSpecials = m_project->specialElementsDatas()
+            ->model(PictureKind::Walls);
+
+    for (int i = 0; i < model->invisibleRootItem()->rowCount(); i++) {
+        int id = ((SuperListItem*) model->item(i)->data().value<qintptr>())
+                ->id();
+        SystemSpecialElement* special = (SystemSpecialElement*)
+                SuperListItem::getById(modelSpecials->invisibleRootItem(), id);
+        if (special == nullptr)
+            continue;
+        QString pathWall = special->picture()->getPath(PictureKind::Walls);
+        QSize size = QImageReader(pathWall).size();
+        sizesWalls[id] = size.isValid() ? size : QSize(1, 1);
+        lastModified = qMax(lastModified, QFileInfo(pathWall).lastModified());
+    }
+    sizesWalls[-1] = QSize(1, 1);
 }
 
 // -------------------------------------------------------
@@ -141,28 +382,30 @@ QString ControlExport::generateWebStuff(QString path){
     QString pathWeb = Wanok::pathCombine("Content", "web");
 
     // Write index.php
-    QFile::copy(Wanok::pathCombine(pathWeb, "index.php"),
-                Wanok::pathCombine(path, "index.php"));
+    copyFileExport(Wanok::pathCombine(pathWeb, "index.php"),
+                   Wanok::pathCombine(path, "index.php"));
 
     // Write include.html
     m_project->scriptsDatas()->writeBrowser(path);
 
     // Write three.js library and other .js files to include
     QDir dir(path);
-    if (!dir.mkdir("js"))
-        return "The directory js already exists.";
+    if (!dir.mkpath("js"))
+        return "Could not create the directory js.";
     QString pathJS = Wanok::pathCombine(path, "js");
-    QFile::copy(Wanok::pathCombine(pathWeb, "three.js"),
-                Wanok::pathCombine(pathJS, "three.js"));
-    QFile::copy(Wanok::pathCombine(pathWeb, "index.js"),
-                Wanok::pathCombine(pathJS, "index.js"));
-    QFile::copy(Wanok::pathCombine(pathWeb, "utilities.js"),
-                Wanok::pathCombine(pathJS, "utilities.js"));
+    QStringList filesJS;
+    filesJS << "three.js" << "index.js" << "utilities.js";
+    if (!copyFilesExport(pathWeb, pathJS, filesJS))
+        return "Could not copy in " + pathJS;
 
     // Pictures
-    copyBRPictures(path);
+    if (!copyBRPictures(path))
+        return "Could not copy the BR pictures.";
+    if (!packWebPictures(path))
+        return "Could not write the pictures atlases.";
 
-    return NULL;
+    // Datas bundles
+    return packWebDatas(path);
 }
 
 // -------------------------------------------------------
@@ -185,37 +428,27 @@ QString ControlExport::generateDesktopStuff(QString path, OSKind os){
     }
     QString pathExecutable = Wanok::pathCombine("Content", executableFolder);
 
-    if (!Wanok::copyPath(pathExecutable, path))
+    if (!copyPathExport(pathExecutable, path))
         return "Could not copy in " + pathExecutable;
 
     // Pictures
-    copyBRPictures(path);
+    if (!copyBRPictures(path))
+        return "Could not copy the BR pictures.";
 
     return NULL;
 }
 
 // -------------------------------------------------------
+//  The BR pictures are copied like the planned files, only if they changed
+//  since a previous export
 
-void ControlExport::removeMapsTemp(QString pathDatas){
-    QString pathMaps = Wanok::pathCombine(pathDatas, "Maps");
-
-    QDirIterator directories(pathMaps, QDir::Dirs | QDir::NoDotAndDotDot);
-
-    while (directories.hasNext()){
-        directories.next();
-        QDir(Wanok::pathCombine(Wanok::pathCombine(pathMaps,
-                                                   directories.fileName()),
-                                "temp")).removeRecursively();
-    }
-}
-
-// -------------------------------------------------------
-
-void ControlExport::copyBRPictures(QString path){
+bool ControlExport::copyBRPictures(QString path){
     PictureKind kind;
     QStandardItemModel* model, *newModel;
     SystemPicture* picture, *newPicture;
     PicturesDatas newPicturesDatas;
+    QSet<QString> planned = m_exportedFiles.toSet();
+    QList<QPair<QString, QString>> copies;
 
     // Iterate all the pictures kind
     for (int k = (int) PictureKind::Bars; k != (int) PictureKind::Last; k++)
@@ -231,28 +464,458 @@ void ControlExport::copyBRPictures(QString path){
            newPicture->setId(picture->id());
 
            // If the picture is from BR, we need to copy it in the project
+           // (renamed if the project already has a picture with this name)
            if (picture->isBR()){
-                QString pathBR = picture->getPath(kind);
-                QString pathProject =
-                        Wanok::pathCombine(path, picture->getLocalPath(kind));
-                if (QFile(pathProject).exists()) {
+                QString localPath = picture->getLocalPath(kind);
+                if (planned.contains(localPath)) {
                     QFileInfo fileInfo(picture->name());
                     QString extension = fileInfo.completeSuffix();
                     QString baseName = fileInfo.baseName();
-                    newPicture->setName(baseName + "_br" + extension);
-                    pathProject =
-                       Wanok::pathCombine(path, newPicture->getLocalPath(kind));
+                    newPicture->setName(baseName + "_br." + extension);
+                    localPath = newPicture->getLocalPath(kind);
                 }
-
-                QFile::copy(pathBR, pathProject);
+                copies.append(QPair<QString, QString>(
+                                  picture->getPath(kind),
+                                  Wanok::pathCombine(path, localPath)));
+                m_exportedFiles.append(localPath);
                 newPicture->setIsBR(false);
            }
            newPicturesDatas.model(kind)->appendRow(newPicture->getModelRow());
        }
     }
 
-    // Copy the new picutres datas without BR
-    QString pathDatas = Wanok::pathCombine(path, Wanok::pathDatas);
-    Wanok::writeJSON(Wanok::pathCombine(pathDatas, "pictures.json"),
-                     newPicturesDatas);
+    // Copy the new picutres datas without BR (only if changed, so that the
+    // datas bundle is not packed again)
+    QString pathPictures = Wanok::pathCombine(path, Wanok::pathPicturesDatas);
+    QJsonObject objPictures;
+    newPicturesDatas.write(objPictures);
+    QFile filePictures(pathPictures);
+    if (!filePictures.open(QIODevice::ReadOnly) ||
+        QJsonDocument::fromJson(filePictures.readAll()).object() !=
+        objPictures)
+    {
+        filePictures.close();
+        Wanok::writeOtherJSON(pathPictures, objPictures);
+    }
+    m_exportedFiles.append(Wanok::pathPicturesDatas);
+
+    for (int i = 0; i < copies.size(); i++) {
+        if (!QDir().mkpath(QFileInfo(copies.at(i).second).path()))
+            return false;
+    }
+
+    return copyFilesExport(copies);
+}
+
+// -------------------------------------------------------
+//  Copy all the files of a directory, skipping the ones that didn't change
+//  since a previous export
+
+bool ControlExport::copyPathExport(QString src, QString dst) {
+    QDir dir(src);
+    if (!dir.exists())
+        return false;
+
+    QStringList files;
+    QDirIterator it(src, QDir::Files, QDirIterator::Subdirectories);
+    while (it.hasNext()) {
+        it.next();
+        QString relative = dir.relativeFilePath(it.filePath());
+        if (!QDir(dst).mkpath(QFileInfo(relative).path()))
+            return false;
+        files.append(relative);
+    }
+
+    return copyFilesExport(src, dst, files);
+}
+
+// -------------------------------------------------------
+//  Copy a list of relative files in parallel. The target directories need to
+//  exist.
+
+bool ControlExport::copyFilesExport(QString src, QString dst,
+                                    const QStringList& files)
+{
+    QList<QPair<QString, QString>> copies;
+    copies.reserve(files.size());
+    for (int i = 0; i < files.size(); i++) {
+        copies.append(QPair<QString, QString>(
+                          Wanok::pathCombine(src, files.at(i)),
+                          Wanok::pathCombine(dst, files.at(i))));
+    }
+
+    return copyFilesExport(copies);
+}
+
+// -------------------------------------------------------
+//  Copy a list of (source, target) files in parallel
+
+bool ControlExport::copyFilesExport(const QList<QPair<QString, QString>>&
+                                    files)
+{
+    QAtomicInt errors(0);
+    QtConcurrent::blockingMap(files, [&](const QPair<QString, QString>& file)
+    {
+        if (!copyFileExport(file.first, file.second))
+            errors.ref();
+    });
+
+    return errors.load() == 0;
+}
+
+// -------------------------------------------------------
+
+bool ControlExport::copyFileExport(QString src, QString dst) {
+    QFileInfo infoSource(src), infoTarget(dst);
+
+    // Same size and copied after the last source modification: up to date
+    if (infoTarget.exists() && infoTarget.size() == infoSource.size() &&
+        infoTarget.lastModified() >= infoSource.lastModified())
+    {
+        return true;
+    }
+
+    QFile::remove(dst);
+    if (cloneFile(src, dst))
+        return true;
+
+    return QFile::copy(src, dst);
+}
+
+// -------------------------------------------------------
+//  Share the file blocks when the file system allows it (copy-on-write, so
+//  the export and the project stay independant)
+
+bool ControlExport::cloneFile(QString src, QString dst) {
+    #if defined(__linux__) && defined(FICLONE)
+        QFile fileSource(src);
+        QFile fileTarget(dst);
+        if (!fileSource.open(QIODevice::ReadOnly))
+            return false;
+        if (!fileTarget.open(QIODevice::WriteOnly))
+            return false;
+        if (ioctl(fileTarget.handle(), FICLONE, fileSource.handle()) == 0)
+            return true;
+        fileTarget.close();
+        fileTarget.remove();
+    #else
+        Q_UNUSED(src);
+        Q_UNUSED(dst);
+    #endif
+
+    return false;
+}
+
+// -------------------------------------------------------
+//  Pack the small pictures of each kind into a few atlases, with a manifest
+//  giving the page and UVs of each picture so that the browser only needs to
+//  load a few textures. Tilesets, autotiles and walls are sampled with repeat
+//  so they keep their own file.
+
+bool ControlExport::packWebPictures(QString path) {
+    QString pathManifest = Wanok::pathCombine(
+                Wanok::pathCombine(path, PATH_ATLASES), "atlases.json");
+    QJsonDocument previous;
+    if (QFile(pathManifest).exists())
+        Wanok::readOtherJSON(pathManifest, previous);
+
+    if (!QDir(path).mkpath(PATH_ATLASES))
+        return false;
+    QJsonObject manifest;
+    if (!packWebPicturesKind(path, PictureKind::Bars, previous.object(),
+                             manifest) ||
+        !packWebPicturesKind(path, PictureKind::Icons, previous.object(),
+                             manifest) ||
+        !packWebPicturesKind(path, PictureKind::Characters,
+                             previous.object(), manifest))
+    {
+        return false;
+    }
+
+    Wanok::writeOtherJSON(pathManifest, manifest);
+    m_exportedFiles.append(Wanok::pathCombine(PATH_ATLASES, "atlases.json"));
+
+    return true;
+}
+
+// -------------------------------------------------------
+//  Shelf packing: pictures sorted by height are placed left to right on rows,
+//  a new page is created when a page is full. A kind is only packed again if
+//  its exported pictures changed since the previous export.
+
+bool ControlExport::packWebPicturesKind(QString path, PictureKind kind,
+                                        const QJsonObject& previous,
+                                        QJsonObject& manifest)
+{
+    QString key = QString::number((int) kind);
+    QString localFolder = SystemPicture::getLocalFolder(kind);
+    QStringList files = getExportedFiles(localFolder, QStringList("png"),
+                                         false);
+    QString signature = getFilesSignature(path, files);
+
+    // Nothing changed: keep the pages of the previous export
+    QJsonObject objPrevious = previous[key].toObject();
+    if (objPrevious["s"].toString() == signature) {
+        QStringList pagesFiles;
+        QJsonArray tabPages = objPrevious["pages"].toArray();
+        for (int i = 0; i < tabPages.size(); i++)
+            pagesFiles.append(tabPages.at(i).toObject()["f"].toString());
+        if (keepExportedFiles(path, pagesFiles)) {
+            manifest[key] = objPrevious;
+            return true;
+        }
+    }
+
+    QList<QPair<QString, QImage>> images;
+    for (int i = 0; i < files.size(); i++) {
+        QImage image(Wanok::pathCombine(path, files.at(i)));
+        if (image.isNull() || image.width() > ATLAS_SIZE ||
+            image.height() > ATLAS_SIZE)
+        {
+            continue;
+        }
+        images.append(QPair<QString, QImage>(files.at(i), image));
+    }
+    std::sort(images.begin(), images.end(),
+              [](const QPair<QString, QImage>& a,
+                 const QPair<QString, QImage>& b)
+    {
+        return a.second.height() > b.second.height();
+    });
+
+    QList<QImage> pages;
+    QList<int> pagesHeights;
+    int x = 0, y = 0, rowHeight = 0;
+    QJsonObject objPictures;
+    QPainter painter;
+
+    for (int i = 0; i < images.size(); i++) {
+        const QImage& image = images.at(i).second;
+
+        // New row, and new page if needed
+        if (x + image.width() > ATLAS_SIZE) {
+            x = 0;
+            y += rowHeight;
+            rowHeight = 0;
+        }
+        if (pages.isEmpty() || y + image.height() > ATLAS_SIZE) {
+            if (painter.isActive())
+                painter.end();
+            pages.append(QImage(ATLAS_SIZE, ATLAS_SIZE,
+                                QImage::Format_ARGB32));
+            pages.last().fill(Qt::transparent);
+            pagesHeights.append(0);
+            painter.begin(&pages.last());
+            x = 0;
+            y = 0;
+            rowHeight = 0;
+        }
+
+        painter.drawImage(x, y, image);
+        QJsonObject obj;
+        obj["p"] = pages.size() - 1;
+        obj["x"] = x;
+        obj["y"] = y;
+        obj["w"] = image.width();
+        obj["h"] = image.height();
+        objPictures[images.at(i).first] = obj;
+        x += image.width();
+        rowHeight = qMax(rowHeight, image.height());
+        pagesHeights.last() = qMax(pagesHeights.last(), y + rowHeight);
+    }
+    if (painter.isActive())
+        painter.end();
+
+    // Crop the pages to a power of two height and write them
+    QJsonArray tabPages;
+    for (int i = 0; i < pages.size(); i++) {
+        int height = 1;
+        while (height < pagesHeights.at(i))
+            height *= 2;
+        QString name = "atlas" + key + "_" + QString::number(i) + ".png";
+        QString relative = Wanok::pathCombine(PATH_ATLASES, name);
+        if (!pages[i].copy(0, 0, ATLAS_SIZE, height).save(
+                Wanok::pathCombine(path, relative)))
+        {
+            return false;
+        }
+        m_exportedFiles.append(relative);
+        QJsonObject obj;
+        obj["f"] = relative;
+        obj["w"] = ATLAS_SIZE;
+        obj["h"] = height;
+        tabPages.append(obj);
+    }
+
+    QJsonObject objKind;
+    objKind["s"] = signature;
+    objKind["pages"] = tabPages;
+    objKind["pictures"] = objPictures;
+    manifest[key] = objKind;
+
+    return true;
+}
+
+// -------------------------------------------------------
+//  Bundle all the datas json files and all the maps files into a few zlib
+//  compressed archives, with an index giving for each file its offset and
+//  size in the archive so that it can be fetched with a HTTP range request
+
+QString ControlExport::packWebDatas(QString path) {
+    QString pathIndex = Wanok::pathCombine(
+                Wanok::pathCombine(path, PATH_BUNDLES), "bundles.json");
+    QJsonDocument previous;
+    if (QFile(pathIndex).exists())
+        Wanok::readOtherJSON(pathIndex, previous);
+
+    QStringList datas = getExportedFiles(Wanok::pathDatas,
+                                         QStringList("json"), false);
+    QStringList maps = getExportedFiles(Wanok::pathMaps,
+                                        QStringList() << "json" << "geo",
+                                        true);
+
+    if (!QDir(path).mkpath(PATH_BUNDLES))
+        return "Could not create the directory " + PATH_BUNDLES + ".";
+    QJsonObject index;
+    if (!writeBundle(path, "datas.bundle", datas, previous.object(), index) ||
+        !writeBundle(path, "maps.bundle", maps, previous.object(), index))
+    {
+        return "Could not write the datas bundles.";
+    }
+    Wanok::writeOtherJSON(pathIndex, index);
+    m_exportedFiles.append(Wanok::pathCombine(PATH_BUNDLES, "bundles.json"));
+
+    return NULL;
+}
+
+// -------------------------------------------------------
+//  Each entry of the index is [offset, compressed size, size]. The entries
+//  are raw zlib streams (without the qCompress size header), an empty file
+//  has an empty entry. A bundle is only written again if its files changed
+//  since the previous export.
+
+bool ControlExport::writeBundle(QString path, QString name,
+                                const QStringList& files,
+                                const QJsonObject& previous,
+                                QJsonObject& index)
+{
+    QString relative = Wanok::pathCombine(PATH_BUNDLES, name);
+    QString signature = getFilesSignature(path, files);
+
+    // Nothing changed: keep the bundle of the previous export
+    QJsonObject objPrevious = previous[name].toObject();
+    if (objPrevious["s"].toString() == signature &&
+        keepExportedFiles(path, QStringList(relative)))
+    {
+        index[name] = objPrevious;
+        return true;
+    }
+
+    QAtomicInt errors(0);
+    QList<QByteArray> compressed = QtConcurrent::blockingMapped(
+                files, std::function<QByteArray(const QString&)>(
+                    [&path, &errors](const QString& file)
+    {
+        QFile loadFile(Wanok::pathCombine(path, file));
+        if (!loadFile.open(QIODevice::ReadOnly)) {
+            errors.ref();
+            return QByteArray();
+        }
+        QByteArray data = loadFile.readAll();
+        if (data.isEmpty())
+            return QByteArray();
+
+        return qCompress(data, 9).mid(4);
+    }));
+    if (errors.load() != 0)
+        return false;
+
+    QFile saveFile(Wanok::pathCombine(path, relative));
+    if (!saveFile.open(QIODevice::WriteOnly))
+        return false;
+
+    QJsonObject objFiles;
+    qint64 offset = 0;
+    for (int i = 0; i < files.size(); i++) {
+        const QByteArray& data = compressed.at(i);
+        if (saveFile.write(data) != data.size())
+            return false;
+
+        QJsonArray tab;
+        tab.append((double) offset);
+        tab.append(data.size());
+        tab.append((double) QFileInfo(Wanok::pathCombine(path, files.at(i)))
+                   .size());
+        objFiles[files.at(i)] = tab;
+        offset += data.size();
+    }
+    m_exportedFiles.append(relative);
+
+    QJsonObject objBundle;
+    objBundle["s"] = signature;
+    objBundle["files"] = objFiles;
+    index[name] = objBundle;
+
+    return true;
+}
+
+// -------------------------------------------------------
+//  getExportedFiles: the files of the current export in this folder (and its
+//  subfolders if recursive), sorted
+
+QStringList ControlExport::getExportedFiles(QString folder,
+                                            const QStringList& suffixes,
+                                            bool recursive) const
+{
+    QStringList files;
+    QString prefix = folder + "/";
+
+    for (int i = 0; i < m_exportedFiles.size(); i++) {
+        const QString& file = m_exportedFiles.at(i);
+        if (!file.startsWith(prefix))
+            continue;
+        if (!recursive && file.indexOf('/', prefix.size()) != -1)
+            continue;
+        if (suffixes.contains(QFileInfo(file).suffix()))
+            files.append(file);
+    }
+    files.sort();
+    files.removeDuplicates();
+
+    return files;
+}
+
+// -------------------------------------------------------
+//  keepExportedFiles: keep files written by a previous export if they all
+//  still exist
+
+bool ControlExport::keepExportedFiles(QString path, const QStringList& files)
+{
+    for (int i = 0; i < files.size(); i++) {
+        if (!QFile(Wanok::pathCombine(path, files.at(i))).exists())
+            return false;
+    }
+    m_exportedFiles.append(files);
+
+    return true;
+}
+
+// -------------------------------------------------------
+//  getFilesSignature: the exported files are only copied if they changed, so
+//  their names, sizes and dates tell if a packed file needs to be written
+//  again
+
+QString ControlExport::getFilesSignature(QString path,
+                                         const QStringList& files)
+{
+    QCryptographicHash hash(QCryptographicHash::Md5);
+
+    for (int i = 0; i < files.size(); i++) {
+        QFileInfo info(Wanok::pathCombine(path, files.at(i)));
+        hash.addData((files.at(i) + ":" + QString::number(info.size()) + ":" +
+                      QString::number(info.lastModified().toMSecsSinceEpoch())
+                      + "\n").toUtf8());
+    }
+
+    return hash.result().toHex();
 }
@@ -22,8 +22,11 @@
 
 #include <QString>
 #include <QDir>
+#include <QJsonObject>
+#include <QDateTime>
 #include "oskind.h"
 #include "project.h"
+#include "systemtileset.h"
 
 // -------------------------------------------------------
 //
@@ -36,20 +39,51 @@
 class ControlExport
 {
 public:
+    static const QString FILE_MANIFEST;
+    static const int ATLAS_SIZE;
+    static const QString PATH_ATLASES;
+    static const QString PATH_BUNDLES;
+
     ControlExport(Project* project);
     QString createDesktop(QString location, OSKind os, bool);
     QString createBrowser(QString location);
     QString copyAllProject(QString location, QString projectName, QString path,
-                           QDir dirLocation);
-    void removeWebNoNeed(QString path);
-    void removeDesktopNoNeed(QString path);
+                           QDir dirLocation, bool isWeb);
+    void getExportFiles(QString pathDir, QString relativeDir, bool isWeb,
+                        QStringList& dirs, QStringList& files);
+    bool isNoNeedDir(QString relativeDir, bool isWeb) const;
+    bool isNoNeedFile(QString relativeFile, bool isWeb) const;
+    void removeExportStale(QString path);
+    QString bakeMapsGeometry(QString path);
+    QString bakeMapGeometry(QString path, QString pathMap, int squareSize);
+    void getSizesWalls(SystemTileset* tileset, QHash<int, QSize>& sizesWalls,
+                       QDateTime& lastModified);
     QString generateWebStuff(QString path);
     QString generateDesktopStuff(QString path, OSKind os);
-    void removeMapsTemp(QString pathDatas);
-    void copyBRPictures(QString path);
+    bool copyBRPictures(QString path);
+    bool packWebPictures(QString path);
+    bool packWebPicturesKind(QString path, PictureKind kind,
+                             const QJsonObject& previous,
+                             QJsonObject& manifest);
+    QString packWebDatas(QString path);
+    bool writeBundle(QString path, QString name, const QStringList& files,
+                     const QJsonObject& previous, QJsonObject& index);
+    QStringList getExportedFiles(QString folder, const QStringList& suffixes,
+                                 bool recursive) const;
+    bool keepExportedFiles(QString path, const QStringList& files);
+    static QString getFilesSignature(QString path, const QStringList& files);
+    static bool copyPathExport(QString src, QString dst);
+    static bool copyFilesExport(QString src, QString dst,
+                                const QStringList& files);
+    static bool copyFilesExport(const QList<QPair<QString, QString>>& files);
+    static bool copyFileExport(QString src, QString dst);
+    static bool cloneFile(QString src, QString dst);
 
 protected:
     Project* m_project;
+
+    // Files written under Content by the current export, relative to it
+    QStringList m_exportedFiles;
 };
 
 #endif // CONTROLEXPORT_H
@@ -0,0 +1,221 @@
+/*
+    RPG Paper Maker Copyright (C) 2017 Marie Laporte
+
+    This file is part of RPG Paper Maker.
+
+    RPG Paper Maker is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    RPG Paper Maker is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with Foobar.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include "controlmapsremap.h"
+#include "wanok.h"
+#include "lands.h"
+#include "sprites.h"
+#include <QDirIterator>
+#include <QRegularExpression>
+#include <QtConcurrent>
+
+// -------------------------------------------------------
+//
+//  CONSTRUCTOR / DESTRUCTOR / GET / SET
+//
+// -------------------------------------------------------
+
+ControlMapsRemap::ControlMapsRemap(Project* project) :
+    m_project(project),
+    m_tilesetID(-1)
+{
+
+}
+
+void ControlMapsRemap::setTilesetID(int id) { m_tilesetID = id; }
+
+bool ControlMapsRemap::isEmpty() const {
+    return m_floors.isEmpty() && m_sprites.isEmpty() && m_walls.isEmpty();
+}
+
+// -------------------------------------------------------
+//
+//  INTERMEDIARY FUNCTIONS
+//
+// -------------------------------------------------------
+
+// One rule per line: "floor x y -> x y", "sprite x y -> x y" (textures
+// origins in squares) or "wall id -> id". Everything after a # is ignored.
+
+QString ControlMapsRemap::parse(const QString& text) {
+    QRegularExpression regexTextures(
+                "^(floor|sprite)s?\\s+(\\d+)\\s+(\\d+)\\s*->\\s*(\\d+)\\s+"
+                "(\\d+)$");
+    QRegularExpression regexWalls("^walls?\\s+(\\d+)\\s*->\\s*(\\d+)$");
+    QStringList lines = text.split("\n");
+
+    m_floors.clear();
+    m_sprites.clear();
+    m_walls.clear();
+    for (int i = 0; i < lines.size(); i++) {
+        QString line = lines.at(i).section("#", 0, 0).trimmed();
+        if (line.isEmpty())
+            continue;
+
+        QRegularExpressionMatch match = regexTextures.match(line);
+        if (match.hasMatch()) {
+            QPair<int, int> from(match.captured(2).toInt(),
+                                 match.captured(3).toInt());
+            QPair<int, int> to(match.captured(4).toInt(),
+                               match.captured(5).toInt());
+            if (match.captured(1) == "floor")
+                m_floors.insert(from, to);
+            else
+                m_sprites.insert(from, to);
+            continue;
+        }
+        match = regexWalls.match(line);
+        if (match.hasMatch()) {
+            m_walls.insert(match.captured(1).toInt(),
+                           match.captured(2).toInt());
+            continue;
+        }
+
+        return "Line " + QString::number(i + 1) + " is not a valid rule: " +
+                line;
+    }
+
+    if (isEmpty())
+        return "There is nothing to replace.";
+
+    return NULL;
+}
+
+// -------------------------------------------------------
+
+QStringList ControlMapsRemap::getMapsPaths() const {
+    QString pathMaps = Wanok::pathCombine(m_project->pathCurrentProject(),
+                                          Wanok::pathMaps);
+    QDirIterator directories(pathMaps, QDir::Dirs | QDir::NoDotAndDotDot);
+    QStringList paths;
+
+    while (directories.hasNext()) {
+        directories.next();
+        if (directories.fileName() != Wanok::TEMP_MAP_FOLDER_NAME)
+            paths << directories.filePath();
+    }
+
+    return paths;
+}
+
+// -------------------------------------------------------
+// Each map is remapped by the global thread pool. The result is the ID of the
+// map if it was modified, -1 otherwise
+
+QFuture<int> ControlMapsRemap::start() {
+    QSet<int> mapsToSave = Wanok::mapsToSave;
+
+    return QtConcurrent::mapped(
+                getMapsPaths(), std::function<int(const QString&)>(
+                    [this, mapsToSave](const QString& pathMap)
+    {
+        return remapMap(pathMap, mapsToSave);
+    }));
+}
+
+// -------------------------------------------------------
+
+int ControlMapsRemap::remapMap(const QString& pathMap,
+                               const QSet<int>& mapsToSave) const
+{
+    QJsonObject infos = Wanok::parseJSON(
+                Wanok::pathCombine(pathMap, Wanok::fileMapInfos)).object();
+    if (infos.isEmpty())
+        return -1;
+    int id = infos["id"].toInt();
+    bool isTileset = infos["tileset"].toInt() == m_tilesetID;
+    if (!isTileset && m_walls.isEmpty())
+        return -1;
+
+    // If the map is not saved, its temp portions are the current ones
+    QString pathTemp = Wanok::pathCombine(pathMap,
+                                          Wanok::TEMP_MAP_FOLDER_NAME);
+    bool isTemp = mapsToSave.contains(id);
+    QStringList filters;
+    filters << "*.json";
+    QSet<QString> names = QDir(pathMap).entryList(filters, QDir::Files)
+            .toSet();
+    if (isTemp) {
+        names.unite(QDir(pathTemp).entryList(filters, QDir::Files)
+                    .toSet());
+    }
+    names.remove(Wanok::fileMapInfos);
+    names.remove(Wanok::fileMapObjects);
+
+    bool changed = false;
+    QSet<QString>::const_iterator i;
+    for (i = names.begin(); i != names.end(); i++) {
+        QString pathPortionTemp = Wanok::pathCombine(pathTemp, *i);
+        QString pathPortion = isTemp && QFile::exists(pathPortionTemp)
+                ? pathPortionTemp : Wanok::pathCombine(pathMap, *i);
+        QJsonObject json = Wanok::parseJSON(pathPortion).object();
+        if (!remapPortion(json, isTileset))
+            continue;
+
+        // Same as opening the map: the temp folder starts from the saved map
+        if (!changed && !isTemp) {
+            QDir(pathMap).mkpath(Wanok::TEMP_MAP_FOLDER_NAME);
+            Wanok::deleteAllFiles(pathTemp);
+            QFile(Wanok::pathCombine(pathMap, Wanok::fileMapObjects)).copy(
+                        Wanok::pathCombine(pathTemp, Wanok::fileMapObjects));
+        }
+        Wanok::writeOtherJSON(pathPortionTemp, json);
+        changed = true;
+    }
+
+    return changed ? id : -1;
+}
+
+// -------------------------------------------------------
+
+bool ControlMapsRemap::remapPortion(QJsonObject& json, bool isTileset) const
+{
+    if (!json.contains("lands"))
+        return false;
+
+    bool changed = false;
+    QJsonObject obj;
+
+    // Floors
+    if (isTileset && !m_floors.isEmpty()) {
+        Lands lands;
+        lands.read(json["lands"].toObject());
+        if (lands.remapTextures(m_floors)) {
+            lands.write(obj);
+            json["lands"] = obj;
+            changed = true;
+        }
+    }
+
+    // Sprites
+    if ((isTileset && !m_sprites.isEmpty()) || !m_walls.isEmpty()) {
+        Sprites sprites;
+        sprites.read(json["sprites"].toObject());
+        if (sprites.remapTextures(isTileset ? m_sprites : TexturesRemap(),
+                                  m_walls))
+        {
+            obj = QJsonObject();
+            sprites.write(obj);
+            json["sprites"] = obj;
+            changed = true;
+        }
+    }
+
+    return changed;
+}
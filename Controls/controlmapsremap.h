@@ -0,0 +1,59 @@
+/*
+    RPG Paper Maker Copyright (C) 2017 Marie Laporte
+
+    This file is part of RPG Paper Maker.
+
+    RPG Paper Maker is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    RPG Paper Maker is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with Foobar.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#ifndef CONTROLMAPSREMAP_H
+#define CONTROLMAPSREMAP_H
+
+#include <QFuture>
+#include <QSet>
+#include "project.h"
+#include "mapelement.h"
+
+// -------------------------------------------------------
+//
+//  CLASS ControlMapsRemap
+//
+//  The controler of the maps remap dialog. Replaces floors and sprites
+//  textures of a tileset and sprites walls IDs in every portion of every map.
+//  The results are written in the temp folder of the maps, so that they are
+//  only applied when saving (and discarded if not).
+//
+// -------------------------------------------------------
+
+class ControlMapsRemap
+{
+public:
+    ControlMapsRemap(Project* project);
+    void setTilesetID(int id);
+    bool isEmpty() const;
+    QString parse(const QString& text);
+    QStringList getMapsPaths() const;
+    QFuture<int> start();
+    int remapMap(const QString& pathMap, const QSet<int>& mapsToSave) const;
+    bool remapPortion(QJsonObject& json, bool isTileset) const;
+
+protected:
+    Project* m_project;
+    int m_tilesetID;
+    TexturesRemap m_floors;
+    TexturesRemap m_sprites;
+    QHash<int, int> m_walls;
+};
+
+#endif // CONTROLMAPSREMAP_H
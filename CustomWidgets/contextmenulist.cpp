@@ -78,9 +78,11 @@ ContextMenuList* ContextMenuList::createContextSuperList(QWidget *parent){
     QAction* actionCopy = new QAction("Copy", parent);
     QAction* actionPaste = new QAction("Paste", parent);
     QAction* actionDelete = new QAction("Delete", parent);
+    QAction* actionFindUsages = new QAction("Find usages", parent);
     menu->setActionCopy(actionCopy);
     menu->setActionPaste(actionPaste);
     menu->setActionDelete(actionDelete);
+    menu->setActionFindUsages(actionFindUsages);
 
     // Editing shortcut
     actionCopy->setShortcut(QKeySequence(QKeySequence::Copy));
@@ -92,11 +94,15 @@ ContextMenuList* ContextMenuList::createContextSuperList(QWidget *parent){
     menu->addAction(actionPaste);
     menu->addSeparator();
     menu->addAction(actionDelete);
+    menu->addSeparator();
+    menu->addAction(actionFindUsages);
 
     // Connexions
     connect(actionCopy, SIGNAL(triggered()), parent, SLOT(contextCopy()));
     connect(actionPaste, SIGNAL(triggered()), parent, SLOT(contextPaste()));
     connect(actionDelete, SIGNAL(triggered()), parent, SLOT(contextDelete()));
+    connect(actionFindUsages, SIGNAL(triggered()),
+            parent, SLOT(contextFindUsages()));
 
     return menu;
 }
@@ -267,6 +273,12 @@ void ContextMenuList::setActionHero(QAction* action){
 
 // -------------------------------------------------------
 
+void ContextMenuList::setActionFindUsages(QAction* action){
+    m_actionFindUsages = action;
+}
+
+// -------------------------------------------------------
+
 void ContextMenuList::canNew(bool b){
     m_actionNew->setEnabled(b);
 }
@@ -303,6 +315,12 @@ void ContextMenuList::canHero(bool b){
 
 // -------------------------------------------------------
 
+void ContextMenuList::canFindUsages(bool b){
+    m_actionFindUsages->setVisible(b);
+}
+
+// -------------------------------------------------------
+
 void ContextMenuList::showContextMenu(const QPoint &p)
 {
     this->exec(this->parentWidget()->mapToGlobal(p));
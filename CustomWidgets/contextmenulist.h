@@ -47,12 +47,14 @@ public:
     void setActionPaste(QAction* action);
     void setActionDelete(QAction* action);
     void setActionHero(QAction* action);
+    void setActionFindUsages(QAction* action);
     void canNew(bool b);
     void canEdit(bool b);
     void canCopy(bool b);
     void canPaste(bool b);
     void canDelete(bool b);
     void canHero(bool b);
+    void canFindUsages(bool b);
 
 protected:
     QAction* m_actionNew;
@@ -61,6 +63,7 @@ protected:
     QAction* m_actionPaste;
     QAction* m_actionDelete;
     QAction* m_actionHero;
+    QAction* m_actionFindUsages;
 
 public slots:
     void showContextMenu(const QPoint & p);
@@ -105,6 +105,9 @@ void PanelPicturePreview::setPictureKind(PictureKind kind){
     bool isNone = kind == PictureKind::None;
     m_pictureKind = kind;
     ui->widgetPreview->setKind(kind);
+    ui->widgetPanelIDs->list()->setUsageKind(
+                kind == PictureKind::Characters ? UsageKind::Character
+                                                : UsageKind::None);
 
     showPictures(!isNone);
 
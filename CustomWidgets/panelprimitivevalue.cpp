@@ -518,11 +518,11 @@ void PanelPrimitiveValue::initializeCommand(EventCommand* command, int &i){
     case PanelPrimitiveValueKind::DataBaseCommandId:
     case PanelPrimitiveValueKind::Number:
         setKind(static_cast<PrimitiveValueKind>(command
-                                                ->valueCommandAt(i++).toInt()));
+                                                ->intValueCommandAt(i++)));
         if (m_model->kind() == PrimitiveValueKind::NumberDouble)
             setNumberDoubleValue(command->valueCommandAt(i++).toDouble());
         else
-            setNumberValue(command->valueCommandAt(i++).toInt());
+            setNumberValue(command->intValueCommandAt(i++));
         break;
     }
 }
@@ -22,6 +22,8 @@
 #include <QHash>
 #include <QHashIterator>
 #include <QTime>
+#include <QElapsedTimer>
+#include <QFileInfo>
 #include "widgetmapeditor.h"
 #include "wanok.h"
 #include <QMessageBox>
@@ -35,17 +37,30 @@
 WidgetMapEditor::WidgetMapEditor(QWidget *parent) :
     QOpenGLWidget(parent),
     m_menuBar(nullptr),
+    m_panelTextures(nullptr),
     m_needUpdateMap(false),
     isGLInitialized(false),
     m_timerFirstPressure(new QTimer),
     m_firstPressure(false),
     m_spinBoxX(nullptr),
-    m_spinBoxZ(nullptr)
+    m_spinBoxZ(nullptr),
+    m_minimap(new WidgetMinimap(this)),
+    m_timerMinimap(new QTimer),
+    m_memoryUsageShown(-1)
 {
     // Timers
     m_timerFirstPressure->setSingleShot(true);
     connect(m_timerFirstPressure, SIGNAL(timeout()),
             this, SLOT(onFirstPressure()));
+    m_timerMinimap->setSingleShot(true);
+    m_timerMinimap->setInterval(1000);
+    connect(m_timerMinimap, SIGNAL(timeout()),
+            this, SLOT(onMinimapRefresh()));
+
+    // Minimap
+    m_minimap->resize(160, 160);
+    connect(m_minimap, SIGNAL(teleport(int, int)),
+            this, SLOT(onMinimapTeleport(int, int)));
 
     m_contextMenu = ContextMenuList::createContextObject(this);
     m_control.setContextMenu(m_contextMenu);
@@ -57,6 +72,7 @@ WidgetMapEditor::~WidgetMapEditor()
 {
     makeCurrent();
     delete m_timerFirstPressure;
+    delete m_timerMinimap;
 }
 
 void WidgetMapEditor::setMenuBar(WidgetMenuBarMapEditor* m){ m_menuBar = m; }
@@ -87,15 +103,33 @@ Map *WidgetMapEditor::loadMap(int idMap, QVector3D* position,
     m_cameraHorizontalAngle = cameraHorizontalAngle;
     m_cameraVerticalAngle = cameraVerticalAngle;
 
-    return m_control.loadMap(idMap, position, positionObject, cameraDistance,
-                             cameraHorizontalAngle, cameraVerticalAngle);
+    Map* map = m_control.loadMap(idMap, position, positionObject,
+                                 cameraDistance, cameraHorizontalAngle,
+                                 cameraVerticalAngle);
+    if (!m_control.checkPicking())
+        emit pickingUnsupported();
+
+    // Minimap (the cached one while the new one is generated)
+    ProjectMinimaps* minimaps = Wanok::get()->project()->minimaps();
+    connect(minimaps, SIGNAL(updated(int)), this, SLOT(onMinimapUpdated(int)),
+            Qt::UniqueConnection);
+    m_minimap->setImage(minimaps->image(idMap));
+    minimaps->refresh(idMap);
+
+    return map;
 }
 
 // -------------------------------------------------------
 
 void WidgetMapEditor::deleteMap(){
     makeCurrent();
+    m_replay.stopRecording();
+    m_replay.stopReplay();
     m_control.deleteMap();
+    m_timerMinimap->stop();
+    m_minimap->setImage(QImage());
+    m_memoryUsageShown = -1;
+    emit memoryUsageChanged("");
 }
 
 // -------------------------------------------------------
@@ -122,6 +156,7 @@ void WidgetMapEditor::initializeGL(){
 
 void WidgetMapEditor::resizeGL(int width, int height){
     m_control.onResize(width, height);
+    m_minimap->move(this->width() - m_minimap->width() - 10, 10);
 }
 
 // -------------------------------------------------------
@@ -129,11 +164,17 @@ void WidgetMapEditor::resizeGL(int width, int height){
 void WidgetMapEditor::paintGL(){
 
     QPainter p(this);
+    QElapsedTimer frameTimer;
+    frameTimer.start();
 
     // Clear buffer
     glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
 
     if (m_control.map() != nullptr) {
+        bool replaying = m_replay.isReplaying();
+        if (replaying)
+            replayFrame();
+
         p.beginNativePainting();
         glEnable(GL_DEPTH_TEST);
         glEnable(GL_BLEND);
@@ -145,26 +186,39 @@ void WidgetMapEditor::paintGL(){
         MapEditorSubSelectionKind subKind;
         DrawKind drawKind;
         bool layerOn;
+        QRect tileset;
+        int specialID;
 
         if (m_menuBar == nullptr) {
             kind = MapEditorSelectionKind::Land;
             subKind = MapEditorSubSelectionKind::None;
             drawKind = DrawKind::Pencil;
             layerOn = false;
+            specialID = -1;
         }
         else {
-            kind = m_menuBar->selectionKind();
-            subKind = m_menuBar->subSelectionKind();
-            drawKind = m_menuBar->drawKind();
-            layerOn = m_menuBar->layerOn();
+            getSelection(kind, subKind, drawKind, layerOn, tileset,
+                         specialID);
         }
 
+        // Time and mouse position (the recorded ones when replaying)
+        int elapsed = QTime::currentTime().msecsSinceStartOfDay() -
+                m_elapsedTime;
+        QPoint point;
+        if (replaying) {
+            elapsed = m_replay.frameElapsed();
+            m_firstPressure = m_replay.frameFirstPressure();
+            point = m_replay.frameMouse();
+        }
+        else
+            point = mapFromGlobal(QCursor::pos());
+        bool firstPressure = m_firstPressure;
+
         if (!Wanok::isInConfig || m_menuBar == nullptr) {
 
             // Key press
             if (!m_firstPressure) {
-                double speed = (QTime::currentTime().msecsSinceStartOfDay() -
-                                m_elapsedTime) * 0.04666 *
+                double speed = elapsed * 0.04666 *
                         Wanok::get()->getSquareSize();
 
                 // Multi keys
@@ -175,13 +229,12 @@ void WidgetMapEditor::paintGL(){
             }
 
             // Update control
-            QPoint point = mapFromGlobal(QCursor::pos());
             bool mousePosChanged = m_control.mousePositionChanged(point);
             m_control.updateMousePosition(point);
             m_control.update(layerOn);
+            m_minimap->setCursorSquare(m_control.cursor()->getSquareX(),
+                                       m_control.cursor()->getSquareZ());
             if (m_menuBar != nullptr) {
-                QRect tileset = m_panelTextures->getTilesetTexture();
-                int specialID = m_panelTextures->getID(subKind);
                 m_control.updateWallIndicator();
                 if (mousePosChanged) {
                     m_control.updatePreviewElements(kind, subKind, drawKind,
@@ -228,6 +281,17 @@ void WidgetMapEditor::paintGL(){
 
         // Update elapsed time
         m_elapsedTime = QTime::currentTime().msecsSinceStartOfDay();
+        updateMemoryUsage();
+
+        // Replay timings (waiting for the GPU to finish the frame), or
+        // recording of the frame
+        if (replaying) {
+            glFinish();
+            if (m_replay.endReplayFrame(frameTimer.nsecsElapsed()))
+                finishReplay();
+        }
+        else if (m_replay.isRecording())
+            m_replay.addFrame(elapsed, firstPressure, point);
     }
     else
         p.end();
@@ -271,6 +335,7 @@ void WidgetMapEditor::initializeMap(){
     m_needUpdateMap = false;
     this->setFocus();
     updateSpinBoxes();
+    emit mapLoaded();
 }
 
 // -------------------------------------------------------
@@ -383,14 +448,258 @@ void WidgetMapEditor::showHideSquareInformations() {
 
 // -------------------------------------------------------
 
+void WidgetMapEditor::switchPicking() {
+    makeCurrent();
+    m_control.switchPicking();
+    if (!m_control.checkPicking())
+        emit pickingUnsupported();
+}
+
+// -------------------------------------------------------
+
+void WidgetMapEditor::updateMemoryUsage() {
+    const MapMemoryUsage& usage = m_control.memoryUsage();
+    if (usage.total() == m_memoryUsageShown)
+        return;
+
+    m_memoryUsageShown = usage.total();
+    emit memoryUsageChanged(usage.toString() + ", portions ray: " +
+                            QString::number(m_control.map()->portionsRay()
+                                            - 1));
+}
+
+// -------------------------------------------------------
+
 void WidgetMapEditor::undo() {
+    if (m_replay.isInputIgnored())
+        return;
+    recordInput(MapEditorInputKind::Undo);
     m_control.undo();
+    m_timerMinimap->start();
 }
 
 // -------------------------------------------------------
 
 void WidgetMapEditor::redo() {
+    if (m_replay.isInputIgnored())
+        return;
+    recordInput(MapEditorInputKind::Redo);
     m_control.redo();
+    m_timerMinimap->start();
+}
+
+// -------------------------------------------------------
+
+bool WidgetMapEditor::isRecording() const { return m_replay.isRecording(); }
+
+// -------------------------------------------------------
+
+const MapEditorReplay& WidgetMapEditor::replay() const { return m_replay; }
+
+// -------------------------------------------------------
+//  startRecording: the keys and buttons pressed before are forgotten so that
+//  the replay starts from the same state
+
+bool WidgetMapEditor::startRecording() {
+    if (m_control.map() == nullptr || m_replay.isReplaying())
+        return false;
+
+    Camera* camera = m_control.camera();
+    m_replay.startRecording(m_control.map()->mapProperties()->id(),
+                            m_control.cursor()->getSquareX(),
+                            m_control.cursor()->getSquareZ(),
+                            camera->distance(), camera->horizontalAngle(),
+                            camera->verticalAngle(), size());
+    m_keysPressed.clear();
+    m_mousesPressed.clear();
+
+    return true;
+}
+
+// -------------------------------------------------------
+
+void WidgetMapEditor::stopRecording(const QString& path) {
+    m_replay.stopRecording();
+    if (!path.isEmpty())
+        Wanok::writeJSON(path, m_replay);
+}
+
+// -------------------------------------------------------
+//  startReplay: the message is a warning when the replay can still start
+
+bool WidgetMapEditor::startReplay(const QString& path, QString& message) {
+    if (m_control.map() == nullptr) {
+        message = "Open a map before replaying inputs.";
+        return false;
+    }
+    m_replay.stopRecording();
+    Wanok::readJSON(path, m_replay);
+    if (m_replay.framesCount() == 0) {
+        message = "There is no frame to replay in this file.";
+        return false;
+    }
+    if (m_replay.idMap() != m_control.map()->mapProperties()->id()) {
+        message = "These inputs were recorded on the map " +
+                QString::number(m_replay.idMap()) +
+                ", open it before replaying them.";
+        m_replay.clear();
+        return false;
+    }
+    if (m_replay.size() != size()) {
+        message = "The map editor does not have the same size as when "
+                  "recording, the mouse positions will not match.";
+    }
+
+    // Same cursor and camera as when recording
+    makeCurrent();
+    m_control.teleportCursor(m_replay.cursorX(), m_replay.cursorZ());
+    Camera* camera = m_control.camera();
+    camera->setDistance(m_replay.cameraDistance());
+    camera->setHorizontalAngle(m_replay.cameraHorizontalAngle());
+    camera->setVerticalAngle(m_replay.cameraVerticalAngle());
+    camera->update(m_control.cursor(), m_control.map()->squareSize());
+    updateSpinBoxes();
+    m_keysPressed.clear();
+    m_mousesPressed.clear();
+    m_replayPath = path;
+
+    return m_replay.startReplay();
+}
+
+// -------------------------------------------------------
+//  getSelection: the selection of the menu bar and the textures panel, or
+//  the recorded one when replaying
+
+void WidgetMapEditor::getSelection(MapEditorSelectionKind& kind,
+                                   MapEditorSubSelectionKind& subKind,
+                                   DrawKind& drawKind, bool& layerOn,
+                                   QRect& tileset, int& specialID)
+{
+    const MapEditorInputEvent* selection = m_replay.selection();
+    if (m_replay.isReplaying() && selection != nullptr) {
+        kind = selection->selectionKind();
+        subKind = selection->subSelectionKind();
+        drawKind = selection->drawKind();
+        layerOn = selection->layerOn();
+        tileset = selection->tileset();
+        specialID = selection->specialID();
+        return;
+    }
+
+    kind = m_menuBar->selectionKind();
+    subKind = m_menuBar->subSelectionKind();
+    drawKind = m_menuBar->drawKind();
+    layerOn = m_menuBar->layerOn();
+    tileset = m_panelTextures->getTilesetTexture();
+    specialID = m_panelTextures->getID(subKind);
+    if (m_replay.isRecording()) {
+        m_replay.updateSelection(kind, subKind, drawKind, layerOn, tileset,
+                                 specialID);
+    }
+}
+
+// -------------------------------------------------------
+
+void WidgetMapEditor::recordInput(MapEditorInputKind kind,
+                                  const QInputEvent* event)
+{
+    if (m_replay.isRecording())
+        m_replay.addEvent(new MapEditorInputEvent(kind, event));
+}
+
+// -------------------------------------------------------
+
+void WidgetMapEditor::replayFrame() {
+    m_replay.setDispatching(true);
+    MapEditorInputEvent* event = m_replay.nextFrameEvent();
+    while (event != nullptr) {
+        dispatchInput(event);
+        event = m_replay.nextFrameEvent();
+    }
+    m_replay.setDispatching(false);
+}
+
+// -------------------------------------------------------
+
+void WidgetMapEditor::dispatchInput(const MapEditorInputEvent* event) {
+    switch (event->kind()) {
+    case MapEditorInputKind::MouseMove: {
+        QMouseEvent mouse(QEvent::MouseMove, event->position(),
+                          event->button(), event->buttons(),
+                          event->modifiers());
+        mouseMoveEvent(&mouse);
+        break;
+    }
+    case MapEditorInputKind::MousePress: {
+        QMouseEvent mouse(QEvent::MouseButtonPress, event->position(),
+                          event->button(), event->buttons(),
+                          event->modifiers());
+        mousePressEvent(&mouse);
+        break;
+    }
+    case MapEditorInputKind::MouseRelease: {
+        QMouseEvent mouse(QEvent::MouseButtonRelease, event->position(),
+                          event->button(), event->buttons(),
+                          event->modifiers());
+        mouseReleaseEvent(&mouse);
+        break;
+    }
+    case MapEditorInputKind::MouseDoubleClick: {
+        QMouseEvent mouse(QEvent::MouseButtonDblClick, event->position(),
+                          event->button(), event->buttons(),
+                          event->modifiers());
+        mouseDoubleClickEvent(&mouse);
+        break;
+    }
+    case MapEditorInputKind::Wheel: {
+        QWheelEvent wheel(event->position(), event->delta(), event->buttons(),
+                          event->modifiers());
+        wheelEvent(&wheel);
+        break;
+    }
+    case MapEditorInputKind::KeyPress: {
+        QKeyEvent key(QEvent::KeyPress, event->key(), event->modifiers(),
+                      QString(), event->autoRepeat());
+        keyPressEvent(&key);
+        break;
+    }
+    case MapEditorInputKind::KeyRelease: {
+        QKeyEvent key(QEvent::KeyRelease, event->key(), event->modifiers(),
+                      QString(), event->autoRepeat());
+        keyReleaseEvent(&key);
+        break;
+    }
+    case MapEditorInputKind::Undo:
+        undo();
+        break;
+    case MapEditorInputKind::Redo:
+        redo();
+        break;
+    case MapEditorInputKind::Teleport:
+        onMinimapTeleport(event->position().x(), event->position().y());
+        break;
+    default:
+        break;
+    }
+}
+
+// -------------------------------------------------------
+//  finishReplay: the timings are written next to the replay file
+
+void WidgetMapEditor::finishReplay() {
+    m_keysPressed.clear();
+    m_mousesPressed.clear();
+
+    QJsonObject json;
+    m_replay.writeTimings(json);
+    QFileInfo info(m_replayPath);
+    QString path = Wanok::pathCombine(info.absolutePath(),
+                                      info.completeBaseName() +
+                                      "-timings.json");
+    Wanok::writeOtherJSON(path, json);
+
+    emit replayFinished(m_replay.timingsToString() + "\nTimings written in " +
+                        path);
 }
 
 // -------------------------------------------------------
@@ -400,6 +709,8 @@ void WidgetMapEditor::redo() {
 // -------------------------------------------------------
 
 void WidgetMapEditor::focusOutEvent(QFocusEvent*){
+    if (m_replay.isReplaying())
+        return;
     m_keysPressed.clear();
     m_mousesPressed.clear();
     this->setFocus();
@@ -408,7 +719,10 @@ void WidgetMapEditor::focusOutEvent(QFocusEvent*){
 // -------------------------------------------------------
 
 void WidgetMapEditor::wheelEvent(QWheelEvent* event){
+    if (m_replay.isInputIgnored())
+        return;
     if (m_control.map() != nullptr){
+        recordInput(MapEditorInputKind::Wheel, event);
         m_control.onMouseWheelMove(event);
     }
 }
@@ -416,7 +730,11 @@ void WidgetMapEditor::wheelEvent(QWheelEvent* event){
 // -------------------------------------------------------
 
 void WidgetMapEditor::mouseMoveEvent(QMouseEvent* event){
+    if (m_replay.isInputIgnored())
+        return;
     if (m_control.map() != nullptr){
+        makeCurrent();
+        recordInput(MapEditorInputKind::MouseMove, event);
 
         // Multi keys
         QSet<Qt::MouseButton>::iterator i;
@@ -427,13 +745,15 @@ void WidgetMapEditor::mouseMoveEvent(QMouseEvent* event){
 
             if (m_menuBar != nullptr && button != Qt::MouseButton::MiddleButton)
             {
-                QRect tileset = m_panelTextures->getTilesetTexture();
-                MapEditorSubSelectionKind subSelection =
-                        m_menuBar->subSelectionKind();
-                int specialID = m_panelTextures->getID(subSelection);
-                bool layerOn = m_menuBar->layerOn();
-                m_control.addRemove(m_menuBar->selectionKind(),
-                                    subSelection, m_menuBar->drawKind(),
+                MapEditorSelectionKind selection;
+                MapEditorSubSelectionKind subSelection;
+                DrawKind drawKind;
+                bool layerOn;
+                QRect tileset;
+                int specialID;
+                getSelection(selection, subSelection, drawKind, layerOn,
+                             tileset, specialID);
+                m_control.addRemove(selection, subSelection, drawKind,
                                     layerOn, tileset, specialID);
             }
         }
@@ -443,24 +763,29 @@ void WidgetMapEditor::mouseMoveEvent(QMouseEvent* event){
 // -------------------------------------------------------
 
 void WidgetMapEditor::mousePressEvent(QMouseEvent* event){
+    if (m_replay.isInputIgnored())
+        return;
     this->setFocus();
     if (m_control.map() != nullptr){
+        makeCurrent();
+        recordInput(MapEditorInputKind::MousePress, event);
         Qt::MouseButton button = event->button();
         m_mousesPressed += button;
         if (m_menuBar != nullptr){
-            MapEditorSelectionKind selection = m_menuBar->selectionKind();
-            MapEditorSubSelectionKind subSelection =
-                    m_menuBar->subSelectionKind();
-            DrawKind drawKind = m_menuBar->drawKind();
+            MapEditorSelectionKind selection;
+            MapEditorSubSelectionKind subSelection;
+            DrawKind drawKind;
+            bool layerOn;
+            QRect tileset;
+            int specialID;
+            getSelection(selection, subSelection, drawKind, layerOn, tileset,
+                         specialID);
             QString messageError;
-            bool layerOn = m_menuBar->layerOn();
             if (button == Qt::MouseButton::MiddleButton ||
                 (m_control.isTinPaintPossible(selection, drawKind, messageError)
                 && m_control.isPutLayerPossible(subSelection, drawKind, layerOn,
                                                 messageError)))
             {
-                QRect tileset = m_panelTextures->getTilesetTexture();
-                int specialID = m_panelTextures->getID(subSelection);
                 m_control.onMousePressed(selection, subSelection, drawKind,
                                          layerOn, tileset, specialID,
                                          event->pos(), button);
@@ -485,28 +810,48 @@ void WidgetMapEditor::mousePressEvent(QMouseEvent* event){
 // -------------------------------------------------------
 
 void WidgetMapEditor::mouseReleaseEvent(QMouseEvent* event){
+    if (m_replay.isInputIgnored())
+        return;
     this->setFocus();
     if (m_control.map() != nullptr && m_menuBar != nullptr){
+        recordInput(MapEditorInputKind::MouseRelease, event);
         Qt::MouseButton button = event->button();
         m_mousesPressed -= button;
-        QRect tileset = m_panelTextures->getTilesetTexture();
-        MapEditorSubSelectionKind subSelection =
-                m_menuBar->subSelectionKind();
-        int specialID = m_panelTextures->getID(subSelection);
-        m_control.onMouseReleased(m_menuBar->selectionKind(),
-                                  subSelection, m_menuBar->drawKind(), tileset,
+        MapEditorSelectionKind selection;
+        MapEditorSubSelectionKind subSelection;
+        DrawKind drawKind;
+        bool layerOn;
+        QRect tileset;
+        int specialID;
+        getSelection(selection, subSelection, drawKind, layerOn, tileset,
+                     specialID);
+        m_control.onMouseReleased(selection, subSelection, drawKind, tileset,
                                   specialID, event->pos(), button);
+
+        // The modified portions are saved in temp on the next update
+        m_timerMinimap->start();
     }
 }
 
 // -------------------------------------------------------
 
 void WidgetMapEditor::mouseDoubleClickEvent(QMouseEvent* event){
+    if (m_replay.isInputIgnored())
+        return;
     this->setFocus();
     if (m_control.map() != nullptr){
         if (m_menuBar != nullptr){
+            recordInput(MapEditorInputKind::MouseDoubleClick, event);
             m_mousesPressed += event->button();
-            if (m_menuBar->selectionKind() == MapEditorSelectionKind::Objects)
+            MapEditorSelectionKind selection;
+            MapEditorSubSelectionKind subSelection;
+            DrawKind drawKind;
+            bool layerOn;
+            QRect tileset;
+            int specialID;
+            getSelection(selection, subSelection, drawKind, layerOn, tileset,
+                         specialID);
+            if (selection == MapEditorSelectionKind::Objects)
                 addObject();
         }
     }
@@ -515,7 +860,10 @@ void WidgetMapEditor::mouseDoubleClickEvent(QMouseEvent* event){
 // -------------------------------------------------------
 
 void WidgetMapEditor::keyPressEvent(QKeyEvent* event){
+    if (m_replay.isInputIgnored())
+        return;
     if (m_control.map() != nullptr){
+        recordInput(MapEditorInputKind::KeyPress, event);
         if (m_keysPressed.isEmpty()){
             m_firstPressure = true;
             m_timerFirstPressure->start(35);
@@ -575,7 +923,10 @@ void WidgetMapEditor::keyPressEvent(QKeyEvent* event){
 // -------------------------------------------------------
 
 void WidgetMapEditor::keyReleaseEvent(QKeyEvent* event){
+    if (m_replay.isInputIgnored())
+        return;
     if (m_control.map() != nullptr){
+        recordInput(MapEditorInputKind::KeyRelease, event);
         if (!event->isAutoRepeat()){
             m_keysPressed -= event->key();
             m_control.onKeyReleased(event->key());
@@ -591,6 +942,41 @@ void WidgetMapEditor::onFirstPressure(){
 
 // -------------------------------------------------------
 
+void WidgetMapEditor::onMinimapTeleport(int x, int z) {
+    if (m_replay.isInputIgnored())
+        return;
+    if (m_control.map() != nullptr) {
+        makeCurrent();
+        if (m_replay.isRecording())
+            m_replay.addEvent(new MapEditorInputEvent(x, z));
+        m_control.teleportCursor(x, z);
+        updateSpinBoxes();
+        this->setFocus();
+    }
+}
+
+// -------------------------------------------------------
+
+void WidgetMapEditor::onMinimapRefresh() {
+    if (m_control.map() != nullptr) {
+        Wanok::get()->project()->minimaps()->refresh(
+                    m_control.map()->mapProperties()->id());
+    }
+}
+
+// -------------------------------------------------------
+
+void WidgetMapEditor::onMinimapUpdated(int idMap) {
+    if (m_control.map() != nullptr &&
+        m_control.map()->mapProperties()->id() == idMap)
+    {
+        m_minimap->setImage(Wanok::get()->project()->minimaps()
+                            ->image(idMap));
+    }
+}
+
+// -------------------------------------------------------
+
 void WidgetMapEditor::onKeyPress(int k, double speed){
     m_control.onKeyPressed(k, speed);
     updateSpinBoxes();
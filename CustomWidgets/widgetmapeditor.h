@@ -28,6 +28,8 @@
 #include "widgetmenubarmapeditor.h"
 #include "paneltextures.h"
 #include "controlmapeditor.h"
+#include "widgetminimap.h"
+#include "mapeditorreplay.h"
 
 // -------------------------------------------------------
 //
@@ -78,8 +80,15 @@ public:
                     const QColor& outlineColor = QColor());
     void showHideGrid();
     void showHideSquareInformations();
+    void switchPicking();
     void undo();
     void redo();
+    void updateMemoryUsage();
+    bool isRecording() const;
+    bool startRecording();
+    void stopRecording(const QString& path);
+    bool startReplay(const QString& path, QString& message);
+    const MapEditorReplay& replay() const;
 
 private:
     WidgetMenuBarMapEditor* m_menuBar;
@@ -101,10 +110,33 @@ private:
     double m_cameraVerticalAngle;
     ContextMenuList* m_contextMenu;
     long m_elapsedTime;
+    WidgetMinimap* m_minimap;
+    QTimer* m_timerMinimap;
+    qint64 m_memoryUsageShown;
+    MapEditorReplay m_replay;
+    QString m_replayPath;
+
+    void getSelection(MapEditorSelectionKind& kind,
+                      MapEditorSubSelectionKind& subKind, DrawKind& drawKind,
+                      bool& layerOn, QRect& tileset, int& specialID);
+    void recordInput(MapEditorInputKind kind,
+                     const QInputEvent* event = nullptr);
+    void replayFrame();
+    void dispatchInput(const MapEditorInputEvent* event);
+    void finishReplay();
+
+signals:
+    void memoryUsageChanged(QString text);
+    void mapLoaded();
+    void replayFinished(QString text);
+    void pickingUnsupported();
 
 public slots:
     void update();
     void onFirstPressure();
+    void onMinimapTeleport(int x, int z);
+    void onMinimapRefresh();
+    void onMinimapUpdated(int idMap);
 
 protected slots:
     void focusOutEvent(QFocusEvent*);
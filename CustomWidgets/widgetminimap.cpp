@@ -0,0 +1,104 @@
+/*
+    RPG Paper Maker Copyright (C) 2017 Marie Laporte
+
+    This file is part of RPG Paper Maker.
+
+    RPG Paper Maker is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    RPG Paper Maker is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with Foobar.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include "widgetminimap.h"
+#include <QPainter>
+#include <QMouseEvent>
+
+// -------------------------------------------------------
+//
+//  CONSTRUCTOR / DESTRUCTOR / GET / SET
+//
+// -------------------------------------------------------
+
+WidgetMinimap::WidgetMinimap(QWidget *parent) :
+    QWidget(parent),
+    m_cursorX(0),
+    m_cursorZ(0)
+{
+    setCursor(Qt::PointingHandCursor);
+    setVisible(false);
+}
+
+void WidgetMinimap::setImage(const QImage& image) {
+    m_image = image;
+    setVisible(!m_image.isNull());
+    update();
+}
+
+void WidgetMinimap::setCursorSquare(int x, int z) {
+    if (x != m_cursorX || z != m_cursorZ) {
+        m_cursorX = x;
+        m_cursorZ = z;
+        update();
+    }
+}
+
+// -------------------------------------------------------
+//
+//  INTERMEDIARY FUNCTIONS
+//
+// -------------------------------------------------------
+
+// The image is scaled to fit the widget, keeping its ratio
+
+QRect WidgetMinimap::getImageRect() const {
+    if (m_image.isNull())
+        return QRect();
+
+    QSize size = m_image.size().scaled(this->size(), Qt::KeepAspectRatio);
+
+    return QRect((width() - size.width()) / 2, (height() - size.height()) / 2,
+                 size.width(), size.height());
+}
+
+// -------------------------------------------------------
+//
+//  EVENTS
+//
+// -------------------------------------------------------
+
+void WidgetMinimap::mousePressEvent(QMouseEvent* event) {
+    QRect rect = getImageRect();
+    if (event->button() == Qt::LeftButton && rect.contains(event->pos())) {
+        int x = (event->pos().x() - rect.x()) * m_image.width() /
+                rect.width();
+        int z = (event->pos().y() - rect.y()) * m_image.height() /
+                rect.height();
+        emit teleport(x, z);
+    }
+}
+
+// -------------------------------------------------------
+
+void WidgetMinimap::paintEvent(QPaintEvent*) {
+    QPainter painter(this);
+    QRect rect = getImageRect();
+
+    painter.fillRect(rect, QColor(0, 0, 0, 150));
+    painter.drawImage(rect, m_image);
+
+    // Cursor
+    if (!rect.isEmpty()) {
+        int x = rect.x() + m_cursorX * rect.width() / m_image.width();
+        int y = rect.y() + m_cursorZ * rect.height() / m_image.height();
+        painter.setPen(Qt::red);
+        painter.drawRect(x - 2, y - 2, 4, 4);
+    }
+}
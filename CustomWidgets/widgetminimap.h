@@ -0,0 +1,56 @@
+/*
+    RPG Paper Maker Copyright (C) 2017 Marie Laporte
+
+    This file is part of RPG Paper Maker.
+
+    RPG Paper Maker is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    RPG Paper Maker is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with Foobar.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#ifndef WIDGETMINIMAP_H
+#define WIDGETMINIMAP_H
+
+#include <QWidget>
+#include <QImage>
+
+// -------------------------------------------------------
+//
+//  CLASS WidgetMinimap
+//
+//  A minimap of the current map with the cursor position. Clicking on it
+//  teleports the cursor.
+//
+// -------------------------------------------------------
+
+class WidgetMinimap : public QWidget
+{
+    Q_OBJECT
+public:
+    explicit WidgetMinimap(QWidget *parent = 0);
+    void setImage(const QImage& image);
+    void setCursorSquare(int x, int z);
+
+protected:
+    QImage m_image;
+    int m_cursorX;
+    int m_cursorZ;
+
+    QRect getImageRect() const;
+    virtual void mousePressEvent(QMouseEvent *event);
+    virtual void paintEvent(QPaintEvent *);
+
+signals:
+    void teleport(int x, int z);
+};
+
+#endif // WIDGETMINIMAP_H
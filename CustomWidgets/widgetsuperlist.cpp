@@ -19,7 +19,10 @@
 
 #include "widgetsuperlist.h"
 #include "widgetsupertree.h"
+#include "superlistitemmodel.h"
 #include "wanok.h"
+#include "eventcommand.h"
+#include <QMessageBox>
 
 // -------------------------------------------------------
 //
@@ -31,7 +34,8 @@ WidgetSuperList::WidgetSuperList(QWidget *parent) :
     QListView(parent),
     m_newItemInstance(nullptr),
     m_canBrutRemove(false),
-    m_hasContextMenu(true)
+    m_hasContextMenu(true),
+    m_usageKind(UsageKind::None)
 {
     this->setEditTriggers(QAbstractItemView::NoEditTriggers);
     this->setAcceptDrops(true);
@@ -57,6 +61,8 @@ WidgetSuperList::~WidgetSuperList()
 
 void WidgetSuperList::setCanBrutRemove(bool b) { m_canBrutRemove = b; }
 
+void WidgetSuperList::setUsageKind(UsageKind kind) { m_usageKind = kind; }
+
 void WidgetSuperList::setHasContextMenu(bool b) { m_hasContextMenu = b; }
 
 QStandardItemModel *WidgetSuperList::getModel() const { return p_model; }
@@ -74,6 +80,16 @@ void WidgetSuperList::setName(const QString &s){
 void WidgetSuperList::initializeModel(QStandardItemModel* m){
     p_model = m;
     this->setModel(m);
+
+    // Commands display the names and ids of these items
+    connect(m, SIGNAL(dataChanged(QModelIndex,QModelIndex,QVector<int>)),
+            this, SLOT(updateCommandsStrings()), Qt::UniqueConnection);
+    connect(m, SIGNAL(rowsInserted(QModelIndex,int,int)),
+            this, SLOT(updateCommandsStrings()), Qt::UniqueConnection);
+    connect(m, SIGNAL(rowsRemoved(QModelIndex,int,int)),
+            this, SLOT(updateCommandsStrings()), Qt::UniqueConnection);
+    connect(m, SIGNAL(rowsMoved(QModelIndex,int,int,QModelIndex,int)),
+            this, SLOT(updateCommandsStrings()), Qt::UniqueConnection);
 }
 
 void WidgetSuperList::initializeNewItemInstance(SuperListItem* item){
@@ -108,23 +124,41 @@ int WidgetSuperList::getIndex(){
 void WidgetSuperList::setMaximum(int newSize){
     int previousSize = p_model->invisibleRootItem()->rowCount();
 
-    // Add new empty items
+    // Add new empty items, inserted all at once
     if (newSize > previousSize) {
+        QList<SuperListItem*> supers;
+        supers.reserve(newSize - previousSize);
         for (int i = previousSize; i < newSize; i++){
             SuperListItem* super = m_newItemInstance->createCopy();
             super->setId(i+1);
             super->setDefault();
-            QList<QStandardItem*> row = super->getModelRow();
-            p_model->insertRow(i, row);
+            supers.append(super);
+        }
+        SuperListItemModel* model = qobject_cast<SuperListItemModel*>(p_model);
+        if (model != nullptr)
+            model->appendSuperItems(supers);
+        else {
+            QList<QStandardItem*> items;
+            items.reserve(supers.size());
+            for (int i = 0; i < supers.size(); i++){
+                QList<QStandardItem*> row = supers.at(i)->getModelRow();
+                items.append(row.takeFirst());
+                qDeleteAll(row);
+            }
+            p_model->invisibleRootItem()->insertRows(previousSize, items);
         }
     }
     else {
-        for (int i = previousSize - 1; i >= newSize; i--){
-            SuperListItem* super = (SuperListItem*) p_model->item(i)->data()
-                                   .value<quintptr>();
-            p_model->removeRow(i);
-            delete super;
+        QList<SuperListItem*> supers;
+        supers.reserve(previousSize - newSize);
+        for (int i = newSize; i < previousSize; i++){
+            supers.append((SuperListItem*) p_model->item(i)->data()
+                          .value<quintptr>());
         }
+        if (!canDelete(supers))
+            return;
+        p_model->removeRows(newSize, previousSize - newSize);
+        qDeleteAll(supers);
         emit deleteIDs();
     }
 
@@ -146,12 +180,56 @@ void WidgetSuperList::addNewItem(SuperListItem* super){
     emit updated();
 }
 
+// -------------------------------------------------------
+//  getUsages: the locations in maps and common events of the items ids, an
+//  empty string if they are not used
+
+QString WidgetSuperList::getUsages(const QList<SuperListItem*>& supers) const
+{
+    const int maxDisplayed = 10;
+    QStringList locations;
+    if (m_usageKind == UsageKind::None || Wanok::get()->project() == nullptr)
+        return "";
+
+    ProjectUsages* usages = Wanok::get()->project()->usages();
+    for (int i = 0; i < supers.size(); i++) {
+        SuperListItem* super = supers.at(i);
+        QStringList superLocations = usages->findUsages(m_usageKind,
+                                                        super->id());
+        for (int j = 0; j < superLocations.size(); j++)
+            locations << super->toString() + ": " + superLocations.at(j);
+    }
+    if (locations.size() > maxDisplayed) {
+        locations = locations.mid(0, maxDisplayed);
+        locations << "...";
+    }
+
+    return locations.join("\n");
+}
+
+// -------------------------------------------------------
+//  canDelete: if the items ids are still used in maps or common events, ask
+//  before deleting them
+
+bool WidgetSuperList::canDelete(const QList<SuperListItem*>& supers){
+    QString locations = getUsages(supers);
+    if (locations.isEmpty())
+        return true;
+
+    return QMessageBox::question(this, "Warning", "Still used in:\n" +
+                                 locations + "\n\nDo you still want to "
+                                 "delete " + (supers.size() > 1 ? "them?"
+                                                                : "it?"),
+                                 QMessageBox::Yes | QMessageBox::No)
+            == QMessageBox::Yes;
+}
+
 // -------------------------------------------------------
 
 void WidgetSuperList::brutDelete(QStandardItem* item){
     SuperListItem* super = (SuperListItem*) item->data().value<qintptr>();
 
-    if (super->id() != -1){
+    if (super->id() != -1 && canDelete(QList<SuperListItem*>() << super)){
         delete ((SuperListItem*) item->data().value<qintptr>());
         p_model->removeRow(item->row());
 
@@ -213,6 +291,7 @@ void WidgetSuperList::showContextMenu(const QPoint & p){
             m_contextMenu->canCopy(false);
             m_contextMenu->canPaste(false);
             m_contextMenu->canDelete(m_canBrutRemove);
+            m_contextMenu->canFindUsages(m_usageKind != UsageKind::None);
             m_contextMenu->showContextMenu(p);
         }
     }
@@ -239,3 +318,24 @@ void WidgetSuperList::contextDelete(){
             brutDelete(selected);
     }
 }
+
+// -------------------------------------------------------
+
+void WidgetSuperList::contextFindUsages(){
+    QStandardItem* selected = getSelected();
+    if (selected != nullptr){
+        SuperListItem* super = (SuperListItem*)(selected->data()
+                                                .value<quintptr>());
+        QString locations = getUsages(QList<SuperListItem*>() << super);
+        QMessageBox::information(this, "Usages", locations.isEmpty()
+                                 ? super->toString() + " is not used in maps "
+                                   "or common events."
+                                 : "Used in:\n" + locations);
+    }
+}
+
+// -------------------------------------------------------
+
+void WidgetSuperList::updateCommandsStrings(){
+    EventCommand::invalidateStrings();
+}
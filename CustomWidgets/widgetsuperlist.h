@@ -25,6 +25,7 @@
 #include <QStandardItemModel>
 #include "superlistitem.h"
 #include "contextmenulist.h"
+#include "usagekind.h"
 
 // -------------------------------------------------------
 //
@@ -42,6 +43,7 @@ public:
     virtual ~WidgetSuperList();
     void setCanBrutRemove(bool b);
     void setHasContextMenu(bool b);
+    void setUsageKind(UsageKind kind);
     void initializeModel(QStandardItemModel* m);
     void initializeNewItemInstance(SuperListItem *item);
     QStandardItemModel* getModel() const;
@@ -61,7 +63,10 @@ private:
     ContextMenuList* m_contextMenu;
     bool m_canBrutRemove;
     bool m_hasContextMenu;
+    UsageKind m_usageKind;
 
+    QString getUsages(const QList<SuperListItem*>& supers) const;
+    bool canDelete(const QList<SuperListItem*>& supers);
     void brutDelete(QStandardItem* item);
 
 private slots:
@@ -70,6 +75,8 @@ private slots:
     void contextCopy();
     void contextPaste();
     void contextDelete();
+    void contextFindUsages();
+    void updateCommandsStrings();
 
 signals:
     void updated();
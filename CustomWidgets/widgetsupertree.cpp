@@ -19,7 +19,9 @@
 
 #include "widgetsupertree.h"
 #include "superlistitem.h"
+#include "superlistitemmodel.h"
 #include "wanok.h"
+#include "eventcommand.h"
 
 // -------------------------------------------------------
 //
@@ -72,6 +74,16 @@ void WidgetSuperTree::setCanMove(bool b) { m_canMove = b; }
 void WidgetSuperTree::initializeModel(QStandardItemModel* m){
     p_model = m;
     this->setModel(m);
+
+    // Commands display the names and ids of these items
+    connect(m, SIGNAL(dataChanged(QModelIndex,QModelIndex,QVector<int>)),
+            this, SLOT(updateCommandsStrings()), Qt::UniqueConnection);
+    connect(m, SIGNAL(rowsInserted(QModelIndex,int,int)),
+            this, SLOT(updateCommandsStrings()), Qt::UniqueConnection);
+    connect(m, SIGNAL(rowsRemoved(QModelIndex,int,int)),
+            this, SLOT(updateCommandsStrings()), Qt::UniqueConnection);
+    connect(m, SIGNAL(rowsMoved(QModelIndex,int,int,QModelIndex,int)),
+            this, SLOT(updateCommandsStrings()), Qt::UniqueConnection);
 }
 
 void WidgetSuperTree::initializeNewItemInstance(SuperListItem* item){
@@ -196,20 +208,22 @@ void WidgetSuperTree::updateAllNodesString(QStandardItem *item){
 // -------------------------------------------------------
 
 int WidgetSuperTree::getNewId(QStandardItemModel *model, int offset){
-    int id;
-    for (id = 1; id < model->invisibleRootItem()->rowCount(); id++){
-        bool test = false;
-        int length = model->invisibleRootItem()->rowCount() - offset;
-        for (int j = 0; j < length; j++){
-            SuperListItem* super = (SuperListItem*) model->item(j)->data()
-                                   .value<quintptr>();
-            if (id == super->id()){
-                test = true;
-                break;
-            }
-        }
-        if (!test) break;
+    SuperListItemModel* indexedModel = qobject_cast<SuperListItemModel*>(model);
+    if (indexedModel != nullptr)
+        return indexedModel->getNewId();
+
+    // Mark the used ids in only one pass, the first free one is the new id
+    int length = model->invisibleRootItem()->rowCount() - offset;
+    QVector<bool> used(length + 2, false);
+    for (int j = 0; j < length; j++){
+        SuperListItem* super = (SuperListItem*) model->item(j)->data()
+                               .value<quintptr>();
+        if (super != nullptr && super->id() > 0 && super->id() < used.size())
+            used[super->id()] = true;
     }
+    int id = 1;
+    while (used.at(id))
+        id++;
 
     return id;
 }
@@ -424,3 +438,9 @@ void WidgetSuperTree::write(QStandardItemModel *model, QJsonArray &json){
         json.append(obj);
     }
 }
+
+// -------------------------------------------------------
+
+void WidgetSuperTree::updateCommandsStrings(){
+    EventCommand::invalidateStrings();
+}
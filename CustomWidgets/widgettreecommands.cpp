@@ -20,6 +20,7 @@
 #include "widgettreecommands.h"
 #include "dialogcommands.h"
 #include "eventcommand.h"
+#include "eventcommandsmodel.h"
 #include "wanok.h"
 #include "systemcommonreaction.h"
 #include <QDebug>
@@ -74,8 +75,12 @@ void WidgetTreeCommands::initializeModel(QStandardItemModel* m){
     this->setModel(p_model);
     this->expandAll();
 
-    // Update text in nodes
-    updateAllNodesString(p_model->invisibleRootItem());
+    // Update text in nodes: a commands model only generates the text of the
+    // lines that are painted
+    EventCommandsModel* model = qobject_cast<EventCommandsModel*>(m);
+    if (model != nullptr)
+        model->setContext(m_linkedObject, m_parameters);
+    this->viewport()->update();
 }
 
 // -------------------------------------------------------
@@ -183,9 +188,6 @@ void WidgetTreeCommands::newCommand(QStandardItem* selected){
         default:
             break;
         }
-
-        // Update text in nodes
-        updateAllNodesString(p_model->invisibleRootItem());
     }
 }
 
@@ -235,7 +237,7 @@ void WidgetTreeCommands::editCommand(QStandardItem *selected,
             delete command;
             selected->setData(QVariant::fromValue(
                                   reinterpret_cast<quintptr>(newCommand)));
-            updateAllNodesString(p_model->invisibleRootItem());
+            updateNodeString(selected);
         }
         delete dialog;
     }
@@ -275,19 +277,21 @@ void WidgetTreeCommands::copyCommand(){
 //  pasteCommand: paste the copied command in the selected command
 
 void WidgetTreeCommands::pasteCommand(QStandardItem* selected){
-    QStandardItem* copiedCommand;
     QStandardItem* root = getRootOfCommand(selected);
+    QList<QStandardItem*> copies;
     QStandardItem* copy;
 
-    // Paste copy and fill a new list of copies
+    // Fill a new list of copies and paste them all at once
+    copies.reserve(m_copiedCommands.size());
     for (int i = 0; i < m_copiedCommands.size(); i++){
-        copiedCommand = m_copiedCommands.at(i);
         copy = new QStandardItem;
-        SystemCommonReaction::copyCommandsItem(copiedCommand, copy);
-        root->insertRow(selected->row(), copy);
-        expand(copy->index());
-        updateAllNodesString(copy);
+        SystemCommonReaction::copyCommandsItem(m_copiedCommands.at(i), copy);
+        copies.append(copy);
     }
+    root->insertRows(selected->row(), copies);
+
+    for (int i = 0; i < copies.size(); i++)
+        expand(copies.at(i)->index());
 }
 
 // -------------------------------------------------------
@@ -296,20 +300,31 @@ void WidgetTreeCommands::deleteCommand(){
     QList<QStandardItem*> list = getAllSelected();
     QStandardItem* selected;
     EventCommand* command;
-    QStandardItem* root;
+    QStandardItem* root = nullptr;
+    int first = -1, count = 0, row;
 
-    for (int i = 0; i < list.size(); i++){
+    // Selected commands all have the same root and are sorted: removing
+    // contiguous rows together, from the last ones
+    for (int i = list.size() - 1; i >= 0; i--){
         selected = list.at(i);
         command = (EventCommand*) selected->data().value<quintptr>();
 
         if (command != nullptr && command->kind() != EventCommandKind::None){
             root = getRootOfCommand(selected);
+            row = selected->row();
+            if (count > 0 && row != first - 1){
+                root->removeRows(first, count);
+                count = 0;
+            }
 
             // Delete selected command
             SystemCommonReaction::deleteCommands(selected);
-            root->removeRow(selected->row());
+            first = row;
+            count++;
         }
     }
+    if (count > 0)
+        root->removeRows(first, count);
 }
 
 // -------------------------------------------------------
@@ -341,7 +356,6 @@ QStandardItem* WidgetTreeCommands::insertCommand(EventCommand* command,
 {
     QStandardItem* item = new QStandardItem();
     item->setData(QVariant::fromValue(reinterpret_cast<quintptr>(command)));
-    item->setText(command->toString(m_linkedObject, m_parameters));
     root->insertRow(pos, item);
 
     return item;
@@ -415,28 +429,26 @@ void WidgetTreeCommands::deleteStartBattleBlock(QStandardItem *root, int row){
 }
 
 // -------------------------------------------------------
+//  updateNodeString: the commands model generates the text, only notify the
+//  views that this line changed
 
-void WidgetTreeCommands::updateAllNodesString(QStandardItem *item){
-    for (int i = 0; i < item->rowCount(); i++){
-        updateAllNodesString(item->child(i));
-        EventCommand* command = (EventCommand*) item->child(i)->data()
-                                .value<quintptr>();
-        item->child(i)->setText(command->toString(m_linkedObject,
-                                                  m_parameters));
-    }
+void WidgetTreeCommands::updateNodeString(QStandardItem *item){
+    QModelIndex index = item->index();
+    emit p_model->dataChanged(index, index);
 }
 
 // -------------------------------------------------------
 
-void WidgetTreeCommands::selectChildren(QStandardItem* item){
+void WidgetTreeCommands::selectChildren(QStandardItem* item,
+                                        QItemSelection& selection)
+{
 
     // Select children
-    selectChildrenOnly(item);
+    selectChildrenOnly(item, selection);
 
     // Select others (end etc.)
     EventCommand* command = (EventCommand*) item->data().value<quintptr>();
     QStandardItem* root = getRootOfCommand(item);
-    QItemSelectionModel* sm = this->selectionModel();
     QStandardItem* st;
     int j = item->row();
 
@@ -444,34 +456,34 @@ void WidgetTreeCommands::selectChildren(QStandardItem* item){
         switch(command->kind()){
         case EventCommandKind::While:
             st = root->child(j+1);
-            sm->select(st->index(), QItemSelectionModel::Select);
+            selection.select(st->index(), st->index());
             break;
         case EventCommandKind::EndWhile:
             st = root->child(j-1);
-            sm->select(st->index(), QItemSelectionModel::Select);
-            selectChildrenOnly(st);
+            selection.select(st->index(), st->index());
+            selectChildrenOnly(st, selection);
             break;
         case EventCommandKind::StartBattle:
             if (command->isBattleWithoutGameOver()){
                 st = root->child(j+1);
-                sm->select(st->index(), QItemSelectionModel::Select);
-                selectChildrenOnly(st);
+                selection.select(st->index(), st->index());
+                selectChildrenOnly(st, selection);
                 st = root->child(j+2);
-                sm->select(st->index(), QItemSelectionModel::Select);
-                selectChildrenOnly(st);
+                selection.select(st->index(), st->index());
+                selectChildrenOnly(st, selection);
                 st = root->child(j+3);
-                sm->select(st->index(), QItemSelectionModel::Select);
+                selection.select(st->index(), st->index());
             }
             break;
         case EventCommandKind::IfWin:
             st = root->child(j-1);
-            sm->select(st->index(), QItemSelectionModel::Select);
-            selectChildren(st);
+            selection.select(st->index(), st->index());
+            selectChildren(st, selection);
             break;
         case EventCommandKind::IfLose:
             st = root->child(j-2);
-            sm->select(st->index(), QItemSelectionModel::Select);
-            selectChildren(st);
+            selection.select(st->index(), st->index());
+            selectChildren(st, selection);
             break;
         case EventCommandKind::EndIf:
             st = root->child(j-1);
@@ -480,15 +492,15 @@ void WidgetTreeCommands::selectChildren(QStandardItem* item){
             // Battle
             if (command->kind() == EventCommandKind::IfLose){
                 st = root->child(j-3);
-                sm->select(st->index(), QItemSelectionModel::Select);
-                selectChildren(st);
+                selection.select(st->index(), st->index());
+                selectChildren(st, selection);
             }
             // Condition
             else{
                 if (command->kind() == EventCommandKind::Else)
                     st = root->child(j-2);
-                sm->select(st->index(), QItemSelectionModel::Select);
-                selectChildren(st);
+                selection.select(st->index(), st->index());
+                selectChildren(st, selection);
             }
             break;
         case EventCommandKind::If:
@@ -498,18 +510,18 @@ void WidgetTreeCommands::selectChildren(QStandardItem* item){
             // Else
             if (command->hasElse()){
                 st = root->child(j++);
-                sm->select(st->index(), QItemSelectionModel::Select);
-                selectChildrenOnly(st);
+                selection.select(st->index(), st->index());
+                selectChildrenOnly(st, selection);
             }
 
             // End
             st = root->child(j);
-            sm->select(st->index(), QItemSelectionModel::Select);
+            selection.select(st->index(), st->index());
             break;
         case EventCommandKind::Else:
             st = root->child(j-1);
-            sm->select(st->index(), QItemSelectionModel::Select);
-            selectChildren(st);
+            selection.select(st->index(), st->index());
+            selectChildren(st, selection);
             break;
         default:
             break;
@@ -519,14 +531,19 @@ void WidgetTreeCommands::selectChildren(QStandardItem* item){
 
 // -------------------------------------------------------
 
-void WidgetTreeCommands::selectChildrenOnly(QStandardItem* item){
-    QModelIndex index = item->index();
-
-    // Select children
-    for (int i = 0; i < item->rowCount(); i++){
-        QModelIndex childIndex = p_model->index(i, 0, index);
-        this->selectionModel()->select(childIndex, QItemSelectionModel::Select);
-        selectChildren(item->child(i));
+void WidgetTreeCommands::selectChildrenOnly(QStandardItem* item,
+                                            QItemSelection& selection)
+{
+    int l = item->rowCount();
+    if (l == 0)
+        return;
+
+    // Select children as one range, and their own children
+    selection.select(item->child(0)->index(), item->child(l - 1)->index());
+    for (int i = 0; i < l; i++){
+        QStandardItem* child = item->child(i);
+        if (child->hasChildren())
+            selectChildrenOnly(child, selection);
     }
 }
 
@@ -586,9 +603,13 @@ void WidgetTreeCommands::mouseDoubleClickEvent(QMouseEvent* event){
 
 void WidgetTreeCommands::onTreeViewClicked(const QModelIndex &){
     QModelIndexList l = this->selectionModel()->selectedIndexes();
+    QItemSelection selection;
 
     for (int i = 0; i < l.size(); i++)
-        selectChildren(p_model->itemFromIndex(l.at(i)));
+        selectChildren(p_model->itemFromIndex(l.at(i)), selection);
+
+    // Only one selection update
+    this->selectionModel()->select(selection, QItemSelectionModel::Select);
 }
 
 // -------------------------------------------------------
@@ -23,6 +23,7 @@
 #include <QTreeView>
 #include <QMouseEvent>
 #include <QStandardItemModel>
+#include <QItemSelection>
 #include "gamedatas.h"
 #include "contextmenulist.h"
 #include "eventcommand.h"
@@ -75,9 +76,9 @@ protected:
     void deleteEndBlock(QStandardItem *root, int row);
     void deleteElseBlock(QStandardItem *root, int row);
     void deleteStartBattleBlock(QStandardItem *root, int row);
-    void updateAllNodesString(QStandardItem* item);
-    void selectChildren(QStandardItem* item);
-    void selectChildrenOnly(QStandardItem* item);
+    void updateNodeString(QStandardItem* item);
+    void selectChildren(QStandardItem* item, QItemSelection& selection);
+    void selectChildrenOnly(QStandardItem* item, QItemSelection& selection);
     static bool itemLessThan(const QStandardItem* item1,
                              const QStandardItem* item2);
 
@@ -24,6 +24,9 @@
 #include "treemapdatas.h"
 #include <QDir>
 #include <QMessageBox>
+#include <QHelpEvent>
+#include <QToolTip>
+#include <QUrl>
 
 // -------------------------------------------------------
 //
@@ -111,8 +114,12 @@ QStandardItemModel* WidgetTreeLocalMaps::getModel() const { return m_model; }
 
 void WidgetTreeLocalMaps::updateNodeSaved(QStandardItem* item){
     TreeMapTag* tag = (TreeMapTag*) item->data().value<quintptr>();
-    if (tag != nullptr)
-        item->setText(tag->name());
+    if (tag != nullptr) {
+        if (!tag->isDir() && Wanok::mapsToSave.contains(tag->id()))
+            item->setText(tag->name() + " *");
+        else
+            item->setText(tag->name());
+    }
 }
 
 // -------------------------------------------------------
@@ -362,6 +369,49 @@ void WidgetTreeLocalMaps::paste(QStandardItem* item){
     Wanok::get()->project()->writeTreeMapDatas();
 }
 
+// -------------------------------------------------------
+//
+//  EVENTS
+//
+// -------------------------------------------------------
+
+// The map tooltip shows the cached minimap, which is refreshed in background
+// for the next time
+
+bool WidgetTreeLocalMaps::viewportEvent(QEvent* event) {
+    if (event->type() == QEvent::ToolTip && m_project != nullptr) {
+        QHelpEvent* helpEvent = static_cast<QHelpEvent*>(event);
+        QStandardItem* item = m_model->itemFromIndex(
+                    indexAt(helpEvent->pos()));
+        TreeMapTag* tag = item == nullptr ? nullptr
+                                          : (TreeMapTag*) item->data()
+                                            .value<quintptr>();
+        if (tag == nullptr || tag->isDir()) {
+            QToolTip::hideText();
+            event->ignore();
+            return true;
+        }
+
+        ProjectMinimaps* minimaps = m_project->minimaps();
+        QImage image = minimaps->image(tag->id());
+        QString text = "<b>" + tag->name().toHtmlEscaped() + "</b>";
+        if (!image.isNull()) {
+            QSize size = image.size().scaled(200, 200, Qt::KeepAspectRatio);
+            text += QString("<br><img src=\"%1\" width=\"%2\" "
+                            "height=\"%3\">")
+                    .arg(QUrl::fromLocalFile(minimaps->getPathImage(tag->id()))
+                         .toString())
+                    .arg(size.width()).arg(size.height());
+        }
+        QToolTip::showText(helpEvent->globalPos(), text, this);
+        minimaps->refresh(tag->id());
+
+        return true;
+    }
+
+    return QTreeView::viewportEvent(event);
+}
+
 // -------------------------------------------------------
 //
 //  CONTEXT MENU SLOTS
@@ -457,6 +507,7 @@ void WidgetTreeLocalMaps::contextEditMap(){
                 Wanok::copyAllFiles(pathTemp, path);
                 Wanok::deleteAllFiles(pathTemp);
                 Wanok::mapsToSave.remove(properties.id());
+                Wanok::get()->project()->usages()->refreshMap(path);
             }
             properties.save(path);
             tag->reset();
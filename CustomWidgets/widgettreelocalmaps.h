@@ -80,6 +80,9 @@ private:
     QStandardItem* getMap(int id, QStandardItem* item);
     void updateTileset();
 
+protected:
+    virtual bool viewportEvent(QEvent* event);
+
 public slots:
     void on_selectionChanged(QModelIndex, QModelIndex);
     void showContextMenu(const QPoint & p);
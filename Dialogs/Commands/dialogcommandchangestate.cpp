@@ -72,7 +72,7 @@ void DialogCommandChangeState::initialize(EventCommand* command){
     int i = 0;
 
     ui->widgetStateId->initializeCommand(command,i);
-    int action = command->valueCommandAt(i++).toInt();
+    int action = command->intValueCommandAt(i++);
     switch(action){
     case 0:
         ui->radioButtonReplace->setChecked(true); break;
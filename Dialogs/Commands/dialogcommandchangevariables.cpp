@@ -54,7 +54,7 @@ void DialogCommandChangeVariables::initialize(EventCommand* command){
     int i = 0;
 
     // Selection
-    switch(command->valueCommandAt(i++).toInt()){
+    switch(command->intValueCommandAt(i++)){
     case 0:
         ui->radioButtonOneVariable->setChecked(true);
         ui->widgetVariableOne->setCurrentId(command->valueCommandAt(i++)
@@ -62,13 +62,13 @@ void DialogCommandChangeVariables::initialize(EventCommand* command){
         break;
     case 1:
         ui->radioButtonRange->setChecked(true);
-        ui->spinBoxRange1->setValue(command->valueCommandAt(i++).toInt());
-        ui->spinBoxRange2->setValue(command->valueCommandAt(i++).toInt());
+        ui->spinBoxRange1->setValue(command->intValueCommandAt(i++));
+        ui->spinBoxRange2->setValue(command->intValueCommandAt(i++));
         break;
     }
 
     // Operation
-    switch (command->valueCommandAt(i++).toInt()) {
+    switch (command->intValueCommandAt(i++)) {
     case 0: ui->radioButtonEquals->setChecked(true); break;
     case 1: ui->radioButtonPlus->setChecked(true); break;
     case 2: ui->radioButtonMinus->setChecked(true); break;
@@ -78,11 +78,11 @@ void DialogCommandChangeVariables::initialize(EventCommand* command){
     }
 
     // Value
-    switch(command->valueCommandAt(i++).toInt()){
+    switch(command->intValueCommandAt(i++)){
     case 0:
         ui->radioButtonRandom->setChecked(true);
-        ui->spinBoxRandom1->setValue(command->valueCommandAt(i++).toInt());
-        ui->spinBoxRandom2->setValue(command->valueCommandAt(i++).toInt());
+        ui->spinBoxRandom1->setValue(command->intValueCommandAt(i++));
+        ui->spinBoxRandom2->setValue(command->intValueCommandAt(i++));
         break;
     }
 }
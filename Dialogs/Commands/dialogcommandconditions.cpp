@@ -56,7 +56,7 @@ DialogCommandConditions::~DialogCommandConditions()
 void DialogCommandConditions::initialize(EventCommand* command){
     int i = 0;
     ui->checkBox->setChecked(command->valueCommandAt(i++) == "1");
-    ui->tabWidget->setCurrentIndex(command->valueCommandAt(i++).toInt());
+    ui->tabWidget->setCurrentIndex(command->intValueCommandAt(i++));
     ui->widgetVariableVariable->setCurrentId(command->valueCommandAt(i++)
                                              .toInt());
     ui->widgetVariableOperation->setCurrentIndex(command
@@ -50,7 +50,7 @@ DialogCommandInputNumber::~DialogCommandInputNumber()
 // -------------------------------------------------------
 
 void DialogCommandInputNumber::initialize(EventCommand* command){
-    ui->widgetVariable->setCurrentId(command->valueCommandAt(0).toInt());
+    ui->widgetVariable->setCurrentId(command->intValueCommandAt(0));
 }
 
 // -------------------------------------------------------
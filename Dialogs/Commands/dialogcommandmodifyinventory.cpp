@@ -64,8 +64,8 @@ void DialogCommandModifyInventory::initialize(EventCommand* command){
     int i = 0;
 
     // Selection
-    int type = command->valueCommandAt(i++).toInt();
-    int id = command->valueCommandAt(i++).toInt();
+    int type = command->intValueCommandAt(i++);
+    int id = command->intValueCommandAt(i++);
     QStandardItem* item;
     switch(type){
     case 0:
@@ -92,7 +92,7 @@ void DialogCommandModifyInventory::initialize(EventCommand* command){
     }
 
     // Operation
-    switch(command->valueCommandAt(i++).toInt()){
+    switch(command->intValueCommandAt(i++)){
     case 0: ui->radioButtonEquals->setChecked(true); break;
     case 1: ui->radioButtonPlus->setChecked(true); break;
     case 2: ui->radioButtonMinus->setChecked(true); break;
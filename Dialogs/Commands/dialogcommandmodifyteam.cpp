@@ -57,23 +57,23 @@ DialogCommandModifyTeam::~DialogCommandModifyTeam()
 void DialogCommandModifyTeam::initialize(EventCommand* command){
     int i = 0;
 
-    int type = command->valueCommandAt(i++).toInt();
+    int type = command->intValueCommandAt(i++);
     int typeCharacter;
     switch(type){
     case 0:
         ui->radioButtonNewInstance->setChecked(true);
-        ui->spinBoxLevel->setValue(command->valueCommandAt(i++).toInt());
+        ui->spinBoxLevel->setValue(command->intValueCommandAt(i++));
         ui->comboBoxInstanceTeam->setCurrentIndex(command->valueCommandAt(i++)
                                                   .toInt());
         ui->widgetVariableStock->setCurrentId(command->valueCommandAt(i++)
                                               .toInt());
-        typeCharacter = command->valueCommandAt(i++).toInt();
+        typeCharacter = command->intValueCommandAt(i++);
         if (typeCharacter == 0){
             ui->radioButtonHero->setChecked(true);
             ui->comboBoxHero->setCurrentIndex(SuperListItem::getIndexById(
                     Wanok::get()->project()->gameDatas()->heroesDatas()
                     ->model()->invisibleRootItem(),
-                    command->valueCommandAt(i++).toInt()));
+                    command->intValueCommandAt(i++)));
         }
         else if (typeCharacter == 1){
             ui->radioButtonMonster->setChecked(true);
@@ -77,7 +77,7 @@ void DialogCommandMoveCamera::initialize(EventCommand* command) {
     int i = 0;
 
     // Target
-    int targetKind = command->valueCommandAt(i++).toInt();
+    int targetKind = command->intValueCommandAt(i++);
     switch (targetKind) {
     case 0:
         ui->radioButtonTargetUnchanged->setChecked(true);
@@ -89,7 +89,7 @@ void DialogCommandMoveCamera::initialize(EventCommand* command) {
     }
 
     // Operations
-    switch (command->valueCommandAt(i++).toInt()) {
+    switch (command->intValueCommandAt(i++)) {
     case 0: ui->radioButtonEquals->setChecked(true); break;
     case 1: ui->radioButtonPlus->setChecked(true); break;
     case 2: ui->radioButtonMinus->setChecked(true); break;
@@ -104,11 +104,11 @@ void DialogCommandMoveCamera::initialize(EventCommand* command) {
     ui->checkBoxCameraOrientation->setChecked(command->valueCommandAt(i++)
                                               == "1");
     ui->widgetNumberX->initializeCommand(command, i);
-    ui->comboBoxX->setCurrentIndex(command->valueCommandAt(i++).toInt());
+    ui->comboBoxX->setCurrentIndex(command->intValueCommandAt(i++));
     ui->widgetNumberY->initializeCommand(command, i);
-    ui->comboBoxY->setCurrentIndex(command->valueCommandAt(i++).toInt());
+    ui->comboBoxY->setCurrentIndex(command->intValueCommandAt(i++));
     ui->widgetNumberZ->initializeCommand(command, i);
-    ui->comboBoxZ->setCurrentIndex(command->valueCommandAt(i++).toInt());
+    ui->comboBoxZ->setCurrentIndex(command->intValueCommandAt(i++));
 
     // Rotation
     ui->checkBoxtargetOffsetRotation->setChecked(
@@ -66,18 +66,18 @@ DialogCommandSendEvent::~DialogCommandSendEvent()
 void DialogCommandSendEvent::initialize(EventCommand* command){
     int i = 0;
 
-    int target = command->valueCommandAt(i++).toInt();
+    int target = command->intValueCommandAt(i++);
     switch(target){
     case 0:
         ui->radioButtonAll->setChecked(true);
         break;
     case 1:
         ui->radioButtonDetection->setChecked(true);
-        command->valueCommandAt(i++).toInt();
+        command->intValueCommandAt(i++);
         break;
     case 2:
         ui->radioButtonObject->setChecked(true);
-        command->valueCommandAt(i++).toInt();
+        command->intValueCommandAt(i++);
         break;
     case 3:
         ui->radioButtonSender->setChecked(true);
@@ -63,7 +63,7 @@ void DialogCommandStartBattle::initialize(EventCommand* command){
     ui->checkBoxGameOver->setChecked(command->valueCommandAt(i++) == "1");
 
     // Troop's ID
-    int type = command->valueCommandAt(i++).toInt();
+    int type = command->intValueCommandAt(i++);
     switch(type){
     case 0:
         ui->radioButtonDB->setChecked(true);
@@ -71,7 +71,7 @@ void DialogCommandStartBattle::initialize(EventCommand* command){
                     SuperListItem::getIndexById(
                         Wanok::get()->project()->gameDatas()->troopsDatas()
                         ->model()->invisibleRootItem(),
-                        command->valueCommandAt(i++).toInt()));
+                        command->intValueCommandAt(i++)));
         break;
     case 1:
         ui->radioButtonVariableConstant->setChecked(true);
@@ -83,7 +83,7 @@ void DialogCommandTeleportObject::initialize(EventCommand* command){
     ui->widgetObjectID->initializeCommand(command, i);
 
     // Position
-    switch (command->valueCommandAt(i++).toInt()){
+    switch (command->intValueCommandAt(i++)){
     case 0:
         ui->radioButtonSelect->setChecked(true);
         ui->labelIDMap->setText(command->valueCommandAt(i++));
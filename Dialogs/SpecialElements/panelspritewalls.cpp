@@ -57,6 +57,7 @@ PanelSuperList *PanelSpriteWalls::superList() const {
 
 void PanelSpriteWalls::initialize() {
     ui->panelSuperList->list()->initializeNewItemInstance(new SystemSpriteWall);
+    ui->panelSuperList->list()->setUsageKind(UsageKind::SpriteWall);
     ui->panelSuperList->initializeModel(Wanok::get()->project()
                                         ->specialElementsDatas()
                                         ->modelSpriteWalls());
@@ -65,6 +65,7 @@ DialogDatas::~DialogDatas()
 
 void DialogDatas::initializeItems(GameDatas *gameDatas){
     ui->panelSuperListItems->list()->initializeNewItemInstance(new SystemItem);
+    ui->panelSuperListItems->list()->setUsageKind(UsageKind::Item);
     ui->panelSuperListItems->initializeModel(gameDatas->itemsDatas()->model());
     connect(ui->panelSuperListItems->list()->selectionModel(),
             SIGNAL(currentChanged(QModelIndex,QModelIndex)), this,
@@ -102,6 +103,7 @@ void DialogDatas::initializeSkills(GameDatas *gameDatas){
 void DialogDatas::initializeWeapons(GameDatas *gameDatas){
     ui->panelSuperListWeapons->list()->initializeNewItemInstance(
                 new SystemWeapon);
+    ui->panelSuperListWeapons->list()->setUsageKind(UsageKind::Weapon);
     ui->panelSuperListWeapons->initializeModel(gameDatas->weaponsDatas()
                                                ->model());
     connect(ui->panelSuperListWeapons->list()->selectionModel(),
@@ -131,6 +133,7 @@ void DialogDatas::updateWeapon(SystemWeapon *sysWeapon){
 void DialogDatas::initializeArmors(GameDatas *gameDatas){
     ui->panelSuperListArmors->list()->initializeNewItemInstance(
                 new SystemArmor);
+    ui->panelSuperListArmors->list()->setUsageKind(UsageKind::Armor);
     ui->panelSuperListArmors->initializeModel(gameDatas->armorsDatas()
                                               ->model());
     connect(ui->panelSuperListArmors->list()->selectionModel(),
@@ -160,6 +163,7 @@ void DialogDatas::updateArmor(SystemArmor *sysArmor){
 void DialogDatas::initializeHeroes(GameDatas *gameDatas){
     ui->panelSuperListHeroes->list()->initializeNewItemInstance(
                 new SystemHero);
+    ui->panelSuperListHeroes->list()->setUsageKind(UsageKind::Hero);
     ui->panelSuperListHeroes->initializeModel(gameDatas->heroesDatas()
                                               ->model());
     connect(ui->panelSuperListHeroes->list()->selectionModel(),
@@ -214,6 +218,7 @@ void DialogDatas::updateMonster(SystemMonster *sysMonster){
 void DialogDatas::initializeTroops(GameDatas *gameDatas){
     ui->panelSuperListTroops->list()->initializeNewItemInstance(
                 new SystemTroop);
+    ui->panelSuperListTroops->list()->setUsageKind(UsageKind::Troop);
     ui->panelSuperListTroops->initializeModel(gameDatas->troopsDatas()
                                               ->model());
     connect(ui->panelSuperListTroops->list()->selectionModel(),
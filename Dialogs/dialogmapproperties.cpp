@@ -75,6 +75,14 @@ void DialogMapProperties::initialize(){
                                             ->tilesetsDatas()->model()
                                             ->invisibleRootItem(),
                                             m_mapProperties.tileset()->id()));
+
+    // Merged floors layers
+    QList<int> mergedLayers = m_mapProperties.mergedLayers().toList();
+    qSort(mergedLayers);
+    QStringList listLayers;
+    for (int i = 0; i < mergedLayers.size(); i++)
+        listLayers << QString::number(mergedLayers.at(i));
+    ui->lineEditMergedLayers->setText(listLayers.join(", "));
 }
 
 // -------------------------------------------------------
@@ -112,3 +120,19 @@ void DialogMapProperties::on_comboBoxTilesetCurrentIndexChanged(int index){
                                 ->gameDatas()->tilesetsDatas()->model()
                                 ->item(index)->data().value<qintptr>())->id());
 }
+
+// -------------------------------------------------------
+
+void DialogMapProperties::on_lineEditMergedLayers_textEdited(
+        const QString& text)
+{
+    QSet<int> layers;
+    QStringList listLayers = text.split(",", QString::SkipEmptyParts);
+    for (int i = 0; i < listLayers.size(); i++) {
+        bool ok;
+        int layer = listLayers.at(i).trimmed().toInt(&ok);
+        if (ok && layer >= 0)
+            layers.insert(layer);
+    }
+    m_mapProperties.setMergedLayers(layers);
+}
@@ -55,6 +55,7 @@ private slots:
     void on_spinBoxHeight_valueChanged(int i);
     void on_spinBoxDepth_valueChanged(int i);
     void on_comboBoxTilesetCurrentIndexChanged(int index);
+    void on_lineEditMergedLayers_textEdited(const QString& text);
 };
 
 #endif // DIALOGMAPPROPERTIES_H
@@ -0,0 +1,105 @@
+/*
+    RPG Paper Maker Copyright (C) 2017 Marie Laporte
+
+    This file is part of RPG Paper Maker.
+
+    RPG Paper Maker is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    RPG Paper Maker is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with Foobar.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include "dialogmapsremap.h"
+#include "ui_dialogmapsremap.h"
+#include "dialogprogress.h"
+#include "superlistitem.h"
+#include "wanok.h"
+#include <QMessageBox>
+
+// -------------------------------------------------------
+//
+//  CONSTRUCTOR / DESTRUCTOR / GET / SET
+//
+// -------------------------------------------------------
+
+DialogMapsRemap::DialogMapsRemap(Project* project, QWidget *parent) :
+    QDialog(parent),
+    m_control(project),
+    m_countModifiedMaps(0),
+    ui(new Ui::DialogMapsRemap)
+{
+    ui->setupUi(this);
+
+    SuperListItem::fillComboBox(ui->comboBoxTileset,
+                                project->gameDatas()->tilesetsDatas()
+                                ->model());
+    connect(&m_watcher, SIGNAL(progressValueChanged(int)),
+            this, SLOT(on_remapProgress(int)));
+}
+
+DialogMapsRemap::~DialogMapsRemap()
+{
+    delete ui;
+}
+
+int DialogMapsRemap::countModifiedMaps() const {
+    return m_countModifiedMaps;
+}
+
+//-------------------------------------------------
+//
+//  SLOTS
+//
+//-------------------------------------------------
+
+void DialogMapsRemap::accept() {
+    QString message = m_control.parse(ui->plainTextEditRules->toPlainText());
+    if (message != NULL) {
+        QMessageBox::critical(this, "Error", message);
+        return;
+    }
+    m_control.setTilesetID(SuperListItem::getIdByIndex(
+                               Wanok::get()->project()->gameDatas()
+                               ->tilesetsDatas()->model(),
+                               ui->comboBoxTileset->currentIndex()));
+
+    // Remapping all the maps on the thread pool
+    DialogProgress dialog;
+    connect(this, SIGNAL(progress(int, QString)),
+            &dialog, SLOT(setValueLabel(int, QString)));
+    connect(&m_watcher, SIGNAL(finished()), &dialog, SLOT(accept()));
+    m_watcher.setFuture(m_control.start());
+    dialog.exec();
+    m_watcher.waitForFinished();
+
+    // The modified maps now need to be saved
+    QList<int> ids = m_watcher.future().results();
+    m_countModifiedMaps = 0;
+    for (int i = 0; i < ids.size(); i++) {
+        if (ids.at(i) != -1) {
+            Wanok::mapsToSave.insert(ids.at(i));
+            m_countModifiedMaps++;
+        }
+    }
+
+    QDialog::accept();
+}
+
+// -------------------------------------------------------
+
+void DialogMapsRemap::on_remapProgress(int value) {
+    int maximum = m_watcher.progressMaximum();
+    if (maximum > 0) {
+        emit progress((100 * value) / maximum,
+                      "Replacing in maps (" + QString::number(value) + "/" +
+                      QString::number(maximum) + ")...");
+    }
+}
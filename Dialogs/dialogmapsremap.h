@@ -0,0 +1,64 @@
+/*
+    RPG Paper Maker Copyright (C) 2017 Marie Laporte
+
+    This file is part of RPG Paper Maker.
+
+    RPG Paper Maker is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    RPG Paper Maker is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with Foobar.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#ifndef DIALOGMAPSREMAP_H
+#define DIALOGMAPSREMAP_H
+
+#include <QDialog>
+#include <QFutureWatcher>
+#include "controlmapsremap.h"
+
+// -------------------------------------------------------
+//
+//  CLASS DialogMapsRemap
+//
+//  A dialog used for replacing tiles, sprites and walls in all the maps.
+//
+// -------------------------------------------------------
+
+namespace Ui {
+class DialogMapsRemap;
+}
+
+class DialogMapsRemap : public QDialog
+{
+    Q_OBJECT
+
+public:
+    explicit DialogMapsRemap(Project *project, QWidget *parent = 0);
+    ~DialogMapsRemap();
+    int countModifiedMaps() const;
+
+protected:
+    ControlMapsRemap m_control;
+    QFutureWatcher<int> m_watcher;
+    int m_countModifiedMaps;
+
+private:
+    Ui::DialogMapsRemap *ui;
+
+signals:
+    void progress(int, QString);
+
+private slots:
+    void accept();
+    void on_remapProgress(int value);
+};
+
+#endif // DIALOGMAPSREMAP_H
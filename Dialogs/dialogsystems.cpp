@@ -186,6 +186,7 @@ void DialogSystems::initializeEvents(GameDatas *gameDatas){
             ->initializeNewItemInstance(new SystemCreateParameter);
     ui->panelSuperListEvents->list()
             ->initializeNewItemInstance(new SystemEvent);
+    ui->panelSuperListEvents->list()->setUsageKind(UsageKind::EventUser);
     ui->panelSuperListEvents->initializeModel(gameDatas->commonEventsDatas()
                                               ->modelEventsUser());
     connect(ui->panelSuperListEvents->list()->selectionModel(),
@@ -262,6 +263,7 @@ void DialogSystems::initializeCommonObjects(GameDatas *gameDatas){
     ui->widgetCommonObject->showName(false);
     ui->panelSuperListCommonObjects->list()
             ->initializeNewItemInstance(new SystemCommonObject);
+    ui->panelSuperListCommonObjects->list()->setUsageKind(UsageKind::Object);
     ui->panelSuperListCommonObjects
             ->initializeModel(gameDatas->commonEventsDatas()
                               ->modelCommonObjects());
@@ -36,6 +36,7 @@ DialogVariables::DialogVariables(QWidget *parent) :
     setFixedSize(geometry().width(), geometry().height());
 
     ui->panelList->showButtonMax(false);
+    ui->panelList->list()->setUsageKind(UsageKind::Variable);
     ui->panelListPages->list()->initializeNewItemInstance(new SystemVariables);
     ui->panelListPages->setMaximumLimit(400);
 }
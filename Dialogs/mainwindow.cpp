@@ -19,6 +19,7 @@
 
 #include <QMessageBox>
 #include <QFileDialog>
+#include <QInputDialog>
 #include <QProcess>
 #include <QJsonDocument>
 #include <QDebug>
@@ -34,11 +35,15 @@
 #include "panelmainmenu.h"
 #include "panelproject.h"
 #include "wanok.h"
+#include "eventcommand.h"
 #include "widgettreelocalmaps.h"
 #include "dialoglocation.h"
 #include "dialogprogress.h"
 #include "dialogengineupdate.h"
 #include "dialogspritewalls.h"
+#include "dialogmapsremap.h"
+#include "controlnewproject.h"
+#include "projectgenerator.h"
 
 // -------------------------------------------------------
 //
@@ -118,6 +123,9 @@ int MainWindow::openDialog(QDialog& dialog){
     int res = dialog.exec();
     this->setEnabled(true);
 
+    // Datas could have been renamed: command strings need to be updated
+    EventCommand::invalidateStrings();
+
     return res;
 }
 
@@ -150,6 +158,12 @@ void MainWindow::openProject(QString pathProject) {
         if (project->read(pathProject)) {
             enableGame();
             replaceMainPanel(new PanelProject(this, project));
+            connect(mapEditor(), SIGNAL(memoryUsageChanged(QString)),
+                    ui->statusBar, SLOT(showMessage(QString)));
+            connect(mapEditor(), SIGNAL(replayFinished(QString)),
+                    this, SLOT(on_replayFinished(QString)));
+            connect(mapEditor(), SIGNAL(pickingUnsupported()),
+                    this, SLOT(on_pickingUnsupported()));
         }
         else {
             delete project;
@@ -174,6 +188,8 @@ bool MainWindow::closeProject(){
     WidgetMapEditor* mapEditor = ((PanelProject*)mainPanel)->widgetMapEditor();
     mapEditor->setVisible(false);
     replaceMainPanel(new PanelMainMenu(this));
+    ui->statusBar->clearMessage();
+    ui->actionRecord_map_editor_inputs->setChecked(false);
 
     return true;
 }
@@ -201,6 +217,7 @@ void MainWindow::enableAll(bool b){
     ui->actionClose_project->setEnabled(b);
     ui->actionUndo->setEnabled(b);
     ui->actionRedo->setEnabled(b);
+    ui->actionReplace_in_all_maps->setEnabled(b);
     ui->actionDatas_manager->setEnabled(b);
     ui->actionSystems_manager->setEnabled(b);
     ui->actionVariables_manager->setEnabled(b);
@@ -210,6 +227,9 @@ void MainWindow::enableAll(bool b){
     ui->actionSprite_walls->setEnabled(b);
     ui->actionShow_Hide_grid->setEnabled(b);
     ui->actionShow_Hide_square_informations->setEnabled(b);
+    ui->actionGPU_picking->setEnabled(b);
+    ui->actionRecord_map_editor_inputs->setEnabled(b);
+    ui->actionReplay_map_editor_inputs->setEnabled(b);
     ui->actionPlay->setEnabled(b);
 }
 
@@ -231,6 +251,7 @@ void MainWindow::enableGame(){ // When a project is opened
     ui->actionClose_project->setEnabled(true);
     ui->actionUndo->setEnabled(true);
     ui->actionRedo->setEnabled(true);
+    ui->actionReplace_in_all_maps->setEnabled(true);
     ui->actionDatas_manager->setEnabled(true);
     ui->actionSystems_manager->setEnabled(true);
     ui->actionVariables_manager->setEnabled(true);
@@ -240,6 +261,9 @@ void MainWindow::enableGame(){ // When a project is opened
     ui->actionSprite_walls->setEnabled(true);
     ui->actionShow_Hide_grid->setEnabled(true);
     ui->actionShow_Hide_square_informations->setEnabled(true);
+    ui->actionGPU_picking->setEnabled(true);
+    ui->actionRecord_map_editor_inputs->setEnabled(true);
+    ui->actionReplay_map_editor_inputs->setEnabled(true);
     ui->actionPlay->setEnabled(true);
 }
 
@@ -393,6 +417,21 @@ void MainWindow::on_actionRedo_triggered() {
 
 // -------------------------------------------------------
 
+void MainWindow::on_actionReplace_in_all_maps_triggered() {
+    DialogMapsRemap dialog(project);
+    if (openDialog(dialog) == QDialog::Accepted) {
+        ((PanelProject*)mainPanel)->widgetTreeLocalMaps()
+                ->updateAllNodesSaved();
+        updateTextures();
+        QMessageBox::information(this, "Replace in all maps",
+                                 QString::number(dialog.countModifiedMaps())
+                                 + " map(s) modified. Save all to apply the "
+                                 "changes.");
+    }
+}
+
+// -------------------------------------------------------
+
 void MainWindow::on_actionDatas_manager_triggered(){
     Wanok::isInConfig = true;
     DialogDatas dialog(project->gameDatas());
@@ -478,6 +517,23 @@ void MainWindow::on_actionSet_BR_path_folder_triggered(){
 
 // -------------------------------------------------------
 
+void MainWindow::on_actionMemory_budget_triggered() {
+    EngineSettings* settings = Wanok::get()->engineSettings();
+    bool ok;
+    int budget = QInputDialog::getInt(this, "Memory budget",
+                                      "Memory budget of a map in MB, the "
+                                      "portions ray being reduced to fit in "
+                                      "it (0 for no limit):",
+                                      settings->memoryBudget(), 0, 65536, 64,
+                                      &ok);
+    if (ok) {
+        settings->setMemoryBudget(budget);
+        Wanok::get()->saveEngineSettings();
+    }
+}
+
+// -------------------------------------------------------
+
 void MainWindow::on_actionShow_Hide_grid_triggered() {
     ((PanelProject*)mainPanel)->widgetMapEditor()->showHideGrid();
 }
@@ -490,6 +546,82 @@ void MainWindow::on_actionShow_Hide_square_informations_triggered() {
 
 // -------------------------------------------------------
 
+void MainWindow::on_actionGPU_picking_triggered() {
+    ((PanelProject*)mainPanel)->widgetMapEditor()->switchPicking();
+}
+
+// -------------------------------------------------------
+
+void MainWindow::on_actionRecord_map_editor_inputs_triggered() {
+    WidgetMapEditor* widget = mapEditor();
+    if (widget->isRecording()) {
+        QString path = QFileDialog::getSaveFileName(
+                    this, "Save the recorded inputs",
+                    project->pathCurrentProject(), "JSON (*.json)");
+        widget->stopRecording(path);
+    }
+    else if (!widget->startRecording()) {
+        QMessageBox::information(this, "Warning",
+                                 "Open a map before recording inputs.");
+    }
+    ui->actionRecord_map_editor_inputs->setChecked(widget->isRecording());
+}
+
+// -------------------------------------------------------
+
+void MainWindow::on_actionReplay_map_editor_inputs_triggered() {
+    QString path = QFileDialog::getOpenFileName(
+                this, "Replay map editor inputs",
+                project->pathCurrentProject(), "JSON (*.json)");
+    if (path.isEmpty())
+        return;
+
+    QString message;
+    mapEditor()->startReplay(path, message);
+    ui->actionRecord_map_editor_inputs->setChecked(false);
+    if (!message.isEmpty())
+        QMessageBox::information(this, "Warning", message);
+}
+
+// -------------------------------------------------------
+//  on_actionGenerate_benchmark_project_triggered: the settings file is
+//  optional, the default settings are used if it is cancelled
+
+void MainWindow::on_actionGenerate_benchmark_project_triggered() {
+    ProjectGenerator generator;
+    QString pathSettings = QFileDialog::getOpenFileName(
+                this, "Generator settings (cancel for the default ones)",
+                Wanok::dirGames, "JSON (*.json)");
+    if (!pathSettings.isEmpty())
+        Wanok::readJSON(pathSettings, generator);
+    QString location = QFileDialog::getExistingDirectory(
+                this, "Location of the generated project", Wanok::dirGames);
+    if (location.isEmpty())
+        return;
+    bool ok;
+    QString dirName = QInputDialog::getText(this, "Generate benchmark project",
+                                            "Directory name:",
+                                            QLineEdit::Normal, "Benchmark",
+                                            &ok);
+    if (!ok)
+        return;
+
+    ControlNewproject control;
+    QString error = generator.generate(control.filterDirectoryName(dirName),
+                                       location);
+    if (error != NULL)
+        QMessageBox::critical(this, "Error", error);
+    else {
+        QMessageBox::information(this, "Generate benchmark project",
+                                 "The project was generated with " +
+                                 QString::number(generator.mapsCount()) +
+                                 " maps. Its settings are in " +
+                                 ProjectGenerator::PATH_SETTINGS + ".");
+    }
+}
+
+// -------------------------------------------------------
+
 void MainWindow::on_actionPlay_triggered(){
     if (Wanok::mapsToSave.count() > 0) {
         QMessageBox::StandardButton box =
@@ -549,6 +681,21 @@ void MainWindow::on_updateFinished() {
     QProcess::startDetached(path, arguments);
 }
 
+// -------------------------------------------------------
+
+void MainWindow::on_replayFinished(QString text) {
+    QMessageBox::information(this, "Replay", text);
+}
+
+// -------------------------------------------------------
+
+void MainWindow::on_pickingUnsupported() {
+    ui->actionGPU_picking->setChecked(false);
+    QMessageBox::information(this, "GPU picking",
+                             "GPU picking needs an OpenGL 3.0 context. The "
+                             "map editor keeps using the raycasting.");
+}
+
 // -------------------------------------------------------
 //
 //  EVENTS
@@ -86,6 +86,7 @@ private slots:
     void on_actionQuit_triggered();
     void on_actionUndo_triggered();
     void on_actionRedo_triggered();
+    void on_actionReplace_in_all_maps_triggered();
     void on_actionDatas_manager_triggered();
     void on_actionSystems_manager_triggered();
     void on_actionVariables_manager_triggered();
@@ -93,11 +94,18 @@ private slots:
     void on_actionKeyboard_controls_triggered();
     void on_actionSprite_walls_triggered();
     void on_actionSet_BR_path_folder_triggered();
+    void on_actionMemory_budget_triggered();
     void on_actionShow_Hide_grid_triggered();
     void on_actionShow_Hide_square_informations_triggered();
+    void on_actionGPU_picking_triggered();
+    void on_actionRecord_map_editor_inputs_triggered();
+    void on_actionReplay_map_editor_inputs_triggered();
+    void on_actionGenerate_benchmark_project_triggered();
     void on_actionPlay_triggered();
     void on_updateCheckFinished(bool b);
     void on_updateFinished();
+    void on_replayFinished(QString text);
+    void on_pickingUnsupported();
     void closeEvent(QCloseEvent *event);
 };
 
@@ -6,7 +6,7 @@
 
 CONFIG += c++11
 
-QT       += core gui opengl network
+QT       += core gui opengl network concurrent
 
 win32{
     LIBS += -lOpengl32
@@ -233,7 +233,34 @@ HEADERS += \
     MapEditor/land.h \
     MapEditor/floor.h \
     Enums/cameraupdownkind.h \
-    Controls/MapEditor/controlundoredo.h
+    Controls/MapEditor/controlundoredo.h \
+    MapEditor/portiongeometry.h \
+    MapEditor/vertextiled.h \
+    Models/superlistitemmodel.h \
+    Models/jsonstreamreader.h \
+    Models/eventcommandsmodel.h \
+    Enums/usagekind.h \
+    Models/projectusages.h \
+    Controls/controlmapsremap.h \
+    Dialogs/dialogmapsremap.h \
+    Models/projectminimaps.h \
+    CustomWidgets/widgetminimap.h \
+    MathUtils/boxesbatch.h \
+    Enums/mappickingkind.h \
+    MapEditor/mappicking.h \
+    MapEditor/vertexpacking.h \
+    MapEditor/vertexpacked.h \
+    MapEditor/vertexbillboardpacked.h \
+    MapEditor/vertextiledpacked.h \
+    MapEditor/portionarena.h \
+    MapEditor/mapmemoryusage.h \
+    MapEditor/mapelementpool.h \
+    MapEditor/positionkey.h \
+    Enums/mapeditorinputkind.h \
+    MapEditor/mapeditorinputevent.h \
+    MapEditor/mapeditorreplay.h \
+    Models/projectgenerator.h \
+    Models/projectbenchmark.h
 
 SOURCES += \
     main.cpp \
@@ -415,7 +442,30 @@ SOURCES += \
     Controls/MapEditor/controlmapeditor-preview.cpp \
     Controls/MapEditor/controlmapeditor-raycasting.cpp \
     Controls/MapEditor/controlmapeditor-add-remove.cpp \
-    Controls/MapEditor/controlmapeditor-objects.cpp
+    Controls/MapEditor/controlmapeditor-objects.cpp \
+    MapEditor/portiongeometry.cpp \
+    MapEditor/vertextiled.cpp \
+    Models/superlistitemmodel.cpp \
+    Models/jsonstreamreader.cpp \
+    Models/eventcommandsmodel.cpp \
+    Models/projectusages.cpp \
+    Controls/controlmapsremap.cpp \
+    Dialogs/dialogmapsremap.cpp \
+    Models/projectminimaps.cpp \
+    CustomWidgets/widgetminimap.cpp \
+    MathUtils/boxesbatch.cpp \
+    MapEditor/mappicking.cpp \
+    MapEditor/vertexpacking.cpp \
+    MapEditor/vertexpacked.cpp \
+    MapEditor/vertexbillboardpacked.cpp \
+    MapEditor/vertextiledpacked.cpp \
+    MapEditor/portionarena.cpp \
+    MapEditor/mapmemoryusage.cpp \
+    MapEditor/positionkey.cpp \
+    MapEditor/mapeditorinputevent.cpp \
+    MapEditor/mapeditorreplay.cpp \
+    Models/projectgenerator.cpp \
+    Models/projectbenchmark.cpp
 
 FORMS += \
     Dialogs/mainwindow.ui \
@@ -481,7 +531,8 @@ FORMS += \
     Dialogs/dialogengineupdate.ui \
     Dialogs/SpecialElements/dialogspritewalls.ui \
     Dialogs/SpecialElements/panelspritewalls.ui \
-    Dialogs/SpecialElements/dialogtilesetspritewalls.ui
+    Dialogs/SpecialElements/dialogtilesetspritewalls.ui \
+    Dialogs/dialogmapsremap.ui
 
 OTHER_FILES += \
     style.qss
@@ -526,3 +577,21 @@ win32{
     export(copyBR.commands)
     QMAKE_EXTRA_TARGETS += first copyBR
 }
+
+#-------------------------------------------------
+# Headless benchmarks on a generated project (make benchmark), the results
+# are written in benchmark.json. make benchmarkDatabases is the same on a
+# project with 10000 items in each database
+#-------------------------------------------------
+
+unix:!macx{
+    benchmark.commands = QT_QPA_PLATFORM=offscreen ./$$TARGET \
+        --benchmark $$PWD/Benchmarks/fixture.json \
+        --replay $$PWD/Benchmarks/session.json --output benchmark.json
+    benchmark.depends = first
+    benchmarkDatabases.commands = QT_QPA_PLATFORM=offscreen ./$$TARGET \
+        --benchmark $$PWD/Benchmarks/databases.json \
+        --output benchmarkDatabases.json
+    benchmarkDatabases.depends = first
+    QMAKE_EXTRA_TARGETS += benchmark benchmarkDatabases
+}
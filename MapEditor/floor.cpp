@@ -36,12 +36,12 @@ QString FloorDatas::jsonTexture = "t";
 // -------------------------------------------------------
 
 FloorDatas::FloorDatas() :
-    FloorDatas(new QRect)
+    FloorDatas(QRect())
 {
 
 }
 
-FloorDatas::FloorDatas(QRect* texture, bool up) :
+FloorDatas::FloorDatas(const QRect& texture, bool up) :
     LandDatas(up),
     m_textureRect(texture)
 {
@@ -50,22 +50,29 @@ FloorDatas::FloorDatas(QRect* texture, bool up) :
 
 FloorDatas::~FloorDatas()
 {
-    delete m_textureRect;
+
 }
 
 bool FloorDatas::operator==(const FloorDatas& other) const {
     return LandDatas::operator==(other) &&
-           m_textureRect->x() == other.m_textureRect->x() &&
-           m_textureRect->y() == other.m_textureRect->y() &&
-           m_textureRect->width() == other.m_textureRect->width() &&
-           m_textureRect->height() == other.m_textureRect->height();
+           m_textureRect == other.m_textureRect;
 }
 
 bool FloorDatas::operator!=(const FloorDatas& other) const {
     return !operator==(other);
 }
 
-QRect *FloorDatas::textureRect() const { return m_textureRect; }
+void* FloorDatas::operator new(size_t size) {
+    return MapElementPool<FloorDatas>::allocate(size);
+}
+
+void FloorDatas::operator delete(void* pointer, size_t size) {
+    MapElementPool<FloorDatas>::deallocate(pointer, size);
+}
+
+const QRect& FloorDatas::textureRect() const { return m_textureRect; }
+
+QRect& FloorDatas::textureRect() { return m_textureRect; }
 
 MapEditorSubSelectionKind FloorDatas::getSubKind() const{
     return MapEditorSubSelectionKind::Floors;
@@ -81,6 +88,25 @@ QString FloorDatas::toString() const {
 //
 // -------------------------------------------------------
 
+QVector4D FloorDatas::getTextureCoords(int squareSize, int width,
+                                       int height) const
+{
+    float x = (float)(textureRect().x() * squareSize) / width;
+    float y = (float)(textureRect().y() * squareSize) / height;
+    float w = (float)(textureRect().width() * squareSize) / width;
+    float h = (float)(textureRect().height() * squareSize) / height;
+    float coefX = 0.1 / width;
+    float coefY = 0.1 / height;
+    x += coefX;
+    y += coefY;
+    w -= (coefX * 2);
+    h -= (coefY * 2);
+
+    return QVector4D(x, y, w, h);
+}
+
+// -------------------------------------------------------
+
 void FloorDatas::initializeVertices(int squareSize, int width, int height,
                                    QVector<Vertex>& vertices,
                                    QVector<GLuint>& indexes, Position& position,
@@ -89,16 +115,11 @@ void FloorDatas::initializeVertices(int squareSize, int width, int height,
     QVector3D pos, size;
     getPosSize(pos, size, squareSize, position);
 
-    float x = (float)(textureRect()->x() * squareSize) / width;
-    float y = (float)(textureRect()->y() * squareSize) / height;
-    float w = (float)(textureRect()->width() * squareSize) / width;
-    float h = (float)(textureRect()->height() * squareSize) / height;
-    float coefX = 0.1 / width;
-    float coefY = 0.1 / height;
-    x += coefX;
-    y += coefY;
-    w -= (coefX * 2);
-    h -= (coefY * 2);
+    QVector4D coords = getTextureCoords(squareSize, width, height);
+    float x = coords.x();
+    float y = coords.y();
+    float w = coords.z();
+    float h = coords.w();
 
     // Vertices
     vertices.append(Vertex(Floor::verticesQuad[0] * size + pos,
@@ -118,6 +139,41 @@ void FloorDatas::initializeVertices(int squareSize, int width, int height,
     count++;
 }
 
+// -------------------------------------------------------
+
+void FloorDatas::initializeVerticesTiled(int squareSize, int width, int height,
+                                         QVector<VertexTiled>& vertices,
+                                         QVector<GLuint>& indexes,
+                                         Position& position, int tilesX,
+                                         int tilesZ, int& count)
+{
+    QVector3D pos, size;
+    getPosSize(pos, size, squareSize, position);
+    size.setX(size.x() * tilesX);
+    size.setZ(size.z() * tilesZ);
+
+    // The texture coordinates are in tiles, repeated by the shader inside the
+    // texture rectangle
+    QVector4D coords = getTextureCoords(squareSize, width, height);
+
+    // Vertices
+    vertices.append(VertexTiled(Floor::verticesQuad[0] * size + pos,
+                    QVector2D(0.0f, 0.0f), coords));
+    vertices.append(VertexTiled(Floor::verticesQuad[1] * size + pos,
+                    QVector2D(tilesX, 0.0f), coords));
+    vertices.append(VertexTiled(Floor::verticesQuad[2] * size + pos,
+                    QVector2D(tilesX, tilesZ), coords));
+    vertices.append(VertexTiled(Floor::verticesQuad[3] * size + pos,
+                    QVector2D(0.0f, tilesZ), coords));
+
+    // indexes
+    int offset = count * Floor::nbVerticesQuad;
+    for (int i = 0; i < Floor::nbIndexesQuad; i++)
+        indexes.append(Floor::indexesQuad[i] + offset);
+
+    count++;
+}
+
 // -------------------------------------------------------
 //
 //  READ / WRITE
@@ -128,10 +184,43 @@ void FloorDatas::read(const QJsonObject & json){
     LandDatas::read(json);
 
     QJsonArray tab = json[jsonTexture].toArray();
-    m_textureRect->setLeft(tab[0].toInt());
-    m_textureRect->setTop(tab[1].toInt());
-    m_textureRect->setWidth(tab[2].toInt());
-    m_textureRect->setHeight(tab[3].toInt());
+    m_textureRect.setLeft(tab[0].toInt());
+    m_textureRect.setTop(tab[1].toInt());
+    m_textureRect.setWidth(tab[2].toInt());
+    m_textureRect.setHeight(tab[3].toInt());
+}
+
+// -------------------------------------------------------
+
+void FloorDatas::readStream(JsonStreamReader& reader){
+    QString key;
+
+    if (!reader.beginObject())
+        return;
+    while (reader.nextKey(key)) {
+        if (key == jsonTexture && reader.beginArray()) {
+            int values[4] = {0, 0, 0, 0};
+            for (int i = 0; reader.nextElement(); i++) {
+                int value = reader.readInt();
+                if (i < 4)
+                    values[i] = value;
+            }
+            m_textureRect.setLeft(values[0]);
+            m_textureRect.setTop(values[1]);
+            m_textureRect.setWidth(values[2]);
+            m_textureRect.setHeight(values[3]);
+        }
+        else if (key == jsonUp)
+            m_up = reader.readBool();
+        else if (key == MapElement::jsonX)
+            m_xOffset = reader.readInt();
+        else if (key == MapElement::jsonY)
+            m_yOffset = reader.readInt();
+        else if (key == MapElement::jsonZ)
+            m_zOffset = reader.readInt();
+        else
+            reader.skipValue();
+    }
 }
 
 // -------------------------------------------------------
@@ -140,10 +229,10 @@ void FloorDatas::write(QJsonObject &json) const{
     LandDatas::write(json);
 
     QJsonArray tab;
-    tab.append(m_textureRect->left());
-    tab.append(m_textureRect->top());
-    tab.append(m_textureRect->width());
-    tab.append(m_textureRect->height());
+    tab.append(m_textureRect.left());
+    tab.append(m_textureRect.top());
+    tab.append(m_textureRect.width());
+    tab.append(m_textureRect.height());
     json[jsonTexture] = tab;
 }
 
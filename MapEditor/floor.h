@@ -30,6 +30,9 @@
 #include "land.h"
 #include "position.h"
 #include "vertex.h"
+#include "vertextiled.h"
+#include "vertexpacking.h"
+#include "mapelementpool.h"
 
 // -------------------------------------------------------
 //
@@ -43,12 +46,15 @@ class FloorDatas : public LandDatas
 {
 public:
     FloorDatas();
-    FloorDatas(QRect *texture, bool up = true);
+    FloorDatas(const QRect& texture, bool up = true);
     virtual ~FloorDatas();
     bool operator==(const FloorDatas& other) const;
     bool operator!=(const FloorDatas& other) const;
+    static void* operator new(size_t size);
+    static void operator delete(void* pointer, size_t size);
 
-    QRect* textureRect() const;
+    const QRect& textureRect() const;
+    QRect& textureRect();
     virtual MapEditorSubSelectionKind getSubKind() const;
     virtual QString toString() const;
 
@@ -56,14 +62,21 @@ public:
                                     QVector<Vertex>& vertices,
                                     QVector<GLuint>& indexes,
                                     Position& position, int& count);
+    void initializeVerticesTiled(int squareSize, int width, int height,
+                                 QVector<VertexTiled>& vertices,
+                                 QVector<GLuint>& indexes, Position& position,
+                                 int tilesX, int tilesZ, int& count);
 
     static QString jsonTexture;
 
     virtual void read(const QJsonObject &json);
     virtual void write(QJsonObject & json) const;
+    void readStream(JsonStreamReader& reader);
 
 protected:
-    QRect* m_textureRect;
+    QRect m_textureRect;
+
+    QVector4D getTextureCoords(int squareSize, int width, int height) const;
 };
 
 // -------------------------------------------------------
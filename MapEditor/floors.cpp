@@ -27,16 +27,19 @@
 // -------------------------------------------------------
 
 Floors::Floors() :
-    m_vertexBuffer(QOpenGLBuffer::VertexBuffer),
-    m_indexBuffer(QOpenGLBuffer::IndexBuffer),
-    m_programStatic(nullptr)
+    m_boxesSquareSize(0),
+    m_boxesDirty(true),
+    m_pickableStatic(0),
+    m_vertexBufferTiled(QOpenGLBuffer::VertexBuffer),
+    m_indexBufferTiled(QOpenGLBuffer::IndexBuffer),
+    m_programTiled(nullptr)
 {
 
 }
 
 Floors::~Floors()
 {
-    QHash<Position, FloorDatas*>::iterator i;
+    QHash<PositionKey, FloorDatas*>::iterator i;
     for (i = m_all.begin(); i != m_all.end(); i++)
         delete i.value();
 }
@@ -61,6 +64,7 @@ FloorDatas *Floors::getFloor(Position& p) const{
 
 void Floors::setFloor(Position& p, FloorDatas *floor){
     m_all.insert(p, floor);
+    m_boxesDirty = true;
 }
 
 // -------------------------------------------------------
@@ -68,8 +72,10 @@ void Floors::setFloor(Position& p, FloorDatas *floor){
 FloorDatas *Floors::removeFloor(Position& p){
     FloorDatas* floor = m_all.value(p);
 
-    if (floor != nullptr)
+    if (floor != nullptr) {
         m_all.remove(p);
+        m_boxesDirty = true;
+    }
 
     return floor;
 }
@@ -116,7 +122,7 @@ bool Floors::deleteFloor(Position& p, QJsonObject &previous,
 
 void Floors::removeFloorOut(MapProperties& properties) {
     QList<Position> list;
-    QHash<Position, FloorDatas*>::iterator i;
+    QHash<PositionKey, FloorDatas*>::iterator i;
     for (i = m_all.begin(); i != m_all.end(); i++) {
         Position position = i.key();
 
@@ -130,6 +136,30 @@ void Floors::removeFloorOut(MapProperties& properties) {
 
     for (int j = 0; j < list.size(); j++)
         m_all.remove(list.at(j));
+    m_boxesDirty = true;
+}
+
+// -------------------------------------------------------
+
+bool Floors::remapTextures(const TexturesRemap& textures) {
+    bool changed = false;
+    QHash<PositionKey, FloorDatas*>::iterator i;
+    for (i = m_all.begin(); i != m_all.end(); i++) {
+        if (MapElement::remapTextureRect(i.value()->textureRect(), textures))
+            changed = true;
+    }
+
+    return changed;
+}
+
+// -------------------------------------------------------
+
+void Floors::getTexturesRects(QList<QPair<Position, QRect>>& textures) const
+{
+    QHash<PositionKey, FloorDatas*>::const_iterator i;
+    for (i = m_all.begin(); i != m_all.end(); i++)
+        textures.append(QPair<Position, QRect>(i.key(),
+                                               i.value()->textureRect()));
 }
 
 // -------------------------------------------------------
@@ -137,21 +167,16 @@ void Floors::removeFloorOut(MapProperties& properties) {
 MapElement* Floors::updateRaycasting(int squareSize, float& finalDistance,
                                      Position &finalPosition, QRay3D &ray)
 {
-    MapElement* element = nullptr;
+    updateBoxes(squareSize);
 
-    for (QHash<Position, FloorDatas*>::iterator i = m_all.begin();
-         i != m_all.end(); i++)
-    {
-        Position position = i.key();
-        FloorDatas* floor = i.value();
-        if (updateRaycastingAt(position, floor, squareSize, finalDistance,
-                               finalPosition, ray))
-        {
-            element = floor;
-        }
+    float distance;
+    int index = m_boxes.intersection(ray, &distance);
+    if (index != -1 && Wanok::getMinDistance(finalDistance, distance)) {
+        finalPosition = m_boxesPositions.at(index);
+        return m_all.value(finalPosition);
     }
 
-    return element;
+    return nullptr;
 }
 
 // -------------------------------------------------------
@@ -171,6 +196,51 @@ bool Floors::updateRaycastingAt(Position &position, FloorDatas* floor,
 
 // -------------------------------------------------------
 
+void Floors::updateBoxes(int squareSize) {
+    if (!m_boxesDirty && squareSize == m_boxesSquareSize)
+        return;
+
+    m_boxes.clear();
+    m_boxesPositions.clear();
+    m_boxes.reserve(m_all.size());
+    m_boxesPositions.reserve(m_all.size());
+    QHash<PositionKey, FloorDatas*>::iterator i;
+    for (i = m_all.begin(); i != m_all.end(); i++) {
+        Position position = i.key();
+        QVector3D vecA, vecC;
+        i.value()->getBoxCorners(vecA, vecC, squareSize, position);
+        m_boxes.append(vecA, vecC);
+        m_boxesPositions.append(position);
+    }
+    m_boxesSquareSize = squareSize;
+    m_boxesDirty = false;
+}
+
+// -------------------------------------------------------
+
+FloorDatas* Floors::getPickedFloor(MapPickingKind kind, int quad, int extra,
+                                   Position& position) const
+{
+    if (kind == MapPickingKind::Floors) {
+        if (quad >= m_pickableStatic)
+            return nullptr;
+        position = m_quadsStatic.at(quad);
+    }
+    else {
+        // A merged quad is stored with its first square, and extra is the
+        // tile of the quad that was picked
+        if (quad >= m_quadsTiled.size())
+            return nullptr;
+        position = m_quadsTiled.at(quad);
+        position.setX(position.x() + (extra & 0xFFFF));
+        position.setZ(position.z() + (extra >> 16));
+    }
+
+    return m_all.value(position);
+}
+
+// -------------------------------------------------------
+
 int Floors::getLastLayerAt(Position& position) const {
     int count = position.layer() + 1;
     Position p(position.x(), position.y(), position.yPlus(), position.z(),
@@ -215,55 +285,200 @@ void Floors::updateRemoveLayer(Position& position, QList<QJsonObject>& previous,
 //
 // -------------------------------------------------------
 
-void Floors::initializeVertices(QHash<Position, MapElement *> &previewSquares,
-                                int squareSize, int width, int height)
+void Floors::initializeVertices(
+        QHash<PositionKey, MapElement *> &previewSquares,
+        const QSet<int>& mergedLayers, int squareSize, int width, int height)
 {
     m_vertices.clear();
     m_indexes.clear();
+    m_quadsStatic.clear();
     int count = 0;
 
     // Create temp hash for preview
-    QHash<Position, FloorDatas*> floorsWithPreview(m_all);
-    QHash<Position, MapElement*>::iterator it;
+    QHash<PositionKey, FloorDatas*> floorsWithPreview(m_all);
+    QHash<PositionKey, MapElement*>::iterator it;
     for (it = previewSquares.begin(); it != previewSquares.end(); it++) {
         MapElement* element = it.value();
         if (element->getSubKind() == MapEditorSubSelectionKind::Floors)
             floorsWithPreview[it.key()] = (FloorDatas*) element;
     }
 
-    // Initialize vertices
-    QHash<Position, FloorDatas*>::iterator i;
+    // Initialize vertices (floors in merged layers are kept for later, and
+    // previews are added at the end so that the picking can skip them)
+    QList<Position> positionsMerged, positionsPreview;
+    QHash<PositionKey, FloorDatas*>::iterator i;
     for (i = floorsWithPreview.begin(); i != floorsWithPreview.end(); i++) {
         FloorDatas* floor = i.value();
         Position p = i.key();
-        floor->initializeVertices(squareSize, width, height, m_vertices,
-                                  m_indexes, p, count);
+        if (mergedLayers.contains(p.layer()))
+            positionsMerged.append(p);
+        else if (floor != m_all.value(p))
+            positionsPreview.append(p);
+        else {
+            floor->initializeVertices(squareSize, width, height, m_vertices,
+                                      m_indexes, p, count);
+            m_quadsStatic.append(p);
+        }
+    }
+    m_pickableStatic = count;
+    for (int j = 0; j < positionsPreview.size(); j++) {
+        Position p = positionsPreview.at(j);
+        floorsWithPreview.value(p)->initializeVertices(squareSize, width,
+                                                       height, m_vertices,
+                                                       m_indexes, p, count);
+        m_quadsStatic.append(p);
     }
+
+    initializeVerticesMerged(floorsWithPreview, positionsMerged, squareSize,
+                             width, height);
 }
 
 // -------------------------------------------------------
 
-void Floors::initializeGL(QOpenGLShaderProgram *programStatic){
-    if (m_programStatic == nullptr){
+void Floors::initializeVerticesMerged(QHash<PositionKey, FloorDatas*>& floors,
+                                      QList<Position>& positions,
+                                      int squareSize, int width, int height)
+{
+    m_verticesTiled.clear();
+    m_indexesTiled.clear();
+    m_quadsTiled.clear();
+    int count = 0;
+
+    // Greedy meshing: each floor not merged yet is extended along x as long as
+    // the next floor is identical, then the whole row is extended along z.
+    // The resulting rectangle is drawn with only one quad
+    qSort(positions.begin(), positions.end(), Floors::positionLessThan);
+    QSet<PositionKey> merged;
+    for (int i = 0; i < positions.size(); i++) {
+        Position p = positions.at(i);
+        if (merged.contains(p))
+            continue;
+        FloorDatas* floor = floors.value(p);
+
+        // Extend along x
+        int tilesX = 1;
+        Position next = p;
+        while (true) {
+            next.setX(p.x() + tilesX);
+            FloorDatas* nextFloor = floors.value(next);
+            if (nextFloor == nullptr || merged.contains(next) ||
+                *nextFloor != *floor)
+            {
+                break;
+            }
+            tilesX++;
+        }
+
+        // Extend along z
+        int tilesZ = 1;
+        bool isRowIdentical = true;
+        while (isRowIdentical) {
+            next.setZ(p.z() + tilesZ);
+            for (int x = 0; x < tilesX && isRowIdentical; x++) {
+                next.setX(p.x() + x);
+                FloorDatas* nextFloor = floors.value(next);
+                isRowIdentical = nextFloor != nullptr &&
+                        !merged.contains(next) && *nextFloor == *floor;
+            }
+            if (isRowIdentical)
+                tilesZ++;
+        }
+
+        // Mark all the floors of the rectangle as merged
+        for (int z = 0; z < tilesZ; z++) {
+            next.setZ(p.z() + z);
+            for (int x = 0; x < tilesX; x++) {
+                next.setX(p.x() + x);
+                merged.insert(next);
+            }
+        }
+
+        floor->initializeVerticesTiled(squareSize, width, height,
+                                       m_verticesTiled, m_indexesTiled, p,
+                                       tilesX, tilesZ, count);
+        m_quadsTiled.append(p);
+    }
+}
+
+// -------------------------------------------------------
+
+bool Floors::positionLessThan(const Position& p1, const Position& p2) {
+    if (p1.layer() != p2.layer())
+        return p1.layer() < p2.layer();
+    if (p1.y() != p2.y())
+        return p1.y() < p2.y();
+    if (p1.yPlus() != p2.yPlus())
+        return p1.yPlus() < p2.yPlus();
+    if (p1.z() != p2.z())
+        return p1.z() < p2.z();
+
+    return p1.x() < p2.x();
+}
+
+// -------------------------------------------------------
+
+void Floors::bakeVertices(PortionGeometry& geometry, int squareSize, int width,
+                          int height)
+{
+    QHash<PositionKey, FloorDatas*>::iterator i;
+    for (i = m_all.begin(); i != m_all.end(); i++) {
+        Position p = i.key();
+        i.value()->initializeVertices(squareSize, width, height,
+                                      geometry.verticesStatic(),
+                                      geometry.indexesStatic(), p,
+                                      geometry.countStatic());
+    }
+}
+
+// -------------------------------------------------------
+
+void Floors::initializeGL(QOpenGLShaderProgram *programTiled) {
+    if (m_programTiled == nullptr){
         initializeOpenGLFunctions();
 
-        m_programStatic = programStatic;
+        m_programTiled = programTiled;
     }
 }
 
 // -------------------------------------------------------
 
 void Floors::updateGL(){
-    Map::updateGLStatic(m_vertexBuffer, m_indexBuffer, m_vertices, m_indexes,
-                        m_vao, m_programStatic);
+    Map::updateGLTiled(m_vertexBufferTiled, m_indexBufferTiled,
+                       m_verticesTiled, m_vaoTiled, m_programTiled,
+                       m_packingTiled);
+
+    // Only the quads count is needed for drawing once uploaded
+    m_verticesTiled = QVector<VertexTiled>();
+    m_indexesTiled = QVector<GLuint>();
 }
 
 // -------------------------------------------------------
 
-void Floors::paintGL(){
-    m_vao.bind();
-    glDrawElements(GL_TRIANGLES, m_indexes.size(), GL_UNSIGNED_INT, 0);
-    m_vao.release();
+void Floors::updateArena(PortionArena& arena) {
+    arena.append(PortionArena::FLOORS, m_vertices, m_pickableStatic);
+
+    // The arena keeps the vertices until they are uploaded
+    m_vertices = QVector<Vertex>();
+    m_indexes = QVector<GLuint>();
+}
+
+// -------------------------------------------------------
+
+void Floors::addMemoryUsage(MapMemoryUsage& usage) const {
+    usage.addElements(m_all.size(), sizeof(FloorDatas));
+    usage.addVertices(m_boxes.bytes());
+    usage.addVertices(m_boxesPositions);
+    usage.addVertices(m_quadsStatic);
+    usage.addVertices(m_quadsTiled);
+    usage.addBuffers(m_packingTiled.bufferBytes());
+}
+
+// -------------------------------------------------------
+
+void Floors::paintTiledGL(){
+    m_vaoTiled.bind();
+    m_packingTiled.draw(*this, 0, m_quadsTiled.size());
+    m_vaoTiled.release();
 }
 
 // -------------------------------------------------------
@@ -282,8 +497,52 @@ void Floors::read(const QJsonObject & json){
         QJsonObject objLand = obj["v"].toObject();
         FloorDatas* floor = new FloorDatas;
         floor->read(objLand);
+        delete m_all.value(p);
         m_all[p] = floor;
     }
+    m_boxesDirty = true;
+}
+
+// -------------------------------------------------------
+
+bool Floors::canReadStream() const {
+    return true;
+}
+
+// -------------------------------------------------------
+
+void Floors::readStream(JsonStreamReader& reader){
+    QString key;
+
+    if (!reader.beginObject())
+        return;
+    while (reader.nextKey(key)) {
+        if (key != "floors" || !reader.beginArray()) {
+            reader.skipValue();
+            continue;
+        }
+        while (reader.nextElement()) {
+            Position p;
+            FloorDatas* floor = new FloorDatas;
+            if (reader.beginObject()) {
+                while (reader.nextKey(key)) {
+                    if (key == "k")
+                        p.readStream(reader);
+                    else if (key == "v")
+                        floor->readStream(reader);
+                    else
+                        reader.skipValue();
+                }
+            }
+            if (reader.hasError()) {
+                delete floor;
+                return;
+            }
+            delete m_all.value(p);
+            m_all[p] = floor;
+            m_boxesDirty = true;
+        }
+    }
 }
 
 // -------------------------------------------------------
@@ -291,7 +550,7 @@ void Floors::read(const QJsonObject & json){
 void Floors::write(QJsonObject & json) const{
     QJsonArray tabFloors;
 
-    QHash<Position, FloorDatas*>::const_iterator i;
+    QHash<PositionKey, FloorDatas*>::const_iterator i;
     for (i = m_all.begin(); i != m_all.end(); i++){
         QJsonObject objHash;
         QJsonArray tabKey;
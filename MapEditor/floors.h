@@ -23,6 +23,11 @@
 #include <QHash>
 #include "mapproperties.h"
 #include "floor.h"
+#include "positionkey.h"
+#include "portiongeometry.h"
+#include "boxesbatch.h"
+#include "mappickingkind.h"
+#include "portionarena.h"
 
 // -------------------------------------------------------
 //
@@ -47,35 +52,67 @@ public:
                      MapEditorSubSelectionKind &previousType);
 
     void removeFloorOut(MapProperties& properties);
+    bool remapTextures(const TexturesRemap& textures);
+    void getTexturesRects(QList<QPair<Position, QRect>>& textures) const;
     MapElement *updateRaycasting(int squareSize, float& finalDistance,
                                  Position &finalPosition, QRay3D &ray);
     bool updateRaycastingAt(Position &position, FloorDatas *floor,
                             int squareSize, float &finalDistance,
                             Position &finalPosition, QRay3D& ray);
+    void updateBoxes(int squareSize);
+    FloorDatas* getPickedFloor(MapPickingKind kind, int quad, int extra,
+                               Position& position) const;
     int getLastLayerAt(Position& position) const;
     void updateRemoveLayer(Position& position, QList<QJsonObject> &previous,
                            QList<MapEditorSubSelectionKind> &previousType,
                            QList<Position> &positions);
 
-    void initializeVertices(QHash<Position, MapElement*>& previewSquares,
-                            int squareSize, int width, int height);
-    void initializeGL(QOpenGLShaderProgram* programStatic);
+    void initializeVertices(QHash<PositionKey, MapElement*>& previewSquares,
+                            const QSet<int>& mergedLayers, int squareSize,
+                            int width, int height);
+    void initializeVerticesMerged(QHash<PositionKey, FloorDatas*>& floors,
+                                  QList<Position>& positions, int squareSize,
+                                  int width, int height);
+    static bool positionLessThan(const Position& p1, const Position& p2);
+    void bakeVertices(PortionGeometry& geometry, int squareSize, int width,
+                      int height);
+    void initializeGL(QOpenGLShaderProgram* programTiled);
     void updateGL();
-    void paintGL();
+    void updateArena(PortionArena& arena);
+    void addMemoryUsage(MapMemoryUsage& usage) const;
+    void paintTiledGL();
 
     virtual void read(const QJsonObject &json);
     virtual void write(QJsonObject &json) const;
+    virtual bool canReadStream() const;
+    virtual void readStream(JsonStreamReader& reader);
 
 protected:
-    QHash<Position, FloorDatas*> m_all;
+    QHash<PositionKey, FloorDatas*> m_all;
 
-    // OpenGL informations
-    QOpenGLBuffer m_vertexBuffer;
-    QOpenGLBuffer m_indexBuffer;
+    // Raycasting boxes, rebuilt after any change of m_all
+    BoxesBatch m_boxes;
+    QVector<Position> m_boxesPositions;
+    int m_boxesSquareSize;
+    bool m_boxesDirty;
+
+    // Vertices, only kept until they are given to the arena of the portion
     QVector<Vertex> m_vertices;
     QVector<GLuint> m_indexes;
-    QOpenGLVertexArrayObject m_vao;
-    QOpenGLShaderProgram* m_programStatic;
+
+    // Position of each quad for picking, the previews being the last quads
+    QVector<Position> m_quadsStatic;
+    int m_pickableStatic;
+    QVector<Position> m_quadsTiled;
+
+    // OpenGL informations for merged layers
+    QOpenGLBuffer m_vertexBufferTiled;
+    QOpenGLBuffer m_indexBufferTiled;
+    QVector<VertexTiled> m_verticesTiled;
+    QVector<GLuint> m_indexesTiled;
+    QOpenGLVertexArrayObject m_vaoTiled;
+    VertexPacking m_packingTiled;
+    QOpenGLShaderProgram* m_programTiled;
 };
 
 #endif // FLOORS_H
@@ -67,12 +67,21 @@ void LandDatas::initializeVertices(int, int, int, QVector<Vertex>&,
 
 // -------------------------------------------------------
 
-float LandDatas::intersection(int squareSize, QRay3D& ray, Position& position) {
+void LandDatas::getBoxCorners(QVector3D& vecA, QVector3D& vecC,
+                              int squareSize, Position& position)
+{
     QVector3D pos, size;
     getPosSize(pos, size, squareSize, position);
 
-    QVector3D vecA = Floor::verticesQuad[0] * size + pos,
-              vecC = Floor::verticesQuad[2] * size + pos;
+    vecA = Floor::verticesQuad[0] * size + pos;
+    vecC = Floor::verticesQuad[2] * size + pos;
+}
+
+// -------------------------------------------------------
+
+float LandDatas::intersection(int squareSize, QRay3D& ray, Position& position) {
+    QVector3D vecA, vecC;
+    getBoxCorners(vecA, vecC, squareSize, position);
     QBox3D box(vecA, vecC);
 
     return box.intersection(ray);
@@ -39,6 +39,8 @@ public:
                                     QVector<GLuint>&, Position&, int&);
     void getPosSize(QVector3D& pos, QVector3D& size, int squareSize,
                     Position &position);
+    void getBoxCorners(QVector3D& vecA, QVector3D& vecC, int squareSize,
+                       Position& position);
     float intersection(int squareSize, QRay3D& ray, Position& position);
 
     static QString jsonUp;
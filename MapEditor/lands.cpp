@@ -89,6 +89,18 @@ void Lands::removeLandOut(MapProperties& properties) {
 
 // -------------------------------------------------------
 
+bool Lands::remapTextures(const TexturesRemap& textures) {
+    return m_floors->remapTextures(textures);
+}
+
+// -------------------------------------------------------
+
+void Lands::getTexturesRects(QList<QPair<Position, QRect>>& textures) const {
+    m_floors->getTexturesRects(textures);
+}
+
+// -------------------------------------------------------
+
 MapElement* Lands::updateRaycasting(int squareSize, float& finalDistance,
                                     Position &finalPosition, QRay3D &ray)
 {
@@ -98,6 +110,14 @@ MapElement* Lands::updateRaycasting(int squareSize, float& finalDistance,
 
 // -------------------------------------------------------
 
+MapElement* Lands::getPickedElement(MapPickingKind kind, int quad, int extra,
+                                    Position& position) const
+{
+    return m_floors->getPickedFloor(kind, quad, extra, position);
+}
+
+// -------------------------------------------------------
+
 MapElement* Lands::getMapElementAt(Position& position,
                                    MapEditorSubSelectionKind subKind)
 {
@@ -127,16 +147,26 @@ int Lands::getLastLayerAt(Position& position, MapEditorSubSelectionKind subKind)
 //
 // -------------------------------------------------------
 
-void Lands::initializeVertices(QHash<Position, MapElement *> &previewSquares,
-                               int squareSize, int width, int height)
+void Lands::initializeVertices(QHash<PositionKey, MapElement *> &previewSquares,
+                               const QSet<int>& mergedLayers, int squareSize,
+                               int width, int height)
+{
+    m_floors->initializeVertices(previewSquares, mergedLayers, squareSize,
+                                 width, height);
+}
+
+// -------------------------------------------------------
+
+void Lands::bakeVertices(PortionGeometry& geometry, int squareSize, int width,
+                         int height)
 {
-    m_floors->initializeVertices(previewSquares, squareSize, width, height);
+    m_floors->bakeVertices(geometry, squareSize, width, height);
 }
 
 // -------------------------------------------------------
 
-void Lands::initializeGL(QOpenGLShaderProgram *programStatic){
-    m_floors->initializeGL(programStatic);
+void Lands::initializeGL(QOpenGLShaderProgram *programTiled) {
+    m_floors->initializeGL(programTiled);
 }
 
 // -------------------------------------------------------
@@ -147,8 +177,20 @@ void Lands::updateGL(){
 
 // -------------------------------------------------------
 
-void Lands::paintGL(){
-    m_floors->paintGL();
+void Lands::updateArena(PortionArena& arena) {
+    m_floors->updateArena(arena);
+}
+
+// -------------------------------------------------------
+
+void Lands::addMemoryUsage(MapMemoryUsage& usage) const {
+    m_floors->addMemoryUsage(usage);
+}
+
+// -------------------------------------------------------
+
+void Lands::paintTiledGL(){
+    m_floors->paintTiledGL();
 }
 
 // -------------------------------------------------------
@@ -163,6 +205,18 @@ void Lands::read(const QJsonObject & json){
 
 // -------------------------------------------------------
 
+bool Lands::canReadStream() const {
+    return true;
+}
+
+// -------------------------------------------------------
+
+void Lands::readStream(JsonStreamReader& reader){
+    m_floors->readStream(reader);
+}
+
+// -------------------------------------------------------
+
 void Lands::write(QJsonObject & json) const{
     m_floors->write(json);
 }
@@ -37,20 +37,31 @@ public:
                     QList<MapEditorSubSelectionKind> &previousType,
                     QList<Position> &positions);
     void removeLandOut(MapProperties& properties);
+    bool remapTextures(const TexturesRemap& textures);
+    void getTexturesRects(QList<QPair<Position, QRect>>& textures) const;
     MapElement *updateRaycasting(int squareSize, float& finalDistance,
                                  Position &finalPosition, QRay3D &ray);
+    MapElement* getPickedElement(MapPickingKind kind, int quad, int extra,
+                                 Position& position) const;
     MapElement* getMapElementAt(Position& position,
                                 MapEditorSubSelectionKind subKind);
     int getLastLayerAt(Position& position, MapEditorSubSelectionKind subKind);
 
-    void initializeVertices(QHash<Position, MapElement*>& previewSquares,
-                            int squareSize, int width, int height);
-    void initializeGL(QOpenGLShaderProgram* programStatic);
+    void initializeVertices(QHash<PositionKey, MapElement*>& previewSquares,
+                            const QSet<int>& mergedLayers, int squareSize,
+                            int width, int height);
+    void bakeVertices(PortionGeometry& geometry, int squareSize, int width,
+                      int height);
+    void initializeGL(QOpenGLShaderProgram* programTiled);
     void updateGL();
-    void paintGL();
+    void updateArena(PortionArena& arena);
+    void addMemoryUsage(MapMemoryUsage& usage) const;
+    void paintTiledGL();
 
     virtual void read(const QJsonObject &json);
     virtual void write(QJsonObject &json) const;
+    virtual bool canReadStream() const;
+    virtual void readStream(JsonStreamReader& reader);
 
 protected:
     Floors* m_floors;
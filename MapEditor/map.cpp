@@ -22,11 +22,20 @@
 #include <QJsonDocument>
 #include <cmath>
 #include <QDir>
+#include <QFileInfo>
 #include "map.h"
 #include "wanok.h"
+#include "eventcommand.h"
 #include "systemmapobject.h"
 #include "systemspecialelement.h"
 
+// The visible portions around the cursor and the not visible border
+const int Map::MIN_PORTIONS_RAY = 2;
+
+// Memory of a portion never loaded for a byte of its file, until the ratio is
+// known from the loaded ones
+const int Map::MEMORY_PER_FILE_BYTE = 8;
+
 // -------------------------------------------------------
 //
 //  CONSTRUCTOR / DESTRUCTOR / GET / SET
@@ -41,8 +50,11 @@ Map::Map() :
     m_saved(true),
     m_programStatic(nullptr),
     m_programFaceSprite(nullptr),
+    m_programTiled(nullptr),
     m_textureTileset(nullptr),
-    m_textureObjectSquare(nullptr)
+    m_textureObjectSquare(nullptr),
+    m_portionsMemoryLoaded(0),
+    m_portionsFilesLoaded(0)
 {
 
 }
@@ -53,8 +65,11 @@ Map::Map(int id) :
     m_modelObjects(new QStandardItemModel),
     m_programStatic(nullptr),
     m_programFaceSprite(nullptr),
+    m_programTiled(nullptr),
     m_textureTileset(nullptr),
-    m_textureObjectSquare(nullptr)
+    m_textureObjectSquare(nullptr),
+    m_portionsMemoryLoaded(0),
+    m_portionsFilesLoaded(0)
 {
     QString realName = Wanok::generateMapName(id);
     QString pathMaps = Wanok::pathCombine(Wanok::get()->project()
@@ -79,6 +94,7 @@ Map::Map(int id) :
     readObjects();
     m_saved = !Wanok::mapsToSave.contains(id);
     m_portionsRay = Wanok::get()->getPortionsRay() + 1;
+    m_maxPortionsRay = m_portionsRay;
     m_squareSize = Wanok::get()->getSquareSize();
 
     // Loading textures
@@ -91,7 +107,8 @@ Map::Map(MapProperties* properties) :
     m_cursor(nullptr),
     m_modelObjects(new QStandardItemModel),
     m_programStatic(nullptr),
-    m_programFaceSprite(nullptr)
+    m_programFaceSprite(nullptr),
+    m_programTiled(nullptr)
 {
 
 }
@@ -106,6 +123,8 @@ Map::~Map() {
         delete m_programStatic;
     if (m_programFaceSprite != nullptr)
         delete m_programFaceSprite;
+    if (m_programTiled != nullptr)
+        delete m_programTiled;
 
     deleteTextures();
 }
@@ -126,6 +145,12 @@ void Map::setSaved(bool b){ m_saved = b; }
 
 QStandardItemModel* Map::modelObjects() const { return m_modelObjects; }
 
+QOpenGLTexture* Map::textureTileset() const { return m_textureTileset; }
+
+const QHash<int, QOpenGLTexture*>& Map::texturesSpriteWalls() const {
+    return m_texturesSpriteWalls;
+}
+
 MapPortion* Map::mapPortion(Portion &p) const {
     return mapPortion(p.x(), p.y(), p.z());
 }
@@ -620,6 +645,7 @@ MapPortion* Map::loadPortionMap(int i, int j, int k, bool force){
         */
         loadPortionThread(mapPortion);
         mapPortion->setIsLoaded(true);
+        addPortionMemory(mapPortion, QFileInfo(path).size());
         return mapPortion;
     }
 
@@ -680,8 +706,10 @@ void Map::loadPortionThread(MapPortion* portion)
     portion->initializeVertices(m_squareSize,
                                 m_textureTileset,
                                 m_texturesCharacters,
-                                m_texturesSpriteWalls);
-    portion->initializeGL(m_programStatic, m_programFaceSprite);
+                                m_texturesSpriteWalls,
+                                m_mapProperties->mergedLayers());
+    portion->initializeGL(m_programStatic, m_programFaceSprite,
+                          m_programTiled);
     portion->updateGL();
 }
 
@@ -706,8 +734,10 @@ void Map::updatePortion(MapPortion* mapPortion)
     mapPortion->initializeVertices(m_squareSize,
                                    m_textureTileset,
                                    m_texturesCharacters,
-                                   m_texturesSpriteWalls);
-    mapPortion->initializeGL(m_programStatic, m_programFaceSprite);
+                                   m_texturesSpriteWalls,
+                                   m_mapProperties->mergedLayers());
+    mapPortion->initializeGL(m_programStatic, m_programFaceSprite,
+                             m_programTiled);
     mapPortion->updateGL();
 }
 
@@ -795,7 +825,133 @@ void Map::deletePortions(){
         for (int i = 0; i < totalSize; i++)
             delete this->mapPortionBrut(i);
         delete[] m_mapPortions;
+        m_mapPortions = nullptr;
+    }
+}
+
+// -------------------------------------------------------
+
+void Map::updateMemoryUsage(MapMemoryUsage& usage) const {
+    usage.clear();
+    if (m_mapPortions != nullptr) {
+        int totalSize = getMapPortionTotalSize();
+        for (int i = 0; i < totalSize; i++) {
+            MapPortion* mapPortion = this->mapPortionBrut(i);
+            if (mapPortion != nullptr)
+                mapPortion->addMemoryUsage(usage);
+        }
     }
+    addTexturesMemoryUsage(usage);
+}
+
+// -------------------------------------------------------
+
+void Map::addTexturesMemoryUsage(MapMemoryUsage& usage) const {
+    usage.addTexture(m_textureTileset);
+    usage.addTexture(m_textureObjectSquare);
+    QHash<int, QOpenGLTexture*>::const_iterator i;
+    for (i = m_texturesCharacters.begin(); i != m_texturesCharacters.end();
+         i++)
+    {
+        usage.addTexture(i.value());
+    }
+    for (i = m_texturesSpriteWalls.begin(); i != m_texturesSpriteWalls.end();
+         i++)
+    {
+        usage.addTexture(i.value());
+    }
+}
+
+// -------------------------------------------------------
+//  updatePortionsRay: the largest portions ray, up to the project one, whose
+//  portions around the given one fit in the memory budget of the engine
+//  settings. It is computed before loading the portions, from the memory of
+//  the portions already loaded or else from the size of their files. If the
+//  ray changes, the portions are deleted as their indexes depend on it and
+//  they have to be loaded again. Returns true if the ray changed.
+
+bool Map::updatePortionsRay(Portion portion) {
+    qint64 budget = (qint64) Wanok::get()->engineSettings()->memoryBudget() *
+            1024 * 1024;
+    int ray = m_maxPortionsRay;
+
+    if (budget > 0) {
+
+        // The loaded portions may have been modified since they were loaded
+        if (m_mapPortions != nullptr) {
+            int totalSize = getMapPortionTotalSize();
+            for (int i = 0; i < totalSize; i++) {
+                MapPortion* mapPortion = this->mapPortionBrut(i);
+                if (mapPortion != nullptr) {
+                    MapMemoryUsage usage;
+                    Portion globalPortion;
+                    mapPortion->addMemoryUsage(usage);
+                    mapPortion->getGlobalPortion(globalPortion);
+                    m_portionsMemory[globalPortion] = usage.total();
+                }
+            }
+        }
+
+        // Memory used by each ring of portions around the cursor, the
+        // textures being needed whatever the ray
+        QVector<qint64> rings(m_maxPortionsRay + 1, 0);
+        for (int i = -m_maxPortionsRay; i <= m_maxPortionsRay; i++) {
+            for (int j = -m_maxPortionsRay; j <= m_maxPortionsRay; j++) {
+                for (int k = -m_maxPortionsRay; k <= m_maxPortionsRay; k++) {
+                    int ring = qMax(qAbs(i), qMax(qAbs(j), qAbs(k)));
+                    rings[ring] += portionMemory(i + portion.x(),
+                                                 j + portion.y(),
+                                                 k + portion.z());
+                }
+            }
+        }
+        MapMemoryUsage usage;
+        addTexturesMemoryUsage(usage);
+        qint64 total = usage.total();
+        for (ray = 0; ray <= m_maxPortionsRay; ray++) {
+            total += rings.at(ray);
+            if (total > budget)
+                break;
+        }
+        ray = qMax(ray - 1, MIN_PORTIONS_RAY);
+    }
+    if (ray == m_portionsRay)
+        return false;
+
+    deletePortions();
+    m_portionsRay = ray;
+
+    return true;
+}
+
+// -------------------------------------------------------
+//  portionMemory: i, j, k are the coordinates of the global portion
+
+qint64 Map::portionMemory(int i, int j, int k) {
+    Portion portion(i, j, k);
+    QHash<Portion, qint64>::const_iterator it = m_portionsMemory.find(portion);
+    if (it != m_portionsMemory.end())
+        return it.value();
+
+    QFileInfo info(getPortionPath(i, j, k));
+    if (!info.exists())
+        return 0;
+    if (m_portionsFilesLoaded == 0)
+        return info.size() * MEMORY_PER_FILE_BYTE;
+
+    return info.size() * m_portionsMemoryLoaded / m_portionsFilesLoaded;
+}
+
+// -------------------------------------------------------
+
+void Map::addPortionMemory(MapPortion* mapPortion, qint64 fileSize) {
+    MapMemoryUsage usage;
+    Portion globalPortion;
+    mapPortion->addMemoryUsage(usage);
+    mapPortion->getGlobalPortion(globalPortion);
+    m_portionsMemory[globalPortion] = usage.total();
+    m_portionsMemoryLoaded += usage.total();
+    m_portionsFilesLoaded += fileSize;
 }
 
 // -------------------------------------------------------
@@ -894,6 +1050,7 @@ bool Map::addObject(Position& p, MapPortion* mapPortion,
     item->setData(QVariant::fromValue(reinterpret_cast<quintptr>(newObject)));
     item->setText(newObject->toString());
     m_modelObjects->insertRow(row, item);
+    EventCommand::invalidateStrings();
 
     return b;
 }
@@ -923,6 +1080,7 @@ bool Map::deleteObject(Position& p, MapPortion *mapPortion,
                        MapEditorSubSelectionKind &previousType)
 {
     Map::removeObject(m_modelObjects, object);
+    EventCommand::invalidateStrings();
 
     return mapPortion->deleteObject(p, previous, previousType);
 }
@@ -934,6 +1092,7 @@ void Map::save(){
                                           Wanok::TEMP_MAP_FOLDER_NAME);
     Wanok::copyAllFiles(pathTemp, m_pathMap);
     Wanok::deleteAllFiles(pathTemp);
+    Wanok::get()->project()->usages()->refreshMap(m_pathMap);
 }
 
 // -------------------------------------------------------
@@ -986,6 +1145,10 @@ void Map::initializeGL(){
                                              ":/Shaders/static.vert");
     m_programStatic->addShaderFromSourceFile(QOpenGLShader::Fragment,
                                              ":/Shaders/static.frag");
+    m_programStatic->bindAttributeLocation("position", 0);
+    m_programStatic->bindAttributeLocation("texCoord0", 1);
+    m_programStatic->bindAttributeLocation("unpack",
+                                           VertexPacking::UNPACK_LOCATION);
     m_programStatic->link();
     m_programStatic->bind();
 
@@ -997,12 +1160,38 @@ void Map::initializeGL(){
     m_programStatic->release();
 
 
+    // Create MERGED FLOORS Shader
+    m_programTiled = new QOpenGLShaderProgram();
+    m_programTiled->addShaderFromSourceFile(QOpenGLShader::Vertex,
+                                            ":/Shaders/floorsTiled.vert");
+    m_programTiled->addShaderFromSourceFile(QOpenGLShader::Fragment,
+                                            ":/Shaders/floorsTiled.frag");
+    m_programTiled->bindAttributeLocation("position", 0);
+    m_programTiled->bindAttributeLocation("texCoord0", 1);
+    m_programTiled->bindAttributeLocation("texRect", 2);
+    m_programTiled->bindAttributeLocation("unpack",
+                                          VertexPacking::UNPACK_LOCATION);
+    m_programTiled->link();
+    m_programTiled->bind();
+
+    // Uniform location of camera
+    u_modelviewProjectionTiled = m_programTiled
+            ->uniformLocation("modelviewProjection");
+
+    // Release
+    m_programTiled->release();
+
     // Create SPRITE FACE Shader
     m_programFaceSprite = new QOpenGLShaderProgram();
     m_programFaceSprite->addShaderFromSourceFile(QOpenGLShader::Vertex,
                                                  ":/Shaders/spriteFace.vert");
     m_programFaceSprite->addShaderFromSourceFile(QOpenGLShader::Fragment,
                                                  ":/Shaders/spriteFace.frag");
+    m_programFaceSprite->bindAttributeLocation("centerPosition", 0);
+    m_programFaceSprite->bindAttributeLocation("texCoord0", 1);
+    m_programFaceSprite->bindAttributeLocation("corner", 2);
+    m_programFaceSprite->bindAttributeLocation(
+                "unpack", VertexPacking::UNPACK_LOCATION);
     m_programFaceSprite->link();
     m_programFaceSprite->bind();
 
@@ -1018,6 +1207,9 @@ void Map::initializeGL(){
 
     // Release
     m_programFaceSprite->release();
+
+    // Indexes shared by all the quads buffers
+    VertexPacking::createIndexBufferQuads();
 }
 
 // -------------------------------------------------------
@@ -1025,50 +1217,75 @@ void Map::initializeGL(){
 void Map::updateGLStatic(QOpenGLBuffer &vertexBuffer,
                          QOpenGLBuffer &indexBuffer,
                          QVector<Vertex> &vertices,
-                         QVector<GLuint> &indexes,
                          QOpenGLVertexArrayObject &vao,
-                         QOpenGLShaderProgram* program)
+                         QOpenGLShaderProgram* program,
+                         VertexPacking& packing)
+{
+    QList<QVector<Vertex>> list;
+    list.append(vertices);
+    updateGLStatic(vertexBuffer, indexBuffer, list, vao, program, packing);
+}
+
+// -------------------------------------------------------
+
+void Map::updateGLStatic(QOpenGLBuffer &vertexBuffer,
+                         QOpenGLBuffer &indexBuffer,
+                         const QList<QVector<Vertex>> &vertices,
+                         QOpenGLVertexArrayObject &vao,
+                         QOpenGLShaderProgram* program,
+                         VertexPacking& packing)
 {
     program->bind();
 
+    // Pack all the vertices, one after the other, relatively to their
+    // bounding box
+    QVector3D min, max;
+    int count = 0;
+    for (int i = 0; i < vertices.size(); i++) {
+        const QVector<Vertex>& list = vertices.at(i);
+        for (int j = 0; j < list.size(); j++, count++) {
+            VertexPacking::updateBounds(min, max, list.at(j).position(),
+                                        count == 0);
+        }
+    }
+    packing.setBounds(min, max);
+    QVector<VertexPacked> packed;
+    packed.reserve(count);
+    for (int i = 0; i < vertices.size(); i++) {
+        const QVector<Vertex>& list = vertices.at(i);
+        for (int j = 0; j < list.size(); j++)
+            packed.append(VertexPacked(list.at(j), packing));
+    }
+
     // If existing VAO or VBO, destroy it
     if (vao.isCreated())
         vao.destroy();
     if (vertexBuffer.isCreated())
         vertexBuffer.destroy();
-    if (indexBuffer.isCreated())
-        indexBuffer.destroy();
 
     // Create new VBO for vertex
     vertexBuffer.create();
     vertexBuffer.bind();
     vertexBuffer.setUsagePattern(QOpenGLBuffer::StaticDraw);
-    vertexBuffer.allocate(vertices.constData(),
-                          vertices.size() * sizeof(Vertex));
-
-    // Create new VBO for indexes
-    indexBuffer.create();
-    indexBuffer.bind();
-    indexBuffer.setUsagePattern(QOpenGLBuffer::StaticDraw);
-    indexBuffer.allocate(indexes.constData(),
-                         indexes.size() * sizeof(GLuint));
+    vertexBuffer.allocate(packed.constData(),
+                          packed.size() * sizeof(VertexPacked));
+    packing.setVerticesBytes(packed.size() * sizeof(VertexPacked));
 
     // Create new VAO
     vao.create();
     vao.bind();
-    program->enableAttributeArray(0);
-    program->enableAttributeArray(1);
-    program->setAttributeBuffer(0, GL_FLOAT, Vertex::positionOffset(),
-                                Vertex::positionTupleSize,
-                                Vertex::stride());
-    program->setAttributeBuffer(1, GL_FLOAT, Vertex::texOffset(),
-                                Vertex::texCoupleSize,
-                                Vertex::stride());
-    indexBuffer.bind();
+    VertexPacking::setAttributeBuffer(0, GL_SHORT, false,
+                                      VertexPacked::positionOffset(),
+                                      VertexPacked::positionTupleSize,
+                                      VertexPacked::stride());
+    VertexPacking::setAttributeBuffer(1, GL_UNSIGNED_SHORT, true,
+                                      VertexPacked::texOffset(),
+                                      VertexPacked::texCoupleSize,
+                                      VertexPacked::stride());
+    packing.bindIndexes(indexBuffer, packed.size());
 
     // Releases
     vao.release();
-    indexBuffer.release();
     vertexBuffer.release();
     program->release();
 }
@@ -1078,58 +1295,126 @@ void Map::updateGLStatic(QOpenGLBuffer &vertexBuffer,
 void Map::updateGLFace(QOpenGLBuffer &vertexBuffer,
                        QOpenGLBuffer &indexBuffer,
                        QVector<VertexBillboard> &vertices,
-                       QVector<GLuint> &indexes,
                        QOpenGLVertexArrayObject &vao,
-                       QOpenGLShaderProgram* program)
+                       QOpenGLShaderProgram* program,
+                       VertexPacking& packing)
 {
     program->bind();
 
+    // Pack the vertices relatively to their bounding box, the corners
+    // offsets also need to fit
+    QVector3D min, max;
+    for (int i = 0; i < vertices.size(); i++) {
+        const VertexBillboard& vertex = vertices.at(i);
+        QVector3D model = vertex.model();
+        float corner = qMax(qMax(qAbs(model.x() * vertex.size().x()),
+                                 qAbs(model.y() * vertex.size().y())),
+                            qAbs(model.z()));
+        QVector3D extent(corner, corner, corner);
+        VertexPacking::updateBounds(min, max,
+                                    vertex.centerPosition() - extent, i == 0);
+        VertexPacking::updateBounds(min, max,
+                                    vertex.centerPosition() + extent, false);
+    }
+    packing.setBounds(min, max);
+    QVector<VertexBillboardPacked> packed;
+    packed.reserve(vertices.size());
+    for (int i = 0; i < vertices.size(); i++)
+        packed.append(VertexBillboardPacked(vertices.at(i), packing));
+
     // If existing VAO or VBO, destroy it
     if (vao.isCreated())
         vao.destroy();
     if (vertexBuffer.isCreated())
         vertexBuffer.destroy();
-    if (indexBuffer.isCreated())
-        indexBuffer.destroy();
 
     // Create new VBO for vertex
     vertexBuffer.create();
     vertexBuffer.bind();
     vertexBuffer.setUsagePattern(QOpenGLBuffer::StaticDraw);
-    vertexBuffer.allocate(vertices.constData(),
-                          vertices.size() * sizeof(VertexBillboard));
+    vertexBuffer.allocate(packed.constData(),
+                          packed.size() * sizeof(VertexBillboardPacked));
+    packing.setVerticesBytes(packed.size() * sizeof(VertexBillboardPacked));
+
+    // Create new VAO
+    vao.create();
+    vao.bind();
+    VertexPacking::setAttributeBuffer(0, GL_SHORT, false,
+                                      VertexBillboardPacked::positionOffset(),
+                                      VertexBillboardPacked::positionTupleSize,
+                                      VertexBillboardPacked::stride());
+    VertexPacking::setAttributeBuffer(1, GL_UNSIGNED_SHORT, true,
+                                      VertexBillboardPacked::texOffset(),
+                                      VertexBillboardPacked::texCoupleSize,
+                                      VertexBillboardPacked::stride());
+    VertexPacking::setAttributeBuffer(2, GL_SHORT, false,
+                                      VertexBillboardPacked::cornerOffset(),
+                                      VertexBillboardPacked::cornerTupleSize,
+                                      VertexBillboardPacked::stride());
+    packing.bindIndexes(indexBuffer, vertices.size());
+
+    // Releases
+    vao.release();
+    vertexBuffer.release();
+    program->release();
+}
+
+// -------------------------------------------------------
+
+void Map::updateGLTiled(QOpenGLBuffer &vertexBuffer,
+                        QOpenGLBuffer &indexBuffer,
+                        QVector<VertexTiled> &vertices,
+                        QOpenGLVertexArrayObject &vao,
+                        QOpenGLShaderProgram* program,
+                        VertexPacking& packing)
+{
+    program->bind();
+
+    // Pack the vertices relatively to their bounding box
+    QVector3D min, max;
+    for (int i = 0; i < vertices.size(); i++) {
+        VertexPacking::updateBounds(min, max, vertices.at(i).position(),
+                                    i == 0);
+    }
+    packing.setBounds(min, max);
+    QVector<VertexTiledPacked> packed;
+    packed.reserve(vertices.size());
+    for (int i = 0; i < vertices.size(); i++)
+        packed.append(VertexTiledPacked(vertices.at(i), packing));
+
+    // If existing VAO or VBO, destroy it
+    if (vao.isCreated())
+        vao.destroy();
+    if (vertexBuffer.isCreated())
+        vertexBuffer.destroy();
 
-    // Create new VBO for indexes
-    indexBuffer.create();
-    indexBuffer.bind();
-    indexBuffer.setUsagePattern(QOpenGLBuffer::StaticDraw);
-    indexBuffer.allocate(indexes.constData(),
-                         indexes.size() * sizeof(GLuint));
+    // Create new VBO for vertex
+    vertexBuffer.create();
+    vertexBuffer.bind();
+    vertexBuffer.setUsagePattern(QOpenGLBuffer::StaticDraw);
+    vertexBuffer.allocate(packed.constData(),
+                          packed.size() * sizeof(VertexTiledPacked));
+    packing.setVerticesBytes(packed.size() * sizeof(VertexTiledPacked));
 
     // Create new VAO
     vao.create();
     vao.bind();
-    program->enableAttributeArray(0);
-    program->enableAttributeArray(1);
-    program->enableAttributeArray(2);
-    program->enableAttributeArray(3);
-    program->setAttributeBuffer(0, GL_FLOAT, VertexBillboard::positionOffset(),
-                                VertexBillboard::positionTupleSize,
-                                VertexBillboard::stride());
-    program->setAttributeBuffer(1, GL_FLOAT, VertexBillboard::texOffset(),
-                                VertexBillboard::texCoupleSize,
-                                VertexBillboard::stride());
-    program->setAttributeBuffer(2, GL_FLOAT, VertexBillboard::sizeOffset(),
-                                VertexBillboard::sizeCoupleSize,
-                                VertexBillboard::stride());
-    program->setAttributeBuffer(3, GL_FLOAT, VertexBillboard::modelOffset(),
-                                VertexBillboard::modelTupleSize,
-                                VertexBillboard::stride());
-    indexBuffer.bind();
+    VertexPacking::setAttributeBuffer(0, GL_SHORT, false,
+                                      VertexTiledPacked::positionOffset(),
+                                      VertexTiledPacked::positionTupleSize,
+                                      VertexTiledPacked::stride());
+    VertexPacking::setAttributeBuffer(1, GL_SHORT, false,
+                                      VertexTiledPacked::texOffset(),
+                                      VertexTiledPacked::texCoupleSize,
+                                      VertexTiledPacked::stride());
+    VertexPacking::setAttributeBuffer(2, GL_UNSIGNED_SHORT, true,
+                                      VertexTiledPacked::texRectOffset(),
+                                      VertexTiledPacked::texRectQuadrupletSize,
+                                      VertexTiledPacked::stride());
+    packing.bindIndexes(indexBuffer, vertices.size());
 
     // Releases
     vao.release();
-    indexBuffer.release();
     vertexBuffer.release();
     program->release();
 }
@@ -1152,6 +1437,18 @@ void Map::paintFloors(QMatrix4x4& modelviewProjection)
     }
 
     m_programStatic->release();
+
+    // Merged floors layers
+    m_programTiled->bind();
+    m_programTiled->setUniformValue(u_modelviewProjectionTiled,
+                                    modelviewProjection);
+    for (int i = 0; i < totalSize; i++) {
+        MapPortion* mapPortion = this->mapPortionBrut(i);
+        if (mapPortion != nullptr && mapPortion->isVisibleLoaded())
+            mapPortion->paintFloorsTiled();
+    }
+
+    m_programTiled->release();
 }
 
 // -------------------------------------------------------
@@ -1168,14 +1465,14 @@ void Map::paintOthers(QMatrix4x4 &modelviewProjection,
     m_programStatic->setUniformValue(u_modelviewProjectionStatic,
                                      modelviewProjection);
 
-    // Sprites
-    m_textureTileset->bind();
+    // Sprites and walls, binding the arena of each portion only once
     for (int i = 0; i < totalSize; i++) {
         mapPortion = this->mapPortionBrut(i);
-        if (mapPortion != nullptr && mapPortion->isVisibleLoaded())
-            mapPortion->paintSprites();
+        if (mapPortion != nullptr && mapPortion->isVisibleLoaded()) {
+            mapPortion->paintSprites(m_textureTileset,
+                                     m_texturesSpriteWalls);
+        }
     }
-    m_textureTileset->release();
 
     // Objects
     QHash<int, QOpenGLTexture*>::iterator it;
@@ -1191,22 +1488,6 @@ void Map::paintOthers(QMatrix4x4 &modelviewProjection,
         }
     }
 
-    // Walls
-    QHash<int, QOpenGLTexture*>::iterator itWalls;
-    for (itWalls = m_texturesSpriteWalls.begin();
-         itWalls != m_texturesSpriteWalls.end(); itWalls++)
-    {
-        int textureID = itWalls.key();
-        QOpenGLTexture* texture = itWalls.value();
-        texture->bind();
-        for (int i = 0; i < totalSize; i++) {
-            mapPortion = this->mapPortionBrut(i);
-            if (mapPortion != nullptr && mapPortion->isVisibleLoaded())
-                mapPortion->paintSpritesWalls(textureID);
-        }
-        texture->release();
-    }
-
     // Face sprites
     m_programStatic->release();
     m_programFaceSprite->bind();
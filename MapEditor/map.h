@@ -27,6 +27,9 @@
 #include "systemcommonobject.h"
 #include "threadmapportionloader.h"
 #include "cursor.h"
+#include "vertexpacked.h"
+#include "vertexbillboardpacked.h"
+#include "vertextiledpacked.h"
 
 // -------------------------------------------------------
 //
@@ -43,6 +46,8 @@ public:
     Map(int id);
     Map(MapProperties* properties);
     virtual ~Map();
+    static const int MIN_PORTIONS_RAY;
+    static const int MEMORY_PER_FILE_BYTE;
     MapProperties* mapProperties() const;
     void setMapProperties(MapProperties* p);
     Cursor* cursor() const;
@@ -51,6 +56,8 @@ public:
     bool saved() const;
     void setSaved(bool b);
     QStandardItemModel* modelObjects() const;
+    QOpenGLTexture* textureTileset() const;
+    const QHash<int, QOpenGLTexture*>& texturesSpriteWalls() const;
     MapPortion* mapPortion(Portion& p) const;
     MapPortion* mapPortionFromGlobal(Portion& p) const;
     MapPortion* mapPortion(int x, int y, int z) const;
@@ -95,15 +102,27 @@ public:
     static void updateGLStatic(QOpenGLBuffer& vertexBuffer,
                                QOpenGLBuffer& indexBuffer,
                                QVector<Vertex>& vertices,
-                               QVector<GLuint>& indexes,
                                QOpenGLVertexArrayObject& vao,
-                               QOpenGLShaderProgram* program);
+                               QOpenGLShaderProgram* program,
+                               VertexPacking& packing);
+    static void updateGLStatic(QOpenGLBuffer& vertexBuffer,
+                               QOpenGLBuffer& indexBuffer,
+                               const QList<QVector<Vertex>>& vertices,
+                               QOpenGLVertexArrayObject& vao,
+                               QOpenGLShaderProgram* program,
+                               VertexPacking& packing);
     static void updateGLFace(QOpenGLBuffer& vertexBuffer,
                              QOpenGLBuffer& indexBuffer,
                              QVector<VertexBillboard>& vertices,
-                             QVector<GLuint>& indexes,
                              QOpenGLVertexArrayObject& vao,
-                             QOpenGLShaderProgram* program);
+                             QOpenGLShaderProgram* program,
+                             VertexPacking& packing);
+    static void updateGLTiled(QOpenGLBuffer& vertexBuffer,
+                              QOpenGLBuffer& indexBuffer,
+                              QVector<VertexTiled>& vertices,
+                              QOpenGLVertexArrayObject& vao,
+                              QOpenGLShaderProgram* program,
+                              VertexPacking& packing);
     void loadTextures();
     void deleteTextures();
     void loadCharactersTextures();
@@ -131,6 +150,9 @@ public:
     void updateMapObjects();
     void loadPortions(Portion portion);
     void deletePortions();
+    void updateMemoryUsage(MapMemoryUsage& usage) const;
+    void addTexturesMemoryUsage(MapMemoryUsage& usage) const;
+    bool updatePortionsRay(Portion portion);
     bool isInGrid(Position3D& position) const;
     bool isPortionInGrid(Portion& portion) const;
     bool isInPortion(Portion& portion, int offset = -1) const;
@@ -185,11 +207,24 @@ private:
     int u_cameraDeepWorldspace;
     int u_modelViewProjection;
 
+    // Merged floors program
+    QOpenGLShaderProgram* m_programTiled;
+    int u_modelviewProjectionTiled;
+
     // Textures
     QOpenGLTexture* m_textureTileset;
     QHash<int, QOpenGLTexture*> m_texturesCharacters;
     QHash<int, QOpenGLTexture*> m_texturesSpriteWalls;
     QOpenGLTexture* m_textureObjectSquare;
+
+    // Memory budget
+    int m_maxPortionsRay;
+    QHash<Portion, qint64> m_portionsMemory;
+    qint64 m_portionsMemoryLoaded;
+    qint64 m_portionsFilesLoaded;
+
+    qint64 portionMemory(int i, int j, int k);
+    void addPortionMemory(MapPortion* mapPortion, qint64 fileSize);
 };
 
 #endif // MAP_H
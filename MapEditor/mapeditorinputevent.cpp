@@ -0,0 +1,226 @@
+/*
+    RPG Paper Maker Copyright (C) 2017 Marie Laporte
+
+    This file is part of RPG Paper Maker.
+
+    RPG Paper Maker is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    RPG Paper Maker is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with Foobar.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include "mapeditorinputevent.h"
+
+// -------------------------------------------------------
+//
+//  CONSTRUCTOR / DESTRUCTOR / GET / SET
+//
+// -------------------------------------------------------
+
+MapEditorInputEvent::MapEditorInputEvent() :
+    MapEditorInputEvent(MapEditorInputKind::MouseMove)
+{
+
+}
+
+MapEditorInputEvent::MapEditorInputEvent(MapEditorInputKind kind,
+                                         const QInputEvent* event) :
+    m_frame(0),
+    m_kind(kind),
+    m_button(Qt::NoButton),
+    m_buttons(Qt::NoButton),
+    m_modifiers(event == nullptr ? Qt::NoModifier : (int) event->modifiers()),
+    m_key(0),
+    m_delta(0),
+    m_autoRepeat(false),
+    m_selectionKind(MapEditorSelectionKind::Land),
+    m_subSelectionKind(MapEditorSubSelectionKind::None),
+    m_drawKind(DrawKind::Pencil),
+    m_layerOn(false),
+    m_specialID(-1)
+{
+    if (event == nullptr)
+        return;
+
+    switch (kind) {
+    case MapEditorInputKind::MouseMove:
+    case MapEditorInputKind::MousePress:
+    case MapEditorInputKind::MouseRelease:
+    case MapEditorInputKind::MouseDoubleClick: {
+        const QMouseEvent* mouse = static_cast<const QMouseEvent*>(event);
+        m_position = mouse->pos();
+        m_button = mouse->button();
+        m_buttons = mouse->buttons();
+        break;
+    }
+    case MapEditorInputKind::Wheel: {
+        const QWheelEvent* wheel = static_cast<const QWheelEvent*>(event);
+        m_position = wheel->pos();
+        m_buttons = wheel->buttons();
+        m_delta = wheel->delta();
+        break;
+    }
+    case MapEditorInputKind::KeyPress:
+    case MapEditorInputKind::KeyRelease: {
+        const QKeyEvent* key = static_cast<const QKeyEvent*>(event);
+        m_key = key->key();
+        m_autoRepeat = key->isAutoRepeat();
+        break;
+    }
+    default:
+        break;
+    }
+}
+
+MapEditorInputEvent::MapEditorInputEvent(
+        MapEditorSelectionKind selectionKind,
+        MapEditorSubSelectionKind subSelectionKind, DrawKind drawKind,
+        bool layerOn, const QRect& tileset, int specialID) :
+    MapEditorInputEvent(MapEditorInputKind::Selection)
+{
+    m_selectionKind = selectionKind;
+    m_subSelectionKind = subSelectionKind;
+    m_drawKind = drawKind;
+    m_layerOn = layerOn;
+    m_tileset = tileset;
+    m_specialID = specialID;
+}
+
+MapEditorInputEvent::MapEditorInputEvent(int x, int z) :
+    MapEditorInputEvent(MapEditorInputKind::Teleport)
+{
+    m_position = QPoint(x, z);
+}
+
+int MapEditorInputEvent::frame() const { return m_frame; }
+
+void MapEditorInputEvent::setFrame(int frame) { m_frame = frame; }
+
+MapEditorInputKind MapEditorInputEvent::kind() const { return m_kind; }
+
+QPoint MapEditorInputEvent::position() const { return m_position; }
+
+Qt::MouseButton MapEditorInputEvent::button() const {
+    return static_cast<Qt::MouseButton>(m_button);
+}
+
+Qt::MouseButtons MapEditorInputEvent::buttons() const {
+    return Qt::MouseButtons(m_buttons);
+}
+
+Qt::KeyboardModifiers MapEditorInputEvent::modifiers() const {
+    return Qt::KeyboardModifiers(m_modifiers);
+}
+
+int MapEditorInputEvent::key() const { return m_key; }
+
+int MapEditorInputEvent::delta() const { return m_delta; }
+
+bool MapEditorInputEvent::autoRepeat() const { return m_autoRepeat; }
+
+MapEditorSelectionKind MapEditorInputEvent::selectionKind() const {
+    return m_selectionKind;
+}
+
+MapEditorSubSelectionKind MapEditorInputEvent::subSelectionKind() const {
+    return m_subSelectionKind;
+}
+
+DrawKind MapEditorInputEvent::drawKind() const { return m_drawKind; }
+
+bool MapEditorInputEvent::layerOn() const { return m_layerOn; }
+
+QRect MapEditorInputEvent::tileset() const { return m_tileset; }
+
+int MapEditorInputEvent::specialID() const { return m_specialID; }
+
+// -------------------------------------------------------
+//
+//  INTERMEDIARY FUNCTIONS
+//
+// -------------------------------------------------------
+
+bool MapEditorInputEvent::isSameSelection(
+        MapEditorSelectionKind selectionKind,
+        MapEditorSubSelectionKind subSelectionKind, DrawKind drawKind,
+        bool layerOn, const QRect& tileset, int specialID) const
+{
+    return m_selectionKind == selectionKind &&
+           m_subSelectionKind == subSelectionKind &&
+           m_drawKind == drawKind && m_layerOn == layerOn &&
+           m_tileset == tileset && m_specialID == specialID;
+}
+
+// -------------------------------------------------------
+//
+//  READ / WRITE
+//
+// -------------------------------------------------------
+
+void MapEditorInputEvent::read(const QJsonObject &json) {
+    m_frame = json["f"].toInt();
+    m_kind = static_cast<MapEditorInputKind>(json["k"].toInt());
+    m_position = QPoint(json["x"].toInt(), json["y"].toInt());
+    m_button = json["b"].toInt();
+    m_buttons = json["bs"].toInt();
+    m_modifiers = json["m"].toInt();
+    m_key = json["key"].toInt();
+    m_delta = json["d"].toInt();
+    m_autoRepeat = json["r"].toBool();
+    if (m_kind == MapEditorInputKind::Selection) {
+        m_selectionKind = static_cast<MapEditorSelectionKind>(
+                    json["s"].toInt());
+        m_subSelectionKind = static_cast<MapEditorSubSelectionKind>(
+                    json["ss"].toInt());
+        m_drawKind = static_cast<DrawKind>(json["dk"].toInt());
+        m_layerOn = json["l"].toBool();
+        QJsonArray tab = json["t"].toArray();
+        m_tileset = QRect(tab[0].toInt(), tab[1].toInt(), tab[2].toInt(),
+                          tab[3].toInt());
+        m_specialID = json["id"].toInt();
+    }
+}
+
+// -------------------------------------------------------
+
+void MapEditorInputEvent::write(QJsonObject &json) const {
+    json["f"] = m_frame;
+    json["k"] = (int) m_kind;
+    if (!m_position.isNull()) {
+        json["x"] = m_position.x();
+        json["y"] = m_position.y();
+    }
+    if (m_button != Qt::NoButton)
+        json["b"] = m_button;
+    if (m_buttons != Qt::NoButton)
+        json["bs"] = m_buttons;
+    if (m_modifiers != Qt::NoModifier)
+        json["m"] = m_modifiers;
+    if (m_key != 0)
+        json["key"] = m_key;
+    if (m_delta != 0)
+        json["d"] = m_delta;
+    if (m_autoRepeat)
+        json["r"] = m_autoRepeat;
+    if (m_kind == MapEditorInputKind::Selection) {
+        json["s"] = (int) m_selectionKind;
+        json["ss"] = (int) m_subSelectionKind;
+        json["dk"] = (int) m_drawKind;
+        json["l"] = m_layerOn;
+        QJsonArray tab;
+        tab.append(m_tileset.x());
+        tab.append(m_tileset.y());
+        tab.append(m_tileset.width());
+        tab.append(m_tileset.height());
+        json["t"] = tab;
+        json["id"] = m_specialID;
+    }
+}
@@ -0,0 +1,94 @@
+/*
+    RPG Paper Maker Copyright (C) 2017 Marie Laporte
+
+    This file is part of RPG Paper Maker.
+
+    RPG Paper Maker is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    RPG Paper Maker is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with Foobar.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#ifndef MAPEDITORINPUTEVENT_H
+#define MAPEDITORINPUTEVENT_H
+
+#include <QInputEvent>
+#include <QRect>
+#include "serializable.h"
+#include "mapeditorinputkind.h"
+#include "mapeditorselectionkind.h"
+#include "mapeditorsubselectionkind.h"
+#include "drawkind.h"
+
+// -------------------------------------------------------
+//
+//  CLASS MapEditorInputEvent
+//
+//  An input of the map editor recorded in a replay: a mouse, wheel or
+//  keyboard event, a change of the selection in the menu bar and the
+//  textures panel, an undo / redo or a teleport from the minimap.
+//
+// -------------------------------------------------------
+
+class MapEditorInputEvent : public Serializable
+{
+public:
+    MapEditorInputEvent();
+    MapEditorInputEvent(MapEditorInputKind kind,
+                        const QInputEvent* event = nullptr);
+    MapEditorInputEvent(MapEditorSelectionKind selectionKind,
+                        MapEditorSubSelectionKind subSelectionKind,
+                        DrawKind drawKind, bool layerOn, const QRect& tileset,
+                        int specialID);
+    MapEditorInputEvent(int x, int z);
+    int frame() const;
+    void setFrame(int frame);
+    MapEditorInputKind kind() const;
+    QPoint position() const;
+    Qt::MouseButton button() const;
+    Qt::MouseButtons buttons() const;
+    Qt::KeyboardModifiers modifiers() const;
+    int key() const;
+    int delta() const;
+    bool autoRepeat() const;
+    MapEditorSelectionKind selectionKind() const;
+    MapEditorSubSelectionKind subSelectionKind() const;
+    DrawKind drawKind() const;
+    bool layerOn() const;
+    QRect tileset() const;
+    int specialID() const;
+    bool isSameSelection(MapEditorSelectionKind selectionKind,
+                         MapEditorSubSelectionKind subSelectionKind,
+                         DrawKind drawKind, bool layerOn,
+                         const QRect& tileset, int specialID) const;
+
+    virtual void read(const QJsonObject &json);
+    virtual void write(QJsonObject &json) const;
+
+protected:
+    int m_frame;
+    MapEditorInputKind m_kind;
+    QPoint m_position;
+    int m_button;
+    int m_buttons;
+    int m_modifiers;
+    int m_key;
+    int m_delta;
+    bool m_autoRepeat;
+    MapEditorSelectionKind m_selectionKind;
+    MapEditorSubSelectionKind m_subSelectionKind;
+    DrawKind m_drawKind;
+    bool m_layerOn;
+    QRect m_tileset;
+    int m_specialID;
+};
+
+#endif // MAPEDITORINPUTEVENT_H
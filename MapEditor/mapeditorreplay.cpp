@@ -0,0 +1,362 @@
+/*
+    RPG Paper Maker Copyright (C) 2017 Marie Laporte
+
+    This file is part of RPG Paper Maker.
+
+    RPG Paper Maker is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    RPG Paper Maker is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with Foobar.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include "mapeditorreplay.h"
+
+// -------------------------------------------------------
+//
+//  CONSTRUCTOR / DESTRUCTOR / GET / SET
+//
+// -------------------------------------------------------
+
+MapEditorReplay::MapEditorReplay() :
+    m_idMap(-1),
+    m_cursorX(0),
+    m_cursorZ(0),
+    m_cameraDistance(0),
+    m_cameraHorizontalAngle(0),
+    m_cameraVerticalAngle(0),
+    m_recording(false),
+    m_replaying(false),
+    m_dispatching(false),
+    m_frame(0),
+    m_nextEvent(0),
+    m_selection(nullptr)
+{
+
+}
+
+MapEditorReplay::~MapEditorReplay()
+{
+    clear();
+}
+
+bool MapEditorReplay::isRecording() const { return m_recording; }
+
+bool MapEditorReplay::isReplaying() const { return m_replaying; }
+
+bool MapEditorReplay::isInputIgnored() const {
+    return m_replaying && !m_dispatching;
+}
+
+void MapEditorReplay::setDispatching(bool dispatching) {
+    m_dispatching = dispatching;
+}
+
+int MapEditorReplay::idMap() const { return m_idMap; }
+
+int MapEditorReplay::cursorX() const { return m_cursorX; }
+
+int MapEditorReplay::cursorZ() const { return m_cursorZ; }
+
+int MapEditorReplay::cameraDistance() const { return m_cameraDistance; }
+
+double MapEditorReplay::cameraHorizontalAngle() const {
+    return m_cameraHorizontalAngle;
+}
+
+double MapEditorReplay::cameraVerticalAngle() const {
+    return m_cameraVerticalAngle;
+}
+
+QSize MapEditorReplay::size() const { return m_size; }
+
+int MapEditorReplay::framesCount() const { return m_framesElapsed.size(); }
+
+int MapEditorReplay::eventsCount() const { return m_events.size(); }
+
+int MapEditorReplay::frameElapsed() const {
+    return m_framesElapsed.at(m_frame);
+}
+
+bool MapEditorReplay::frameFirstPressure() const {
+    return m_framesFirstPressure.at(m_frame);
+}
+
+QPoint MapEditorReplay::frameMouse() const {
+    return m_framesMouse.at(m_frame);
+}
+
+const MapEditorInputEvent* MapEditorReplay::selection() const {
+    return m_selection;
+}
+
+// -------------------------------------------------------
+//
+//  INTERMEDIARY FUNCTIONS
+//
+// -------------------------------------------------------
+
+void MapEditorReplay::clear() {
+    for (int i = 0; i < m_events.size(); i++)
+        delete m_events.at(i);
+    m_events.clear();
+    m_framesElapsed.clear();
+    m_framesFirstPressure.clear();
+    m_framesMouse.clear();
+    m_timings.clear();
+    m_recording = false;
+    m_replaying = false;
+    m_dispatching = false;
+    m_frame = 0;
+    m_nextEvent = 0;
+    m_selection = nullptr;
+}
+
+// -------------------------------------------------------
+
+void MapEditorReplay::startRecording(int idMap, int cursorX, int cursorZ,
+                                     int cameraDistance,
+                                     double cameraHorizontalAngle,
+                                     double cameraVerticalAngle, QSize size)
+{
+    clear();
+    m_idMap = idMap;
+    m_cursorX = cursorX;
+    m_cursorZ = cursorZ;
+    m_cameraDistance = cameraDistance;
+    m_cameraHorizontalAngle = cameraHorizontalAngle;
+    m_cameraVerticalAngle = cameraVerticalAngle;
+    m_size = size;
+    m_recording = true;
+}
+
+// -------------------------------------------------------
+
+void MapEditorReplay::stopRecording() {
+    m_recording = false;
+    m_selection = nullptr;
+}
+
+// -------------------------------------------------------
+//  addEvent: the event is applied before painting the next frame
+
+void MapEditorReplay::addEvent(MapEditorInputEvent* event) {
+    event->setFrame(m_frame);
+    m_events.append(event);
+}
+
+// -------------------------------------------------------
+
+void MapEditorReplay::updateSelection(
+        MapEditorSelectionKind selectionKind,
+        MapEditorSubSelectionKind subSelectionKind, DrawKind drawKind,
+        bool layerOn, const QRect& tileset, int specialID)
+{
+    if (m_selection != nullptr &&
+        m_selection->isSameSelection(selectionKind, subSelectionKind,
+                                     drawKind, layerOn, tileset, specialID))
+    {
+        return;
+    }
+
+    MapEditorInputEvent* event = new MapEditorInputEvent(
+                selectionKind, subSelectionKind, drawKind, layerOn, tileset,
+                specialID);
+    addEvent(event);
+    m_selection = event;
+}
+
+// -------------------------------------------------------
+
+void MapEditorReplay::addFrame(int elapsed, bool firstPressure,
+                               QPoint mouse)
+{
+    m_framesElapsed.append(elapsed);
+    m_framesFirstPressure.append(firstPressure);
+    m_framesMouse.append(mouse);
+    m_frame++;
+}
+
+// -------------------------------------------------------
+
+bool MapEditorReplay::startReplay() {
+    m_recording = false;
+    m_frame = 0;
+    m_nextEvent = 0;
+    m_selection = nullptr;
+    m_timings.clear();
+    m_timings.reserve(framesCount());
+    m_replaying = framesCount() > 0;
+
+    return m_replaying;
+}
+
+// -------------------------------------------------------
+
+void MapEditorReplay::stopReplay() {
+    m_replaying = false;
+    m_dispatching = false;
+}
+
+// -------------------------------------------------------
+//  nextFrameEvent: the selection changes are only applied here, the other
+//  events are given back to be dispatched to the widget
+
+MapEditorInputEvent* MapEditorReplay::nextFrameEvent() {
+    while (m_nextEvent < m_events.size()) {
+        MapEditorInputEvent* event = m_events.at(m_nextEvent);
+        if (event->frame() > m_frame)
+            return nullptr;
+
+        m_nextEvent++;
+        if (event->kind() == MapEditorInputKind::Selection)
+            m_selection = event;
+        else
+            return event;
+    }
+
+    return nullptr;
+}
+
+// -------------------------------------------------------
+
+bool MapEditorReplay::endReplayFrame(qint64 nsecs) {
+    m_timings.append(nsecs);
+    m_frame++;
+    if (m_frame >= framesCount())
+        stopReplay();
+
+    return !m_replaying;
+}
+
+// -------------------------------------------------------
+
+double MapEditorReplay::timingPercentile(const QVector<qint64>& sorted,
+                                         int percent)
+{
+    if (sorted.isEmpty())
+        return 0;
+
+    int index = qMin(sorted.size() - 1, sorted.size() * percent / 100);
+
+    return sorted.at(index) / 1000000.0;
+}
+
+// -------------------------------------------------------
+
+void MapEditorReplay::writeTimings(QJsonObject& json) const {
+    QVector<qint64> sorted(m_timings);
+    qSort(sorted);
+    qint64 total = 0;
+    QJsonArray tab;
+    for (int i = 0; i < m_timings.size(); i++) {
+        total += m_timings.at(i);
+        tab.append(m_timings.at(i) / 1000000.0);
+    }
+
+    json["map"] = m_idMap;
+    json["frames"] = m_timings.size();
+    json["events"] = m_events.size();
+    json["totalMs"] = total / 1000000.0;
+    json["averageMs"] = m_timings.isEmpty() ? 0 : total / 1000000.0 /
+                                              m_timings.size();
+    json["minMs"] = timingPercentile(sorted, 0);
+    json["p50Ms"] = timingPercentile(sorted, 50);
+    json["p95Ms"] = timingPercentile(sorted, 95);
+    json["p99Ms"] = timingPercentile(sorted, 99);
+    json["maxMs"] = sorted.isEmpty() ? 0 : sorted.last() / 1000000.0;
+    json["framesMs"] = tab;
+}
+
+// -------------------------------------------------------
+
+QString MapEditorReplay::timingsToString() const {
+    QJsonObject json;
+    writeTimings(json);
+
+    return QString::number(json["frames"].toInt()) + " frames in " +
+            QString::number(json["totalMs"].toDouble(), 'f', 1) +
+            " ms\nAverage: " +
+            QString::number(json["averageMs"].toDouble(), 'f', 2) +
+            " ms, median: " +
+            QString::number(json["p50Ms"].toDouble(), 'f', 2) +
+            " ms, 95%: " + QString::number(json["p95Ms"].toDouble(), 'f', 2) +
+            " ms, max: " + QString::number(json["maxMs"].toDouble(), 'f', 2) +
+            " ms";
+}
+
+// -------------------------------------------------------
+//
+//  READ / WRITE
+//
+// -------------------------------------------------------
+
+void MapEditorReplay::read(const QJsonObject &json) {
+    clear();
+    m_idMap = json["map"].toInt(-1);
+    m_cursorX = json["cx"].toInt();
+    m_cursorZ = json["cz"].toInt();
+    m_cameraDistance = json["cd"].toInt();
+    m_cameraHorizontalAngle = json["ch"].toDouble();
+    m_cameraVerticalAngle = json["cv"].toDouble();
+    m_size = QSize(json["w"].toInt(), json["h"].toInt());
+
+    // Frames
+    QJsonArray tab = json["frames"].toArray();
+    for (int i = 0; i < tab.size(); i++) {
+        QJsonArray tabFrame = tab.at(i).toArray();
+        m_framesElapsed.append(tabFrame[0].toInt());
+        m_framesFirstPressure.append(tabFrame[1].toBool());
+        m_framesMouse.append(QPoint(tabFrame[2].toInt(),
+                                    tabFrame[3].toInt()));
+    }
+
+    // Events
+    tab = json["events"].toArray();
+    for (int i = 0; i < tab.size(); i++) {
+        MapEditorInputEvent* event = new MapEditorInputEvent;
+        event->read(tab.at(i).toObject());
+        m_events.append(event);
+    }
+}
+
+// -------------------------------------------------------
+
+void MapEditorReplay::write(QJsonObject &json) const {
+    json["map"] = m_idMap;
+    json["cx"] = m_cursorX;
+    json["cz"] = m_cursorZ;
+    json["cd"] = m_cameraDistance;
+    json["ch"] = m_cameraHorizontalAngle;
+    json["cv"] = m_cameraVerticalAngle;
+    json["w"] = m_size.width();
+    json["h"] = m_size.height();
+
+    // Frames
+    QJsonArray tab;
+    for (int i = 0; i < m_framesElapsed.size(); i++) {
+        QJsonArray tabFrame;
+        tabFrame.append(m_framesElapsed.at(i));
+        tabFrame.append(m_framesFirstPressure.at(i));
+        tabFrame.append(m_framesMouse.at(i).x());
+        tabFrame.append(m_framesMouse.at(i).y());
+        tab.append(tabFrame);
+    }
+    json["frames"] = tab;
+
+    // Events
+    tab = QJsonArray();
+    for (int i = 0; i < m_events.size(); i++) {
+        QJsonObject obj;
+        m_events.at(i)->write(obj);
+        tab.append(obj);
+    }
+    json["events"] = tab;
+}
@@ -0,0 +1,108 @@
+/*
+    RPG Paper Maker Copyright (C) 2017 Marie Laporte
+
+    This file is part of RPG Paper Maker.
+
+    RPG Paper Maker is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    RPG Paper Maker is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with Foobar.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#ifndef MAPEDITORREPLAY_H
+#define MAPEDITORREPLAY_H
+
+#include <QVector>
+#include <QSize>
+#include "mapeditorinputevent.h"
+
+// -------------------------------------------------------
+//
+//  CLASS MapEditorReplay
+//
+//  The inputs of the map editor recorded frame by frame, with the state
+//  of the cursor and the camera at the beginning. Replaying them on the
+//  same map of the same saved project paints the same frames, so the
+//  time spent in each frame can be compared between versions.
+//
+// -------------------------------------------------------
+
+class MapEditorReplay : public Serializable
+{
+public:
+    MapEditorReplay();
+    virtual ~MapEditorReplay();
+    bool isRecording() const;
+    bool isReplaying() const;
+    bool isInputIgnored() const;
+    void setDispatching(bool dispatching);
+    int idMap() const;
+    int cursorX() const;
+    int cursorZ() const;
+    int cameraDistance() const;
+    double cameraHorizontalAngle() const;
+    double cameraVerticalAngle() const;
+    QSize size() const;
+    int framesCount() const;
+    int eventsCount() const;
+    int frameElapsed() const;
+    bool frameFirstPressure() const;
+    QPoint frameMouse() const;
+    const MapEditorInputEvent* selection() const;
+
+    void clear();
+    void startRecording(int idMap, int cursorX, int cursorZ,
+                        int cameraDistance, double cameraHorizontalAngle,
+                        double cameraVerticalAngle, QSize size);
+    void stopRecording();
+    void addEvent(MapEditorInputEvent* event);
+    void updateSelection(MapEditorSelectionKind selectionKind,
+                         MapEditorSubSelectionKind subSelectionKind,
+                         DrawKind drawKind, bool layerOn,
+                         const QRect& tileset, int specialID);
+    void addFrame(int elapsed, bool firstPressure, QPoint mouse);
+    bool startReplay();
+    void stopReplay();
+    MapEditorInputEvent* nextFrameEvent();
+    bool endReplayFrame(qint64 nsecs);
+    void writeTimings(QJsonObject& json) const;
+    QString timingsToString() const;
+
+    virtual void read(const QJsonObject &json);
+    virtual void write(QJsonObject &json) const;
+
+protected:
+    int m_idMap;
+    int m_cursorX;
+    int m_cursorZ;
+    int m_cameraDistance;
+    double m_cameraHorizontalAngle;
+    double m_cameraVerticalAngle;
+    QSize m_size;
+    QList<MapEditorInputEvent*> m_events;
+    QVector<int> m_framesElapsed;
+    QVector<bool> m_framesFirstPressure;
+    QVector<QPoint> m_framesMouse;
+
+    // Current state of the recording or the replay
+    bool m_recording;
+    bool m_replaying;
+    bool m_dispatching;
+    int m_frame;
+    int m_nextEvent;
+    const MapEditorInputEvent* m_selection;
+    QVector<qint64> m_timings;
+
+    static double timingPercentile(const QVector<qint64>& sorted,
+                                   int percent);
+};
+
+#endif // MAPEDITORREPLAY_H
@@ -134,3 +134,17 @@ void MapElement::write(QJsonObject &json) const{
     if (m_zOffset != 0)
         json[MapElement::jsonZ] = m_zOffset;
 }
+
+// -------------------------------------------------------
+
+bool MapElement::remapTextureRect(QRect& rect, const TexturesRemap& textures)
+{
+    TexturesRemap::const_iterator i = textures.find(
+                QPair<int, int>(rect.x(), rect.y()));
+    if (i == textures.end())
+        return false;
+
+    rect.moveTo(i.value().first, i.value().second);
+
+    return true;
+}
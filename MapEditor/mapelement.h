@@ -27,6 +27,11 @@
 #include "cameraupdownkind.h"
 #include "position.h"
 #include <QVector3D>
+#include <QRect>
+#include <QHash>
+
+// Texture origins (x, y in squares) to replace by other origins
+typedef QHash<QPair<int, int>, QPair<int, int>> TexturesRemap;
 
 // -------------------------------------------------------
 //
@@ -58,6 +63,7 @@ public:
                                   QVector3D& center, QVector3D &offset,
                                   int squareSize, Position &position, int width,
                                   int height, bool front);
+    static bool remapTextureRect(QRect& rect, const TexturesRemap& textures);
 
     virtual void read(const QJsonObject &json);
     virtual void write(QJsonObject &json) const;
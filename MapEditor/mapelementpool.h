@@ -0,0 +1,130 @@
+/*
+    RPG Paper Maker Copyright (C) 2017 Marie Laporte
+
+    This file is part of RPG Paper Maker.
+
+    RPG Paper Maker is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    RPG Paper Maker is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with Foobar.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#ifndef MAPELEMENTPOOL_H
+#define MAPELEMENTPOOL_H
+
+#include <new>
+#include <type_traits>
+#include <QList>
+#include <QMutex>
+
+// -------------------------------------------------------
+//
+//  CLASS MapElementPool
+//
+//  A pool for the small elements of the portions (floors, sprites, walls).
+//  Elements are taken from large blocks, and the slots of the deleted
+//  elements are used again for the next ones. When there are no more
+//  elements of this kind, all the blocks but one are released, so that
+//  adding and removing a single element doesn't allocate a block each time.
+//
+// -------------------------------------------------------
+
+template <class T> class MapElementPool
+{
+public:
+    static void* allocate(size_t size);
+    static void deallocate(void* pointer, size_t size);
+
+    static const int BLOCK_ELEMENTS = 1024;
+
+protected:
+    union Slot {
+        Slot* next;
+        typename std::aligned_storage<sizeof(T), alignof(T)>::type datas;
+    };
+
+    static void linkBlock(Slot* block);
+
+    static QMutex mutex;
+    static QList<Slot*> blocks;
+    static Slot* freeSlots;
+    static int elements;
+};
+
+template <class T> QMutex MapElementPool<T>::mutex;
+template <class T> QList<typename MapElementPool<T>::Slot*>
+    MapElementPool<T>::blocks;
+template <class T> typename MapElementPool<T>::Slot*
+    MapElementPool<T>::freeSlots = nullptr;
+template <class T> int MapElementPool<T>::elements = 0;
+
+// -------------------------------------------------------
+//  allocate: elements of derived classes do not fit in the slots, they
+//  are allocated as usual
+
+template <class T> void* MapElementPool<T>::allocate(size_t size) {
+    if (size != sizeof(T))
+        return ::operator new(size);
+
+    QMutexLocker locker(&mutex);
+    if (freeSlots == nullptr) {
+        Slot* block = new Slot[BLOCK_ELEMENTS];
+        linkBlock(block);
+        blocks.append(block);
+    }
+    Slot* slot = freeSlots;
+    freeSlots = slot->next;
+    elements++;
+
+    return slot;
+}
+
+// -------------------------------------------------------
+
+template <class T> void MapElementPool<T>::deallocate(void* pointer,
+                                                      size_t size)
+{
+    if (pointer == nullptr)
+        return;
+    if (size != sizeof(T)) {
+        ::operator delete(pointer);
+        return;
+    }
+
+    QMutexLocker locker(&mutex);
+    Slot* slot = static_cast<Slot*>(pointer);
+    slot->next = freeSlots;
+    freeSlots = slot;
+    elements--;
+
+    // No more elements (e.g. the map was closed): give the blocks back,
+    // except the first one
+    if (elements == 0 && blocks.size() > 1) {
+        for (int i = 1; i < blocks.size(); i++)
+            delete[] blocks.at(i);
+        Slot* block = blocks.first();
+        blocks.clear();
+        blocks.append(block);
+        linkBlock(block);
+    }
+}
+
+// -------------------------------------------------------
+//  linkBlock: all the slots of the block become the free slots
+
+template <class T> void MapElementPool<T>::linkBlock(Slot* block) {
+    for (int i = 0; i < BLOCK_ELEMENTS - 1; i++)
+        block[i].next = &block[i + 1];
+    block[BLOCK_ELEMENTS - 1].next = nullptr;
+    freeSlots = block;
+}
+
+#endif // MAPELEMENTPOOL_H
@@ -0,0 +1,125 @@
+/*
+    RPG Paper Maker Copyright (C) 2017 Marie Laporte
+
+    This file is part of RPG Paper Maker.
+
+    RPG Paper Maker is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    RPG Paper Maker is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with Foobar.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include "mapmemoryusage.h"
+#include "positionkey.h"
+
+// Key, hash and next pointer of a QHash node, in addition to the value
+const int MapMemoryUsage::HASH_NODE_SIZE = sizeof(PositionKey) + sizeof(uint) +
+                                           sizeof(void*);
+
+// -------------------------------------------------------
+//
+//  CONSTRUCTOR / DESTRUCTOR / GET / SET
+//
+// -------------------------------------------------------
+
+MapMemoryUsage::MapMemoryUsage()
+{
+    clear();
+}
+
+qint64 MapMemoryUsage::elements() const { return m_elements; }
+
+qint64 MapMemoryUsage::vertices() const { return m_vertices; }
+
+qint64 MapMemoryUsage::buffers() const { return m_buffers; }
+
+qint64 MapMemoryUsage::textures() const { return m_textures; }
+
+qint64 MapMemoryUsage::total() const {
+    return m_elements + m_vertices + m_buffers + m_textures;
+}
+
+int MapMemoryUsage::portions() const { return m_portions; }
+
+// -------------------------------------------------------
+//
+//  INTERMEDIARY FUNCTIONS
+//
+// -------------------------------------------------------
+
+void MapMemoryUsage::clear() {
+    m_elements = 0;
+    m_vertices = 0;
+    m_buffers = 0;
+    m_textures = 0;
+    m_portions = 0;
+}
+
+// -------------------------------------------------------
+
+void MapMemoryUsage::addPortion() {
+    m_portions++;
+}
+
+// -------------------------------------------------------
+//  addElements: elements stored by pointer in a hash of positions
+
+void MapMemoryUsage::addElements(int count, int elementSize) {
+    m_elements += (qint64) count * (elementSize + HASH_NODE_SIZE +
+                                    sizeof(void*));
+}
+
+// -------------------------------------------------------
+
+void MapMemoryUsage::addVertices(qint64 bytes) {
+    m_vertices += bytes;
+}
+
+// -------------------------------------------------------
+
+void MapMemoryUsage::addBuffers(qint64 bytes) {
+    m_buffers += bytes;
+}
+
+// -------------------------------------------------------
+
+void MapMemoryUsage::addTexture(const QOpenGLTexture* texture) {
+    if (texture == nullptr)
+        return;
+
+    // RGBA 8 bits, mipmaps adding a third of the base level
+    qint64 bytes = (qint64) texture->width() * texture->height() * 4;
+    if (texture->mipLevels() > 1)
+        bytes += bytes / 3;
+    m_textures += bytes;
+}
+
+// -------------------------------------------------------
+
+QString MapMemoryUsage::toString() const {
+    return "Memory: " + bytesToString(total()) + " (" +
+            QString::number(m_portions) + " portions, elements " +
+            bytesToString(m_elements) + ", vertices " +
+            bytesToString(m_vertices) + ", GL buffers " +
+            bytesToString(m_buffers) + ", textures " +
+            bytesToString(m_textures) + ")";
+}
+
+// -------------------------------------------------------
+
+QString MapMemoryUsage::bytesToString(qint64 bytes) {
+    if (bytes < 1024)
+        return QString::number(bytes) + " B";
+    if (bytes < 1024 * 1024)
+        return QString::number(bytes / 1024.0, 'f', 1) + " KB";
+
+    return QString::number(bytes / (1024.0 * 1024.0), 'f', 1) + " MB";
+}
@@ -0,0 +1,70 @@
+/*
+    RPG Paper Maker Copyright (C) 2017 Marie Laporte
+
+    This file is part of RPG Paper Maker.
+
+    RPG Paper Maker is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    RPG Paper Maker is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with Foobar.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#ifndef MAPMEMORYUSAGE_H
+#define MAPMEMORYUSAGE_H
+
+#include <QVector>
+#include <QString>
+#include <QOpenGLTexture>
+
+// -------------------------------------------------------
+//
+//  CLASS MapMemoryUsage
+//
+//  An estimation of the memory used by a loaded map: the elements of the
+//  portions, their vertices kept in RAM, the GL buffers and the textures.
+//
+// -------------------------------------------------------
+
+class MapMemoryUsage
+{
+public:
+    MapMemoryUsage();
+    qint64 elements() const;
+    qint64 vertices() const;
+    qint64 buffers() const;
+    qint64 textures() const;
+    qint64 total() const;
+    int portions() const;
+    void clear();
+    void addPortion();
+    void addElements(int count, int elementSize);
+    void addVertices(qint64 bytes);
+    void addBuffers(qint64 bytes);
+    void addTexture(const QOpenGLTexture* texture);
+    QString toString() const;
+    static QString bytesToString(qint64 bytes);
+
+    template <typename T>
+    void addVertices(const QVector<T>& vertices) {
+        addVertices(vertices.capacity() * (qint64) sizeof(T));
+    }
+
+    static const int HASH_NODE_SIZE;
+
+protected:
+    qint64 m_elements;
+    qint64 m_vertices;
+    qint64 m_buffers;
+    qint64 m_textures;
+    int m_portions;
+};
+
+#endif // MAPMEMORYUSAGE_H
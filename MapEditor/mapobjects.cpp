@@ -30,14 +30,15 @@
 MapObjects::MapObjects() :
     m_vertexBuffer(QOpenGLBuffer::VertexBuffer),
     m_indexBuffer(QOpenGLBuffer::IndexBuffer),
-    m_programStatic(nullptr)
+    m_programStatic(nullptr),
+    m_squares(0)
 {
 
 }
 
 MapObjects::~MapObjects()
 {
-    QHash<Position, SystemCommonObject*>::const_iterator i;
+    QHash<PositionKey, SystemCommonObject*>::const_iterator i;
     for (i = m_all.begin(); i != m_all.end(); i++)
         delete i.value();
 
@@ -116,7 +117,7 @@ void MapObjects::removeObjectsOut(QList<int> &listDeletedObjectsIDs,
                                   MapProperties& properties)
 {
     QList<Position> list;
-    QHash<Position, SystemCommonObject*>::iterator i;
+    QHash<PositionKey, SystemCommonObject*>::iterator i;
     for (i = m_all.begin(); i != m_all.end(); i++) {
         Position position = i.key();
 
@@ -170,7 +171,7 @@ void MapObjects::initializeVertices(int squareSize,
 
     // Objects and their squares
     int count = 0;
-    QHash<Position, SystemCommonObject*>::iterator i;
+    QHash<PositionKey, SystemCommonObject*>::iterator i;
     for (i = m_all.begin(); i != m_all.end(); i++){
         Position position = i.key();
         SystemCommonObject* o = i.value();
@@ -194,9 +195,9 @@ void MapObjects::initializeVertices(int squareSize,
             int height = texture->height() / frames / squareSize;
             SpriteDatas sprite(
                         state->graphicsKind(),
-                        new QRect(state->indexX() * width,
-                                  state->indexY() * height,
-                                  width, height));
+                        QRect(state->indexX() * width,
+                              state->indexY() * height,
+                              width, height));
             SpriteObject* spriteObject = new SpriteObject(sprite, texture);
             spriteObject->initializeVertices(squareSize, position);
 
@@ -229,6 +230,7 @@ void MapObjects::initializeVertices(int squareSize,
 
         count++;
     }
+    m_squares = count;
 }
 
 // -------------------------------------------------------
@@ -276,8 +278,28 @@ void MapObjects::updateGL(){
     }
 
     // Squares of objects
-    Map::updateGLStatic(m_vertexBuffer, m_indexBuffer, m_vertices, m_indexes,
-                        m_vao, m_programStatic);
+    Map::updateGLStatic(m_vertexBuffer, m_indexBuffer, m_vertices, m_vao,
+                        m_programStatic, m_packing);
+    m_vertices = QVector<Vertex>();
+    m_indexes = QVector<GLuint>();
+}
+
+// -------------------------------------------------------
+
+void MapObjects::addMemoryUsage(MapMemoryUsage& usage) const {
+    usage.addElements(m_all.size(), sizeof(SystemCommonObject));
+    usage.addBuffers(m_packing.bufferBytes());
+    QHash<int, QList<SpriteObject*>*>::const_iterator i;
+    for (i = m_spritesStaticGL.begin(); i != m_spritesStaticGL.end(); i++){
+        QList<SpriteObject*>* list = i.value();
+        for (int j = 0; j < list->size(); j++)
+            list->at(j)->addMemoryUsage(usage);
+    }
+    for (i = m_spritesFaceGL.begin(); i != m_spritesFaceGL.end(); i++){
+        QList<SpriteObject*>* list = i.value();
+        for (int j = 0; j < list->size(); j++)
+            list->at(j)->addMemoryUsage(usage);
+    }
 }
 
 // -------------------------------------------------------
@@ -310,7 +332,7 @@ void MapObjects::paintFaceSprites(int textureID, QOpenGLTexture* texture){
 
 void MapObjects::paintSquares(){
     m_vao.bind();
-    glDrawElements(GL_TRIANGLES, m_indexes.size(), GL_UNSIGNED_INT, 0);
+    m_packing.draw(*this, 0, m_squares);
     m_vao.release();
 }
 
@@ -338,12 +360,12 @@ void MapObjects::read(const QJsonObject & json){
 void MapObjects::write(QJsonObject & json) const{
     QJsonArray tab;
 
-    QHash<Position, SystemCommonObject*>::const_iterator i;
+    QHash<PositionKey, SystemCommonObject*>::const_iterator i;
     for (i = m_all.begin(); i != m_all.end(); i++){
         QJsonObject objHash;
         QJsonArray tabKeyPosition;
         QJsonObject objValueObject;
-        i.key().write(tabKeyPosition);
+        i.key().toPosition().write(tabKeyPosition);
         i.value()->write(objValueObject);
         objHash["k"] = tabKeyPosition;
         objHash["v"] = objValueObject;
@@ -28,7 +28,7 @@
 #include <QOpenGLVertexArrayObject>
 #include <QOpenGLTexture>
 #include "serializable.h"
-#include "position.h"
+#include "positionkey.h"
 #include "systemcommonobject.h"
 #include "vertex.h"
 #include "sprites.h"
@@ -65,6 +65,7 @@ public:
     void initializeGL(QOpenGLShaderProgram* programStatic,
                       QOpenGLShaderProgram *programFace);
     void updateGL();
+    void addMemoryUsage(MapMemoryUsage& usage) const;
     void paintStaticSprites(int textureID, QOpenGLTexture* texture);
     void paintFaceSprites(int textureID, QOpenGLTexture* texture);
     void paintSquares();
@@ -73,7 +74,7 @@ public:
     virtual void write(QJsonObject &json) const;
 
 private:
-    QHash<Position, SystemCommonObject*> m_all;
+    QHash<PositionKey, SystemCommonObject*> m_all;
     QHash<int, QList<SpriteObject*>*> m_spritesStaticGL;
     QHash<int, QList<SpriteObject*>*> m_spritesFaceGL;
 
@@ -83,7 +84,11 @@ private:
     QVector<Vertex> m_vertices;
     QVector<GLuint> m_indexes;
     QOpenGLVertexArrayObject m_vao;
+    VertexPacking m_packing;
     QOpenGLShaderProgram* m_programStatic;
+
+    // The vertices are freed once uploaded, only their quads count is kept
+    int m_squares;
 };
 
 #endif // MAPOBJECTS_H
@@ -0,0 +1,452 @@
+/*
+    RPG Paper Maker Copyright (C) 2017 Marie Laporte
+
+    This file is part of RPG Paper Maker.
+
+    RPG Paper Maker is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    RPG Paper Maker is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with Foobar.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include "mappicking.h"
+#include <QOpenGLContext>
+#include <QOpenGLExtraFunctions>
+
+// -------------------------------------------------------
+//
+//  CONSTRUCTOR / DESTRUCTOR / GET / SET
+//
+// -------------------------------------------------------
+
+MapPicking::MapPicking() :
+    m_isSupported(false),
+    m_context(nullptr),
+    m_framebuffer(0),
+    m_renderbufferColor(0),
+    m_renderbufferDepth(0),
+    m_programStatic(nullptr),
+    m_programTiled(nullptr),
+    m_programFace(nullptr),
+    m_isValid(false),
+    m_layerOn(false),
+    m_distanceLand(0),
+    m_distanceSprite(0)
+{
+    for (int i = 0; i < 4; i++) {
+        m_land[i] = 0;
+        m_sprite[i] = 0;
+    }
+}
+
+MapPicking::~MapPicking()
+{
+    if (m_framebuffer != 0 && QOpenGLContext::currentContext() == m_context)
+    {
+        glDeleteFramebuffers(1, &m_framebuffer);
+        glDeleteRenderbuffers(1, &m_renderbufferColor);
+        glDeleteRenderbuffers(1, &m_renderbufferDepth);
+    }
+    delete m_programStatic;
+    delete m_programTiled;
+    delete m_programFace;
+}
+
+bool MapPicking::isSupported() const {
+    return m_isSupported;
+}
+
+// -------------------------------------------------------
+//
+//  INTERMEDIARY FUNCTIONS
+//
+// -------------------------------------------------------
+
+void MapPicking::invalidate() {
+    m_isValid = false;
+}
+
+// -------------------------------------------------------
+
+bool MapPicking::pick(Map* map, QRay3D& ray, QMatrix4x4& projection,
+                      QMatrix4x4& view, const QPoint& mouse, int width,
+                      int height, bool layerOn)
+{
+    if (!m_isSupported || QOpenGLContext::currentContext() != m_context)
+        return false;
+
+    // Only draw again if something changed since the last picking
+    QMatrix4x4 viewProjection = projection * view;
+    if (m_isValid && m_mouse == mouse && m_layerOn == layerOn &&
+        m_viewProjection == viewProjection)
+    {
+        return true;
+    }
+    m_isValid = true;
+    m_mouse = mouse;
+    m_layerOn = layerOn;
+    m_viewProjection = viewProjection;
+
+    // Zoom the projection on the point of the ray so that it fills the 1x1
+    // framebuffer
+    float x = (2.0f * mouse.x()) / width - 1.0f;
+    float y = 1.0f - (2.0f * mouse.y()) / height;
+    QMatrix4x4 modelviewProjection;
+    modelviewProjection.scale(width, height, 1.0f);
+    modelviewProjection.translate(-x, -y, 0.0f);
+    modelviewProjection *= viewProjection;
+
+    // Save the state of the widget
+    GLint previousFramebuffer;
+    GLint previousViewport[4];
+    glGetIntegerv(GL_FRAMEBUFFER_BINDING, &previousFramebuffer);
+    glGetIntegerv(GL_VIEWPORT, previousViewport);
+    GLboolean isBlend = glIsEnabled(GL_BLEND);
+    GLboolean isDepthTest = glIsEnabled(GL_DEPTH_TEST);
+
+    glBindFramebuffer(GL_FRAMEBUFFER, m_framebuffer);
+    glViewport(0, 0, 1, 1);
+    glDisable(GL_BLEND);
+    glEnable(GL_DEPTH_TEST);
+
+    clear();
+    paintLands(map, modelviewProjection);
+    readPixel(m_land, m_distanceLand, modelviewProjection, ray);
+    clear();
+    paintSprites(map, modelviewProjection, view, layerOn);
+    readPixel(m_sprite, m_distanceSprite, modelviewProjection, ray);
+
+    // Restore
+    glBindFramebuffer(GL_FRAMEBUFFER, previousFramebuffer);
+    glViewport(previousViewport[0], previousViewport[1], previousViewport[2],
+               previousViewport[3]);
+    if (isBlend)
+        glEnable(GL_BLEND);
+    if (!isDepthTest)
+        glDisable(GL_DEPTH_TEST);
+
+    return true;
+}
+
+// -------------------------------------------------------
+
+MapElement* MapPicking::getLand(Map* map, Position& position,
+                                float& distance) const
+{
+    MapElement* element = getElement(map, m_land, position);
+    distance = element == nullptr ? 0 : m_distanceLand;
+
+    return element;
+}
+
+// -------------------------------------------------------
+
+MapElement* MapPicking::getSprite(Map* map, Position& position,
+                                  float& distance) const
+{
+    MapElement* element = getElement(map, m_sprite, position);
+    distance = element == nullptr ? 0 : m_distanceSprite;
+
+    return element;
+}
+
+// -------------------------------------------------------
+
+MapElement* MapPicking::getElement(Map* map, const GLuint pixel[4],
+                                   Position& position)
+{
+    MapPickingKind kind = static_cast<MapPickingKind>(pixel[0]);
+    if (kind == MapPickingKind::None)
+        return nullptr;
+
+    MapPortion* mapPortion = map->mapPortionBrut(pixel[1]);
+    if (mapPortion == nullptr)
+        return nullptr;
+
+    return mapPortion->getPickedElement(kind, pixel[2], pixel[3], position);
+}
+
+// -------------------------------------------------------
+
+void MapPicking::clear() {
+    const GLuint none[4] = {0, 0, 0, 0};
+    QOpenGLContext::currentContext()->extraFunctions()
+            ->glClearBufferuiv(GL_COLOR, 0, none);
+    glClear(GL_DEPTH_BUFFER_BIT);
+}
+
+// -------------------------------------------------------
+
+void MapPicking::setIDs(QOpenGLShaderProgram* program, MapPickingKind kind,
+                        int portion, int extra)
+{
+    program->setUniformValue("kind", static_cast<GLuint>(kind));
+    program->setUniformValue("portion", static_cast<GLuint>(portion));
+    if (kind != MapPickingKind::FloorsTiled)
+        program->setUniformValue("extra", static_cast<GLuint>(extra));
+}
+
+// -------------------------------------------------------
+
+void MapPicking::readPixel(GLuint pixel[4], float& distance,
+                           QMatrix4x4& modelviewProjection, QRay3D& ray)
+{
+    GLfloat depth;
+    glReadPixels(0, 0, 1, 1, GL_RGBA_INTEGER, GL_UNSIGNED_INT, pixel);
+    glReadPixels(0, 0, 1, 1, GL_DEPTH_COMPONENT, GL_FLOAT, &depth);
+
+    // The pixel center is the origin of the zoomed projection
+    distance = 0;
+    if (static_cast<MapPickingKind>(pixel[0]) != MapPickingKind::None) {
+        QVector4D point = modelviewProjection.inverted() *
+                QVector4D(0.0f, 0.0f, depth * 2.0f - 1.0f, 1.0f);
+        QVector3D world = point.toVector3DAffine();
+        QVector3D direction = ray.direction();
+        distance = QVector3D::dotProduct(world - ray.origin(), direction) /
+                QVector3D::dotProduct(direction, direction);
+    }
+}
+
+// -------------------------------------------------------
+//
+//  GL
+//
+// -------------------------------------------------------
+
+void MapPicking::initializeGL() {
+    initializeOpenGLFunctions();
+
+    // Integer framebuffers and gl_VertexID need OpenGL 3.0, which is also
+    // what the llvmpipe software renderer of Mesa provides
+    QOpenGLContext* context = QOpenGLContext::currentContext();
+    if (context == nullptr || context->isOpenGLES() ||
+        context->format().majorVersion() < 3)
+    {
+        return;
+    }
+    m_context = context;
+
+    // Programs (the attributes have the locations used by the map VAOs)
+    m_programStatic = createProgram(":/Shaders/picking.vert",
+                                    ":/Shaders/picking.frag",
+                                    QStringList({"position", "texCoord0"}));
+    m_programTiled = createProgram(":/Shaders/pickingTiled.vert",
+                                   ":/Shaders/pickingTiled.frag",
+                                   QStringList({"position", "texCoord0",
+                                                "texRect"}));
+    m_programFace = createProgram(":/Shaders/pickingFace.vert",
+                                  ":/Shaders/picking.frag",
+                                  QStringList({"centerPosition", "texCoord0",
+                                               "corner"}));
+    if (m_programStatic == nullptr || m_programTiled == nullptr ||
+        m_programFace == nullptr)
+    {
+        return;
+    }
+
+    // Framebuffer
+    glGenRenderbuffers(1, &m_renderbufferColor);
+    glBindRenderbuffer(GL_RENDERBUFFER, m_renderbufferColor);
+    glRenderbufferStorage(GL_RENDERBUFFER, GL_RGBA32UI, 1, 1);
+    glGenRenderbuffers(1, &m_renderbufferDepth);
+    glBindRenderbuffer(GL_RENDERBUFFER, m_renderbufferDepth);
+    glRenderbufferStorage(GL_RENDERBUFFER, GL_DEPTH_COMPONENT24, 1, 1);
+    glBindRenderbuffer(GL_RENDERBUFFER, 0);
+
+    GLint previousFramebuffer;
+    glGetIntegerv(GL_FRAMEBUFFER_BINDING, &previousFramebuffer);
+    glGenFramebuffers(1, &m_framebuffer);
+    glBindFramebuffer(GL_FRAMEBUFFER, m_framebuffer);
+    glFramebufferRenderbuffer(GL_FRAMEBUFFER, GL_COLOR_ATTACHMENT0,
+                              GL_RENDERBUFFER, m_renderbufferColor);
+    glFramebufferRenderbuffer(GL_FRAMEBUFFER, GL_DEPTH_ATTACHMENT,
+                              GL_RENDERBUFFER, m_renderbufferDepth);
+    m_isSupported = glCheckFramebufferStatus(GL_FRAMEBUFFER) ==
+            GL_FRAMEBUFFER_COMPLETE;
+    glBindFramebuffer(GL_FRAMEBUFFER, previousFramebuffer);
+}
+
+// -------------------------------------------------------
+
+QOpenGLShaderProgram* MapPicking::createProgram(const QString& vertex,
+                                                const QString& fragment,
+                                                const QStringList& attributes)
+{
+    QOpenGLShaderProgram* program = new QOpenGLShaderProgram();
+    program->addShaderFromSourceFile(QOpenGLShader::Vertex, vertex);
+    program->addShaderFromSourceFile(QOpenGLShader::Fragment, fragment);
+    for (int i = 0; i < attributes.size(); i++)
+        program->bindAttributeLocation(attributes.at(i), i);
+    program->bindAttributeLocation("unpack", VertexPacking::UNPACK_LOCATION);
+    if (!program->link()) {
+        delete program;
+        return nullptr;
+    }
+
+    return program;
+}
+
+// -------------------------------------------------------
+
+void MapPicking::paintLands(Map* map, QMatrix4x4& modelviewProjection) {
+    int totalSize = map->getMapPortionTotalSize();
+    MapPortion* mapPortion;
+
+    map->textureTileset()->bind();
+
+    // Floors
+    m_programStatic->bind();
+    m_programStatic->setUniformValue("modelviewProjection",
+                                     modelviewProjection);
+    for (int i = 0; i < totalSize; i++) {
+        mapPortion = map->mapPortionBrut(i);
+        if (mapPortion != nullptr && mapPortion->isVisibleLoaded()) {
+            setIDs(m_programStatic, MapPickingKind::Floors, i);
+            mapPortion->paintPickingFloors();
+        }
+    }
+    m_programStatic->release();
+
+    // Merged floors layers
+    m_programTiled->bind();
+    m_programTiled->setUniformValue("modelviewProjection",
+                                    modelviewProjection);
+    for (int i = 0; i < totalSize; i++) {
+        mapPortion = map->mapPortionBrut(i);
+        if (mapPortion != nullptr && mapPortion->isVisibleLoaded()) {
+            setIDs(m_programTiled, MapPickingKind::FloorsTiled, i);
+            mapPortion->paintFloorsTiled();
+        }
+    }
+    m_programTiled->release();
+
+    map->textureTileset()->release();
+}
+
+// -------------------------------------------------------
+
+void MapPicking::paintSprites(Map* map, QMatrix4x4& modelviewProjection,
+                              QMatrix4x4& view, bool layerOn)
+{
+    int totalSize = map->getMapPortionTotalSize();
+    MapPortion* mapPortion;
+    QHash<int, QList<Position>> overflow;
+    QHash<int, QList<Position>>::const_iterator itOverflow;
+    getOverflowSprites(map, overflow);
+
+    // Sprites
+    m_programStatic->bind();
+    m_programStatic->setUniformValue("modelviewProjection",
+                                     modelviewProjection);
+    map->textureTileset()->bind();
+    for (int i = 0; i < totalSize; i++) {
+        mapPortion = map->mapPortionBrut(i);
+        if (mapPortion != nullptr && mapPortion->isVisibleLoaded()) {
+            setIDs(m_programStatic, MapPickingKind::Sprites, i);
+            mapPortion->paintPickingSprites();
+        }
+    }
+    for (itOverflow = overflow.begin(); itOverflow != overflow.end();
+         itOverflow++)
+    {
+        setIDs(m_programStatic, MapPickingKind::Sprites, itOverflow.key());
+        map->mapPortionBrut(itOverflow.key())->paintPickingSprites(
+                    itOverflow.value());
+    }
+    map->textureTileset()->release();
+
+    // Walls, only when layer on like the raycasting
+    if (layerOn) {
+        QHash<int, QOpenGLTexture*>::const_iterator it;
+        for (it = map->texturesSpriteWalls().begin();
+             it != map->texturesSpriteWalls().end(); it++)
+        {
+            int textureID = it.key();
+            QOpenGLTexture* texture = it.value();
+            texture->bind();
+            for (int i = 0; i < totalSize; i++) {
+                mapPortion = map->mapPortionBrut(i);
+                if (mapPortion != nullptr && mapPortion->isVisibleLoaded()) {
+                    setIDs(m_programStatic, MapPickingKind::SpritesWalls, i,
+                           textureID);
+                    mapPortion->paintPickingSpritesWalls(textureID);
+                }
+            }
+            texture->release();
+        }
+    }
+    m_programStatic->release();
+
+    // Face sprites
+    m_programFace->bind();
+    m_programFace->setUniformValue("cameraRightWorldspace",
+                                   view.row(0).toVector3D());
+    m_programFace->setUniformValue("cameraUpWorldspace",
+                                   view.row(1).toVector3D());
+    m_programFace->setUniformValue("cameraDeepWorldspace",
+                                   view.row(2).toVector3D());
+    m_programFace->setUniformValue("modelViewProjection",
+                                   modelviewProjection);
+    map->textureTileset()->bind();
+    for (int i = 0; i < totalSize; i++) {
+        mapPortion = map->mapPortionBrut(i);
+        if (mapPortion != nullptr && mapPortion->isVisible()) {
+            setIDs(m_programFace, MapPickingKind::SpritesFace, i);
+            mapPortion->paintPickingFaceSprites();
+        }
+    }
+    for (itOverflow = overflow.begin(); itOverflow != overflow.end();
+         itOverflow++)
+    {
+        setIDs(m_programFace, MapPickingKind::SpritesFace, itOverflow.key());
+        map->mapPortionBrut(itOverflow.key())->paintPickingFaceSprites(
+                    itOverflow.value());
+    }
+    map->textureTileset()->release();
+    m_programFace->release();
+}
+
+// -------------------------------------------------------
+//  getOverflowSprites: the sprites overflowing in the visible portions (or
+//  out of the map) are only drawn by their own portion, which can be loaded
+//  but not visible. They are grouped by the index of this portion
+
+void MapPicking::getOverflowSprites(Map* map,
+                                    QHash<int, QList<Position>>& overflow)
+{
+    int totalSize = map->getMapPortionTotalSize();
+    MapPortion* mapPortion;
+    QSet<PositionKey> positions;
+
+    for (int i = 0; i < totalSize; i++) {
+        mapPortion = map->mapPortionBrut(i);
+        if (mapPortion != nullptr && mapPortion->isVisibleLoaded())
+            positions += mapPortion->overflowSprites();
+    }
+    const QHash<Portion, QSet<PositionKey>*>& outOverflow =
+            map->mapProperties()->outOverflowSprites();
+    QHash<Portion, QSet<PositionKey>*>::const_iterator it;
+    for (it = outOverflow.begin(); it != outOverflow.end(); it++)
+        positions += *it.value();
+
+    QSet<PositionKey>::const_iterator i;
+    for (i = positions.begin(); i != positions.end(); i++) {
+        Position position = *i;
+        Portion portion;
+        map->getLocalPortion(position, portion);
+        if (!map->isInPortion(portion, 0))
+            continue;
+        int index = map->portionIndex(portion.x(), portion.y(), portion.z());
+        mapPortion = map->mapPortionBrut(index);
+        if (mapPortion != nullptr && !mapPortion->isVisibleLoaded())
+            overflow[index].append(position);
+    }
+}
@@ -0,0 +1,95 @@
+/*
+    RPG Paper Maker Copyright (C) 2017 Marie Laporte
+
+    This file is part of RPG Paper Maker.
+
+    RPG Paper Maker is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    RPG Paper Maker is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with Foobar.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#ifndef MAPPICKING_H
+#define MAPPICKING_H
+
+#include <QOpenGLFunctions>
+#include <QOpenGLShaderProgram>
+#include <QMatrix4x4>
+#include <QPoint>
+#include "map.h"
+#include "mappickingkind.h"
+
+// -------------------------------------------------------
+//
+//  CLASS MapPicking
+//
+//  GPU picking of the map editor. The pixel under the mouse is drawn in a
+//  1x1 integer framebuffer where each fragment contains the kind of buffer,
+//  the portion and the quad it comes from. There is one pass for the lands
+//  and one for the sprites so that both can be known, like with the
+//  raycasting. Sprites overflowing in the visible portions are also drawn
+//  when their own portion is not visible.
+//
+// -------------------------------------------------------
+
+class MapPicking : protected QOpenGLFunctions
+{
+public:
+    MapPicking();
+    virtual ~MapPicking();
+    bool isSupported() const;
+    void initializeGL();
+    void invalidate();
+    bool pick(Map* map, QRay3D& ray, QMatrix4x4& projection,
+              QMatrix4x4& view, const QPoint& mouse, int width, int height,
+              bool layerOn);
+    MapElement* getLand(Map* map, Position& position, float& distance) const;
+    MapElement* getSprite(Map* map, Position& position,
+                          float& distance) const;
+
+protected:
+    bool m_isSupported;
+    QOpenGLContext* m_context;
+    GLuint m_framebuffer;
+    GLuint m_renderbufferColor;
+    GLuint m_renderbufferDepth;
+    QOpenGLShaderProgram* m_programStatic;
+    QOpenGLShaderProgram* m_programTiled;
+    QOpenGLShaderProgram* m_programFace;
+
+    // Last picking
+    bool m_isValid;
+    QPoint m_mouse;
+    QMatrix4x4 m_viewProjection;
+    bool m_layerOn;
+    GLuint m_land[4];
+    float m_distanceLand;
+    GLuint m_sprite[4];
+    float m_distanceSprite;
+
+    static QOpenGLShaderProgram* createProgram(const QString& vertex,
+                                               const QString& fragment,
+                                               const QStringList& attributes);
+    void clear();
+    void paintLands(Map* map, QMatrix4x4& modelviewProjection);
+    void paintSprites(Map* map, QMatrix4x4& modelviewProjection,
+                      QMatrix4x4& view, bool layerOn);
+    static void getOverflowSprites(Map* map,
+                                   QHash<int, QList<Position>>& overflow);
+    void setIDs(QOpenGLShaderProgram* program, MapPickingKind kind,
+                int portion, int extra = 0);
+    void readPixel(GLuint pixel[4], float& distance,
+                   QMatrix4x4& modelviewProjection, QRay3D& ray);
+    static MapElement* getElement(Map* map, const GLuint pixel[4],
+                                  Position& position);
+};
+
+#endif // MAPPICKING_H
@@ -29,7 +29,8 @@ MapPortion::MapPortion(Portion &globalPortion) :
     m_globalPortion(globalPortion),
     m_lands(new Lands),
     m_sprites(new Sprites),
-    m_mapObjects(new MapObjects)
+    m_mapObjects(new MapObjects),
+    m_arena(new PortionArena)
 {
 
 }
@@ -39,6 +40,7 @@ MapPortion::~MapPortion()
     delete m_lands;
     delete m_sprites;
     delete m_mapObjects;
+    delete m_arena;
 
     clearPreview();
 }
@@ -191,6 +193,12 @@ void MapPortion::removeOverflow(Position& p) {
 
 // -------------------------------------------------------
 
+const QSet<PositionKey>& MapPortion::overflowSprites() const {
+    return m_sprites->overflow();
+}
+
+// -------------------------------------------------------
+
 void MapPortion::removeLandOut(MapProperties& properties) {
     m_lands->removeLandOut(properties);
 }
@@ -212,7 +220,7 @@ void MapPortion::removeObjectsOut(QList<int> &listDeletedObjectsIDs,
 // -------------------------------------------------------
 
 void MapPortion::clearPreview() {
-    QHash<Position, MapElement*>::iterator i;
+    QHash<PositionKey, MapElement*>::iterator i;
     for (i = m_previewSquares.begin(); i != m_previewSquares.end(); i++)
         delete i.value();
 
@@ -279,6 +287,31 @@ MapElement* MapPortion::updateRaycastingOverflowSprite(int squareSize,
 
 // -------------------------------------------------------
 
+MapElement* MapPortion::getPickedElement(MapPickingKind kind, int quad,
+                                         int extra, Position& position) const
+{
+    // The quads of the arena are counted from the start of its buffer
+    switch (kind) {
+    case MapPickingKind::Floors:
+        quad -= m_arena->firstQuad(PortionArena::FLOORS);
+        return m_lands->getPickedElement(kind, quad, extra, position);
+    case MapPickingKind::FloorsTiled:
+        return m_lands->getPickedElement(kind, quad, extra, position);
+    case MapPickingKind::Sprites:
+        quad -= m_arena->firstQuad(PortionArena::SPRITES);
+        return m_sprites->getPickedElement(kind, quad, extra, position);
+    case MapPickingKind::SpritesWalls:
+        quad -= m_arena->firstQuad(extra);
+        return m_sprites->getPickedElement(kind, quad, extra, position);
+    case MapPickingKind::SpritesFace:
+        return m_sprites->getPickedElement(kind, quad, extra, position);
+    default:
+        return nullptr;
+    }
+}
+
+// -------------------------------------------------------
+
 MapElement* MapPortion::getMapElementAt(Position& position,
                                         MapEditorSelectionKind kind,
                                         MapEditorSubSelectionKind subKind)
@@ -315,10 +348,11 @@ int MapPortion::getLastLayerAt(Position& position, MapEditorSelectionKind kind,
 
 void MapPortion::initializeVertices(int squareSize, QOpenGLTexture *tileset,
                                     QHash<int, QOpenGLTexture *> &characters,
-                                    QHash<int, QOpenGLTexture *> &walls)
+                                    QHash<int, QOpenGLTexture *> &walls,
+                                    const QSet<int>& mergedLayers)
 {
-    m_lands->initializeVertices(m_previewSquares, squareSize,
-                                 tileset->width(), tileset->height());
+    m_lands->initializeVertices(m_previewSquares, mergedLayers, squareSize,
+                                tileset->width(), tileset->height());
     m_sprites->initializeVertices(walls, m_previewSquares, m_previewDelete,
                                   squareSize, tileset->width(),
                                   tileset->height());
@@ -327,6 +361,16 @@ void MapPortion::initializeVertices(int squareSize, QOpenGLTexture *tileset,
 
 // -------------------------------------------------------
 
+void MapPortion::bakeVertices(PortionGeometry& geometry, int squareSize,
+                              int width, int height,
+                              QHash<int, QSize>& sizesWalls)
+{
+    m_lands->bakeVertices(geometry, squareSize, width, height);
+    m_sprites->bakeVertices(geometry, sizesWalls, squareSize, width, height);
+}
+
+// -------------------------------------------------------
+
 void MapPortion::initializeVerticesObjects(int squareSize,
                                            QHash<int, QOpenGLTexture*>&
                                            characters)
@@ -337,10 +381,12 @@ void MapPortion::initializeVerticesObjects(int squareSize,
 // -------------------------------------------------------
 
 void MapPortion::initializeGL(QOpenGLShaderProgram *programStatic,
-                              QOpenGLShaderProgram *programFace)
+                              QOpenGLShaderProgram *programFace,
+                              QOpenGLShaderProgram *programTiled)
 {
-    m_lands->initializeGL(programStatic);
-    m_sprites->initializeGL(programStatic, programFace);
+    m_lands->initializeGL(programTiled);
+    m_sprites->initializeGL(programFace);
+    m_arena->initializeGL(programStatic);
     initializeGLObjects(programStatic, programFace);
 }
 
@@ -357,6 +403,10 @@ void MapPortion::initializeGLObjects(QOpenGLShaderProgram *programStatic,
 void MapPortion::updateGL(){
     m_lands->updateGL();
     m_sprites->updateGL();
+    m_arena->clear();
+    m_lands->updateArena(*m_arena);
+    m_sprites->updateArena(*m_arena);
+    m_arena->updateGL();
     updateGLObjects();
 }
 
@@ -369,20 +419,62 @@ void MapPortion::updateGLObjects() {
 
 // -------------------------------------------------------
 
+void MapPortion::addMemoryUsage(MapMemoryUsage& usage) const {
+    usage.addPortion();
+    m_lands->addMemoryUsage(usage);
+    m_sprites->addMemoryUsage(usage);
+    m_mapObjects->addMemoryUsage(usage);
+    m_arena->addMemoryUsage(usage);
+}
+
+// -------------------------------------------------------
+
 void MapPortion::paintFloors(){
-    m_lands->paintGL();
+    m_arena->paintGL(PortionArena::FLOORS);
 }
 
 // -------------------------------------------------------
 
-void MapPortion::paintSprites(){
-    m_sprites->paintGL();
+void MapPortion::paintPickingFloors(){
+    m_arena->paintPickingGL(PortionArena::FLOORS);
 }
 
 // -------------------------------------------------------
 
-void MapPortion::paintSpritesWalls(int textureID) {
-    m_sprites->paintSpritesWalls(textureID);
+void MapPortion::paintFloorsTiled(){
+    m_lands->paintTiledGL();
+}
+
+// -------------------------------------------------------
+
+void MapPortion::paintSprites(QOpenGLTexture* tileset,
+                              const QHash<int, QOpenGLTexture*>& texturesWalls)
+{
+    m_arena->paintSpritesGL(tileset, texturesWalls);
+}
+
+// -------------------------------------------------------
+
+void MapPortion::paintPickingSprites(){
+    m_arena->paintPickingGL(PortionArena::SPRITES);
+}
+
+// -------------------------------------------------------
+//  paintPickingSprites: only the sprites at these positions (overflowing in
+//  other portions)
+
+void MapPortion::paintPickingSprites(const QList<Position>& positions){
+    QList<int> quadsStatic, quadsFace;
+    for (int i = 0; i < positions.size(); i++)
+        m_sprites->getPickableQuads(positions.at(i), quadsStatic, quadsFace);
+    m_arena->paintPickingGL(PortionArena::SPRITES, quadsStatic);
+}
+
+
+// -------------------------------------------------------
+
+void MapPortion::paintPickingSpritesWalls(int textureID) {
+    m_arena->paintPickingGL(textureID);
 }
 
 // -------------------------------------------------------
@@ -393,6 +485,21 @@ void MapPortion::paintFaceSprites(){
 
 // -------------------------------------------------------
 
+void MapPortion::paintPickingFaceSprites(){
+    m_sprites->paintFacePickingGL();
+}
+
+// -------------------------------------------------------
+
+void MapPortion::paintPickingFaceSprites(const QList<Position>& positions){
+    QList<int> quadsStatic, quadsFace;
+    for (int i = 0; i < positions.size(); i++)
+        m_sprites->getPickableQuads(positions.at(i), quadsStatic, quadsFace);
+    m_sprites->paintFacePickingGL(quadsFace);
+}
+
+// -------------------------------------------------------
+
 void MapPortion::paintObjectsStaticSprites(int textureID,
                                            QOpenGLTexture* texture)
 {
@@ -427,6 +534,47 @@ void MapPortion::read(const QJsonObject & json){
     }
 }
 
+// -------------------------------------------------------
+//  readGeometry: only what is needed to bake the portion, the objects read
+//  project datas and are not needed
+
+void MapPortion::readGeometry(const QJsonObject & json){
+    if (json.contains("lands")){
+        m_lands->read(json["lands"].toObject());
+        m_sprites->read(json["sprites"].toObject());
+    }
+}
+
+// -------------------------------------------------------
+
+bool MapPortion::canReadStream() const {
+    return true;
+}
+
+// -------------------------------------------------------
+
+void MapPortion::readStream(JsonStreamReader& reader) {
+    QJsonObject json;
+    bool isLands = false;
+    QString key;
+
+    // Lands are read directly from the stream, the rest as before
+    if (reader.beginObject()) {
+        while (reader.nextKey(key)) {
+            if (key == "lands") {
+                m_lands->readStream(reader);
+                isLands = true;
+            }
+            else
+                json[key] = reader.readValue();
+        }
+    }
+    if (isLands && !reader.hasError()) {
+        m_sprites->read(json["sprites"].toObject());
+        m_mapObjects->read(json["objs"].toObject());
+    }
+}
+
 // -------------------------------------------------------
 
 void MapPortion::write(QJsonObject & json) const{
@@ -74,6 +74,7 @@ public:
                       MapEditorSubSelectionKind &previousType);
     void addOverflow(Position& p);
     void removeOverflow(Position& p);
+    const QSet<PositionKey>& overflowSprites() const;
     void removeLandOut(MapProperties& properties);
     void removeSpritesOut(MapProperties& properties);
     void removeObjectsOut(QList<int>& listDeletedObjectsIDs,
@@ -93,6 +94,8 @@ public:
                                                Position &finalPosition,
                                                QRay3D& ray,
                                                double cameraHAngle);
+    MapElement* getPickedElement(MapPickingKind kind, int quad, int extra,
+                                 Position& position) const;
     MapElement* getMapElementAt(Position& position,
                                 MapEditorSelectionKind kind,
                                 MapEditorSubSelectionKind subKind);
@@ -101,32 +104,48 @@ public:
 
     void initializeVertices(int squareSize, QOpenGLTexture* tileset,
                             QHash<int, QOpenGLTexture*>& characters,
-                            QHash<int, QOpenGLTexture *> &walls);
+                            QHash<int, QOpenGLTexture *> &walls,
+                            const QSet<int>& mergedLayers);
+    void bakeVertices(PortionGeometry& geometry, int squareSize, int width,
+                      int height, QHash<int, QSize>& sizesWalls);
     void initializeVerticesObjects(int squareSize,
                                    QHash<int, QOpenGLTexture*>& characters);
     void initializeGL(QOpenGLShaderProgram *programStatic,
-                      QOpenGLShaderProgram *programFace);
+                      QOpenGLShaderProgram *programFace,
+                      QOpenGLShaderProgram *programTiled);
     void initializeGLObjects(QOpenGLShaderProgram *programStatic,
                              QOpenGLShaderProgram *programFace);
     void updateGL();
     void updateGLObjects();
+    void addMemoryUsage(MapMemoryUsage& usage) const;
     void paintFloors();
-    void paintSprites();
-    void paintSpritesWalls(int textureID);
+    void paintPickingFloors();
+    void paintFloorsTiled();
+    void paintSprites(QOpenGLTexture* tileset,
+                      const QHash<int, QOpenGLTexture*>& texturesWalls);
+    void paintPickingSprites();
+    void paintPickingSprites(const QList<Position>& positions);
+    void paintPickingSpritesWalls(int textureID);
     void paintFaceSprites();
+    void paintPickingFaceSprites();
+    void paintPickingFaceSprites(const QList<Position>& positions);
     void paintObjectsStaticSprites(int textureID, QOpenGLTexture* texture);
     void paintObjectsFaceSprites(int textureID, QOpenGLTexture* texture);
     void paintObjectsSquares();
 
     void read(const QJsonObject &json);
+    void readGeometry(const QJsonObject &json);
     void write(QJsonObject &json) const;
+    virtual bool canReadStream() const;
+    virtual void readStream(JsonStreamReader& reader);
 
 private:
     Portion m_globalPortion;
     Lands* m_lands;
     Sprites* m_sprites;
     MapObjects* m_mapObjects;
-    QHash<Position, MapElement*> m_previewSquares;
+    PortionArena* m_arena;
+    QHash<PositionKey, MapElement*> m_previewSquares;
     QList<Position> m_previewDelete;
     bool m_isVisible;
     bool m_isLoaded;
@@ -0,0 +1,173 @@
+/*
+    RPG Paper Maker Copyright (C) 2017 Marie Laporte
+
+    This file is part of RPG Paper Maker.
+
+    RPG Paper Maker is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    RPG Paper Maker is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with Foobar.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include "portionarena.h"
+#include "map.h"
+
+const int PortionArena::FLOORS = -2;
+
+const int PortionArena::SPRITES = -1;
+
+// -------------------------------------------------------
+//
+//  CONSTRUCTOR / DESTRUCTOR / GET / SET
+//
+// -------------------------------------------------------
+
+PortionArena::PortionArena() :
+    m_count(0),
+    m_vertexBuffer(QOpenGLBuffer::VertexBuffer),
+    m_indexBuffer(QOpenGLBuffer::IndexBuffer),
+    m_program(nullptr)
+{
+
+}
+
+PortionArena::~PortionArena()
+{
+
+}
+
+int PortionArena::firstQuad(int material) const {
+    return m_firstQuads.value(material);
+}
+
+// -------------------------------------------------------
+//
+//  INTERMEDIARY FUNCTIONS
+//
+// -------------------------------------------------------
+
+void PortionArena::clear() {
+    m_sources.clear();
+    m_materials.clear();
+    m_firstQuads.clear();
+    m_quads.clear();
+    m_pickableQuads.clear();
+    m_count = 0;
+}
+
+// -------------------------------------------------------
+
+void PortionArena::append(int material, const QVector<Vertex>& vertices,
+                          int pickable)
+{
+    int quads = vertices.size() / Floor::nbVerticesQuad;
+    if (quads == 0)
+        return;
+
+    m_sources.append(vertices);
+    m_materials.append(material);
+    m_firstQuads[material] = m_count;
+    m_quads[material] = quads;
+    m_pickableQuads[material] = pickable;
+    m_count += quads;
+}
+
+// -------------------------------------------------------
+//
+//  GL
+//
+// -------------------------------------------------------
+
+void PortionArena::initializeGL(QOpenGLShaderProgram* program) {
+    if (m_program == nullptr){
+        initializeOpenGLFunctions();
+        m_program = program;
+    }
+}
+
+// -------------------------------------------------------
+
+void PortionArena::updateGL() {
+    Map::updateGLStatic(m_vertexBuffer, m_indexBuffer, m_sources, m_vao,
+                        m_program, m_packing);
+    m_sources.clear();
+}
+
+// -------------------------------------------------------
+
+void PortionArena::addMemoryUsage(MapMemoryUsage& usage) const {
+    usage.addBuffers(m_packing.bufferBytes());
+}
+
+// -------------------------------------------------------
+
+void PortionArena::paintGL(int material) {
+    if (!m_quads.contains(material))
+        return;
+
+    m_vao.bind();
+    m_packing.draw(*this, m_firstQuads.value(material),
+                   m_quads.value(material));
+    m_vao.release();
+}
+
+// -------------------------------------------------------
+
+void PortionArena::paintPickingGL(int material) {
+    if (!m_quads.contains(material))
+        return;
+
+    m_vao.bind();
+    m_packing.draw(*this, m_firstQuads.value(material),
+                   m_pickableQuads.value(material));
+    m_vao.release();
+}
+
+// -------------------------------------------------------
+//  paintPickingGL: only some quads of the material, counted from its first
+//  quad
+
+void PortionArena::paintPickingGL(int material, const QList<int>& quads) {
+    if (!m_quads.contains(material) || quads.isEmpty())
+        return;
+
+    int first = m_firstQuads.value(material);
+    m_vao.bind();
+    for (int i = 0; i < quads.size(); i++)
+        m_packing.draw(*this, first + quads.at(i), 1);
+    m_vao.release();
+}
+
+// -------------------------------------------------------
+
+void PortionArena::paintSpritesGL(QOpenGLTexture* tileset,
+                                  const QHash<int, QOpenGLTexture*>&
+                                  texturesWalls)
+{
+    if (m_materials.isEmpty())
+        return;
+
+    // The sprites and all the walls with only one VAO bind
+    m_vao.bind();
+    for (int i = 0; i < m_materials.size(); i++) {
+        int material = m_materials.at(i);
+        QOpenGLTexture* texture = material == SPRITES ? tileset :
+                                      texturesWalls.value(material);
+        if (material == FLOORS || texture == nullptr)
+            continue;
+
+        texture->bind();
+        m_packing.draw(*this, m_firstQuads.value(material),
+                       m_quads.value(material));
+        texture->release();
+    }
+    m_vao.release();
+}
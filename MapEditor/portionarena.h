@@ -0,0 +1,85 @@
+/*
+    RPG Paper Maker Copyright (C) 2017 Marie Laporte
+
+    This file is part of RPG Paper Maker.
+
+    RPG Paper Maker is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    RPG Paper Maker is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with Foobar.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#ifndef PORTIONARENA_H
+#define PORTIONARENA_H
+
+#include <QHash>
+#include <QList>
+#include <QVector>
+#include <QOpenGLFunctions>
+#include <QOpenGLShaderProgram>
+#include <QOpenGLBuffer>
+#include <QOpenGLVertexArrayObject>
+#include <QOpenGLTexture>
+#include "vertex.h"
+#include "vertexpacking.h"
+#include "mapmemoryusage.h"
+
+// -------------------------------------------------------
+//
+//  CLASS PortionArena
+//
+//  All the static geometry of a portion (floors, sprites and walls) packed
+//  in one vertex buffer. Each material (the tileset for floors and sprites,
+//  a texture for each kind of wall) is a range of quads, drawn from its
+//  offset in the shared quads indexes. A visible portion is then drawn with
+//  only one VAO instead of one for each material.
+//
+// -------------------------------------------------------
+
+class PortionArena : protected QOpenGLFunctions
+{
+public:
+    PortionArena();
+    virtual ~PortionArena();
+    static const int FLOORS;
+    static const int SPRITES;
+    int firstQuad(int material) const;
+    void clear();
+    void append(int material, const QVector<Vertex>& vertices, int pickable);
+    void initializeGL(QOpenGLShaderProgram* program);
+    void updateGL();
+    void addMemoryUsage(MapMemoryUsage& usage) const;
+    void paintGL(int material);
+    void paintPickingGL(int material);
+    void paintPickingGL(int material, const QList<int>& quads);
+    void paintSpritesGL(QOpenGLTexture* tileset,
+                        const QHash<int, QOpenGLTexture*>& texturesWalls);
+
+protected:
+    // Vertices to upload, shared with their owners until the next updateGL
+    QList<QVector<Vertex>> m_sources;
+
+    // Ranges of quads of each material, in the buffer order
+    QList<int> m_materials;
+    QHash<int, int> m_firstQuads;
+    QHash<int, int> m_quads;
+    QHash<int, int> m_pickableQuads;
+    int m_count;
+
+    // OpenGL
+    QOpenGLBuffer m_vertexBuffer;
+    QOpenGLBuffer m_indexBuffer;
+    QOpenGLVertexArrayObject m_vao;
+    VertexPacking m_packing;
+    QOpenGLShaderProgram* m_program;
+};
+
+#endif // PORTIONARENA_H
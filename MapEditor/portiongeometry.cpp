@@ -0,0 +1,204 @@
+/*
+    RPG Paper Maker Copyright (C) 2017 Marie Laporte
+
+    This file is part of RPG Paper Maker.
+
+    RPG Paper Maker is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    RPG Paper Maker is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with Foobar.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include <QFile>
+#include <QtMath>
+#include "portiongeometry.h"
+#include "wanok.h"
+
+const quint32 PortionGeometry::VERSION = 1;
+
+const float PortionGeometry::POSITION_SCALE = 20.0f;
+
+// -------------------------------------------------------
+//
+//  CONSTRUCTOR / DESTRUCTOR / GET / SET
+//
+// -------------------------------------------------------
+
+PortionGeometry::PortionGeometry() :
+    m_countStatic(0),
+    m_countFace(0)
+{
+
+}
+
+QVector<Vertex>& PortionGeometry::verticesStatic() { return m_verticesStatic; }
+
+QVector<GLuint>& PortionGeometry::indexesStatic() { return m_indexesStatic; }
+
+int& PortionGeometry::countStatic() { return m_countStatic; }
+
+QVector<VertexBillboard>& PortionGeometry::verticesFace() {
+    return m_verticesFace;
+}
+
+QVector<GLuint>& PortionGeometry::indexesFace() { return m_indexesFace; }
+
+int& PortionGeometry::countFace() { return m_countFace; }
+
+QVector<Vertex>& PortionGeometry::verticesWalls(int id) {
+    return m_verticesWalls[id];
+}
+
+QVector<GLuint>& PortionGeometry::indexesWalls(int id) {
+    return m_indexesWalls[id];
+}
+
+int& PortionGeometry::countWalls(int id) {
+    if (!m_countWalls.contains(id))
+        m_countWalls[id] = 0;
+
+    return m_countWalls[id];
+}
+
+bool PortionGeometry::isEmpty() const {
+    return m_verticesStatic.isEmpty() && m_verticesFace.isEmpty() &&
+           m_verticesWalls.isEmpty();
+}
+
+// -------------------------------------------------------
+//
+//  INTERMEDIARY FUNCTIONS
+//
+// -------------------------------------------------------
+
+QString PortionGeometry::getPortionPathGeometry(int i, int j, int k) {
+    return QString::number(i) + "_" + QString::number(j) + "_" +
+            QString::number(k) + ".geo";
+}
+
+// -------------------------------------------------------
+
+qint16 PortionGeometry::quantize(float value, float origin) {
+    return (qint16) qBound(-32768, qRound((value - origin) * POSITION_SCALE),
+                           32767);
+}
+
+// -------------------------------------------------------
+
+quint16 PortionGeometry::normalize(float value) {
+    return VertexPacking::packTex(value);
+}
+
+// -------------------------------------------------------
+//  Indexes are written on 16 bits when possible
+
+void PortionGeometry::writeIndexes(QDataStream& stream, int verticesCount,
+                                   const QVector<GLuint>& indexes)
+{
+    bool isShort = verticesCount <= 65536;
+    stream << (quint8) (isShort ? 2 : 4) << (quint32) indexes.size();
+    for (int i = 0; i < indexes.size(); i++) {
+        if (isShort)
+            stream << (quint16) indexes.at(i);
+        else
+            stream << (quint32) indexes.at(i);
+    }
+}
+
+// -------------------------------------------------------
+
+void PortionGeometry::writeStatic(QDataStream& stream, int textureID,
+                                  const QVector<Vertex>& vertices,
+                                  const QVector<GLuint>& indexes,
+                                  QVector3D& origin)
+{
+    stream << (quint8) 0 << (qint32) textureID << (quint32) vertices.size();
+    for (int i = 0; i < vertices.size(); i++) {
+        QVector3D position = vertices.at(i).position();
+        QVector2D tex = vertices.at(i).tex();
+        stream << quantize(position.x(), origin.x())
+               << quantize(position.y(), origin.y())
+               << quantize(position.z(), origin.z())
+               << normalize(tex.x()) << normalize(tex.y());
+    }
+    writeIndexes(stream, vertices.size(), indexes);
+}
+
+// -------------------------------------------------------
+
+void PortionGeometry::writeFace(QDataStream& stream,
+                                const QVector<VertexBillboard>& vertices,
+                                const QVector<GLuint>& indexes,
+                                QVector3D& origin)
+{
+    stream << (quint8) 1 << (qint32) -1 << (quint32) vertices.size();
+    for (int i = 0; i < vertices.size(); i++) {
+        const VertexBillboard& vertex = vertices.at(i);
+        QVector3D center = vertex.centerPosition();
+        QVector2D tex = vertex.tex();
+        QVector2D size = vertex.size();
+        QVector3D model = vertex.model();
+        stream << quantize(center.x(), origin.x())
+               << quantize(center.y(), origin.y())
+               << quantize(center.z(), origin.z())
+               << normalize(tex.x()) << normalize(tex.y())
+               << quantize(size.x(), 0) << quantize(size.y(), 0)
+               << quantize(model.x(), 0) << quantize(model.y(), 0)
+               << quantize(model.z(), 0);
+    }
+    writeIndexes(stream, vertices.size(), indexes);
+}
+
+// -------------------------------------------------------
+//
+//  READ / WRITE
+//
+// -------------------------------------------------------
+
+// The file is little endian:
+//  "RPMG", version, origin (x, y, z), position scale, groups count
+//  For each group: kind (0 static, 1 face), texture ID (-1 for the tileset,
+//  the wall ID otherwise), vertices count, vertices, index size (2 or 4),
+//  indexes count, indexes.
+
+bool PortionGeometry::write(QString path, Portion& globalPortion,
+                            int squareSize) const
+{
+    QFile file(path);
+    if (!file.open(QIODevice::WriteOnly))
+        return false;
+
+    QDataStream stream(&file);
+    stream.setByteOrder(QDataStream::LittleEndian);
+    stream.setFloatingPointPrecision(QDataStream::SinglePrecision);
+    int portionSize = Wanok::portionSize * squareSize;
+    QVector3D origin(globalPortion.x() * portionSize,
+                     globalPortion.y() * portionSize,
+                     globalPortion.z() * portionSize);
+    quint32 groups = (m_verticesStatic.isEmpty() ? 0 : 1) +
+            (m_verticesFace.isEmpty() ? 0 : 1) + m_verticesWalls.size();
+
+    stream.writeRawData("RPMG", 4);
+    stream << VERSION << (qint32) origin.x() << (qint32) origin.y()
+           << (qint32) origin.z() << POSITION_SCALE << groups;
+    if (!m_verticesStatic.isEmpty())
+        writeStatic(stream, -1, m_verticesStatic, m_indexesStatic, origin);
+    if (!m_verticesFace.isEmpty())
+        writeFace(stream, m_verticesFace, m_indexesFace, origin);
+    for (QHash<int, QVector<Vertex>>::const_iterator i =
+         m_verticesWalls.begin(); i != m_verticesWalls.end(); i++)
+    {
+        writeStatic(stream, i.key(), i.value(), m_indexesWalls.value(i.key()),
+                    origin);
+    }
+
+    return stream.status() == QDataStream::Ok;
+}
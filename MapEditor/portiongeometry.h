@@ -0,0 +1,89 @@
+/*
+    RPG Paper Maker Copyright (C) 2017 Marie Laporte
+
+    This file is part of RPG Paper Maker.
+
+    RPG Paper Maker is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    RPG Paper Maker is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with Foobar.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#ifndef PORTIONGEOMETRY_H
+#define PORTIONGEOMETRY_H
+
+#include <QHash>
+#include <QVector>
+#include <QDataStream>
+#include <QOpenGLFunctions>
+#include "vertex.h"
+#include "vertexbillboard.h"
+#include "vertexpacking.h"
+#include "portion.h"
+
+// -------------------------------------------------------
+//
+//  CLASS PortionGeometry
+//
+//  The merged geometry of a portion of the map, computed with the same code
+//  than the map editor. Used for baking the geometry when exporting so that
+//  the runtime only needs to upload buffers. In the written file, the
+//  positions are quantized relatively to the portion origin and the UVs are
+//  normalized on 16 bits.
+//
+// -------------------------------------------------------
+
+class PortionGeometry
+{
+public:
+    PortionGeometry();
+    QVector<Vertex>& verticesStatic();
+    QVector<GLuint>& indexesStatic();
+    int& countStatic();
+    QVector<VertexBillboard>& verticesFace();
+    QVector<GLuint>& indexesFace();
+    int& countFace();
+    QVector<Vertex>& verticesWalls(int id);
+    QVector<GLuint>& indexesWalls(int id);
+    int& countWalls(int id);
+    bool isEmpty() const;
+
+    static const quint32 VERSION;
+    static const float POSITION_SCALE;
+    static QString getPortionPathGeometry(int i, int j, int k);
+    bool write(QString path, Portion& globalPortion, int squareSize) const;
+
+protected:
+    QVector<Vertex> m_verticesStatic;
+    QVector<GLuint> m_indexesStatic;
+    int m_countStatic;
+    QVector<VertexBillboard> m_verticesFace;
+    QVector<GLuint> m_indexesFace;
+    int m_countFace;
+    QHash<int, QVector<Vertex>> m_verticesWalls;
+    QHash<int, QVector<GLuint>> m_indexesWalls;
+    QHash<int, int> m_countWalls;
+
+    static qint16 quantize(float value, float origin);
+    static quint16 normalize(float value);
+    static void writeStatic(QDataStream& stream, int textureID,
+                            const QVector<Vertex>& vertices,
+                            const QVector<GLuint>& indexes,
+                            QVector3D& origin);
+    static void writeFace(QDataStream& stream,
+                          const QVector<VertexBillboard>& vertices,
+                          const QVector<GLuint>& indexes,
+                          QVector3D& origin);
+    static void writeIndexes(QDataStream& stream, int verticesCount,
+                             const QVector<GLuint>& indexes);
+};
+
+#endif // PORTIONGEOMETRY_H
@@ -238,6 +238,28 @@ void Position::read(const QJsonArray & json){
 
 // -------------------------------------------------------
 
+void Position::readStream(JsonStreamReader& reader){
+    int values[8] = {0, 0, 0, 0, 0, m_centerX, m_centerZ, m_angle};
+
+    if (reader.beginArray()) {
+        for (int i = 0; reader.nextElement(); i++) {
+            int value = reader.readInt();
+            if (i < 8)
+                values[i] = value;
+        }
+    }
+    m_x = values[0];
+    m_y = values[1];
+    m_y_plus = values[2];
+    m_z = values[3];
+    m_layer = values[4];
+    m_centerX = values[5];
+    m_centerZ = values[6];
+    m_angle = values[7];
+}
+
+// -------------------------------------------------------
+
 void Position::write(QJsonArray &json) const{
     Position3D::write(json);
 
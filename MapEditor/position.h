@@ -21,6 +21,7 @@
 #define POSITION_H
 
 #include "position3d.h"
+#include "jsonstreamreader.h"
 
 // -------------------------------------------------------
 //
@@ -68,6 +69,7 @@ public:
     virtual QString toString(int squareSize) const;
 
     void read(const QJsonArray &json);
+    void readStream(JsonStreamReader& reader);
     void write(QJsonArray & json) const;
 
 protected:
@@ -0,0 +1,79 @@
+/*
+    RPG Paper Maker Copyright (C) 2017 Marie Laporte
+
+    This file is part of RPG Paper Maker.
+
+    RPG Paper Maker is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    RPG Paper Maker is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with Foobar.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include "positionkey.h"
+
+// -------------------------------------------------------
+//
+//  CONSTRUCTOR / DESTRUCTOR / GET / SET
+//
+// -------------------------------------------------------
+
+PositionKey::PositionKey() : PositionKey(Position()) {}
+
+PositionKey::PositionKey(const Position& position) :
+    m_coords(pack(position.x(), position.y(), position.yPlus(),
+                  position.z())),
+    m_details(pack(position.layer(), position.centerX(), position.centerZ(),
+                   position.angle()))
+{
+
+}
+
+bool PositionKey::operator==(const PositionKey& other) const {
+    return m_coords == other.m_coords && m_details == other.m_details;
+}
+
+bool PositionKey::operator!=(const PositionKey& other) const {
+    return !operator==(other);
+}
+
+PositionKey::operator Position() const {
+    return toPosition();
+}
+
+quint64 PositionKey::coords() const { return m_coords; }
+
+quint64 PositionKey::details() const { return m_details; }
+
+// -------------------------------------------------------
+//
+//  INTERMEDIARY FUNCTIONS
+//
+// -------------------------------------------------------
+
+Position PositionKey::toPosition() const {
+    return Position(unpack(m_coords, 0), unpack(m_coords, 1),
+                    unpack(m_coords, 2), unpack(m_coords, 3),
+                    unpack(m_details, 0), unpack(m_details, 1),
+                    unpack(m_details, 2), unpack(m_details, 3));
+}
+
+// -------------------------------------------------------
+
+quint64 PositionKey::pack(int a, int b, int c, int d) {
+    return ((quint64) (quint16) a) | (((quint64) (quint16) b) << 16) |
+           (((quint64) (quint16) c) << 32) | (((quint64) (quint16) d) << 48);
+}
+
+// -------------------------------------------------------
+
+int PositionKey::unpack(quint64 word, int index) {
+    return (qint16) (quint16) (word >> (16 * index));
+}
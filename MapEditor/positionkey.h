@@ -0,0 +1,66 @@
+/*
+    RPG Paper Maker Copyright (C) 2017 Marie Laporte
+
+    This file is part of RPG Paper Maker.
+
+    RPG Paper Maker is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    RPG Paper Maker is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with Foobar.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#ifndef POSITIONKEY_H
+#define POSITIONKEY_H
+
+#include "position.h"
+
+// -------------------------------------------------------
+//
+//  CLASS PositionKey
+//
+//  A compact copy of a position used as the key of the elements hashes.
+//  Each field is stored on 16 bits (far above the maps limits) and the
+//  fields are packed in two words: the coordinates (x, y, y plus, z) and
+//  the details (layer, center x, center z, angle).
+//
+// -------------------------------------------------------
+
+class PositionKey
+{
+public:
+    PositionKey();
+    PositionKey(const Position& position);
+
+    bool operator==(const PositionKey& other) const;
+    bool operator!=(const PositionKey& other) const;
+    operator Position() const;
+    quint64 coords() const;
+    quint64 details() const;
+    Position toPosition() const;
+
+protected:
+    quint64 m_coords;
+    quint64 m_details;
+
+    static quint64 pack(int a, int b, int c, int d);
+    static int unpack(quint64 word, int index);
+};
+
+Q_DECLARE_TYPEINFO(PositionKey, Q_PRIMITIVE_TYPE);
+
+inline uint qHash(const PositionKey& key)
+{
+    quint64 hash = (key.coords() ^ (key.details() * 0x9E3779B97F4A7C15ULL))
+            * 0x9E3779B97F4A7C15ULL;
+    return (uint) (hash >> 32);
+}
+
+#endif // POSITIONKEY_H
@@ -85,13 +85,13 @@ QString SpriteDatas::jsonFront = "f";
 // -------------------------------------------------------
 
 SpriteDatas::SpriteDatas() :
-    SpriteDatas(MapEditorSubSelectionKind::SpritesFace, new QRect(0, 0, 2, 2))
+    SpriteDatas(MapEditorSubSelectionKind::SpritesFace, QRect(0, 0, 2, 2))
 {
 
 }
 
-SpriteDatas::SpriteDatas(MapEditorSubSelectionKind kind, QRect *textureRect,
-                         bool front) :
+SpriteDatas::SpriteDatas(MapEditorSubSelectionKind kind,
+                         const QRect& textureRect, bool front) :
     m_kind(kind),
     m_textureRect(textureRect),
     m_front(front)
@@ -101,15 +101,12 @@ SpriteDatas::SpriteDatas(MapEditorSubSelectionKind kind, QRect *textureRect,
 
 SpriteDatas::~SpriteDatas()
 {
-    delete m_textureRect;
+
 }
 
 bool SpriteDatas::operator==(const SpriteDatas& other) const {
     return MapElement::operator==(other) &&
-            m_textureRect->x() == other.m_textureRect->x() &&
-            m_textureRect->y() == other.m_textureRect->y() &&
-            m_textureRect->width() == other.m_textureRect->width() &&
-            m_textureRect->height() == other.m_textureRect->height() &&
+            m_textureRect == other.m_textureRect &&
             (int) m_kind == (int) other.m_kind && m_front == other.m_front;
 }
 
@@ -117,6 +114,14 @@ bool SpriteDatas::operator!=(const SpriteDatas& other) const {
     return !operator==(other);
 }
 
+void* SpriteDatas::operator new(size_t size) {
+    return MapElementPool<SpriteDatas>::allocate(size);
+}
+
+void SpriteDatas::operator delete(void* pointer, size_t size) {
+    MapElementPool<SpriteDatas>::deallocate(pointer, size);
+}
+
 MapEditorSelectionKind SpriteDatas::getKind() const {
     return MapEditorSelectionKind::Sprites;
 }
@@ -138,7 +143,9 @@ QString SpriteDatas::toString() const {
     }
 }
 
-QRect* SpriteDatas::textureRect() const { return m_textureRect; }
+const QRect& SpriteDatas::textureRect() const { return m_textureRect; }
+
+QRect& SpriteDatas::textureRect() { return m_textureRect; }
 
 // -------------------------------------------------------
 //
@@ -151,8 +158,8 @@ void SpriteDatas::getPosSizeCenter(QVector3D& pos, QVector3D& size,
                                    int squareSize, Position& position)
 {
     MapElement::getPosSizeCenter(pos, size, center, offset, squareSize,
-                                 position, textureRect()->width(),
-                                 textureRect()->height(), m_front);
+                                 position, textureRect().width(),
+                                 textureRect().height(), m_front);
 }
 
 // -------------------------------------------------------
@@ -170,10 +177,10 @@ void SpriteDatas::initializeVertices(int squareSize,
 
     float x, y, w, h;
     int offset;
-    x = (float)(m_textureRect->x() * squareSize) / width;
-    y = (float)(m_textureRect->y() * squareSize) / height;
-    w = (float)(m_textureRect->width() * squareSize) / width;
-    h = (float)(m_textureRect->height() * squareSize) / height;
+    x = (float)(m_textureRect.x() * squareSize) / width;
+    y = (float)(m_textureRect.y() * squareSize) / height;
+    w = (float)(m_textureRect.width() * squareSize) / width;
+    h = (float)(m_textureRect.height() * squareSize) / height;
     float coefX = 0.1 / width;
     float coefY = 0.1 / height;
     x += coefX;
@@ -185,14 +192,11 @@ void SpriteDatas::initializeVertices(int squareSize,
     QVector2D texA(x, y), texB(x + w, y), texC(x + w, y + h), texD(x, y + h);
 
     // Adding to buffers according to the kind of sprite
-    m_vertices.clear();
     QVector3D vecA = Sprite::modelQuad[0] * size + pos,
               vecB = Sprite::modelQuad[1] * size + pos,
               vecC = Sprite::modelQuad[2] * size + pos,
               vecD = Sprite::modelQuad[3] * size + pos;
     rotateSprite(vecA, vecB, vecC, vecD, center, position.angle());
-    m_vertices.append(vecA);
-    m_vertices.append(vecC);
     switch (m_kind) {
     case MapEditorSubSelectionKind::SpritesFix:
     case MapEditorSubSelectionKind::SpritesDouble:
@@ -212,8 +216,6 @@ void SpriteDatas::initializeVertices(int squareSize,
             addStaticSpriteToBuffer(verticesStatic, indexesStatic, countStatic,
                                     vecDoubleA, vecDoubleB, vecDoubleC,
                                     vecDoubleD, texA, texB, texC, texD);
-            m_vertices.append(vecDoubleA);
-            m_vertices.append(vecDoubleC);
 
             if (m_kind == MapEditorSubSelectionKind::SpritesQuadra) {
                 QVector3D vecQuadra1A(vecA), vecQuadra1B(vecB),
@@ -233,10 +235,6 @@ void SpriteDatas::initializeVertices(int squareSize,
                                         countStatic, vecQuadra2A, vecQuadra2B,
                                         vecQuadra2C, vecQuadra2D, texA, texB,
                                         texC, texD);
-                m_vertices.append(vecQuadra1A);
-                m_vertices.append(vecQuadra1C);
-                m_vertices.append(vecQuadra2A);
-                m_vertices.append(vecQuadra2C);
             }
         }
 
@@ -320,6 +318,81 @@ void SpriteDatas::addStaticSpriteToBuffer(QVector<Vertex>& verticesStatic,
 
 // -------------------------------------------------------
 
+// Two opposite corners of each plane of the sprite, the same planes as the
+// ones added to the buffers. They are computed again when needed instead of
+// being kept in every sprite.
+
+void SpriteDatas::getBoxesCorners(int squareSize, Position& position,
+                                  QVector<QVector3D>& corners)
+{
+    QVector3D pos, size, center, off;
+    getPosSizeCenter(pos, size, center, off, squareSize, position);
+    QVector3D vecA = Sprite::modelQuad[0] * size + pos,
+              vecB = Sprite::modelQuad[1] * size + pos,
+              vecC = Sprite::modelQuad[2] * size + pos,
+              vecD = Sprite::modelQuad[3] * size + pos;
+    rotateSprite(vecA, vecB, vecC, vecD, center, position.angle());
+    corners.append(vecA);
+    corners.append(vecC);
+    if (m_kind == MapEditorSubSelectionKind::SpritesDouble ||
+        m_kind == MapEditorSubSelectionKind::SpritesQuadra)
+    {
+        QList<int> angles;
+        angles << 90;
+        if (m_kind == MapEditorSubSelectionKind::SpritesQuadra)
+            angles << 45 << -45;
+        for (int i = 0; i < angles.size(); i++) {
+            QVector3D vecRotatedA(vecA), vecRotatedB(vecB),
+                      vecRotatedC(vecC), vecRotatedD(vecD);
+            rotateSprite(vecRotatedA, vecRotatedB, vecRotatedC, vecRotatedD,
+                         center, angles.at(i));
+            corners.append(vecRotatedA);
+            corners.append(vecRotatedC);
+        }
+    }
+}
+
+// -------------------------------------------------------
+
+// Append the boxes of a static sprite (face sprites boxes depend on the
+// camera and are not cached) and return the number of boxes added.
+
+int SpriteDatas::appendBoxes(BoxesBatch& boxes, int squareSize,
+                             Position& position)
+{
+    if (m_kind == MapEditorSubSelectionKind::SpritesFace)
+        return 0;
+
+    QVector<QVector3D> corners;
+    getBoxesCorners(squareSize, position, corners);
+    for (int i = 0; i < corners.size(); i += 2)
+        boxes.append(corners.at(i), corners.at(i + 1));
+
+    return corners.size() / 2;
+}
+
+// -------------------------------------------------------
+
+// Two opposite corners of a face sprite turned to the camera.
+
+void SpriteDatas::getFaceBoxCorners(int squareSize, Position& position,
+                                    int cameraHAngle, QVector3D& corner1,
+                                    QVector3D& corner2)
+{
+    QVector3D pos, size, center, off;
+    getPosSizeCenter(pos, size, center, off, squareSize, position);
+
+    QVector3D vecA = Sprite::modelQuad[0] * size + pos,
+              vecB = Sprite::modelQuad[1] * size + pos,
+              vecC = Sprite::modelQuad[2] * size + pos,
+              vecD = Sprite::modelQuad[3] * size + pos;
+    rotateSprite(vecA, vecB, vecC, vecD, center, -cameraHAngle - 90);
+    corner1 = vecA;
+    corner2 = vecC;
+}
+
+// -------------------------------------------------------
+
 float SpriteDatas::intersection(int squareSize, QRay3D& ray, Position& position,
                                 int cameraHAngle)
 {
@@ -327,23 +400,17 @@ float SpriteDatas::intersection(int squareSize, QRay3D& ray, Position& position,
     QBox3D box;
 
     if (m_kind == MapEditorSubSelectionKind::SpritesFace) {
-        QVector3D pos, size, center, off;
-        getPosSizeCenter(pos, size, center, off, squareSize, position);
-
-        QVector3D vecA = Sprite::modelQuad[0] * size + pos,
-                  vecB = Sprite::modelQuad[1] * size + pos,
-                  vecC = Sprite::modelQuad[2] * size + pos,
-                  vecD = Sprite::modelQuad[3] * size + pos;
-        rotateSprite(vecA, vecB, vecC, vecD, center, -cameraHAngle - 90);
-        box = QBox3D(vecA, vecC);
+        QVector3D corner1, corner2;
+        getFaceBoxCorners(squareSize, position, cameraHAngle, corner1,
+                          corner2);
+        box = QBox3D(corner1, corner2);
         minDistance = box.intersection(ray);
     }
     else {
-        int i = 0;
-        while (i < m_vertices.size()) {
-            QVector3D vecA = m_vertices.at(i++),
-                      vecC = m_vertices.at(i++);
-            box = QBox3D(vecA, vecC);
+        QVector<QVector3D> corners;
+        getBoxesCorners(squareSize, position, corners);
+        for (int i = 0; i < corners.size(); i += 2) {
+            box = QBox3D(corners.at(i), corners.at(i + 1));
             distance = box.intersection(ray);
             Wanok::getMinDistance(minDistance, distance);
         }
@@ -354,15 +421,17 @@ float SpriteDatas::intersection(int squareSize, QRay3D& ray, Position& position,
 
 // -------------------------------------------------------
 
-float SpriteDatas::intersectionPlane(int angle, QRay3D& ray)
+float SpriteDatas::intersectionPlane(int squareSize, Position& position,
+                                     QRay3D& ray)
 {
     QVector3D normal(0, 0, 1);
     QMatrix4x4 m;
-    m.rotate(-angle, 0.0, 1.0, 0.0);
+    m.rotate(-position.angle(), 0.0, 1.0, 0.0);
     normal = normal * m;
 
-    QPlane3D plane(m_vertices.isEmpty() ? QVector3D() : m_vertices.at(0),
-                   normal);
+    QVector<QVector3D> corners;
+    getBoxesCorners(squareSize, position, corners);
+    QPlane3D plane(corners.at(0), normal);
 
     return plane.intersection(ray);
 }
@@ -380,10 +449,10 @@ void SpriteDatas::read(const QJsonObject & json){
 
     // Texture
     QJsonArray tab = json["t"].toArray();
-    m_textureRect->setLeft(tab[0].toInt());
-    m_textureRect->setTop(tab[1].toInt());
-    m_textureRect->setWidth(tab[2].toInt());
-    m_textureRect->setHeight(tab[3].toInt());
+    m_textureRect.setLeft(tab[0].toInt());
+    m_textureRect.setTop(tab[1].toInt());
+    m_textureRect.setWidth(tab[2].toInt());
+    m_textureRect.setHeight(tab[3].toInt());
 
     if (json.contains(jsonFront))
         m_front = json[jsonFront].toBool();
@@ -398,10 +467,10 @@ void SpriteDatas::write(QJsonObject & json) const{
     json["k"] = (int) m_kind;
 
     // Texture
-    tab.append(m_textureRect->left());
-    tab.append(m_textureRect->top());
-    tab.append(m_textureRect->width());
-    tab.append(m_textureRect->height());
+    tab.append(m_textureRect.left());
+    tab.append(m_textureRect.top());
+    tab.append(m_textureRect.width());
+    tab.append(m_textureRect.height());
     json["t"] = tab;
 
     if (!m_front)
@@ -428,7 +497,8 @@ SpriteObject::SpriteObject(SpriteDatas &datas, QOpenGLTexture* texture) :
     m_vertexBuffer(QOpenGLBuffer::VertexBuffer),
     m_indexBuffer(QOpenGLBuffer::IndexBuffer),
     m_programStatic(nullptr),
-    m_programFace(nullptr)
+    m_programFace(nullptr),
+    m_quads(0)
 {
 
 }
@@ -455,6 +525,7 @@ void SpriteObject::initializeVertices(int squareSize, Position& position)
                                m_texture->height(),
                                m_verticesStatic, m_indexes, m_verticesFace,
                                m_indexes, position, count, count);
+    m_quads = count;
 }
 
 // -------------------------------------------------------
@@ -483,24 +554,34 @@ void SpriteObject::initializeFaceGL(QOpenGLShaderProgram *programFace){
 
 void SpriteObject::updateStaticGL(){
     Map::updateGLStatic(m_vertexBuffer, m_indexBuffer, m_verticesStatic,
-                        m_indexes, m_vao, m_programStatic);
+                        m_vao, m_programStatic, m_packing);
+    m_verticesStatic = QVector<Vertex>();
+    m_indexes = QVector<GLuint>();
 }
 
 // -------------------------------------------------------
 
 void SpriteObject::updateFaceGL(){
     Map::updateGLFace(m_vertexBuffer, m_indexBuffer, m_verticesFace,
-                      m_indexes, m_vao, m_programFace);
+                      m_vao, m_programFace, m_packing);
+    m_verticesFace = QVector<VertexBillboard>();
+    m_indexes = QVector<GLuint>();
 }
 
 // -------------------------------------------------------
 
 void SpriteObject::paintGL(){
     m_vao.bind();
-    glDrawElements(GL_TRIANGLES, m_indexes.size(), GL_UNSIGNED_INT, 0);
+    m_packing.draw(*this, 0, m_quads);
     m_vao.release();
 }
 
+// -------------------------------------------------------
+
+void SpriteObject::addMemoryUsage(MapMemoryUsage& usage) const {
+    usage.addBuffers(m_packing.bufferBytes());
+}
+
 // -------------------------------------------------------
 //
 //
@@ -536,10 +617,22 @@ bool SpriteWallDatas::operator!=(const SpriteWallDatas& other) const {
     return !operator==(other);
 }
 
+void* SpriteWallDatas::operator new(size_t size) {
+    return MapElementPool<SpriteWallDatas>::allocate(size);
+}
+
+void SpriteWallDatas::operator delete(void* pointer, size_t size) {
+    MapElementPool<SpriteWallDatas>::deallocate(pointer, size);
+}
+
 int SpriteWallDatas::wallID() const {
     return m_wallID;
 }
 
+void SpriteWallDatas::setWallID(int id) {
+    m_wallID = id;
+}
+
 MapEditorSelectionKind SpriteWallDatas::getKind() const {
     return MapEditorSelectionKind::Sprites;
 }
@@ -714,6 +807,12 @@ void SpriteWallDatas::initializeVertices(int squareSize, int width, int height,
 
 // -------------------------------------------------------
 
+void SpriteWallDatas::appendBox(BoxesBatch& boxes) const {
+    boxes.append(m_vecA, m_vecC);
+}
+
+// -------------------------------------------------------
+
 float SpriteWallDatas::intersection(QRay3D& ray)
 {
     QBox3D box(m_vecA, m_vecC);
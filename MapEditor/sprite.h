@@ -31,11 +31,15 @@
 #include "position.h"
 #include "vertex.h"
 #include "vertexbillboard.h"
+#include "vertexpacking.h"
+#include "mapmemoryusage.h"
 #include "mapeditorsubselectionkind.h"
 #include "mapproperties.h"
 #include "mapelement.h"
 #include "spritewallkind.h"
 #include "qray3d.h"
+#include "boxesbatch.h"
+#include "mapelementpool.h"
 
 // -------------------------------------------------------
 //
@@ -69,15 +73,18 @@ class SpriteDatas : public MapElement
 {
 public:
     SpriteDatas();
-    SpriteDatas(MapEditorSubSelectionKind kind, QRect* textureRect,
+    SpriteDatas(MapEditorSubSelectionKind kind, const QRect& textureRect,
                 bool front = true);
     virtual ~SpriteDatas();
     bool operator==(const SpriteDatas& other) const;
     bool operator!=(const SpriteDatas& other) const;
+    static void* operator new(size_t size);
+    static void operator delete(void* pointer, size_t size);
     virtual MapEditorSelectionKind getKind() const;
     virtual MapEditorSubSelectionKind getSubKind() const;
     virtual QString toString() const;
-    QRect* textureRect() const;
+    const QRect& textureRect() const;
+    QRect& textureRect();
     void getPosSizeCenter(QVector3D& pos, QVector3D& size, QVector3D& center,
                           QVector3D &offset, int squareSize,
                           Position &position);
@@ -98,9 +105,15 @@ public:
                                         QVector3D& vecC, QVector3D& vecD,
                                         QVector2D& texA, QVector2D& texB,
                                         QVector2D& texC, QVector2D& texD);
+    void getBoxesCorners(int squareSize, Position& position,
+                         QVector<QVector3D>& corners);
+    int appendBoxes(BoxesBatch& boxes, int squareSize, Position& position);
+    void getFaceBoxCorners(int squareSize, Position& position,
+                           int cameraHAngle, QVector3D& corner1,
+                           QVector3D& corner2);
     float intersection(int squareSize, QRay3D& ray, Position& position,
                        int cameraHAngle);
-    float intersectionPlane(int angle, QRay3D& ray);
+    float intersectionPlane(int squareSize, Position& position, QRay3D& ray);
 
     static QString jsonFront;
 
@@ -109,9 +122,8 @@ public:
 
 protected:
     MapEditorSubSelectionKind m_kind;
-    QRect* m_textureRect;
+    QRect m_textureRect;
     bool m_front;
-    QList<QVector3D> m_vertices;
 };
 
 // -------------------------------------------------------
@@ -133,6 +145,7 @@ public:
     void updateStaticGL();
     void updateFaceGL();
     void paintGL();
+    void addMemoryUsage(MapMemoryUsage& usage) const;
 
 protected:
     SpriteDatas& m_datas;
@@ -144,9 +157,13 @@ protected:
     QVector<Vertex> m_verticesStatic;
     QVector<GLuint> m_indexes;
     QOpenGLVertexArrayObject m_vao;
+    VertexPacking m_packing;
     QOpenGLShaderProgram* m_programStatic;
     QVector<VertexBillboard> m_verticesFace;
     QOpenGLShaderProgram* m_programFace;
+
+    // The vertices are freed once uploaded, only their quads count is kept
+    int m_quads;
 };
 
 // -------------------------------------------------------
@@ -164,7 +181,10 @@ public:
     SpriteWallDatas(int wallID);
     bool operator==(const SpriteWallDatas& other) const;
     bool operator!=(const SpriteWallDatas& other) const;
+    static void* operator new(size_t size);
+    static void operator delete(void* pointer, size_t size);
     int wallID() const;
+    void setWallID(int id);
     virtual MapEditorSelectionKind getKind() const;
     virtual MapEditorSubSelectionKind getSubKind() const;
     void update(Position& position);
@@ -181,6 +201,7 @@ public:
                                     QVector<Vertex>& vertices,
                                     QVector<GLuint>& indexes,
                                     Position& position, int& count);
+    void appendBox(BoxesBatch& boxes) const;
     float intersection(QRay3D& ray);
     float intersectionPlane(int angle, QRay3D& ray);
     virtual QString toString() const;
@@ -37,9 +37,7 @@
 
 SpritesWalls::SpritesWalls() :
     m_count(0),
-    m_vertexBuffer(QOpenGLBuffer::VertexBuffer),
-    m_indexBuffer(QOpenGLBuffer::IndexBuffer),
-    m_program(nullptr)
+    m_pickable(0)
 {
 
 }
@@ -59,34 +57,41 @@ void SpritesWalls::initializeVertices(Position &position,
                                       SpriteWallDatas* sprite,
                                       int squareSize, int width, int height)
 {
+    int previousCount = m_count;
     sprite->initializeVertices(squareSize, width, height, m_vertices,
                                m_indexes, position, m_count);
+    for (; previousCount < m_count; previousCount++)
+        m_quads.append(position);
 }
 
 // -------------------------------------------------------
 
-void SpritesWalls::initializeGL(QOpenGLShaderProgram* program) {
-    if (m_program == nullptr){
-        initializeOpenGLFunctions();
+void SpritesWalls::setPickable() {
+    m_pickable = m_count;
+}
 
-        // Programs
-        m_program = program;
-    }
+// -------------------------------------------------------
+
+bool SpritesWalls::getPickedPosition(int quad, Position& position) const {
+    if (quad >= m_pickable)
+        return false;
+    position = m_quads.at(quad);
+
+    return true;
 }
 
 // -------------------------------------------------------
 
-void SpritesWalls::updateGL(){
-    Map::updateGLStatic(m_vertexBuffer, m_indexBuffer, m_vertices, m_indexes,
-                        m_vao, m_program);
+void SpritesWalls::updateArena(PortionArena& arena, int textureID) {
+    arena.append(textureID, m_vertices, m_pickable);
+    m_vertices = QVector<Vertex>();
+    m_indexes = QVector<GLuint>();
 }
 
 // -------------------------------------------------------
 
-void SpritesWalls::paintGL(){
-    m_vao.bind();
-    glDrawElements(GL_TRIANGLES, m_indexes.size(), GL_UNSIGNED_INT, 0);
-    m_vao.release();
+void SpritesWalls::addMemoryUsage(MapMemoryUsage& usage) const {
+    usage.addVertices(m_quads);
 }
 
 // -------------------------------------------------------
@@ -104,23 +109,26 @@ void SpritesWalls::paintGL(){
 // -------------------------------------------------------
 
 Sprites::Sprites() :
-    m_vertexBufferStatic(QOpenGLBuffer::VertexBuffer),
-    m_indexBufferStatic(QOpenGLBuffer::IndexBuffer),
-    m_programStatic(nullptr),
+    m_boxesFacesAngle(0),
+    m_boxesFacesDirty(true),
+    m_boxesSquareSize(0),
+    m_boxesDirty(true),
     m_vertexBufferFace(QOpenGLBuffer::VertexBuffer),
     m_indexBufferFace(QOpenGLBuffer::IndexBuffer),
-    m_programFace(nullptr)
+    m_programFace(nullptr),
+    m_pickableStatic(0),
+    m_pickableFace(0)
 {
 
 }
 
 Sprites::~Sprites()
 {
-    QHash<Position, SpriteDatas*>::iterator i;
+    QHash<PositionKey, SpriteDatas*>::iterator i;
     for (i = m_all.begin(); i != m_all.end(); i++)
         delete *i;
 
-    QHash<Position, SpriteWallDatas*>::iterator j;
+    QHash<PositionKey, SpriteWallDatas*>::iterator j;
     for (j = m_walls.begin(); j != m_walls.end(); j++)
         delete *j;
 
@@ -137,6 +145,8 @@ void Sprites::removeOverflow(Position& p) {
     m_overflow -= p;
 }
 
+const QSet<PositionKey>& Sprites::overflow() const { return m_overflow; }
+
 // -------------------------------------------------------
 //
 //  INTERMEDIARY FUNCTIONS
@@ -159,6 +169,7 @@ void Sprites::changePosition(Position& position, Position& newPosition) {
     SpriteDatas* sprite = m_all.value(position);
     m_all.remove(position);
     m_all.insert(newPosition, sprite);
+    m_boxesDirty = true;
 }
 
 // -------------------------------------------------------
@@ -172,6 +183,7 @@ SpriteDatas* Sprites::spriteAt(Position& position) const {
 void Sprites::setSprite(QSet<Portion>& portionsOverflow, Position& p,
                         SpriteDatas* sprite){
     m_all[p] = sprite;
+    m_boxesDirty = true;
 
     // Getting overflowing portions
     getSetPortionsOverflow(portionsOverflow, p, sprite);
@@ -187,8 +199,8 @@ void Sprites::getSetPortionsOverflow(QSet<Portion>& portionsOverflow,
 {
     Portion currentPortion;
     Map::getGlobalPortion(p, currentPortion);
-    int r = sprite->textureRect()->width() / 2;
-    int h = sprite->textureRect()->height();
+    int r = sprite->textureRect().width() / 2;
+    int h = sprite->textureRect().height();
 
     for (int i = -r; i < r; i++) {
         for (int j = 0; j < h; j++) {
@@ -249,6 +261,7 @@ SpriteDatas* Sprites::removeSprite(QSet<Portion>& portionsOverflow, Position& p)
     SpriteDatas* sprite = m_all.value(p);
     if (sprite != nullptr){
         m_all.remove(p);
+        m_boxesDirty = true;
 
         // Getting overflowing portions
         getSetPortionsOverflow(portionsOverflow, p, sprite);
@@ -311,6 +324,7 @@ bool Sprites::deleteSprite(QSet<Portion>& portionsOverflow, Position& p,
 
 void Sprites::setSpriteWall(Position &p, SpriteWallDatas* sprite) {
     m_walls[p] = sprite;
+    m_boxesDirty = true;
 }
 
 // -------------------------------------------------------
@@ -319,6 +333,7 @@ SpriteWallDatas* Sprites::removeSpriteWall(Position &p) {
     SpriteWallDatas* sprite = m_walls.value(p);
     if (sprite != nullptr){
         m_walls.remove(p);
+        m_boxesDirty = true;
         return sprite;
     }
 
@@ -366,12 +381,12 @@ bool Sprites::deleteSpriteWall(Position &p, QJsonObject &previousObj,
 
 // -------------------------------------------------------
 
-void Sprites::updateSpriteWalls(QHash<Position, MapElement *> &preview,
+void Sprites::updateSpriteWalls(QHash<PositionKey, MapElement *> &preview,
                                 QList<Position> &previewDelete) {
-    QHash<Position, SpriteWallDatas*> spritesWallWithPreview;
+    QHash<PositionKey, SpriteWallDatas*> spritesWallWithPreview;
     getWallsWithPreview(spritesWallWithPreview, preview, previewDelete);
 
-    QHash<Position, SpriteWallDatas*>::iterator i;
+    QHash<PositionKey, SpriteWallDatas*>::iterator i;
     for (i = spritesWallWithPreview.begin(); i != spritesWallWithPreview.end();
          i++)
     {
@@ -384,11 +399,11 @@ void Sprites::updateSpriteWalls(QHash<Position, MapElement *> &preview,
 
 // -------------------------------------------------------
 
-SpriteWallDatas* Sprites::getWallAt(QHash<Position, MapElement *> &preview,
+SpriteWallDatas* Sprites::getWallAt(QHash<PositionKey, MapElement *> &preview,
                                     QList<Position> &previewDelete,
                                     Position &position)
 {
-    QHash<Position, SpriteWallDatas*> spritesWallWithPreview;
+    QHash<PositionKey, SpriteWallDatas*> spritesWallWithPreview;
     getWallsWithPreview(spritesWallWithPreview, preview, previewDelete);
 
     return spritesWallWithPreview.value(position);
@@ -402,13 +417,13 @@ SpriteWallDatas* Sprites::getWallAtPosition(Position& position) {
 
 // -------------------------------------------------------
 
-void Sprites::getWallsWithPreview(QHash<Position, SpriteWallDatas *>
+void Sprites::getWallsWithPreview(QHash<PositionKey, SpriteWallDatas *>
                                   &spritesWallWithPreview,
-                                  QHash<Position, MapElement *> &preview,
+                                  QHash<PositionKey, MapElement *> &preview,
                                   QList<Position> &previewDelete)
 {
     spritesWallWithPreview = m_walls;
-    QHash<Position, MapElement*>::iterator itw;
+    QHash<PositionKey, MapElement*>::iterator itw;
     for (itw = preview.begin(); itw != preview.end(); itw++) {
         MapElement* element = itw.value();
         if (element->getSubKind() == MapEditorSubSelectionKind::SpritesWall)
@@ -425,7 +440,7 @@ void Sprites::removeSpritesOut(MapProperties& properties) {
     QList<Position> listWalls;
 
     // Global sprites
-    QHash<Position, SpriteDatas*>::iterator i;
+    QHash<PositionKey, SpriteDatas*>::iterator i;
     for (i = m_all.begin(); i != m_all.end(); i++) {
         Position position = i.key();
 
@@ -440,7 +455,7 @@ void Sprites::removeSpritesOut(MapProperties& properties) {
         m_all.remove(listGlobal.at(k));
 
     // Walls sprites
-    QHash<Position, SpriteWallDatas*>::iterator j;
+    QHash<PositionKey, SpriteWallDatas*>::iterator j;
     for (j = m_walls.begin(); j != m_walls.end(); j++) {
         Position position = j.key();
 
@@ -453,6 +468,44 @@ void Sprites::removeSpritesOut(MapProperties& properties) {
     }
     for (int k = 0; k < listWalls.size(); k++)
         m_walls.remove(listWalls.at(k));
+    m_boxesDirty = true;
+}
+
+// -------------------------------------------------------
+
+bool Sprites::remapTextures(const TexturesRemap& textures,
+                            const QHash<int, int>& walls)
+{
+    bool changed = false;
+
+    // Global sprites
+    QHash<PositionKey, SpriteDatas*>::iterator i;
+    for (i = m_all.begin(); i != m_all.end(); i++) {
+        if (MapElement::remapTextureRect(i.value()->textureRect(), textures))
+            changed = true;
+    }
+
+    // Walls sprites
+    QHash<PositionKey, SpriteWallDatas*>::iterator j;
+    for (j = m_walls.begin(); j != m_walls.end(); j++) {
+        QHash<int, int>::const_iterator k = walls.find(j.value()->wallID());
+        if (k != walls.end()) {
+            j.value()->setWallID(k.value());
+            changed = true;
+        }
+    }
+
+    return changed;
+}
+
+// -------------------------------------------------------
+
+void Sprites::getTexturesRects(QList<QPair<Position, QRect>>& textures) const
+{
+    QHash<PositionKey, SpriteDatas*>::const_iterator i;
+    for (i = m_all.begin(); i != m_all.end(); i++)
+        textures.append(QPair<Position, QRect>(i.key(),
+                                               i.value()->textureRect()));
 }
 
 // -------------------------------------------------------
@@ -463,22 +516,27 @@ MapElement* Sprites::updateRaycasting(int squareSize, float &finalDistance,
                                       bool layerOn)
 {
     MapElement* element = nullptr;
+    float distance;
+    int index;
+
+    updateBoxes(squareSize);
+    index = m_boxes.intersection(ray, &distance);
+    if (index != -1 && Wanok::getMinDistance(finalDistance, distance)) {
+        finalPosition = m_boxesPositions.at(index);
+        element = m_all.value(finalPosition);
+    }
 
-    for (QHash<Position, SpriteDatas*>::iterator i = m_all.begin();
-         i != m_all.end(); i++)
-    {
-        Position position = i.key();
-        SpriteDatas *sprite = i.value();
-        if (updateRaycastingAt(position, sprite, squareSize, finalDistance,
-                               finalPosition, ray, cameraHAngle))
-        {
-            element = sprite;
-        }
+    // Face sprites are turned to the camera
+    updateBoxesFaces(squareSize, cameraHAngle);
+    index = m_boxesFaces.intersection(ray, &distance);
+    if (index != -1 && Wanok::getMinDistance(finalDistance, distance)) {
+        finalPosition = m_boxesFacesPositions.at(index);
+        element = m_all.value(finalPosition);
     }
 
     // Overflow
     Map* map = Wanok::get()->project()->currentMap();
-    for (QSet<Position>::iterator i = m_overflow.begin();
+    for (QSet<PositionKey>::iterator i = m_overflow.begin();
          i != m_overflow.end(); i++)
     {
         Position position = *i;
@@ -494,16 +552,10 @@ MapElement* Sprites::updateRaycasting(int squareSize, float &finalDistance,
 
     // If layer on, also check the walls, and sprites on walls
     if (layerOn) {
-        for (QHash<Position, SpriteWallDatas*>::iterator i =
-             m_walls.begin(); i != m_walls.end(); i++)
-        {
-            Position position = i.key();
-            SpriteWallDatas *wall = i.value();
-            if (updateRaycastingWallAt(position, wall, finalDistance,
-                                       finalPosition, ray))
-            {
-                element = wall;
-            }
+        index = m_boxesWalls.intersection(ray, &distance);
+        if (index != -1 && Wanok::getMinDistance(finalDistance, distance)) {
+            finalPosition = m_boxesWallsPositions.at(index);
+            element = m_walls.value(finalPosition);
         }
     }
 
@@ -544,6 +596,112 @@ bool Sprites::updateRaycastingWallAt(
 
 // -------------------------------------------------------
 
+void Sprites::updateBoxes(int squareSize) {
+    if (!m_boxesDirty && squareSize == m_boxesSquareSize)
+        return;
+
+    m_boxes.clear();
+    m_boxesPositions.clear();
+    m_boxesFacesPositions.clear();
+    for (QHash<PositionKey, SpriteDatas*>::iterator i = m_all.begin();
+         i != m_all.end(); i++)
+    {
+        Position position = i.key();
+        SpriteDatas* sprite = i.value();
+        if (sprite->getSubKind() == MapEditorSubSelectionKind::SpritesFace)
+            m_boxesFacesPositions.append(position);
+        else {
+            int count = sprite->appendBoxes(m_boxes, squareSize, position);
+            for (int j = 0; j < count; j++)
+                m_boxesPositions.append(position);
+        }
+    }
+
+    m_boxesWalls.clear();
+    m_boxesWallsPositions.clear();
+    for (QHash<PositionKey, SpriteWallDatas*>::iterator i = m_walls.begin();
+         i != m_walls.end(); i++)
+    {
+        i.value()->appendBox(m_boxesWalls);
+        m_boxesWallsPositions.append(i.key());
+    }
+
+    m_boxesSquareSize = squareSize;
+    m_boxesDirty = false;
+    m_boxesFacesDirty = true;
+}
+
+// -------------------------------------------------------
+//  updateBoxesFaces: the face sprites boxes only change with the camera
+//  angle, so they are not computed again for each ray
+
+void Sprites::updateBoxesFaces(int squareSize, int cameraHAngle) {
+    if (!m_boxesFacesDirty && cameraHAngle == m_boxesFacesAngle)
+        return;
+
+    m_boxesFaces.clear();
+    m_boxesFaces.reserve(m_boxesFacesPositions.size());
+    for (int i = 0; i < m_boxesFacesPositions.size(); i++) {
+        Position position = m_boxesFacesPositions.at(i);
+        QVector3D corner1, corner2;
+        m_all.value(position)->getFaceBoxCorners(squareSize, position,
+                                                 cameraHAngle, corner1,
+                                                 corner2);
+        m_boxesFaces.append(corner1, corner2);
+    }
+
+    m_boxesFacesAngle = cameraHAngle;
+    m_boxesFacesDirty = false;
+}
+
+// -------------------------------------------------------
+
+MapElement* Sprites::getPickedElement(MapPickingKind kind, int quad, int extra,
+                                      Position& position) const
+{
+    switch (kind) {
+    case MapPickingKind::Sprites:
+        if (quad >= m_pickableStatic)
+            return nullptr;
+        position = m_quadsStatic.at(quad);
+        return m_all.value(position);
+    case MapPickingKind::SpritesFace:
+        if (quad >= m_pickableFace)
+            return nullptr;
+        position = m_quadsFace.at(quad);
+        return m_all.value(position);
+    case MapPickingKind::SpritesWalls: {
+        // extra is the wall ID
+        SpritesWalls* sprites = m_wallsGL.value(extra);
+        if (sprites == nullptr || !sprites->getPickedPosition(quad, position))
+            return nullptr;
+        return m_walls.value(position);
+    }
+    default:
+        return nullptr;
+    }
+}
+
+// -------------------------------------------------------
+//  getPickableQuads: the quads of the sprite at this position, used for
+//  picking only one sprite of the portion
+
+void Sprites::getPickableQuads(const Position& position,
+                               QList<int>& quadsStatic,
+                               QList<int>& quadsFace) const
+{
+    for (int i = 0; i < m_pickableStatic; i++) {
+        if (m_quadsStatic.at(i) == position)
+            quadsStatic.append(i);
+    }
+    for (int i = 0; i < m_pickableFace; i++) {
+        if (m_quadsFace.at(i) == position)
+            quadsFace.append(i);
+    }
+}
+
+// -------------------------------------------------------
+
 MapElement* Sprites::getMapElementAt(Position& position,
                                      MapEditorSubSelectionKind subKind)
 {
@@ -608,19 +766,22 @@ void Sprites::updateRemoveLayer(QSet<Portion> portionsOverflow,
 //
 // -------------------------------------------------------
 
-void Sprites::initializeVertices(QHash<int, QOpenGLTexture *> &texturesWalls,
-                                 QHash<Position, MapElement *> &previewSquares,
-                                 QList<Position> &previewDelete,
-                                 int squareSize, int width, int height)
+void Sprites::initializeVertices(
+        QHash<int, QOpenGLTexture *> &texturesWalls,
+        QHash<PositionKey, MapElement *> &previewSquares,
+        QList<Position> &previewDelete, int squareSize, int width, int height)
 {
     int countStatic = 0;
     int countFace = 0;
+    m_boxesDirty = true;
 
     // Clear
     m_verticesStatic.clear();
     m_indexesStatic.clear();
     m_verticesFace.clear();
     m_indexesFace.clear();
+    m_quadsStatic.clear();
+    m_quadsFace.clear();
     for (QHash<int, SpritesWalls*>::iterator i = m_wallsGL.begin();
          i != m_wallsGL.end(); i++)
     {
@@ -629,8 +790,8 @@ void Sprites::initializeVertices(QHash<int, QOpenGLTexture *> &texturesWalls,
     m_wallsGL.clear();
 
     // Create temp hash for preview
-    QHash<Position, SpriteDatas*> spritesWithPreview(m_all);
-    for (QHash<Position, MapElement*>::iterator i = previewSquares.begin();
+    QHash<PositionKey, SpriteDatas*> spritesWithPreview(m_all);
+    for (QHash<PositionKey, MapElement*>::iterator i = previewSquares.begin();
          i != previewSquares.end(); i++)
     {
         MapElement* element = i.value();
@@ -640,98 +801,211 @@ void Sprites::initializeVertices(QHash<int, QOpenGLTexture *> &texturesWalls,
             spritesWithPreview[i.key()] = (SpriteDatas*) element;
         }
     }
-    QHash<Position, SpriteWallDatas*> spritesWallWithPreview;
+    QHash<PositionKey, SpriteWallDatas*> spritesWallWithPreview;
     getWallsWithPreview(spritesWallWithPreview, previewSquares, previewDelete);
 
-    // Initialize vertices in squares
-    for (QHash<Position, SpriteDatas*>::iterator i = spritesWithPreview.begin();
-         i != spritesWithPreview.end(); i++)
+    // Initialize vertices in squares (previews are added at the end so that
+    // the picking can skip them)
+    QList<Position> positionsPreview;
+    for (QHash<PositionKey, SpriteDatas*>::iterator i =
+         spritesWithPreview.begin(); i != spritesWithPreview.end(); i++)
     {
         Position position = i.key();
         SpriteDatas* sprite = i.value();
-
-        sprite->initializeVertices(squareSize, width, height,
-                                   m_verticesStatic, m_indexesStatic,
-                                   m_verticesFace, m_indexesFace,
-                                   position, countStatic, countFace);
+        if (sprite != m_all.value(position))
+            positionsPreview.append(position);
+        else {
+            initializeVerticesAt(position, sprite, squareSize, width, height,
+                                 countStatic, countFace);
+        }
+    }
+    m_pickableStatic = countStatic;
+    m_pickableFace = countFace;
+    for (int i = 0; i < positionsPreview.size(); i++) {
+        Position position = positionsPreview.at(i);
+        initializeVerticesAt(position, spritesWithPreview.value(position),
+                             squareSize, width, height, countStatic,
+                             countFace);
     }
 
     // Initialize vertices for walls
-    for (QHash<Position, SpriteWallDatas*>::iterator i =
+    positionsPreview.clear();
+    for (QHash<PositionKey, SpriteWallDatas*>::iterator i =
          spritesWallWithPreview.begin(); i != spritesWallWithPreview.end(); i++)
     {
         Position position = i.key();
         SpriteWallDatas* sprite = i.value();
-        int id = sprite->wallID();
-        SpritesWalls* sprites = m_wallsGL.value(id);
-        if (sprites == nullptr) {
-            sprites = new SpritesWalls;
-            m_wallsGL[id] = sprites;
+        if (sprite != m_walls.value(position))
+            positionsPreview.append(position);
+        else {
+            initializeVerticesWallAt(texturesWalls, position, sprite,
+                                     squareSize);
         }
-        QOpenGLTexture* texture = texturesWalls.value(id);
-        if (texture == nullptr)
-            texture = texturesWalls.value(-1);
+    }
+    for (QHash<int, SpritesWalls*>::iterator i = m_wallsGL.begin();
+         i != m_wallsGL.end(); i++)
+    {
+        i.value()->setPickable();
+    }
+    for (int i = 0; i < positionsPreview.size(); i++) {
+        Position position = positionsPreview.at(i);
+        initializeVerticesWallAt(texturesWalls, position,
+                                 spritesWallWithPreview.value(position),
+                                 squareSize);
+    }
+}
+
+// -------------------------------------------------------
+
+void Sprites::initializeVerticesAt(Position& position, SpriteDatas* sprite,
+                                   int squareSize, int width, int height,
+                                   int& countStatic, int& countFace)
+{
+    int previousStatic = countStatic;
+    int previousFace = countFace;
+    sprite->initializeVertices(squareSize, width, height,
+                               m_verticesStatic, m_indexesStatic,
+                               m_verticesFace, m_indexesFace,
+                               position, countStatic, countFace);
+    for (; previousStatic < countStatic; previousStatic++)
+        m_quadsStatic.append(position);
+    for (; previousFace < countFace; previousFace++)
+        m_quadsFace.append(position);
+}
+
+// -------------------------------------------------------
+
+void Sprites::initializeVerticesWallAt(
+        QHash<int, QOpenGLTexture*>& texturesWalls, Position& position,
+        SpriteWallDatas* sprite, int squareSize)
+{
+    int id = sprite->wallID();
+    SpritesWalls* sprites = m_wallsGL.value(id);
+    if (sprites == nullptr) {
+        sprites = new SpritesWalls;
+        m_wallsGL[id] = sprites;
+    }
+    QOpenGLTexture* texture = texturesWalls.value(id);
+    if (texture == nullptr)
+        texture = texturesWalls.value(-1);
+
+    sprites->initializeVertices(position, sprite, squareSize,
+                                texture->width(), texture->height());
+}
+
+// -------------------------------------------------------
+
+void Sprites::bakeVertices(PortionGeometry& geometry,
+                           QHash<int, QSize>& sizesWalls, int squareSize,
+                           int width, int height)
+{
+    for (QHash<PositionKey, SpriteDatas*>::iterator i = m_all.begin();
+         i != m_all.end(); i++)
+    {
+        Position position = i.key();
+        i.value()->initializeVertices(squareSize, width, height,
+                                      geometry.verticesStatic(),
+                                      geometry.indexesStatic(),
+                                      geometry.verticesFace(),
+                                      geometry.indexesFace(), position,
+                                      geometry.countStatic(),
+                                      geometry.countFace());
+    }
 
-        sprites->initializeVertices(position, sprite, squareSize,
-                                    texture->width(), texture->height());
+    for (QHash<PositionKey, SpriteWallDatas*>::iterator i = m_walls.begin();
+         i != m_walls.end(); i++)
+    {
+        Position position = i.key();
+        int id = i.value()->wallID();
+        QSize size = sizesWalls.value(id, sizesWalls.value(-1));
+        i.value()->initializeVertices(squareSize, size.width(), size.height(),
+                                      geometry.verticesWalls(id),
+                                      geometry.indexesWalls(id), position,
+                                      geometry.countWalls(id));
     }
 }
 
 // -------------------------------------------------------
 
-void Sprites::initializeGL(QOpenGLShaderProgram* programStatic,
-                           QOpenGLShaderProgram *programFace){
-    if (m_programStatic == nullptr){
+void Sprites::initializeGL(QOpenGLShaderProgram *programFace){
+    if (m_programFace == nullptr){
         initializeOpenGLFunctions();
 
         // Programs
-        m_programStatic = programStatic;
         m_programFace = programFace;
     }
-
-    QHash<int, SpritesWalls*>::iterator i;
-    for (i = m_wallsGL.begin(); i != m_wallsGL.end(); i++)
-        i.value()->initializeGL(programStatic);
 }
 
 // -------------------------------------------------------
 
 void Sprites::updateGL(){
-    Map::updateGLStatic(m_vertexBufferStatic, m_indexBufferStatic,
-                        m_verticesStatic, m_indexesStatic, m_vaoStatic,
-                        m_programStatic);
     Map::updateGLFace(m_vertexBufferFace, m_indexBufferFace,
-                      m_verticesFace, m_indexesFace, m_vaoFace,
-                      m_programFace);
+                      m_verticesFace, m_vaoFace, m_programFace,
+                      m_packingFace);
+
+    // Only the quads count is needed for drawing once uploaded
+    m_verticesFace = QVector<VertexBillboard>();
+    m_indexesFace = QVector<GLuint>();
+}
+
+// -------------------------------------------------------
+
+void Sprites::updateArena(PortionArena& arena) {
+    arena.append(PortionArena::SPRITES, m_verticesStatic, m_pickableStatic);
     QHash<int, SpritesWalls*>::iterator i;
     for (i = m_wallsGL.begin(); i != m_wallsGL.end(); i++)
-        i.value()->updateGL();
+        i.value()->updateArena(arena, i.key());
+
+    // The arena keeps the vertices until they are uploaded
+    m_verticesStatic = QVector<Vertex>();
+    m_indexesStatic = QVector<GLuint>();
 }
 
 // -------------------------------------------------------
 
-void Sprites::paintGL(){
-    m_vaoStatic.bind();
-    glDrawElements(GL_TRIANGLES, m_indexesStatic.size(), GL_UNSIGNED_INT, 0);
-    m_vaoStatic.release();
+void Sprites::addMemoryUsage(MapMemoryUsage& usage) const {
+    usage.addElements(m_all.size(), sizeof(SpriteDatas));
+    usage.addElements(m_walls.size(), sizeof(SpriteWallDatas));
+    usage.addVertices(m_boxes.bytes());
+    usage.addVertices(m_boxesPositions);
+    usage.addVertices(m_boxesFaces.bytes());
+    usage.addVertices(m_boxesFacesPositions);
+    usage.addVertices(m_boxesWalls.bytes());
+    usage.addVertices(m_boxesWallsPositions);
+    usage.addVertices(m_quadsStatic);
+    usage.addVertices(m_quadsFace);
+    usage.addBuffers(m_packingFace.bufferBytes());
+    QHash<int, SpritesWalls*>::const_iterator i;
+    for (i = m_wallsGL.begin(); i != m_wallsGL.end(); i++)
+        i.value()->addMemoryUsage(usage);
 }
 
 // -------------------------------------------------------
 
 void Sprites::paintFaceGL(){
     m_vaoFace.bind();
-    glDrawElements(GL_TRIANGLES, m_indexesFace.size(), GL_UNSIGNED_INT, 0);
+    m_packingFace.draw(*this, 0, m_quadsFace.size());
+    m_vaoFace.release();
+}
+
+// -------------------------------------------------------
+
+void Sprites::paintFacePickingGL(){
+    m_vaoFace.bind();
+    m_packingFace.draw(*this, 0, m_pickableFace);
     m_vaoFace.release();
 }
 
 // -------------------------------------------------------
 
-void Sprites::paintSpritesWalls(int textureID) {
-    SpritesWalls* sprites = m_wallsGL.value(textureID);
-    if (sprites != nullptr)
-        sprites->paintGL();
+void Sprites::paintFacePickingGL(const QList<int>& quads){
+    m_vaoFace.bind();
+    for (int i = 0; i < quads.size(); i++)
+        m_packingFace.draw(*this, quads.at(i), 1);
+    m_vaoFace.release();
 }
 
+
 // -------------------------------------------------------
 //
 //  READ / WRITE
@@ -772,6 +1046,7 @@ void Sprites::read(const QJsonObject & json){
         position.read(tabPosition);
         m_overflow += position;
     }
+    m_boxesDirty = true;
 }
 
 // -------------------------------------------------------
@@ -780,7 +1055,7 @@ void Sprites::write(QJsonObject & json) const{
     QJsonArray tabGlobals, tabWalls, tabOverflow;
 
     // Globals
-    for (QHash<Position, SpriteDatas*>::const_iterator i = m_all.begin();
+    for (QHash<PositionKey, SpriteDatas*>::const_iterator i = m_all.begin();
          i != m_all.end(); i++)
     {
         QJsonObject objHash;
@@ -797,12 +1072,12 @@ void Sprites::write(QJsonObject & json) const{
     json["list"] = tabGlobals;
 
     // Walls
-    for (QHash<Position, SpriteWallDatas*>::const_iterator i =
+    for (QHash<PositionKey, SpriteWallDatas*>::const_iterator i =
          m_walls.begin(); i != m_walls.end(); i++)
     {
         QJsonObject objHash;
         QJsonArray tabKey;
-        i.key().write(tabKey);
+        i.key().toPosition().write(tabKey);
         QJsonObject objSprite;
         i.value()->write(objSprite);
 
@@ -813,7 +1088,7 @@ void Sprites::write(QJsonObject & json) const{
     json["walls"] = tabWalls;
 
     // Overflow
-    for (QSet<Position>::const_iterator i = m_overflow.begin();
+    for (QSet<PositionKey>::const_iterator i = m_overflow.begin();
          i != m_overflow.end(); i++)
     {
         Position position = *i;
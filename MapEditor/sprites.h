@@ -21,6 +21,10 @@
 #define SPRITES_H
 
 #include "sprite.h"
+#include "positionkey.h"
+#include "portiongeometry.h"
+#include "mappickingkind.h"
+#include "portionarena.h"
 
 // -------------------------------------------------------
 //
@@ -30,27 +34,28 @@
 //
 // -------------------------------------------------------
 
-class SpritesWalls : protected QOpenGLFunctions
+class SpritesWalls
 {
 public:
     SpritesWalls();
     virtual ~SpritesWalls();
     void initializeVertices(Position& position, SpriteWallDatas* sprite,
                             int squareSize, int width, int height);
-    void initializeGL(QOpenGLShaderProgram* program);
-    void updateGL();
-    void paintGL();
+    void setPickable();
+    bool getPickedPosition(int quad, Position& position) const;
+    void updateArena(PortionArena& arena, int textureID);
+    void addMemoryUsage(MapMemoryUsage& usage) const;
 
 protected:
     int m_count;
 
-    // OpenGL
-    QOpenGLBuffer m_vertexBuffer;
-    QOpenGLBuffer m_indexBuffer;
+    // Position of each quad for picking, the previews being the last quads
+    QVector<Position> m_quads;
+    int m_pickable;
+
+    // Vertices, only kept until they are given to the arena of the portion
     QVector<Vertex> m_vertices;
     QVector<GLuint> m_indexes;
-    QOpenGLVertexArrayObject m_vao;
-    QOpenGLShaderProgram* m_program;
 };
 
 // -------------------------------------------------------
@@ -68,6 +73,7 @@ public:
     virtual ~Sprites();
     void addOverflow(Position& p);
     void removeOverflow(Position& p);
+    const QSet<PositionKey>& overflow() const;
     bool isEmpty() const;
     bool contains(Position& position) const;
     void changePosition(Position& position, Position& newPosition);
@@ -92,17 +98,20 @@ public:
                        MapEditorSubSelectionKind &previousType);
     bool deleteSpriteWall(Position& p, QJsonObject &previousObj,
                           MapEditorSubSelectionKind &previousType);
-    void updateSpriteWalls(QHash<Position, MapElement*>& preview,
+    void updateSpriteWalls(QHash<PositionKey, MapElement*>& preview,
                            QList<Position> &previewDelete);
-    SpriteWallDatas* getWallAt(QHash<Position, MapElement*>& preview,
+    SpriteWallDatas* getWallAt(QHash<PositionKey, MapElement*>& preview,
                                QList<Position> &previewDelete,
                                Position& position);
     SpriteWallDatas* getWallAtPosition(Position& position);
-    void getWallsWithPreview(QHash<Position, SpriteWallDatas*>&
+    void getWallsWithPreview(QHash<PositionKey, SpriteWallDatas*>&
                              spritesWallWithPreview,
-                             QHash<Position, MapElement *>& preview,
+                             QHash<PositionKey, MapElement *>& preview,
                              QList<Position>& previewDelete);
     void removeSpritesOut(MapProperties& properties);
+    bool remapTextures(const TexturesRemap& textures,
+                       const QHash<int, int>& walls);
+    void getTexturesRects(QList<QPair<Position, QRect>>& textures) const;
     MapElement *updateRaycasting(int squareSize, float& finalDistance,
                                  Position &finalPosition, QRay3D &ray,
                                  double cameraHAngle, bool layerOn);
@@ -113,6 +122,12 @@ public:
     bool updateRaycastingWallAt(
             Position &position, SpriteWallDatas* wall,
             float &finalDistance, Position &finalPosition, QRay3D& ray);
+    void updateBoxes(int squareSize);
+    void updateBoxesFaces(int squareSize, int cameraHAngle);
+    MapElement* getPickedElement(MapPickingKind kind, int quad, int extra,
+                                 Position& position) const;
+    void getPickableQuads(const Position& position, QList<int>& quadsStatic,
+                          QList<int>& quadsFace) const;
     MapElement* getMapElementAt(Position& position,
                                 MapEditorSubSelectionKind subKind);
     int getLastLayerAt(Position& position) const;
@@ -123,32 +138,52 @@ public:
             QList<Position> positions);
 
     void initializeVertices(QHash<int, QOpenGLTexture*>& texturesWalls,
-                            QHash<Position, MapElement*>& previewSquares,
+                            QHash<PositionKey, MapElement*>& previewSquares,
                             QList<Position>& previewDelete,
                             int squareSize, int width, int height);
-    void initializeGL(QOpenGLShaderProgram* programStatic,
-                      QOpenGLShaderProgram* programFace);
+    void initializeVerticesAt(Position& position, SpriteDatas* sprite,
+                              int squareSize, int width, int height,
+                              int& countStatic, int& countFace);
+    void initializeVerticesWallAt(QHash<int, QOpenGLTexture*>& texturesWalls,
+                                  Position& position, SpriteWallDatas* sprite,
+                                  int squareSize);
+    void bakeVertices(PortionGeometry& geometry, QHash<int, QSize>& sizesWalls,
+                      int squareSize, int width, int height);
+    void initializeGL(QOpenGLShaderProgram* programFace);
     void updateGL();
-    void paintGL();
+    void updateArena(PortionArena& arena);
+    void addMemoryUsage(MapMemoryUsage& usage) const;
     void paintFaceGL();
-    void paintSpritesWalls(int textureID);
+    void paintFacePickingGL();
+    void paintFacePickingGL(const QList<int>& quads);
 
     virtual void read(const QJsonObject &json);
     virtual void write(QJsonObject &json) const;
 
 protected:
-    QHash<Position, SpriteDatas*> m_all;
-    QHash<Position, SpriteWallDatas*> m_walls;
+    QHash<PositionKey, SpriteDatas*> m_all;
+    QHash<PositionKey, SpriteWallDatas*> m_walls;
     QHash<int, SpritesWalls*> m_wallsGL;
-    QSet<Position> m_overflow;
+    QSet<PositionKey> m_overflow;
+
+    // Raycasting boxes, rebuilt after any change of the sprites or vertices
+    BoxesBatch m_boxes;
+    QVector<Position> m_boxesPositions;
 
-    // OpenGL static
-    QOpenGLBuffer m_vertexBufferStatic;
-    QOpenGLBuffer m_indexBufferStatic;
+    // Face sprites boxes, rebuilt when the camera turns
+    BoxesBatch m_boxesFaces;
+    QVector<Position> m_boxesFacesPositions;
+    int m_boxesFacesAngle;
+    bool m_boxesFacesDirty;
+
+    BoxesBatch m_boxesWalls;
+    QVector<Position> m_boxesWallsPositions;
+    int m_boxesSquareSize;
+    bool m_boxesDirty;
+
+    // Static vertices, only kept until they are given to the arena
     QVector<Vertex> m_verticesStatic;
     QVector<GLuint> m_indexesStatic;
-    QOpenGLVertexArrayObject m_vaoStatic;
-    QOpenGLShaderProgram* m_programStatic;
 
     // OpenGL face
     QOpenGLBuffer m_vertexBufferFace;
@@ -156,7 +191,14 @@ protected:
     QVector<VertexBillboard> m_verticesFace;
     QVector<GLuint> m_indexesFace;
     QOpenGLVertexArrayObject m_vaoFace;
+    VertexPacking m_packingFace;
     QOpenGLShaderProgram* m_programFace;
+
+    // Position of each quad for picking, the previews being the last quads
+    QVector<Position> m_quadsStatic;
+    int m_pickableStatic;
+    QVector<Position> m_quadsFace;
+    int m_pickableFace;
 };
 
 #endif // SPRITES_H
@@ -0,0 +1,71 @@
+/*
+    RPG Paper Maker Copyright (C) 2017 Marie Laporte
+
+    This file is part of RPG Paper Maker.
+
+    RPG Paper Maker is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    RPG Paper Maker is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with Foobar.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include "vertexbillboardpacked.h"
+
+const int VertexBillboardPacked::positionTupleSize = 3;
+
+const int VertexBillboardPacked::texCoupleSize = 2;
+
+const int VertexBillboardPacked::cornerTupleSize = 3;
+
+int VertexBillboardPacked::positionOffset() {
+    return offsetof(VertexBillboardPacked, m_centerPosition);
+}
+
+int VertexBillboardPacked::texOffset() {
+    return offsetof(VertexBillboardPacked, m_tex);
+}
+
+int VertexBillboardPacked::cornerOffset() {
+    return offsetof(VertexBillboardPacked, m_corner);
+}
+
+int VertexBillboardPacked::stride() { return sizeof(VertexBillboardPacked); }
+
+// -------------------------------------------------------
+//
+//  CONSTRUCTOR / DESTRUCTOR / GET / SET
+//
+// -------------------------------------------------------
+
+VertexBillboardPacked::VertexBillboardPacked()
+{
+
+}
+
+VertexBillboardPacked::VertexBillboardPacked(const VertexBillboard& vertex,
+                                             const VertexPacking& packing)
+{
+    QVector3D center = vertex.centerPosition();
+    QVector2D tex = vertex.tex();
+    QVector2D size = vertex.size();
+    QVector3D model = vertex.model();
+
+    m_centerPosition[0] = packing.packPosition(center.x(), 0);
+    m_centerPosition[1] = packing.packPosition(center.y(), 1);
+    m_centerPosition[2] = packing.packPosition(center.z(), 2);
+    m_centerPosition[3] = 0;
+    m_tex[0] = VertexPacking::packTex(tex.x());
+    m_tex[1] = VertexPacking::packTex(tex.y());
+    m_corner[0] = packing.packLength(model.x() * size.x());
+    m_corner[1] = packing.packLength(model.y() * size.y());
+    m_corner[2] = packing.packLength(model.z());
+    m_corner[3] = 0;
+}
@@ -0,0 +1,56 @@
+/*
+    RPG Paper Maker Copyright (C) 2017 Marie Laporte
+
+    This file is part of RPG Paper Maker.
+
+    RPG Paper Maker is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    RPG Paper Maker is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with Foobar.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#ifndef VERTEXBILLBOARDPACKED_H
+#define VERTEXBILLBOARDPACKED_H
+
+#include "vertexbillboard.h"
+#include "vertexpacking.h"
+
+// -------------------------------------------------------
+//
+//  CLASS VertexBillboardPacked
+//
+//  A billboard vertex packed for the GPU. The model and the size are merged
+//  into the offset of the corner from the center, in the camera space
+//  (20 bytes instead of 40).
+//
+// -------------------------------------------------------
+
+class VertexBillboardPacked
+{
+public:
+    VertexBillboardPacked();
+    VertexBillboardPacked(const VertexBillboard& vertex,
+                          const VertexPacking& packing);
+    static const int positionTupleSize;
+    static const int texCoupleSize;
+    static const int cornerTupleSize;
+    static int positionOffset();
+    static int texOffset();
+    static int cornerOffset();
+    static int stride();
+
+protected:
+    qint16 m_centerPosition[4];
+    quint16 m_tex[2];
+    qint16 m_corner[4];
+};
+
+#endif // VERTEXBILLBOARDPACKED_H
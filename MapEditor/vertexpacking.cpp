@@ -0,0 +1,239 @@
+/*
+    RPG Paper Maker Copyright (C) 2017 Marie Laporte
+
+    This file is part of RPG Paper Maker.
+
+    RPG Paper Maker is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    RPG Paper Maker is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with Foobar.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include "vertexpacking.h"
+#include "floor.h"
+
+const GLuint VertexPacking::UNPACK_LOCATION = 7;
+
+const float VertexPacking::POSITION_SCALE = 20.0f;
+
+const int VertexPacking::MAX_QUADS = 16384;
+
+QHash<QOpenGLContext*, QOpenGLBuffer*> VertexPacking::m_indexBuffersQuads;
+
+// -------------------------------------------------------
+//
+//  CONSTRUCTOR / DESTRUCTOR / GET / SET
+//
+// -------------------------------------------------------
+
+VertexPacking::VertexPacking() :
+    m_unpack(0.0f, 0.0f, 0.0f, 1.0f / POSITION_SCALE),
+    m_indexType(GL_UNSIGNED_SHORT),
+    m_verticesBytes(0),
+    m_indexesBytes(0)
+{
+
+}
+
+QVector4D VertexPacking::unpack() const { return m_unpack; }
+
+GLenum VertexPacking::indexType() const { return m_indexType; }
+
+void VertexPacking::setIndexType(GLenum type) { m_indexType = type; }
+
+qint64 VertexPacking::bufferBytes() const {
+    return m_verticesBytes + m_indexesBytes;
+}
+
+void VertexPacking::setVerticesBytes(qint64 bytes) { m_verticesBytes = bytes; }
+
+// -------------------------------------------------------
+//
+//  INTERMEDIARY FUNCTIONS
+//
+// -------------------------------------------------------
+
+void VertexPacking::setBounds(const QVector3D& min, const QVector3D& max) {
+    QVector3D center = (min + max) / 2;
+    QVector3D half = (max - min) / 2;
+    float extent = qMax(half.x(), qMax(half.y(), half.z()));
+
+    // Keep the best precision unless the box doesn't fit in 16 bits
+    float step = qMax(1.0f / POSITION_SCALE, extent / 32767.0f);
+    m_unpack = QVector4D(center, step);
+}
+
+// -------------------------------------------------------
+
+qint16 VertexPacking::packPosition(float value, int axis) const {
+    return packLength(value - m_unpack[axis]);
+}
+
+// -------------------------------------------------------
+
+qint16 VertexPacking::packLength(float value) const {
+    return (qint16) qBound(-32767, qRound(value / m_unpack.w()), 32767);
+}
+
+// -------------------------------------------------------
+
+void VertexPacking::updateBounds(QVector3D& min, QVector3D& max,
+                                 const QVector3D& position, bool first)
+{
+    if (first) {
+        min = position;
+        max = position;
+    }
+    else {
+        min.setX(qMin(min.x(), position.x()));
+        min.setY(qMin(min.y(), position.y()));
+        min.setZ(qMin(min.z(), position.z()));
+        max.setX(qMax(max.x(), position.x()));
+        max.setY(qMax(max.y(), position.y()));
+        max.setZ(qMax(max.z(), position.z()));
+    }
+}
+
+// -------------------------------------------------------
+
+quint16 VertexPacking::packTex(float value) {
+    return (quint16) qBound(0, qRound(value * 65535.0f), 65535);
+}
+
+// -------------------------------------------------------
+//
+//  GL
+//
+// -------------------------------------------------------
+
+void VertexPacking::bindIndexes(QOpenGLBuffer& indexBuffer, int verticesCount)
+{
+    if (indexBuffer.isCreated())
+        indexBuffer.destroy();
+
+    // The buffers are only made of quads, so the shared 16 bits quads
+    // indexes are used unless there are too many vertices
+    if (verticesCount <= MAX_QUADS * Floor::nbVerticesQuad) {
+        bindIndexBufferQuads();
+        m_indexType = GL_UNSIGNED_SHORT;
+        m_indexesBytes = 0;
+    }
+    else {
+        QVector<GLuint> indexes;
+        int quads = verticesCount / Floor::nbVerticesQuad;
+        indexes.reserve(quads * Floor::nbIndexesQuad);
+        for (int i = 0; i < quads; i++) {
+            int offset = i * Floor::nbVerticesQuad;
+            for (int j = 0; j < Floor::nbIndexesQuad; j++)
+                indexes.append(Floor::indexesQuad[j] + offset);
+        }
+        indexBuffer.create();
+        indexBuffer.bind();
+        indexBuffer.setUsagePattern(QOpenGLBuffer::StaticDraw);
+        indexBuffer.allocate(indexes.constData(),
+                             indexes.size() * sizeof(GLuint));
+        m_indexType = GL_UNSIGNED_INT;
+        m_indexesBytes = indexes.size() * sizeof(GLuint);
+    }
+}
+
+// -------------------------------------------------------
+
+void VertexPacking::draw(QOpenGLFunctions& functions, int firstQuad,
+                         int quads) const
+{
+    // A range of quads is drawn from the offset of its first quad in the
+    // indexes, so several buffers can be merged without a base vertex
+    int indexSize = m_indexType == GL_UNSIGNED_SHORT ? sizeof(GLushort) :
+                                                       sizeof(GLuint);
+    functions.glVertexAttrib4f(UNPACK_LOCATION, m_unpack.x(), m_unpack.y(),
+                               m_unpack.z(), m_unpack.w());
+    functions.glDrawElements(GL_TRIANGLES, quads * Floor::nbIndexesQuad,
+                             m_indexType, (void*) (quintptr) (firstQuad *
+                             Floor::nbIndexesQuad * indexSize));
+}
+
+// -------------------------------------------------------
+
+//  createIndexBufferQuads: create the index buffer of the current context if
+//  it doesn't exist yet. The maps opened in the same context share it, and
+//  it is destroyed only when the context is
+
+void VertexPacking::createIndexBufferQuads() {
+    QOpenGLContext* context = QOpenGLContext::currentContext();
+    if (context == nullptr || m_indexBuffersQuads.contains(context))
+        return;
+
+    QVector<GLushort> indexes;
+    indexes.reserve(MAX_QUADS * Floor::nbIndexesQuad);
+    for (int i = 0; i < MAX_QUADS; i++) {
+        int offset = i * Floor::nbVerticesQuad;
+        for (int j = 0; j < Floor::nbIndexesQuad; j++)
+            indexes.append(Floor::indexesQuad[j] + offset);
+    }
+    QOpenGLBuffer* indexBuffer = new QOpenGLBuffer(
+                QOpenGLBuffer::IndexBuffer);
+    indexBuffer->create();
+    indexBuffer->bind();
+    indexBuffer->setUsagePattern(QOpenGLBuffer::StaticDraw);
+    indexBuffer->allocate(indexes.constData(),
+                          indexes.size() * sizeof(GLushort));
+    indexBuffer->release();
+    m_indexBuffersQuads.insert(context, indexBuffer);
+
+    // Direct connection so that the context can still be made current
+    QObject::connect(context, &QOpenGLContext::aboutToBeDestroyed, [context]()
+    {
+        destroyIndexBufferQuads(context);
+    });
+}
+
+// -------------------------------------------------------
+
+void VertexPacking::destroyIndexBufferQuads(QOpenGLContext* context) {
+    QOpenGLBuffer* indexBuffer = m_indexBuffersQuads.take(context);
+    if (indexBuffer == nullptr)
+        return;
+
+    if (QOpenGLContext::currentContext() != context &&
+        context->surface() != nullptr)
+    {
+        context->makeCurrent(context->surface());
+    }
+    indexBuffer->destroy();
+    delete indexBuffer;
+}
+
+// -------------------------------------------------------
+
+void VertexPacking::bindIndexBufferQuads() {
+    createIndexBufferQuads();
+    QOpenGLBuffer* indexBuffer = m_indexBuffersQuads.value(
+                QOpenGLContext::currentContext());
+    if (indexBuffer != nullptr)
+        indexBuffer->bind();
+}
+
+// -------------------------------------------------------
+
+void VertexPacking::setAttributeBuffer(GLuint location, GLenum type,
+                                       bool normalized, int offset,
+                                       int tupleSize, int stride)
+{
+    // QOpenGLShaderProgram::setAttributeBuffer always normalizes integers,
+    // the packed positions must stay integers
+    QOpenGLFunctions* functions = QOpenGLContext::currentContext()
+            ->functions();
+    functions->glEnableVertexAttribArray(location);
+    functions->glVertexAttribPointer(location, tupleSize, type,
+                                     normalized ? GL_TRUE : GL_FALSE, stride,
+                                     (void*) (quintptr) offset);
+}
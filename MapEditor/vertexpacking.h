@@ -0,0 +1,84 @@
+/*
+    RPG Paper Maker Copyright (C) 2017 Marie Laporte
+
+    This file is part of RPG Paper Maker.
+
+    RPG Paper Maker is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    RPG Paper Maker is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with Foobar.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#ifndef VERTEXPACKING_H
+#define VERTEXPACKING_H
+
+#include <QVector3D>
+#include <QVector4D>
+#include <QOpenGLFunctions>
+#include <QOpenGLBuffer>
+#include <QOpenGLContext>
+#include <QHash>
+
+// -------------------------------------------------------
+//
+//  CLASS VertexPacking
+//
+//  How the vertices of a buffer are packed on the GPU: positions are 16 bits
+//  integers relative to the center of the buffer bounding box, with a step
+//  chosen so that the whole box fits. The origin and the step are given to
+//  the shaders with the constant attribute "unpack". All the buffers are
+//  made of quads, so they share the same 16 bits index buffer when they have
+//  less than 65536 vertices. There is one shared index buffer for each
+//  OpenGL context, destroyed with the context.
+//
+// -------------------------------------------------------
+
+class VertexPacking
+{
+public:
+    VertexPacking();
+    QVector4D unpack() const;
+    GLenum indexType() const;
+    void setIndexType(GLenum type);
+    qint64 bufferBytes() const;
+    void setVerticesBytes(qint64 bytes);
+    void setBounds(const QVector3D& min, const QVector3D& max);
+    qint16 packPosition(float value, int axis) const;
+    qint16 packLength(float value) const;
+    static quint16 packTex(float value);
+    void bindIndexes(QOpenGLBuffer& indexBuffer, int verticesCount);
+    void draw(QOpenGLFunctions& functions, int firstQuad, int quads) const;
+
+    static const GLuint UNPACK_LOCATION;
+    static const float POSITION_SCALE;
+    static const int MAX_QUADS;
+    static void updateBounds(QVector3D& min, QVector3D& max,
+                             const QVector3D& position, bool first);
+    static void createIndexBufferQuads();
+    static void bindIndexBufferQuads();
+    static void setAttributeBuffer(GLuint location, GLenum type,
+                                   bool normalized, int offset, int tupleSize,
+                                   int stride);
+
+protected:
+    QVector4D m_unpack;
+    GLenum m_indexType;
+
+    // Size of the uploaded vertices and own indexes, for memory accounting
+    qint64 m_verticesBytes;
+    qint64 m_indexesBytes;
+
+    static QHash<QOpenGLContext*, QOpenGLBuffer*> m_indexBuffersQuads;
+
+    static void destroyIndexBufferQuads(QOpenGLContext* context);
+};
+
+#endif // VERTEXPACKING_H
@@ -0,0 +1,68 @@
+/*
+    RPG Paper Maker Copyright (C) 2017 Marie Laporte
+
+    This file is part of RPG Paper Maker.
+
+    RPG Paper Maker is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    RPG Paper Maker is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with Foobar.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include "vertextiled.h"
+
+const int VertexTiled::positionTupleSize = 3;
+
+const int VertexTiled::texCoupleSize = 2;
+
+const int VertexTiled::texRectQuadrupletSize = 4;
+
+int VertexTiled::positionOffset() { return offsetof(VertexTiled, m_position); }
+
+int VertexTiled::texOffset() { return offsetof(VertexTiled, m_tex); }
+
+int VertexTiled::texRectOffset() { return offsetof(VertexTiled, m_texRect); }
+
+int VertexTiled::stride() { return sizeof(VertexTiled); }
+
+// -------------------------------------------------------
+//
+//  CONSTRUCTOR / DESTRUCTOR / GET / SET
+//
+// -------------------------------------------------------
+
+VertexTiled::VertexTiled()
+{
+
+}
+
+VertexTiled::VertexTiled(const QVector3D &position, const QVector2D &tex,
+                         const QVector4D &texRect) :
+    m_position(position),
+    m_tex(tex),
+    m_texRect(texRect)
+{
+
+}
+
+QVector3D VertexTiled::position() const { return m_position; }
+
+void VertexTiled::setPosition(const QVector3D& position) {
+    m_position = position;
+}
+
+QVector2D VertexTiled::tex() const { return m_tex; }
+
+void VertexTiled::setTex(const QVector2D &tex) { m_tex = tex; }
+
+QVector4D VertexTiled::texRect() const { return m_texRect; }
+
+void VertexTiled::setTexRect(const QVector4D &texRect) { m_texRect = texRect; }
@@ -0,0 +1,62 @@
+/*
+    RPG Paper Maker Copyright (C) 2017 Marie Laporte
+
+    This file is part of RPG Paper Maker.
+
+    RPG Paper Maker is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    RPG Paper Maker is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with Foobar.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#ifndef VERTEXTILED_H
+#define VERTEXTILED_H
+
+#include <QVector3D>
+#include <QVector2D>
+#include <QVector4D>
+
+// -------------------------------------------------------
+//
+//  CLASS VertexTiled
+//
+//  A vertex used for drawing merged floors: the texture coordinates are
+//  expressed in tiles and repeated inside the texture rectangle.
+//
+// -------------------------------------------------------
+
+class VertexTiled
+{
+public:
+    VertexTiled();
+    VertexTiled(const QVector3D &position, const QVector2D &tex,
+                const QVector4D &texRect);
+    QVector3D position() const;
+    void setPosition(const QVector3D& position);
+    QVector2D tex() const;
+    void setTex(const QVector2D& tex);
+    QVector4D texRect() const;
+    void setTexRect(const QVector4D& texRect);
+    static const int positionTupleSize;
+    static const int texCoupleSize;
+    static const int texRectQuadrupletSize;
+    static int positionOffset();
+    static int texOffset();
+    static int texRectOffset();
+    static int stride();
+
+protected:
+    QVector3D m_position;
+    QVector2D m_tex;
+    QVector4D m_texRect;
+};
+
+#endif // VERTEXTILED_H
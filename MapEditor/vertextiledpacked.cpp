@@ -0,0 +1,68 @@
+/*
+    RPG Paper Maker Copyright (C) 2017 Marie Laporte
+
+    This file is part of RPG Paper Maker.
+
+    RPG Paper Maker is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    RPG Paper Maker is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with Foobar.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include "vertextiledpacked.h"
+
+const int VertexTiledPacked::positionTupleSize = 3;
+
+const int VertexTiledPacked::texCoupleSize = 2;
+
+const int VertexTiledPacked::texRectQuadrupletSize = 4;
+
+int VertexTiledPacked::positionOffset() {
+    return offsetof(VertexTiledPacked, m_position);
+}
+
+int VertexTiledPacked::texOffset() {
+    return offsetof(VertexTiledPacked, m_tex);
+}
+
+int VertexTiledPacked::texRectOffset() {
+    return offsetof(VertexTiledPacked, m_texRect);
+}
+
+int VertexTiledPacked::stride() { return sizeof(VertexTiledPacked); }
+
+// -------------------------------------------------------
+//
+//  CONSTRUCTOR / DESTRUCTOR / GET / SET
+//
+// -------------------------------------------------------
+
+VertexTiledPacked::VertexTiledPacked()
+{
+
+}
+
+VertexTiledPacked::VertexTiledPacked(const VertexTiled& vertex,
+                                     const VertexPacking& packing)
+{
+    QVector3D position = vertex.position();
+    QVector2D tex = vertex.tex();
+    QVector4D texRect = vertex.texRect();
+
+    m_position[0] = packing.packPosition(position.x(), 0);
+    m_position[1] = packing.packPosition(position.y(), 1);
+    m_position[2] = packing.packPosition(position.z(), 2);
+    m_position[3] = 0;
+    m_tex[0] = (qint16) qRound(tex.x());
+    m_tex[1] = (qint16) qRound(tex.y());
+    for (int i = 0; i < texRectQuadrupletSize; i++)
+        m_texRect[i] = VertexPacking::packTex(texRect[i]);
+}
@@ -0,0 +1,55 @@
+/*
+    RPG Paper Maker Copyright (C) 2017 Marie Laporte
+
+    This file is part of RPG Paper Maker.
+
+    RPG Paper Maker is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    RPG Paper Maker is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with Foobar.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#ifndef VERTEXTILEDPACKED_H
+#define VERTEXTILEDPACKED_H
+
+#include "vertextiled.h"
+#include "vertexpacking.h"
+
+// -------------------------------------------------------
+//
+//  CLASS VertexTiledPacked
+//
+//  A merged floor vertex packed for the GPU: 16 bits positions, texture
+//  coordinates in tiles and normalized texture rectangle (20 bytes instead
+//  of 36).
+//
+// -------------------------------------------------------
+
+class VertexTiledPacked
+{
+public:
+    VertexTiledPacked();
+    VertexTiledPacked(const VertexTiled& vertex, const VertexPacking& packing);
+    static const int positionTupleSize;
+    static const int texCoupleSize;
+    static const int texRectQuadrupletSize;
+    static int positionOffset();
+    static int texOffset();
+    static int texRectOffset();
+    static int stride();
+
+protected:
+    qint16 m_position[4];
+    qint16 m_tex[2];
+    quint16 m_texRect[4];
+};
+
+#endif // VERTEXTILEDPACKED_H
@@ -0,0 +1,229 @@
+/*
+    RPG Paper Maker Copyright (C) 2017 Marie Laporte
+
+    This file is part of RPG Paper Maker.
+
+    RPG Paper Maker is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    RPG Paper Maker is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with Foobar.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include "boxesbatch.h"
+#include <limits>
+
+#if defined(__SSE__) || defined(_M_X64) || \
+    (defined(_M_IX86_FP) && _M_IX86_FP >= 1)
+#define BOXES_BATCH_SSE
+#include <xmmintrin.h>
+#endif
+
+// -------------------------------------------------------
+//
+//  CONSTRUCTOR / DESTRUCTOR / GET / SET
+//
+// -------------------------------------------------------
+
+BoxesBatch::BoxesBatch()
+{
+
+}
+
+int BoxesBatch::count() const {
+    return m_minX.size();
+}
+
+qint64 BoxesBatch::bytes() const {
+    return m_minX.capacity() * 6 * (qint64) sizeof(float);
+}
+
+// -------------------------------------------------------
+//
+//  INTERMEDIARY FUNCTIONS
+//
+// -------------------------------------------------------
+
+void BoxesBatch::clear() {
+    m_minX.clear();
+    m_minY.clear();
+    m_minZ.clear();
+    m_maxX.clear();
+    m_maxY.clear();
+    m_maxZ.clear();
+}
+
+// -------------------------------------------------------
+
+void BoxesBatch::reserve(int count) {
+    m_minX.reserve(count);
+    m_minY.reserve(count);
+    m_minZ.reserve(count);
+    m_maxX.reserve(count);
+    m_maxY.reserve(count);
+    m_maxZ.reserve(count);
+}
+
+// -------------------------------------------------------
+
+void BoxesBatch::append(const QVector3D& corner1, const QVector3D& corner2) {
+    m_minX.append(qMin(corner1.x(), corner2.x()));
+    m_minY.append(qMin(corner1.y(), corner2.y()));
+    m_minZ.append(qMin(corner1.z(), corner2.z()));
+    m_maxX.append(qMax(corner1.x(), corner2.x()));
+    m_maxY.append(qMax(corner1.y(), corner2.y()));
+    m_maxZ.append(qMax(corner1.z(), corner2.z()));
+}
+
+// -------------------------------------------------------
+
+// Returns the index of the nearest box hit by the ray (-1 if none) and put
+// in distance the same t than QBox3D::intersection(ray): the entering t, or
+// the leaving t if the origin is inside the box. Only strictly positive t
+// are hits, like in Wanok::getMinDistance.
+
+int BoxesBatch::intersection(const QRay3D& ray, float* distance) const {
+    const float origin[3] = {
+        float(ray.origin().x()), float(ray.origin().y()),
+        float(ray.origin().z())
+    };
+    const float inverse[3] = {
+        inverseDirection(ray.direction().x()),
+        inverseDirection(ray.direction().y()),
+        inverseDirection(ray.direction().z())
+    };
+    *distance = std::numeric_limits<float>::max();
+    int index = -1;
+    int start = 0;
+
+#ifdef BOXES_BATCH_SSE
+    const __m128 zero = _mm_setzero_ps();
+    const __m128 originX = _mm_set1_ps(origin[0]);
+    const __m128 originY = _mm_set1_ps(origin[1]);
+    const __m128 originZ = _mm_set1_ps(origin[2]);
+    const __m128 inverseX = _mm_set1_ps(inverse[0]);
+    const __m128 inverseY = _mm_set1_ps(inverse[1]);
+    const __m128 inverseZ = _mm_set1_ps(inverse[2]);
+    const float *minX = m_minX.constData(), *minY = m_minY.constData(),
+                *minZ = m_minZ.constData(), *maxX = m_maxX.constData(),
+                *maxY = m_maxY.constData(), *maxZ = m_maxZ.constData();
+    int count = m_minX.size() - (m_minX.size() % 4);
+
+    for (; start < count; start += 4) {
+        __m128 t1 = _mm_mul_ps(_mm_sub_ps(_mm_loadu_ps(minX + start),
+                                          originX), inverseX);
+        __m128 t2 = _mm_mul_ps(_mm_sub_ps(_mm_loadu_ps(maxX + start),
+                                          originX), inverseX);
+        __m128 tMin = _mm_min_ps(t1, t2);
+        __m128 tMax = _mm_max_ps(t1, t2);
+        t1 = _mm_mul_ps(_mm_sub_ps(_mm_loadu_ps(minY + start), originY),
+                        inverseY);
+        t2 = _mm_mul_ps(_mm_sub_ps(_mm_loadu_ps(maxY + start), originY),
+                        inverseY);
+        tMin = _mm_max_ps(tMin, _mm_min_ps(t1, t2));
+        tMax = _mm_min_ps(tMax, _mm_max_ps(t1, t2));
+        t1 = _mm_mul_ps(_mm_sub_ps(_mm_loadu_ps(minZ + start), originZ),
+                        inverseZ);
+        t2 = _mm_mul_ps(_mm_sub_ps(_mm_loadu_ps(maxZ + start), originZ),
+                        inverseZ);
+        tMin = _mm_max_ps(tMin, _mm_min_ps(t1, t2));
+        tMax = _mm_min_ps(tMax, _mm_max_ps(t1, t2));
+
+        // t = tMin >= 0 ? tMin : tMax
+        __m128 entering = _mm_cmpge_ps(tMin, zero);
+        __m128 t = _mm_or_ps(_mm_and_ps(entering, tMin),
+                             _mm_andnot_ps(entering, tMax));
+        __m128 hit = _mm_and_ps(_mm_cmpge_ps(tMax, tMin),
+                                _mm_cmpgt_ps(t, zero));
+        hit = _mm_and_ps(hit, _mm_cmplt_ps(t, _mm_set1_ps(*distance)));
+        int mask = _mm_movemask_ps(hit);
+        if (mask != 0) {
+            float values[4];
+            _mm_storeu_ps(values, t);
+            for (int i = 0; i < 4; i++) {
+                if ((mask & (1 << i)) && values[i] < *distance) {
+                    *distance = values[i];
+                    index = start + i;
+                }
+            }
+        }
+    }
+#endif
+
+    index = intersectionScalar(start, origin, inverse, distance, index);
+    if (index == -1)
+        *distance = 0;
+
+    return index;
+}
+
+// -------------------------------------------------------
+
+// The same without SSE, for comparing both in the benchmarks.
+
+int BoxesBatch::intersectionScalar(const QRay3D& ray, float* distance) const {
+    const float origin[3] = {
+        float(ray.origin().x()), float(ray.origin().y()),
+        float(ray.origin().z())
+    };
+    const float inverse[3] = {
+        inverseDirection(ray.direction().x()),
+        inverseDirection(ray.direction().y()),
+        inverseDirection(ray.direction().z())
+    };
+    *distance = std::numeric_limits<float>::max();
+    int index = intersectionScalar(0, origin, inverse, distance, -1);
+    if (index == -1)
+        *distance = 0;
+
+    return index;
+}
+
+// -------------------------------------------------------
+
+int BoxesBatch::intersectionScalar(int start, const float origin[3],
+                                   const float inverse[3], float* distance,
+                                   int index) const
+{
+    for (int i = start; i < m_minX.size(); i++) {
+        float t1 = (m_minX.at(i) - origin[0]) * inverse[0];
+        float t2 = (m_maxX.at(i) - origin[0]) * inverse[0];
+        float tMin = qMin(t1, t2), tMax = qMax(t1, t2);
+        t1 = (m_minY.at(i) - origin[1]) * inverse[1];
+        t2 = (m_maxY.at(i) - origin[1]) * inverse[1];
+        tMin = qMax(tMin, qMin(t1, t2));
+        tMax = qMin(tMax, qMax(t1, t2));
+        t1 = (m_minZ.at(i) - origin[2]) * inverse[2];
+        t2 = (m_maxZ.at(i) - origin[2]) * inverse[2];
+        tMin = qMax(tMin, qMin(t1, t2));
+        tMax = qMin(tMax, qMax(t1, t2));
+
+        float t = tMin >= 0 ? tMin : tMax;
+        if (tMax >= tMin && t > 0 && t < *distance) {
+            *distance = t;
+            index = i;
+        }
+    }
+
+    return index;
+}
+
+// -------------------------------------------------------
+
+// A null direction never crosses the slab planes: the biggest float keeps
+// the slab infinite (or empty if the origin is outside of it) without
+// producing NaN like an infinite inverse would do for 0 * inf.
+
+float BoxesBatch::inverseDirection(float direction) {
+    if (direction == 0.0f)
+        return std::numeric_limits<float>::max();
+
+    return 1.0f / direction;
+}
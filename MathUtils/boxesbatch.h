@@ -0,0 +1,62 @@
+/*
+    RPG Paper Maker Copyright (C) 2017 Marie Laporte
+
+    This file is part of RPG Paper Maker.
+
+    RPG Paper Maker is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    RPG Paper Maker is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with Foobar.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#ifndef BOXESBATCH_H
+#define BOXESBATCH_H
+
+#include <QVector>
+#include "qray3d.h"
+
+// -------------------------------------------------------
+//
+//  CLASS BoxesBatch
+//
+//  A list of axis aligned boxes stored as separated arrays of coordinates
+//  so that one ray can be tested against all of them at once. Four boxes
+//  are tested together with SSE when available.
+//
+// -------------------------------------------------------
+
+class BoxesBatch
+{
+public:
+    BoxesBatch();
+    int count() const;
+    qint64 bytes() const;
+    void clear();
+    void reserve(int count);
+    void append(const QVector3D& corner1, const QVector3D& corner2);
+    int intersection(const QRay3D& ray, float* distance) const;
+    int intersectionScalar(const QRay3D& ray, float* distance) const;
+
+protected:
+    QVector<float> m_minX;
+    QVector<float> m_minY;
+    QVector<float> m_minZ;
+    QVector<float> m_maxX;
+    QVector<float> m_maxY;
+    QVector<float> m_maxZ;
+
+    int intersectionScalar(int start, const float origin[3],
+                           const float inverse[3], float* distance,
+                           int index) const;
+    static float inverseDirection(float direction);
+};
+
+#endif // BOXESBATCH_H
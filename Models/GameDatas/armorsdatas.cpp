@@ -29,7 +29,7 @@
 
 ArmorsDatas::ArmorsDatas()
 {
-    m_model = new QStandardItemModel;
+    m_model = new SuperListItemModel;
 }
 
 ArmorsDatas::~ArmorsDatas()
@@ -80,16 +80,13 @@ void ArmorsDatas::read(const QJsonObject &json){
 
     // Read
     QJsonArray jsonList = json["armors"].toArray();
+    QList<SuperListItem*> list;
     for (int i = 0; i < jsonList.size(); i++){
-        QStandardItem* item = new QStandardItem;
         SystemArmor* sysArmor = new SystemArmor;
         sysArmor->read(jsonList[i].toObject());
-        item->setData(
-                    QVariant::fromValue(reinterpret_cast<quintptr>(sysArmor)));
-        item->setFlags(item->flags() ^ (Qt::ItemIsDropEnabled));
-        item->setText(sysArmor->toString());
-        m_model->appendRow(item);
+        list.append(sysArmor);
     }
+    m_model->appendSuperItems(list);
 }
 
 // -------------------------------------------------------
@@ -31,7 +31,7 @@
 
 ClassesDatas::ClassesDatas()
 {
-    m_model = new QStandardItemModel;
+    m_model = new SuperListItemModel;
 }
 
 ClassesDatas::~ClassesDatas()
@@ -162,18 +162,13 @@ void ClassesDatas::read(const QJsonObject &json){
 
     // Read
     QJsonArray jsonList = json["classes"].toArray();
-    QStandardItem* item;
-    SystemClass* sysClass;
+    QList<SuperListItem*> list;
     for (int i = 0; i < jsonList.size(); i++){
-        item = new QStandardItem;
-        sysClass= new SystemClass;
+        SystemClass* sysClass = new SystemClass;
         sysClass->read(jsonList[i].toObject());
-        item->setData(QVariant::fromValue(
-                          reinterpret_cast<quintptr>(sysClass)));
-        item->setFlags(item->flags() ^ (Qt::ItemIsDropEnabled));
-        item->setText(sysClass->toString());
-        m_model->appendRow(item);
+        list.append(sysClass);
     }
+    m_model->appendSuperItems(list);
 }
 
 // -------------------------------------------------------
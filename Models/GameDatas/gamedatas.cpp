@@ -39,7 +39,10 @@ GameDatas::GameDatas() :
     m_monstersDatas(new MonstersDatas),
     m_troopsDatas(new TroopsDatas),
     m_classesDatas(new ClassesDatas),
-    m_tilesetsDatas(new TilesetsDatas)
+    m_tilesetsDatas(new TilesetsDatas),
+    m_isBattleSystemRead(true),
+    m_isMonstersRead(true),
+    m_isTroopsRead(true)
 {
 
 }
@@ -74,6 +77,8 @@ SystemDatas* GameDatas::systemDatas() const {
 }
 
 BattleSystemDatas* GameDatas::battleSystemDatas() const {
+    readIfNeeded(m_battleSystemDatas, m_jsonBattleSystem, m_isBattleSystemRead);
+
     return m_battleSystemDatas;
 }
 
@@ -98,10 +103,14 @@ HeroesDatas* GameDatas::heroesDatas() const {
 }
 
 MonstersDatas* GameDatas::monstersDatas() const {
+    readIfNeeded(m_monstersDatas, m_jsonMonsters, m_isMonstersRead);
+
     return m_monstersDatas;
 }
 
 TroopsDatas* GameDatas::troopsDatas() const {
+    readIfNeeded(m_troopsDatas, m_jsonTroops, m_isTroopsRead);
+
     return m_troopsDatas;
 }
 
@@ -120,6 +129,9 @@ TilesetsDatas* GameDatas::tilesetsDatas() const {
 // -------------------------------------------------------
 
 void GameDatas::setDefault(){
+    m_isBattleSystemRead = true;
+    m_isMonstersRead = true;
+    m_isTroopsRead = true;
     m_commonEventsDatas->setDefault();
     m_variablesDatas->setDefault();
     m_systemDatas->setDefault();
@@ -153,12 +165,15 @@ void GameDatas::read(QString path){
     readSystem(path);
     m_itemsDatas->read(path);
     m_skillsDatas->read(path);
-    m_battleSystemDatas->read(path);
+    readLazy(Wanok::pathCombine(path, Wanok::pathBattleSystem),
+             m_jsonBattleSystem, m_isBattleSystemRead);
     m_weaponsDatas->read(path);
     m_armorsDatas->read(path);
     m_heroesDatas->read(path);
-    m_monstersDatas->read(path);
-    m_troopsDatas->read(path);
+    readLazy(Wanok::pathCombine(path, Wanok::pathMonsters), m_jsonMonsters,
+             m_isMonstersRead);
+    readLazy(Wanok::pathCombine(path, Wanok::pathTroops), m_jsonTroops,
+             m_isTroopsRead);
     m_classesDatas->read(path);
     readTilesets(path);
 }
@@ -183,14 +198,36 @@ void GameDatas::readSystem(QString path){
 
 // -------------------------------------------------------
 
+void GameDatas::readLazy(QString path, QJsonObject& json, bool& isRead) {
+    QJsonDocument loadDoc;
+    Wanok::readOtherJSON(path, loadDoc);
+    json = loadDoc.object();
+    isRead = false;
+}
+
+// -------------------------------------------------------
+
+void GameDatas::readIfNeeded(Serializable* datas, QJsonObject& json,
+                             bool& isRead) const
+{
+    QMutexLocker locker(&m_mutexLazy);
+    if (!isRead) {
+        isRead = true;
+        datas->read(json);
+        json = QJsonObject();
+    }
+}
+
+// -------------------------------------------------------
+
 void GameDatas::write(QString path){
     Wanok::writeJSON(Wanok::pathCombine(path, Wanok::pathCommonEvents),
                      *m_commonEventsDatas);
     Wanok::writeJSON(Wanok::pathCombine(path, Wanok::pathVariables),
                      *m_variablesDatas);
     writeSystem(path);
-    Wanok::writeJSON(Wanok::pathCombine(path, Wanok::pathBattleSystem),
-                     *m_battleSystemDatas);
+    writeLazy(Wanok::pathCombine(path, Wanok::pathBattleSystem),
+              m_battleSystemDatas, m_jsonBattleSystem, m_isBattleSystemRead);
     Wanok::writeJSON(Wanok::pathCombine(path, Wanok::pathItems),
                      *m_itemsDatas);
     Wanok::writeJSON(Wanok::pathCombine(path, Wanok::pathSkills),
@@ -201,10 +238,10 @@ void GameDatas::write(QString path){
                      *m_armorsDatas);
     Wanok::writeJSON(Wanok::pathCombine(path, Wanok::pathHeroes),
                      *m_heroesDatas);
-    Wanok::writeJSON(Wanok::pathCombine(path, Wanok::pathMonsters),
-                     *m_monstersDatas);
-    Wanok::writeJSON(Wanok::pathCombine(path, Wanok::pathTroops),
-                     *m_troopsDatas);
+    writeLazy(Wanok::pathCombine(path, Wanok::pathMonsters), m_monstersDatas,
+              m_jsonMonsters, m_isMonstersRead);
+    writeLazy(Wanok::pathCombine(path, Wanok::pathTroops), m_troopsDatas,
+              m_jsonTroops, m_isTroopsRead);
     Wanok::writeJSON(Wanok::pathCombine(path, Wanok::pathClasses),
                      *m_classesDatas);
     writeTilesets(path);
@@ -212,6 +249,21 @@ void GameDatas::write(QString path){
 
 // -------------------------------------------------------
 
+void GameDatas::writeLazy(QString path, const Serializable* datas,
+                          const QJsonObject& json,
+                          const bool& isRead) const
+{
+    QMutexLocker locker(&m_mutexLazy);
+
+    // Not deserialized yet: write back what was read
+    if (isRead)
+        Wanok::writeJSON(path, *datas);
+    else
+        Wanok::writeOtherJSON(path, json);
+}
+
+// -------------------------------------------------------
+
 void GameDatas::writeTilesets(QString path) {
     Wanok::writeJSON(Wanok::pathCombine(path, Wanok::PATH_TILESETS),
                      *m_tilesetsDatas);
@@ -20,6 +20,7 @@
 #ifndef GAMEDATAS_H
 #define GAMEDATAS_H
 
+#include <QMutex>
 #include "commoneventsdatas.h"
 #include "variablesdatas.h"
 #include "systemdatas.h"
@@ -84,6 +85,23 @@ private:
     TroopsDatas* m_troopsDatas;
     ClassesDatas* m_classesDatas;
     TilesetsDatas* m_tilesetsDatas;
+
+    // Rarely opened datas: only deserialized when accessed for the first
+    // time. The accessors can be called from the background workers, so the
+    // first deserialization is done under a lock
+    mutable QMutex m_mutexLazy;
+    mutable QJsonObject m_jsonBattleSystem;
+    mutable QJsonObject m_jsonMonsters;
+    mutable QJsonObject m_jsonTroops;
+    mutable bool m_isBattleSystemRead;
+    mutable bool m_isMonstersRead;
+    mutable bool m_isTroopsRead;
+
+    static void readLazy(QString path, QJsonObject& json, bool& isRead);
+    void readIfNeeded(Serializable* datas, QJsonObject& json,
+                      bool& isRead) const;
+    void writeLazy(QString path, const Serializable* datas,
+                   const QJsonObject& json, const bool& isRead) const;
 };
 
 #endif // GAMEDATAS_H
@@ -29,7 +29,7 @@
 
 HeroesDatas::HeroesDatas()
 {
-    m_model = new QStandardItemModel;
+    m_model = new SuperListItemModel;
 }
 
 HeroesDatas::~HeroesDatas()
@@ -80,16 +80,13 @@ void HeroesDatas::read(const QJsonObject &json){
 
     // Read
     QJsonArray jsonList = json["heroes"].toArray();
+    QList<SuperListItem*> list;
     for (int i = 0; i < jsonList.size(); i++){
-        QStandardItem* item = new QStandardItem;
         SystemHero* sysHero = new SystemHero;
         sysHero->read(jsonList[i].toObject());
-        item->setData(QVariant::fromValue(
-                          reinterpret_cast<quintptr>(sysHero)));
-        item->setFlags(item->flags() ^ (Qt::ItemIsDropEnabled));
-        item->setText(sysHero->toString());
-        m_model->appendRow(item);
+        list.append(sysHero);
     }
+    m_model->appendSuperItems(list);
 }
 
 // -------------------------------------------------------
@@ -29,7 +29,7 @@
 
 ItemsDatas::ItemsDatas()
 {
-    m_model = new QStandardItemModel;
+    m_model = new SuperListItemModel;
 }
 
 ItemsDatas::~ItemsDatas()
@@ -88,15 +88,13 @@ void ItemsDatas::read(const QJsonObject &json){
 
     // Read
     QJsonArray jsonList = json["items"].toArray();
+    QList<SuperListItem*> list;
     for (int i = 0; i < jsonList.size(); i++){
-        QStandardItem* item = new QStandardItem;
         SystemItem* sysItem = new SystemItem;
         sysItem->read(jsonList[i].toObject());
-        item->setData(QVariant::fromValue(reinterpret_cast<quintptr>(sysItem)));
-        item->setFlags(item->flags() ^ (Qt::ItemIsDropEnabled));
-        item->setText(sysItem->toString());
-        m_model->appendRow(item);
+        list.append(sysItem);
     }
+    m_model->appendSuperItems(list);
 }
 
 // -------------------------------------------------------
@@ -31,7 +31,7 @@
 
 MonstersDatas::MonstersDatas()
 {
-    m_model = new QStandardItemModel;
+    m_model = new SuperListItemModel;
 }
 
 MonstersDatas::~MonstersDatas()
@@ -156,16 +156,13 @@ void MonstersDatas::read(const QJsonObject &json){
 
     // Read
     QJsonArray jsonList = json["monsters"].toArray();
+    QList<SuperListItem*> list;
     for (int i = 0; i < jsonList.size(); i++){
-        QStandardItem* item = new QStandardItem;
         SystemMonster* sysMonster = new SystemMonster;
         sysMonster->read(jsonList[i].toObject());
-        item->setData(QVariant::fromValue(
-                          reinterpret_cast<quintptr>(sysMonster)));
-        item->setFlags(item->flags() ^ (Qt::ItemIsDropEnabled));
-        item->setText(sysMonster->toString());
-        m_model->appendRow(item);
+        list.append(sysMonster);
     }
+    m_model->appendSuperItems(list);
 }
 
 // -------------------------------------------------------
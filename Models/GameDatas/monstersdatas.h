@@ -22,6 +22,7 @@
 
 #include <QStandardItemModel>
 #include "serializable.h"
+#include "superlistitemmodel.h"
 
 // -------------------------------------------------------
 //
@@ -46,7 +47,7 @@ public:
     virtual void write(QJsonObject &json) const;
 
 private:
-    QStandardItemModel* m_model;
+    SuperListItemModel* m_model;
 };
 
 #endif // MONSTERSDATAS_H
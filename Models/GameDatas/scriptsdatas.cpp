@@ -220,7 +220,7 @@ void ScriptsDatas::writeBrowser(QString path) const{
     path = Wanok::pathCombine(path, "includes.html");
 
     QFile writeInfos(path);
-    if(!writeInfos.open(QIODevice::Append | QIODevice::Text))
+    if(!writeInfos.open(QIODevice::WriteOnly | QIODevice::Text))
         return;
 
     QTextStream out(&writeInfos);
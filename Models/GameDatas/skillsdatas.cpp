@@ -29,7 +29,7 @@
 
 SkillsDatas::SkillsDatas()
 {
-    m_model = new QStandardItemModel;
+    m_model = new SuperListItemModel;
 }
 
 SkillsDatas::~SkillsDatas()
@@ -89,16 +89,13 @@ void SkillsDatas::read(const QJsonObject &json){
 
     // Read
     QJsonArray jsonList = json["skills"].toArray();
+    QList<SuperListItem*> list;
     for (int i = 0; i < jsonList.size(); i++){
-        QStandardItem* item = new QStandardItem;
         SystemSkill* sysSkill = new SystemSkill;
         sysSkill->read(jsonList[i].toObject());
-        item->setData(QVariant::fromValue(
-                          reinterpret_cast<quintptr>(sysSkill)));
-        item->setFlags(item->flags() ^ (Qt::ItemIsDropEnabled));
-        item->setText(sysSkill->toString());
-        m_model->appendRow(item);
+        list.append(sysSkill);
     }
+    m_model->appendSuperItems(list);
 }
 
 // -------------------------------------------------------
@@ -28,7 +28,7 @@
 
 TilesetsDatas::TilesetsDatas()
 {
-    m_model = new QStandardItemModel;
+    m_model = new SuperListItemModel;
 }
 
 TilesetsDatas::~TilesetsDatas()
@@ -68,19 +68,19 @@ void TilesetsDatas::setDefault(){
 // -------------------------------------------------------
 
 void TilesetsDatas::read(const QJsonObject &json){
-    QList<QStandardItem*> row;
     QJsonArray tab = json["list"].toArray();
 
     // Clear
     SuperListItem::deleteModel(m_model, false);
 
     // Read
+    QList<SuperListItem*> list;
     for (int i = 0; i < tab.size(); i++){
         SystemTileset* super = new SystemTileset;
         super->read(tab[i].toObject());
-        row = super->getModelRow();
-        m_model->appendRow(row);
+        list.append(super);
     }
+    m_model->appendSuperItems(list);
 }
 
 // -------------------------------------------------------
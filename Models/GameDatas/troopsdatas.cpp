@@ -30,7 +30,7 @@
 
 TroopsDatas::TroopsDatas()
 {
-    m_model = new QStandardItemModel;
+    m_model = new SuperListItemModel;
 }
 
 TroopsDatas::~TroopsDatas()
@@ -117,16 +117,13 @@ void TroopsDatas::read(const QJsonObject &json){
 
     // Read
     QJsonArray jsonList = json["troops"].toArray();
+    QList<SuperListItem*> list;
     for (int i = 0; i < jsonList.size(); i++){
-        QStandardItem* item = new QStandardItem;
         SystemTroop* sysTroop = new SystemTroop;
         sysTroop->read(jsonList[i].toObject());
-        item->setData(QVariant::fromValue(
-                          reinterpret_cast<quintptr>(sysTroop)));
-        item->setFlags(item->flags() ^ (Qt::ItemIsDropEnabled));
-        item->setText(sysTroop->toString());
-        m_model->appendRow(item);
+        list.append(sysTroop);
     }
+    m_model->appendSuperItems(list);
 }
 
 // -------------------------------------------------------
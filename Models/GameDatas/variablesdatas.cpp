@@ -29,7 +29,7 @@
 
 VariablesDatas::VariablesDatas()
 {
-    p_model = new QStandardItemModel;
+    p_model = new SuperListItemModel;
 }
 
 VariablesDatas::~VariablesDatas()
@@ -66,7 +66,12 @@ void VariablesDatas::setDefault(){
 // -------------------------------------------------------
 
 SuperListItem* VariablesDatas::getVariableById(int id) const{
-    return getById(p_model, id);
+    int idPage = (id - 1) / SystemVariables::variablesPerPage + 1;
+    SystemVariables* page = (SystemVariables*) p_model->getById(idPage);
+    SuperListItem* s = page == nullptr ? nullptr : page->getById(id);
+
+    // Pages not in the usual order
+    return s == nullptr ? getById(p_model, id) : s;
 }
 
 // -------------------------------------------------------
@@ -99,6 +104,44 @@ void VariablesDatas::read(const QJsonObject &json){
 
 // -------------------------------------------------------
 
+bool VariablesDatas::canReadStream() const {
+    return true;
+}
+
+// -------------------------------------------------------
+//  readStream: if the stream fails, the json is read again so the pages
+//  already read are deleted then
+
+void VariablesDatas::readStream(JsonStreamReader& reader){
+    QString key;
+
+    // Clear
+    SuperListItem::deleteModel(p_model, false);
+
+    // Read
+    if (!reader.beginObject())
+        return;
+    while (reader.nextKey(key)) {
+        if (key != "variables" || !reader.beginArray()) {
+            reader.skipValue();
+            continue;
+        }
+        QList<SuperListItem*> pages;
+        while (reader.nextElement()) {
+            SystemVariables* page = new SystemVariables();
+            page->readStream(reader);
+            pages.append(page);
+        }
+        if (reader.hasError()) {
+            qDeleteAll(pages);
+            return;
+        }
+        p_model->appendSuperItems(pages);
+    }
+}
+
+// -------------------------------------------------------
+
 void VariablesDatas::readCommand(const QJsonArray &json,
                                          QStandardItemModel *l)
 {
@@ -21,15 +21,15 @@
 #define VARIABLESDATAS_H
 
 #include "serializable.h"
-#include <QStandardItemModel>
-#include "superlistitem.h"
+#include "superlistitemmodel.h"
 
 // -------------------------------------------------------
 //
 //  CLASS VariablesDatas
 //
 //  Contains all the variables and switches. The variables are
-//  a simple array of int, and the switches an array of booleans.
+//  a simple array of int, and the switches an array of booleans. The pages
+//  are indexed by id, and a variable id gives its page.
 //
 // -------------------------------------------------------
 
@@ -42,6 +42,8 @@ public:
     void setDefault();
     QStandardItemModel* model() const;
     virtual void read(const QJsonObject &json);
+    virtual bool canReadStream() const;
+    virtual void readStream(JsonStreamReader& reader);
     void readCommand(const QJsonArray &json, QStandardItemModel* l);
     virtual void write(QJsonObject &json) const;
     QJsonArray getArrayJSON(QStandardItemModel* l) const;
@@ -49,7 +51,7 @@ public:
     SuperListItem* getById(QStandardItemModel *l, int id) const;
 
 private:
-    QStandardItemModel* p_model;
+    SuperListItemModel* p_model;
 };
 
 #endif // VARIABLESDATAS_H
@@ -29,7 +29,7 @@
 
 WeaponsDatas::WeaponsDatas()
 {
-    m_model = new QStandardItemModel;
+    m_model = new SuperListItemModel;
 }
 
 WeaponsDatas::~WeaponsDatas()
@@ -82,16 +82,13 @@ void WeaponsDatas::read(const QJsonObject &json){
 
     // Read
     QJsonArray jsonList = json["weapons"].toArray();
+    QList<SuperListItem*> list;
     for (int i = 0; i < jsonList.size(); i++){
-        QStandardItem* item = new QStandardItem;
         SystemWeapon* sysWeapon = new SystemWeapon;
         sysWeapon->read(jsonList[i].toObject());
-        item->setData(QVariant::fromValue(
-                          reinterpret_cast<quintptr>(sysWeapon)));
-        item->setFlags(item->flags() ^ (Qt::ItemIsDropEnabled));
-        item->setText(sysWeapon->toString());
-        m_model->appendRow(item);
+        list.append(sysWeapon);
     }
+    m_model->appendSuperItems(list);
 }
 
 // -------------------------------------------------------
@@ -19,6 +19,7 @@
 
 #include "systemcommonreaction.h"
 #include "widgettreecommands.h"
+#include "eventcommandsmodel.h"
 #include "wanok.h"
 #include "systemcreateparameter.h"
 #include "widgetsupertree.h"
@@ -30,7 +31,7 @@
 // -------------------------------------------------------
 
 SystemCommonReaction::SystemCommonReaction() :
-    SystemCommonReaction(1, "", new QStandardItemModel, new QStandardItemModel,
+    SystemCommonReaction(1, "", new QStandardItemModel, new EventCommandsModel,
                          false)
 {
 
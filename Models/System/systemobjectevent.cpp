@@ -71,14 +71,14 @@ SystemObjectEvent* SystemObjectEvent::getCommandEvent(
         const EventCommand *command, int& i)
 {
     PrimitiveValue* v;
-    int type = command->valueCommandAt(i++).toInt();
-    int idEvent = command->valueCommandAt(i++).toInt();
+    int type = command->intValueCommandAt(i++);
+    int idEvent = command->intValueCommandAt(i++);
     SystemObjectEvent* event = new SystemObjectEvent(idEvent, "",
                                                      new QStandardItemModel,
                                                      type == 0);
 
     while (i < command->commandsCount()){
-        int paramId = command->valueCommandAt(i++).toInt();
+        int paramId = command->intValueCommandAt(i++);
         v = new PrimitiveValue;
         v->initializeCommandParameter(command, i);
 
@@ -19,6 +19,7 @@
 
 #include "systemreaction.h"
 #include "widgettreecommands.h"
+#include "eventcommandsmodel.h"
 #include "wanok.h"
 
 // -------------------------------------------------------
@@ -28,7 +29,7 @@
 // -------------------------------------------------------
 
 SystemReaction::SystemReaction() :
-    SystemReaction(1, "", new QStandardItemModel, true)
+    SystemReaction(1, "", new EventCommandsModel, true)
 {
 
 }
@@ -128,11 +129,16 @@ void SystemReaction::copyCommandsItem(const QStandardItem* from,
         to->setText(from->text());
     }
 
-    // Copy children
+    // Copy children, appended all at once
+    QList<QStandardItem*> children;
+    children.reserve(from->rowCount());
     for (int i = 0; i < from->rowCount(); i++){
-        to->appendRow(new QStandardItem);
-        copyCommandsItem(from->child(i), to->child(i));
+        QStandardItem* child = new QStandardItem;
+        copyCommandsItem(from->child(i), child);
+        children.append(child);
     }
+    if (!children.isEmpty())
+        to->appendRows(children);
 }
 
 // -------------------------------------------------------
@@ -165,6 +171,9 @@ void SystemReaction::read(const QJsonObject &json){
 // -------------------------------------------------------
 
 void SystemReaction::readRoot(const QJsonArray &json, QStandardItem* root){
+    QList<QStandardItem*> items;
+    items.reserve(json.size());
+
     for (int i = 0; i < json.size(); i++) {
         QJsonObject obj = json[i].toObject();
 
@@ -177,8 +186,11 @@ void SystemReaction::readRoot(const QJsonArray &json, QStandardItem* root){
             readRoot(obj["children"].toArray(), item);
             addEmptyCommand(item);
         }
-        root->insertRow(i, item);
+        items.append(item);
     }
+
+    // Inserting all the rows at once
+    root->insertRows(0, items);
 }
 
 // -------------------------------------------------------
@@ -132,6 +132,65 @@ void SystemVariables::readCommand(const QJsonArray &json){
 
 // -------------------------------------------------------
 
+void SystemVariables::readStream(JsonStreamReader& reader){
+    QString key;
+    int count = 0;
+
+    if (!reader.beginObject())
+        return;
+    while (reader.nextKey(key)) {
+        if (key == "id")
+            p_id = reader.readInt();
+        else if (key == "name")
+            p_name = reader.readString();
+        else if (key == "list" && reader.beginArray()) {
+            while (reader.nextElement()) {
+                SuperListItem* var = new SuperListItem();
+                var->read(QJsonObject());
+                if (reader.beginObject()) {
+                    while (reader.nextKey(key)) {
+                        if (key == "id")
+                            var->setId(reader.readInt());
+                        else if (key == "name")
+                            var->setName(reader.readString());
+                        else
+                            reader.skipValue();
+                    }
+                }
+                if (reader.hasError() ||
+                    count == SystemVariables::variablesPerPage)
+                {
+                    delete var;
+                    continue;
+                }
+                appendVariable(var);
+                count++;
+            }
+        }
+        else
+            reader.skipValue();
+    }
+
+    // Same number of variables in each page than when reading the json
+    for (; count < SystemVariables::variablesPerPage; count++) {
+        SuperListItem* var = new SuperListItem();
+        var->read(QJsonObject());
+        appendVariable(var);
+    }
+}
+
+// -------------------------------------------------------
+
+void SystemVariables::appendVariable(SuperListItem* var){
+    QStandardItem* varItem = new QStandardItem();
+    varItem->setData(QVariant::fromValue(reinterpret_cast<quintptr>(var)));
+    varItem->setFlags(varItem->flags() ^ (Qt::ItemIsDropEnabled));
+    varItem->setText(var->toString());
+    p_model->invisibleRootItem()->appendRow(varItem);
+}
+
+// -------------------------------------------------------
+
 void SystemVariables::write(QJsonObject &json) const
 {
     SuperListItem::write(json);
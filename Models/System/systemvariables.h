@@ -47,11 +47,14 @@ public:
     virtual SuperListItem* createCopy() const;
     virtual void read(const QJsonObject &json);
     void readCommand(const QJsonArray &json);
+    virtual void readStream(JsonStreamReader& reader);
     virtual void write(QJsonObject &json) const;
     QJsonArray getArrayJSON() const;
 
 private:
     QStandardItemModel* p_model;
+
+    void appendVariable(SuperListItem* var);
 };
 
 Q_DECLARE_METATYPE(SystemVariables)
@@ -28,7 +28,8 @@
 // -------------------------------------------------------
 
 EngineSettings::EngineSettings() :
-    m_keyBoardDatas(new KeyBoardDatas)
+    m_keyBoardDatas(new KeyBoardDatas),
+    m_memoryBudget(0)
 {
 
 }
@@ -52,6 +53,10 @@ KeyBoardDatas* EngineSettings::keyBoardDatas() const {
     return m_keyBoardDatas;
 }
 
+int EngineSettings::memoryBudget() const { return m_memoryBudget; }
+
+void EngineSettings::setMemoryBudget(int budget) { m_memoryBudget = budget; }
+
 // -------------------------------------------------------
 //
 //  INTERMEDIARY FUNCTIONS
@@ -60,6 +65,7 @@ KeyBoardDatas* EngineSettings::keyBoardDatas() const {
 
 void EngineSettings::setDefault(){
     m_keyBoardDatas->setDefaultEngine();
+    m_memoryBudget = 0;
 }
 
 // -------------------------------------------------------
@@ -70,6 +76,7 @@ void EngineSettings::setDefault(){
 
 void EngineSettings::read(const QJsonObject &json){
     m_keyBoardDatas->read(json["kb"].toObject());
+    m_memoryBudget = json["mb"].toInt();
 }
 
 // -------------------------------------------------------
@@ -79,4 +86,5 @@ void EngineSettings::write(QJsonObject &json) const{
 
     m_keyBoardDatas->write(obj);
     json["kb"] = obj;
+    json["mb"] = m_memoryBudget;
 }
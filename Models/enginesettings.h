@@ -26,7 +26,7 @@
 //
 //  CLASS EngineSettings
 //
-//  The engine settings (keyboard for the engine).
+//  The engine settings (keyboard and memory budget for the engine).
 //
 // -------------------------------------------------------
 
@@ -38,6 +38,8 @@ public:
     void read();
     void write();
     KeyBoardDatas* keyBoardDatas() const;
+    int memoryBudget() const;
+    void setMemoryBudget(int budget);
     void setDefault();
 
     virtual void read(const QJsonObject &json);
@@ -45,6 +47,9 @@ public:
 
 protected:
     KeyBoardDatas* m_keyBoardDatas;
+
+    // Memory budget of a map in the map editor in MB, 0 for no limit
+    int m_memoryBudget;
 };
 
 #endif // ENGINESETTINGS_H
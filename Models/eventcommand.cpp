@@ -26,6 +26,7 @@
 #include "systemcommandmove.h"
 
 QVector<QString> EventCommand::emptyCommandList = QVector<QString>();
+QAtomicInt EventCommand::stringsRevision(0);
 
 // -------------------------------------------------------
 //
@@ -40,9 +41,12 @@ EventCommand::EventCommand() : EventCommand(EventCommandKind::None)
 
 EventCommand::EventCommand(EventCommandKind k, QVector<QString> &l) :
     p_kind(k),
-    p_listCommand(l)
+    p_listCommand(l),
+    m_cachedObject(nullptr),
+    m_cachedParameters(nullptr),
+    m_cachedRevision(-1)
 {
-
+    compile();
 }
 
 EventCommand::~EventCommand()
@@ -58,6 +62,10 @@ QString EventCommand::valueCommandAt(int index) const{
     return p_listCommand.at(index);
 }
 
+int EventCommand::intValueCommandAt(int index) const{
+    return p_intCommand.at(index);
+}
+
 // -------------------------------------------------------
 //
 //  INTERMEDIARY FUNCTIONS
@@ -102,6 +110,37 @@ bool EventCommand::isErasable() const{
 void EventCommand::setCopy(const EventCommand& copy){
     p_kind = copy.p_kind;
     p_listCommand = copy.p_listCommand;
+    p_intCommand = copy.p_intCommand;
+    p_arrayCommand = copy.p_arrayCommand;
+    m_cachedRevision = -1;
+}
+
+// -------------------------------------------------------
+//  compile: convert the string list once into typed values so that display
+//  and saving don't need to parse them again
+
+void EventCommand::compile(){
+    int l = p_listCommand.size();
+    p_intCommand.resize(l);
+    p_arrayCommand = QJsonArray();
+    m_cachedRevision = -1;
+
+    for (int i = 0; i < l; i++){
+        const QString& s = p_listCommand.at(i);
+        bool conversionOk, conversionDoubleOk;
+        int integer = s.toInt(&conversionOk);
+        p_intCommand[i] = integer;
+
+        if (conversionOk)
+            p_arrayCommand.append(integer);
+        else {
+            double d = s.toDouble(&conversionDoubleOk);
+            if (conversionDoubleOk)
+                p_arrayCommand.append(d);
+            else
+                p_arrayCommand.append(s);
+        }
+    }
 }
 
 // -------------------------------------------------------
@@ -112,6 +151,33 @@ void EventCommand::setCopy(const EventCommand& copy){
 
 QString EventCommand::toString(SystemCommonObject* object,
                                QStandardItemModel* parameters) const
+{
+    int revision = stringsRevision.load();
+
+    if (m_cachedRevision != revision || m_cachedObject != object ||
+        m_cachedParameters != parameters)
+    {
+        m_cachedString = computeString(object, parameters);
+        m_cachedObject = object;
+        m_cachedParameters = parameters;
+        m_cachedRevision = revision;
+    }
+
+    return m_cachedString;
+}
+
+// -------------------------------------------------------
+//  invalidateStrings: names displayed in commands (variables, datas,
+//  states, objects...) changed, every cached string has to be recomputed
+
+void EventCommand::invalidateStrings(){
+    stringsRevision.ref();
+}
+
+// -------------------------------------------------------
+
+QString EventCommand::computeString(SystemCommonObject* object,
+                                    QStandardItemModel* parameters) const
 {
     QString str = ">";
 
@@ -173,8 +239,8 @@ QString EventCommand::toString(SystemCommonObject* object,
 
 QString EventCommand::strNumberVariable(int &i) const{
     PrimitiveValueKind kind =
-            static_cast<PrimitiveValueKind>(p_listCommand.at(i++).toInt());
-    int value = p_listCommand.at(i++).toInt();
+            static_cast<PrimitiveValueKind>(p_intCommand.at(i++));
+    int value = p_intCommand.at(i++);
     switch (kind){
     case PrimitiveValueKind::Number:
         return QString::number(value);
@@ -192,8 +258,8 @@ QString EventCommand::strDataBaseId(int &i, QStandardItemModel* dataBase,
                                     QStandardItemModel *parameters) const
 {
     PrimitiveValueKind kind =
-            static_cast<PrimitiveValueKind>(p_listCommand.at(i++).toInt());
-    int value = p_listCommand.at(i++).toInt();
+            static_cast<PrimitiveValueKind>(p_intCommand.at(i++));
+    int value = p_intCommand.at(i++);
 
     switch (kind){
     case PrimitiveValueKind::Number:
@@ -216,7 +282,7 @@ QString EventCommand::strDataBaseId(int &i, QStandardItemModel* dataBase,
 
 QString EventCommand::strNumber(int &i, QStandardItemModel *parameters) const{
     PrimitiveValueKind kind =
-            static_cast<PrimitiveValueKind>(p_listCommand.at(i++).toInt());
+            static_cast<PrimitiveValueKind>(p_intCommand.at(i++));
     QString value = p_listCommand.at(i++);
 
     switch (kind){
@@ -264,7 +330,7 @@ QString EventCommand::strChangeVariablesSelection(int& i,
     QString str = "";
     if (selection == "0"){
         str += Wanok::get()->project()->gameDatas()->variablesDatas()
-                ->getVariableById(p_listCommand.at(i++).toInt())->toString();
+                ->getVariableById(p_intCommand.at(i++))->toString();
     }
     else{
         several += "s";
@@ -311,7 +377,7 @@ QString EventCommand::strChangeVariablesValue(int &i) const{
 
 QString EventCommand::strInputNumber() const{
     QString variable = Wanok::get()->project()->gameDatas()->variablesDatas()
-            ->getVariableById(p_listCommand.at(0).toInt())->toString();
+            ->getVariableById(p_intCommand.at(0))->toString();
     return "Input number in variable " + variable;
 }
 
@@ -320,7 +386,7 @@ QString EventCommand::strInputNumber() const{
 QString EventCommand::strCondition() const{
     int i = 1;
     QString condition = "";
-    int page = p_listCommand.at(i++).toInt();
+    int page = p_intCommand.at(i++);
     switch (page){
     case 0:
         condition = strConditionPageVariables(i);
@@ -334,7 +400,7 @@ QString EventCommand::strCondition() const{
 QString EventCommand::strConditionPageVariables(int &i) const{
     QString condition = "";
     condition += "variable ";
-    int variable = p_listCommand.at(i++).toInt();
+    int variable = p_intCommand.at(i++);
     QString operation = WidgetComboBoxOperation::toString(p_listCommand.at(i++)
                                                           .toInt());
     condition += Wanok::get()->project()->gameDatas()
@@ -363,7 +429,7 @@ QString EventCommand::strModifyInventorySelection(int &i) const{
     QString selection = "";
 
     // Object type
-    int objectType = p_listCommand.at(i++).toInt();
+    int objectType = p_intCommand.at(i++);
     switch(objectType){
     case 0:
         selection += "item "; break;
@@ -374,7 +440,7 @@ QString EventCommand::strModifyInventorySelection(int &i) const{
     }
 
     // Id of the object
-    int objectId = p_listCommand.at(i++).toInt();
+    int objectId = p_intCommand.at(i++);
     QStandardItem* item;
     switch(objectType){
     case 0:
@@ -400,7 +466,7 @@ QString EventCommand::strModifyInventorySelection(int &i) const{
 QString EventCommand::strModifyTeam() const{
     int i = 0;
     QString operation = "";
-    int kind = p_listCommand.at(i++).toInt();
+    int kind = p_intCommand.at(i++);
     if (kind == 0) operation += strModifyTeamInstance(i);
     else if (kind == 1) operation += strModifyTeamMoveDelete(i);
 
@@ -417,8 +483,8 @@ QString EventCommand::strModifyTeamInstance(int &i) const{
             ->variablesDatas()->getVariableById(p_listCommand.at(i++)
                                                       .toInt())->toString();
     QString character = "";
-    int kindNew = p_listCommand.at(i++).toInt();
-    int idNew = p_listCommand.at(i++).toInt();
+    int kindNew = p_intCommand.at(i++);
+    int idNew = p_intCommand.at(i++);
     if (kindNew == 0){
         character += "hero " +
                 SuperListItem::getById(Wanok::get()->project()->gameDatas()
@@ -437,7 +503,7 @@ QString EventCommand::strModifyTeamInstance(int &i) const{
 // -------------------------------------------------------
 
 QString EventCommand::strModifyTeamMoveDelete(int &i) const{
-    QString addRemove = p_listCommand.at(i++).toInt() == 0 ? "move" : "remove";
+    QString addRemove = p_intCommand.at(i++) == 0 ? "move" : "remove";
     QString characterId = strNumberVariable(i);
     QString addRemoveTeam = WidgetComboBoxTeam::toString(p_listCommand.at(i++)
                                                          .toInt());
@@ -451,11 +517,11 @@ QString EventCommand::strModifyTeamMoveDelete(int &i) const{
 QString EventCommand::strStartBattle() const{
     int i = 2;
     QString troop = "troop ";
-    int kind = p_listCommand.at(i++).toInt();
+    int kind = p_intCommand.at(i++);
     int id;
     switch(kind){
     case 0:
-        id = p_listCommand.at(i++).toInt();
+        id = p_intCommand.at(i++);
         troop += SuperListItem::getById(Wanok::get()->project()->gameDatas()
                                         ->troopsDatas()->model()
                                         ->invisibleRootItem(), id)->toString();
@@ -490,7 +556,7 @@ QString EventCommand::strChangeState(SystemCommonObject *object,
 // -------------------------------------------------------
 
 QString EventCommand::strChangeStateOperation(int& i) const{
-    int operation = p_listCommand.at(i++).toInt();
+    int operation = p_intCommand.at(i++);
     QString str = "";
     switch (operation){
     case 0:
@@ -530,18 +596,18 @@ QString EventCommand::strSendEvent() const{
 
 QString EventCommand::strSendEventTarget(int& i) const{
     QString str = "";
-    int index = p_listCommand.at(i++).toInt();
+    int index = p_intCommand.at(i++);
     int id;
 
     switch (index){
     case 0:
         str += "all"; break;
     case 1:
-        id = p_listCommand.at(i++).toInt();
+        id = p_intCommand.at(i++);
         str += "detection " + QString::number(id);
         break;
     case 2:
-        id = p_listCommand.at(i++).toInt();
+        id = p_intCommand.at(i++);
         str += "object " + QString::number(id);
         break;
     case 3:
@@ -573,7 +639,7 @@ QString EventCommand::strTeleportObjectPosition(SystemCommonObject*,
                                                 QStandardItemModel* parameters,
                                                 int& i) const
 {
-    int kind = p_listCommand.at(i++).toInt();
+    int kind = p_intCommand.at(i++);
 
     if (kind == 0 || kind == 1){
         QString id, x, y, yPlus, z;
@@ -612,7 +678,7 @@ QString EventCommand::strTeleportObjectOptions(int& i) const{
     QStringList listOptions;
 
     QString str = "Direction:";
-    switch (p_listCommand.at(i++).toInt()){
+    switch (p_intCommand.at(i++)){
     case 0:
         listOptions << str + "Unchanged"; break;
     case 1:
@@ -734,7 +800,7 @@ QString EventCommand::strMoveCamera(QStandardItemModel* parameters) const {
 QString EventCommand::strMoveCameraTarget(QStandardItemModel* parameters,
                                           int& i) const
 {
-    int targetKind = p_listCommand.at(i++).toInt();
+    int targetKind = p_intCommand.at(i++);
     switch (targetKind) {
     case 0:
         return "Unchanged";
@@ -762,11 +828,11 @@ QString EventCommand::strMoveCameraMove(QStandardItemModel* parameters, int& i,
 
     // Moves
     QString x = operation + strNumber(i, parameters) + " ";
-    x += (p_listCommand.at(i++).toInt() == 0 ? "square(s)" : "pixel(s)");
+    x += (p_intCommand.at(i++) == 0 ? "square(s)" : "pixel(s)");
     QString y = operation + strNumber(i, parameters) + " ";
-    y += (p_listCommand.at(i++).toInt() == 0 ? "square(s)" : "pixel(s)");
+    y += (p_intCommand.at(i++) == 0 ? "square(s)" : "pixel(s)");
     QString z = operation + strNumber(i, parameters) + " ";
-    z += (p_listCommand.at(i++).toInt() == 0 ? "square(s)" : "pixel(s)");
+    z += (p_intCommand.at(i++) == 0 ? "square(s)" : "pixel(s)");
 
     return "X: " + x + "; Y: " + y + "; Z: " + z + " " + strOptions;
 }
@@ -816,6 +882,123 @@ QString EventCommand::strMoveCameraOptions(QStandardItemModel* parameters,
     return str;
 }
 
+// -------------------------------------------------------
+//
+//  USAGES : ids referenced by the command
+//
+// -------------------------------------------------------
+
+void EventCommand::getUsages(QVector<QPair<UsageKind, int>>& usages) const{
+    int i, kind;
+    UsageKind usageKind;
+
+    switch (p_kind) {
+    case EventCommandKind::ChangeVariables:
+        if (p_intCommand.value(0) == 0)
+            usages.append(qMakePair(UsageKind::Variable,
+                                    p_intCommand.value(1)));
+        else {
+            for (int id = p_intCommand.value(1); id <= p_intCommand.value(2);
+                 id++)
+            {
+                usages.append(qMakePair(UsageKind::Variable, id));
+            }
+        }
+        break;
+    case EventCommandKind::InputNumber:
+        usages.append(qMakePair(UsageKind::Variable, p_intCommand.value(0)));
+        break;
+    case EventCommandKind::If:
+        if (p_intCommand.value(1) == 0){
+            usages.append(qMakePair(UsageKind::Variable,
+                                    p_intCommand.value(2)));
+            getUsagesNumberVariable(4, usages);
+        }
+        break;
+    case EventCommandKind::ModifyInventory:
+        switch (p_intCommand.value(0)){
+        case 0:
+            usageKind = UsageKind::Item; break;
+        case 1:
+            usageKind = UsageKind::Weapon; break;
+        default:
+            usageKind = UsageKind::Armor; break;
+        }
+        usages.append(qMakePair(usageKind, p_intCommand.value(1)));
+        getUsagesNumberVariable(3, usages);
+        break;
+    case EventCommandKind::ModifyTeam:
+        if (p_intCommand.value(0) == 0){
+            usages.append(qMakePair(UsageKind::Variable,
+                                    p_intCommand.value(3)));
+            if (p_intCommand.value(4) == 0)
+                usages.append(qMakePair(UsageKind::Hero,
+                                        p_intCommand.value(5)));
+        }
+        else
+            getUsagesNumberVariable(2, usages);
+        break;
+    case EventCommandKind::StartBattle:
+        if (p_intCommand.value(2) == 0)
+            usages.append(qMakePair(UsageKind::Troop, p_intCommand.value(3)));
+        else if (p_intCommand.value(2) == 1)
+            getUsagesNumberVariable(3, usages);
+        break;
+    case EventCommandKind::ChangeState:
+        getUsagesDataBaseId(0, UsageKind::None, usages);
+        break;
+    case EventCommandKind::SendEvent:
+        i = 0;
+        kind = p_intCommand.value(i++);
+        if (kind == 1)
+            i++;
+        else if (kind == 2)
+            usages.append(qMakePair(UsageKind::Object,
+                                    p_intCommand.value(i++)));
+        usages.append(qMakePair(p_intCommand.value(i) == 0
+                                ? UsageKind::EventSystem
+                                : UsageKind::EventUser,
+                                p_intCommand.value(i + 1)));
+        break;
+    case EventCommandKind::TeleportObject:
+    case EventCommandKind::MoveObject:
+        getUsagesDataBaseId(0, UsageKind::Object, usages);
+        break;
+    case EventCommandKind::MoveCamera:
+        if (p_intCommand.value(0) == 1)
+            getUsagesDataBaseId(1, UsageKind::Object, usages);
+        break;
+    default:
+        break;
+    }
+}
+
+// -------------------------------------------------------
+
+void EventCommand::getUsagesNumberVariable(
+        int i, QVector<QPair<UsageKind, int>>& usages) const
+{
+    getUsagesDataBaseId(i, UsageKind::None, usages);
+}
+
+// -------------------------------------------------------
+
+void EventCommand::getUsagesDataBaseId(
+        int i, UsageKind kind, QVector<QPair<UsageKind, int>>& usages) const
+{
+    PrimitiveValueKind valueKind =
+            static_cast<PrimitiveValueKind>(p_intCommand.value(i));
+    int value = p_intCommand.value(i + 1);
+
+    if (valueKind == PrimitiveValueKind::Variable)
+        usages.append(qMakePair(UsageKind::Variable, value));
+    else if (valueKind == PrimitiveValueKind::DataBase &&
+             kind != UsageKind::None)
+    {
+        usages.append(qMakePair(kind, value));
+    }
+}
+
 // -------------------------------------------------------
 //
 //  READ / WRITE
@@ -825,6 +1008,7 @@ QString EventCommand::strMoveCameraOptions(QStandardItemModel* parameters,
 void EventCommand::read(const QJsonObject &json){
     p_kind = static_cast<EventCommandKind>(json["kind"].toInt());
     readCommand(json["command"].toArray());
+    compile();
 }
 
 // -------------------------------------------------------
@@ -856,20 +1040,5 @@ QJsonObject EventCommand::getJSON() const{
 // -------------------------------------------------------
 
 QJsonArray EventCommand::getArrayJSON() const{
-    QJsonArray tab;
-    for (int i = 0; i < p_listCommand.length(); i++){
-        QString s = p_listCommand.at(i);
-        bool conversionOk, conversionDoubleOk;
-        int integer = s.toInt(&conversionOk);
-        double d = s.toDouble(&conversionDoubleOk);
-
-        if (conversionOk)
-            tab.append(integer);
-        else if (conversionDoubleOk)
-            tab.append(d);
-        else
-            tab.append(s);
-    }
-
-    return tab;
+    return p_arrayCommand;
 }
@@ -26,7 +26,9 @@
 #include <QJsonObject>
 #include <QJsonArray>
 #include <QStandardItemModel>
+#include <QAtomicInt>
 #include "eventcommandkind.h"
+#include "usagekind.h"
 #include "systemcommonobject.h"
 
 // -------------------------------------------------------
@@ -47,6 +49,7 @@ public:
     EventCommandKind kind() const;
     int commandsCount() const;
     QString valueCommandAt(int index) const;
+    int intValueCommandAt(int index) const;
     bool hasElse() const;
     bool isBattleWithoutGameOver() const;
     bool isEditable() const;
@@ -56,12 +59,32 @@ public:
     void setCopy(const EventCommand& copy);
     QString toString(SystemCommonObject* object = nullptr,
                      QStandardItemModel* parameters = nullptr) const;
+    static void invalidateStrings();
+    void getUsages(QVector<QPair<UsageKind, int>>& usages) const;
 
 private:
     EventCommandKind p_kind;
     QVector<QString> p_listCommand;
 
+    // Compiled representation, built once when the command changes
+    QVector<int> p_intCommand;
+    QJsonArray p_arrayCommand;
+
+    // Display string cache
+    static QAtomicInt stringsRevision;
+    mutable QString m_cachedString;
+    mutable SystemCommonObject* m_cachedObject;
+    mutable QStandardItemModel* m_cachedParameters;
+    mutable int m_cachedRevision;
+
+    void compile();
+    QString computeString(SystemCommonObject* object,
+                          QStandardItemModel* parameters) const;
     void readCommand(const QJsonArray &json);
+    void getUsagesNumberVariable(int i, QVector<QPair<UsageKind, int>>& usages)
+    const;
+    void getUsagesDataBaseId(int i, UsageKind kind,
+                             QVector<QPair<UsageKind, int>>& usages) const;
     QJsonArray getArrayJSON() const;
     QString strNumberVariable(int &i) const;
     QString strDataBaseId(int &i, QStandardItemModel *dataBase = nullptr,
@@ -0,0 +1,63 @@
+/*
+    RPG Paper Maker Copyright (C) 2017 Marie Laporte
+
+    This file is part of RPG Paper Maker.
+
+    RPG Paper Maker is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    RPG Paper Maker is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with Foobar.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include "eventcommandsmodel.h"
+
+// -------------------------------------------------------
+//
+//  CONSTRUCTOR / DESTRUCTOR / GET / SET
+//
+// -------------------------------------------------------
+
+EventCommandsModel::EventCommandsModel(QObject *parent) :
+    QStandardItemModel(parent),
+    m_linkedObject(nullptr),
+    m_parameters(nullptr)
+{
+
+}
+
+EventCommandsModel::~EventCommandsModel()
+{
+
+}
+
+void EventCommandsModel::setContext(SystemCommonObject* object,
+                                    QStandardItemModel* parameters)
+{
+    m_linkedObject = object;
+    m_parameters = parameters;
+}
+
+// -------------------------------------------------------
+//
+//  INTERMEDIARY FUNCTIONS
+//
+// -------------------------------------------------------
+
+QVariant EventCommandsModel::data(const QModelIndex &index, int role) const {
+    if (role == Qt::DisplayRole && index.column() == 0){
+        EventCommand* command = (EventCommand*) QStandardItemModel::data(
+                    index, Qt::UserRole + 1).value<quintptr>();
+        if (command != nullptr)
+            return command->toString(m_linkedObject, m_parameters);
+    }
+
+    return QStandardItemModel::data(index, role);
+}
@@ -0,0 +1,53 @@
+/*
+    RPG Paper Maker Copyright (C) 2017 Marie Laporte
+
+    This file is part of RPG Paper Maker.
+
+    RPG Paper Maker is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    RPG Paper Maker is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with Foobar.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#ifndef EVENTCOMMANDSMODEL_H
+#define EVENTCOMMANDSMODEL_H
+
+#include <QStandardItemModel>
+#include "eventcommand.h"
+
+// -------------------------------------------------------
+//
+//  CLASS EventCommandsModel
+//
+//  A tree of event commands. The text of a line is not stored in the items:
+//  it is generated (and cached by the command) only when a view paints it,
+//  using the object and parameters the commands are displayed for.
+//
+// -------------------------------------------------------
+
+class EventCommandsModel : public QStandardItemModel
+{
+    Q_OBJECT
+public:
+    EventCommandsModel(QObject* parent = nullptr);
+    virtual ~EventCommandsModel();
+    void setContext(SystemCommonObject* object,
+                    QStandardItemModel* parameters);
+
+    virtual QVariant data(const QModelIndex &index,
+                          int role = Qt::DisplayRole) const;
+
+protected:
+    SystemCommonObject* m_linkedObject;
+    QStandardItemModel* m_parameters;
+};
+
+#endif // EVENTCOMMANDSMODEL_H
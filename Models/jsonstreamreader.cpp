@@ -0,0 +1,363 @@
+/*
+    RPG Paper Maker Copyright (C) 2017 Marie Laporte
+
+    This file is part of RPG Paper Maker.
+
+    RPG Paper Maker is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    RPG Paper Maker is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with Foobar.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include "jsonstreamreader.h"
+
+const int JsonStreamReader::CHUNK_SIZE = 65536;
+
+// -------------------------------------------------------
+//
+//  CONSTRUCTOR / DESTRUCTOR / GET / SET
+//
+// -------------------------------------------------------
+
+JsonStreamReader::JsonStreamReader(QIODevice *device) :
+    m_device(device),
+    m_position(0),
+    m_error(false),
+    m_first(false)
+{
+
+}
+
+bool JsonStreamReader::hasError() const {
+    return m_error;
+}
+
+// -------------------------------------------------------
+//
+//  INTERMEDIARY FUNCTIONS
+//
+// -------------------------------------------------------
+
+JsonStreamReader::ValueKind JsonStreamReader::peek() {
+    switch (peekChar()) {
+    case '{':
+        return ValueKind::Object;
+    case '[':
+        return ValueKind::Array;
+    case '"':
+        return ValueKind::String;
+    case 't':
+    case 'f':
+        return ValueKind::Bool;
+    case 'n':
+        return ValueKind::Null;
+    case '-':
+    case '0': case '1': case '2': case '3': case '4':
+    case '5': case '6': case '7': case '8': case '9':
+        return ValueKind::Number;
+    default:
+        return ValueKind::None;
+    }
+}
+
+// -------------------------------------------------------
+
+bool JsonStreamReader::beginObject() {
+    m_first = true;
+
+    return expect('{');
+}
+
+// -------------------------------------------------------
+
+bool JsonStreamReader::nextKey(QString& key) {
+    if (!nextInContainer('}'))
+        return false;
+    key = readString();
+
+    return expect(':');
+}
+
+// -------------------------------------------------------
+
+bool JsonStreamReader::beginArray() {
+    m_first = true;
+
+    return expect('[');
+}
+
+// -------------------------------------------------------
+
+bool JsonStreamReader::nextElement() {
+    return nextInContainer(']');
+}
+
+// -------------------------------------------------------
+
+QString JsonStreamReader::readString() {
+    m_first = false;
+    if (!expect('"'))
+        return QString();
+
+    QByteArray bytes;
+    while (!m_error) {
+        char c = getChar();
+        if (c == '"')
+            break;
+        if (c != '\\') {
+            bytes.append(c);
+            continue;
+        }
+
+        // Unicode, a high surrogate is followed by the escaped low one. If it
+        // is followed by another escape, it goes through the switch below
+        c = getChar();
+        if (c == 'u') {
+            ushort utf16[2];
+            int length = 1;
+            utf16[0] = readHexa();
+            c = 0;
+            if (utf16[0] >= 0xD800 && utf16[0] < 0xDC00 &&
+                peekRawChar() == '\\')
+            {
+                getChar();
+                c = getChar();
+                if (c == 'u') {
+                    utf16[1] = readHexa();
+                    length = 2;
+                    c = 0;
+                }
+            }
+            bytes.append(QString::fromUtf16(utf16, length).toUtf8());
+            if (c == 0)
+                continue;
+        }
+
+        // Escaped characters
+        switch (c) {
+        case 'b': bytes.append('\b'); break;
+        case 'f': bytes.append('\f'); break;
+        case 'n': bytes.append('\n'); break;
+        case 'r': bytes.append('\r'); break;
+        case 't': bytes.append('\t'); break;
+        default:
+            bytes.append(c);
+        }
+    }
+
+    return QString::fromUtf8(bytes);
+}
+
+// -------------------------------------------------------
+
+double JsonStreamReader::readDouble() {
+    m_first = false;
+
+    return readNumberBytes().toDouble();
+}
+
+// -------------------------------------------------------
+
+int JsonStreamReader::readInt() {
+    m_first = false;
+
+    return qRound(readNumberBytes().toDouble());
+}
+
+// -------------------------------------------------------
+
+bool JsonStreamReader::readBool() {
+    m_first = false;
+    if (peekChar() == 't')
+        return readLiteral("true");
+    readLiteral("false");
+
+    return false;
+}
+
+// -------------------------------------------------------
+
+QJsonValue JsonStreamReader::readValue() {
+    QString key;
+
+    switch (peek()) {
+    case ValueKind::Object: {
+        QJsonObject obj;
+        beginObject();
+        while (nextKey(key))
+            obj.insert(key, readValue());
+        m_first = false;
+        return obj;
+    }
+    case ValueKind::Array: {
+        QJsonArray tab;
+        beginArray();
+        while (nextElement())
+            tab.append(readValue());
+        m_first = false;
+        return tab;
+    }
+    case ValueKind::String:
+        return readString();
+    case ValueKind::Number:
+        return readDouble();
+    case ValueKind::Bool:
+        return readBool();
+    case ValueKind::Null:
+        m_first = false;
+        readLiteral("null");
+        return QJsonValue();
+    default:
+        m_error = true;
+        return QJsonValue();
+    }
+}
+
+// -------------------------------------------------------
+
+void JsonStreamReader::skipValue() {
+    QString key;
+
+    switch (peek()) {
+    case ValueKind::Object:
+        beginObject();
+        while (nextKey(key))
+            skipValue();
+        break;
+    case ValueKind::Array:
+        beginArray();
+        while (nextElement())
+            skipValue();
+        break;
+    default:
+        readValue();
+    }
+    m_first = false;
+}
+
+// -------------------------------------------------------
+
+bool JsonStreamReader::fillBuffer() {
+    if (m_position < m_buffer.size())
+        return true;
+    m_buffer = m_device->read(CHUNK_SIZE);
+    m_position = 0;
+
+    return !m_buffer.isEmpty();
+}
+
+// -------------------------------------------------------
+
+char JsonStreamReader::peekChar() {
+    while (fillBuffer()) {
+        char c = m_buffer.at(m_position);
+        if (c != ' ' && c != '\n' && c != '\r' && c != '\t')
+            return c;
+        m_position++;
+    }
+
+    return '\0';
+}
+
+// -------------------------------------------------------
+//  peekRawChar: same as peekChar but whitespaces are significant (inside
+//  strings)
+
+char JsonStreamReader::peekRawChar() {
+    return fillBuffer() ? m_buffer.at(m_position) : '\0';
+}
+
+// -------------------------------------------------------
+
+char JsonStreamReader::getChar() {
+    if (!fillBuffer()) {
+        m_error = true;
+        return '\0';
+    }
+
+    return m_buffer.at(m_position++);
+}
+
+// -------------------------------------------------------
+
+bool JsonStreamReader::expect(char c) {
+    if (m_error || peekChar() != c) {
+        m_error = true;
+        return false;
+    }
+    m_position++;
+
+    return true;
+}
+
+// -------------------------------------------------------
+
+bool JsonStreamReader::nextInContainer(char end) {
+    if (m_error)
+        return false;
+
+    // Closing the container
+    if (peekChar() == end) {
+        m_position++;
+        m_first = false;
+        return false;
+    }
+
+    // The first element has no separator before it
+    if (m_first) {
+        m_first = false;
+        return true;
+    }
+
+    return expect(',');
+}
+
+// -------------------------------------------------------
+
+bool JsonStreamReader::readLiteral(const char* literal) {
+    peekChar();
+    for (int i = 0; literal[i] != '\0'; i++) {
+        if (getChar() != literal[i]) {
+            m_error = true;
+            return false;
+        }
+    }
+
+    return true;
+}
+
+// -------------------------------------------------------
+
+QByteArray JsonStreamReader::readNumberBytes() {
+    QByteArray bytes;
+    char c = peekChar();
+    while ((c >= '0' && c <= '9') || c == '-' || c == '+' || c == '.' ||
+           c == 'e' || c == 'E')
+    {
+        bytes.append(c);
+        m_position++;
+        c = peekRawChar();
+    }
+    if (bytes.isEmpty())
+        m_error = true;
+
+    return bytes;
+}
+
+// -------------------------------------------------------
+
+uint JsonStreamReader::readHexa() {
+    char hexa[5] = {0};
+    for (int i = 0; i < 4; i++)
+        hexa[i] = getChar();
+
+    return QByteArray(hexa).toUInt(nullptr, 16);
+}
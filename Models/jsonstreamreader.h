@@ -0,0 +1,87 @@
+/*
+    RPG Paper Maker Copyright (C) 2017 Marie Laporte
+
+    This file is part of RPG Paper Maker.
+
+    RPG Paper Maker is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    RPG Paper Maker is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with Foobar.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#ifndef JSONSTREAMREADER_H
+#define JSONSTREAMREADER_H
+
+#include <QIODevice>
+#include <QJsonValue>
+#include <QJsonObject>
+#include <QJsonArray>
+
+// -------------------------------------------------------
+//
+//  CLASS JsonStreamReader
+//
+//  A pull parser reading JSON from a device by chunks, without building
+//  the whole document. Objects are read with beginObject / nextKey and
+//  arrays with beginArray / nextElement, values with the typed readers.
+//  readValue can still build a QJsonValue for a part that has no typed
+//  reader.
+//
+// -------------------------------------------------------
+
+class JsonStreamReader
+{
+public:
+    enum class ValueKind {
+        None,
+        Object,
+        Array,
+        String,
+        Number,
+        Bool,
+        Null
+    };
+
+    JsonStreamReader(QIODevice* device);
+    bool hasError() const;
+    ValueKind peek();
+    bool beginObject();
+    bool nextKey(QString& key);
+    bool beginArray();
+    bool nextElement();
+    QString readString();
+    double readDouble();
+    int readInt();
+    bool readBool();
+    QJsonValue readValue();
+    void skipValue();
+
+    static const int CHUNK_SIZE;
+
+protected:
+    QIODevice* m_device;
+    QByteArray m_buffer;
+    int m_position;
+    bool m_error;
+    bool m_first;
+
+    bool fillBuffer();
+    char peekChar();
+    char peekRawChar();
+    char getChar();
+    bool expect(char c);
+    bool nextInContainer(char end);
+    bool readLiteral(const char* literal);
+    QByteArray readNumberBytes();
+    uint readHexa();
+};
+
+#endif // JSONSTREAMREADER_H
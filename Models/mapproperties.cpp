@@ -53,7 +53,7 @@ MapProperties::MapProperties(int i, LangsTranslation* names, int l, int w,
 
 MapProperties::~MapProperties()
 {
-    QHash<Portion, QSet<Position>*>::iterator i;
+    QHash<Portion, QSet<PositionKey>*>::iterator i;
     for (i = m_outOverflowSprites.begin(); i != m_outOverflowSprites.end(); i++)
         delete *i;
 }
@@ -88,11 +88,27 @@ void MapProperties::setHeight(int h) { m_height = h; }
 
 void MapProperties::setDepth(int d) { m_depth = d; }
 
+const QSet<int>& MapProperties::mergedLayers() const { return m_mergedLayers; }
+
+bool MapProperties::isLayerMerged(int layer) const {
+    return m_mergedLayers.contains(layer);
+}
+
+void MapProperties::setMergedLayers(const QSet<int>& layers) {
+    m_mergedLayers = layers;
+}
+
+const QHash<Portion, QSet<PositionKey>*>&
+MapProperties::outOverflowSprites() const
+{
+    return m_outOverflowSprites;
+}
+
 void MapProperties::addOverflow(Position& p, Portion& portion) {
-    QSet<Position>* portions = m_outOverflowSprites.value(portion);
+    QSet<PositionKey>* portions = m_outOverflowSprites.value(portion);
 
     if (portions == nullptr) {
-        portions = new QSet<Position>;
+        portions = new QSet<PositionKey>;
         m_outOverflowSprites.insert(portion, portions);
     }
 
@@ -100,7 +116,7 @@ void MapProperties::addOverflow(Position& p, Portion& portion) {
 }
 
 void MapProperties::removeOverflow(Position& p, Portion& portion) {
-    QSet<Position>* portions = m_outOverflowSprites.value(portion);
+    QSet<PositionKey>* portions = m_outOverflowSprites.value(portion);
 
     if (portions != nullptr) {
         portions->remove(p);
@@ -143,6 +159,7 @@ void MapProperties::setCopy(const MapProperties& super){
     m_width = super.m_width;
     m_height = super.m_height;
     m_depth = super.m_depth;
+    m_mergedLayers = super.m_mergedLayers;
 }
 
 // -------------------------------------------------------
@@ -162,9 +179,9 @@ void MapProperties::updateRaycastingOverflowSprites(Portion &portion,
                                                     double cameraHAngle)
 {
     Map* map = Wanok::get()->project()->currentMap();
-    QSet<Position>* positions = m_outOverflowSprites.value(portion);
+    QSet<PositionKey>* positions = m_outOverflowSprites.value(portion);
     if (positions != nullptr) {
-        QSet<Position>::iterator i;
+        QSet<PositionKey>::iterator i;
         for (i = positions->begin(); i != positions->end(); i++) {
             Position position = *i;
             Portion portion;
@@ -196,6 +213,12 @@ void MapProperties::read(const QJsonObject &json){
     m_height = json["h"].toInt();
     m_depth = json["d"].toInt();
 
+    // Floors layers merged into bigger quads (none by default)
+    m_mergedLayers.clear();
+    QJsonArray tabMerged = json["ml"].toArray();
+    for (int i = 0; i < tabMerged.size(); i++)
+        m_mergedLayers.insert(tabMerged.at(i).toInt());
+
     // Overflow
     QJsonArray tabOverflow = json["ofsprites"].toArray();
     for (int i = 0; i < tabOverflow.size(); i++) {
@@ -204,7 +227,7 @@ void MapProperties::read(const QJsonObject &json){
         QJsonArray tabValue = objHash["v"].toArray();
         Portion portion;
         portion.read(tabKey);
-        QSet<Position>* positions = new QSet<Position>;
+        QSet<PositionKey>* positions = new QSet<PositionKey>;
 
         for (int j = 0; j < tabValue.size(); j++) {
             QJsonArray tabPosition = tabValue.at(j).toArray();
@@ -226,20 +249,26 @@ void MapProperties::write(QJsonObject &json) const{
     json["h"] = m_height;
     json["d"] = m_depth;
     json["tileset"] = m_tilesetID;
+    QJsonArray tabMerged;
+    QList<int> mergedLayers = m_mergedLayers.toList();
+    qSort(mergedLayers);
+    for (int i = 0; i < mergedLayers.size(); i++)
+        tabMerged.append(mergedLayers.at(i));
+    json["ml"] = tabMerged;
 
     // Overflow
-    QHash<Portion, QSet<Position>*>::const_iterator i;
+    QHash<Portion, QSet<PositionKey>*>::const_iterator i;
     QJsonArray tabOverflow;
     for (i = m_outOverflowSprites.begin(); i != m_outOverflowSprites.end(); i++)
     {
         Portion portion = i.key();
-        QSet<Position>* positions = i.value();
+        QSet<PositionKey>* positions = i.value();
         QJsonObject objHash;
         QJsonArray tabKey;
         QJsonArray tabValue;
 
         portion.write(tabKey);
-        QSet<Position>::iterator j;
+        QSet<PositionKey>::iterator j;
         for (j = positions->begin(); j != positions->end(); j++) {
             Position position = *j;
             QJsonArray tabPosition;
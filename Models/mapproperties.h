@@ -21,9 +21,10 @@
 #define MAPPROPERTIES_H
 
 #include <QHash>
+#include <QSet>
 #include "systemlang.h"
 #include "systemtileset.h"
-#include "position.h"
+#include "positionkey.h"
 #include "qray3d.h"
 
 // -------------------------------------------------------
@@ -53,8 +54,12 @@ public:
     void setWidth(int w);
     void setHeight(int h);
     void setDepth(int d);
+    const QSet<int>& mergedLayers() const;
+    bool isLayerMerged(int layer) const;
+    void setMergedLayers(const QSet<int>& layers);
     void addOverflow(Position& p, Portion& portion);
     void removeOverflow(Position& p, Portion& portion);
+    const QHash<Portion, QSet<PositionKey>*>& outOverflowSprites() const;
 
     bool isInGrid(Position3D& position, int squareSize) const;
     void getPortionsNumber(int& lx, int& ly, int& lz);
@@ -73,7 +78,8 @@ protected:
     int m_width;
     int m_height;
     int m_depth;
-    QHash<Portion, QSet<Position>*> m_outOverflowSprites;
+    QSet<int> m_mergedLayers;
+    QHash<Portion, QSet<PositionKey>*> m_outOverflowSprites;
 };
 
 #endif // MAPPROPERTIES_H
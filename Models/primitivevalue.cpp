@@ -256,7 +256,7 @@ void PrimitiveValue::initializeCommandParameter(const EventCommand* command,
     case PrimitiveValueKind::Property:
     case PrimitiveValueKind::DataBase:
     case PrimitiveValueKind::KeyBoard:
-        m_numberValue = command->valueCommandAt(i++).toInt();
+        m_numberValue = command->intValueCommandAt(i++);
         break;
     case PrimitiveValueKind::Message:
     case PrimitiveValueKind::Script:
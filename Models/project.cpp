@@ -19,6 +19,7 @@
 
 #include "project.h"
 #include "wanok.h"
+#include "eventcommand.h"
 #include "oskind.h"
 #include "projectupdater.h"
 #include "dialogprogress.h"
@@ -43,7 +44,9 @@ Project::Project() :
     m_scriptsDatas(new ScriptsDatas),
     m_picturesDatas(new PicturesDatas),
     m_keyBoardDatas(new KeyBoardDatas),
-    m_specialElementsDatas(new SpecialElementsDatas)
+    m_specialElementsDatas(new SpecialElementsDatas),
+    m_usages(new ProjectUsages),
+    m_minimaps(new ProjectMinimaps)
 {
 
 }
@@ -57,6 +60,8 @@ Project::~Project()
     delete m_picturesDatas;
     delete m_keyBoardDatas;
     delete m_specialElementsDatas;
+    delete m_usages;
+    delete m_minimaps;
 }
 
 // Gets
@@ -74,6 +79,9 @@ void Project::setCurrentMap(Map* m) {
         p_currentMapConfig = m;
     else
         p_currentMap = m;
+
+    // Objects displayed in commands depend on the current map
+    EventCommand::invalidateStrings();
 }
 
 GameDatas* Project::gameDatas() const { return p_gameDatas; }
@@ -94,6 +102,10 @@ SpecialElementsDatas* Project::specialElementsDatas() const {
 
 QString Project::version() const { return m_version; }
 
+ProjectUsages* Project::usages() const { return m_usages; }
+
+ProjectMinimaps* Project::minimaps() const { return m_minimaps; }
+
 // -------------------------------------------------------
 //
 //  INTERMEDIARY FUNCTIONS
@@ -132,6 +144,23 @@ bool Project::read(QString path){
     if (!readOS())
         return false;
 
+    // All the datas files are parsed at the same time on the thread pool.
+    // They are then deserialized in the order below (e.g. tilesets after
+    // pictures), each one only waiting for its own file. The variables are
+    // read from the file stream instead
+    QStringList paths;
+    paths << Wanok::pathLangs << Wanok::pathKeyBoard << Wanok::pathPicturesDatas
+          << Wanok::pathCommonEvents
+          << Wanok::pathSystem << Wanok::pathItems << Wanok::pathSkills
+          << Wanok::pathBattleSystem << Wanok::pathWeapons
+          << Wanok::pathArmors << Wanok::pathHeroes << Wanok::pathMonsters
+          << Wanok::pathTroops << Wanok::pathClasses << Wanok::PATH_TILESETS
+          << Wanok::pathTreeMap << Wanok::pathScripts
+          << Wanok::PATH_SPECIAL_ELEMENTS;
+    for (int i = 0; i < paths.size(); i++)
+        paths[i] = Wanok::pathCombine(p_pathCurrentProject, paths.at(i));
+    Wanok::preloadJSON(paths);
+
     readLangsDatas();
     readKeyBoardDatas();
     readPicturesDatas();
@@ -139,8 +168,13 @@ bool Project::read(QString path){
     readTreeMapDatas();
     readScriptsDatas();
     readSpecialsDatas();
+    Wanok::clearPreloadedJSON();
     p_currentMap = nullptr;
 
+    // Index the ids used by maps and common events in background
+    m_usages->load(p_pathCurrentProject);
+    m_minimaps->load(p_pathCurrentProject);
+
     return true;
 }
 
@@ -386,6 +420,7 @@ void Project::write(QString path){
 
 void Project::writeGameDatas(){
     p_gameDatas->write(p_pathCurrentProject);
+    m_usages->refreshCommonEvents();
 }
 
 // -------------------------------------------------------
@@ -28,6 +28,8 @@
 #include "picturesdatas.h"
 #include "keyboarddatas.h"
 #include "specialelementsdatas.h"
+#include "projectusages.h"
+#include "projectminimaps.h"
 
 // -------------------------------------------------------
 //
@@ -57,6 +59,8 @@ public:
     KeyBoardDatas* keyBoardDatas() const;
     SpecialElementsDatas* specialElementsDatas() const;
     QString version() const;
+    ProjectUsages* usages() const;
+    ProjectMinimaps* minimaps() const;
 
     bool read(QString path);
     bool readVersion();
@@ -96,6 +100,8 @@ private:
     PicturesDatas* m_picturesDatas;
     KeyBoardDatas* m_keyBoardDatas;
     SpecialElementsDatas* m_specialElementsDatas;
+    ProjectUsages* m_usages;
+    ProjectMinimaps* m_minimaps;
     QString m_version;
 };
 
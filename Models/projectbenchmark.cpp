@@ -0,0 +1,551 @@
+/*
+    RPG Paper Maker Copyright (C) 2017 Marie Laporte
+
+    This file is part of RPG Paper Maker.
+
+    RPG Paper Maker is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    RPG Paper Maker is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with Foobar.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include <QDirIterator>
+#include <QDateTime>
+#include <QEventLoop>
+#include <QTimer>
+#include <QTextStream>
+#include <QOffscreenSurface>
+#include <QOpenGLContext>
+#include <QOpenGLFunctions>
+#include "projectbenchmark.h"
+#include "projectgenerator.h"
+#include "projectupdater.h"
+#include "controlexport.h"
+#include "controlmapeditor.h"
+#include "widgetmapeditor.h"
+#include "widgetmenubarmapeditor.h"
+#include "paneltextures.h"
+#include "mapportion.h"
+#include "mapproperties.h"
+#include "camera.h"
+#include "superlistitemmodel.h"
+#include "boxesbatch.h"
+#include "wanok.h"
+
+const int ProjectBenchmark::REPLAY_FRAME_TIMEOUT = 1000;
+const int ProjectBenchmark::BOXES_COUNT = 10000;
+const int ProjectBenchmark::BOXES_RAYS = 1000;
+
+// -------------------------------------------------------
+//
+//  CONSTRUCTOR / DESTRUCTOR / GET / SET
+//
+// -------------------------------------------------------
+
+ProjectBenchmark::ProjectBenchmark()
+{
+
+}
+
+ProjectBenchmark::~ProjectBenchmark()
+{
+
+}
+
+// -------------------------------------------------------
+//
+//  INTERMEDIARY FUNCTIONS
+//
+// -------------------------------------------------------
+
+void ProjectBenchmark::startTiming() {
+    m_timer.start();
+}
+
+// -------------------------------------------------------
+
+void ProjectBenchmark::stopTiming(QString name, int count) {
+    addTiming(name, m_timer.nsecsElapsed() / 1000000.0, count);
+}
+
+// -------------------------------------------------------
+
+void ProjectBenchmark::addTiming(QString name, double ms, int count) {
+    m_names.append(name);
+    m_timings.append(ms);
+    m_counts.append(count);
+}
+
+// -------------------------------------------------------
+//  run: path is a project directory, which is copied, or generator settings,
+//  which are used to generate the project. The maps steps are done in the
+//  biggest map, and the replay (if any) in the map it was recorded on. The
+//  migration is last because it modifies the portions of the copy
+
+QString ProjectBenchmark::run(QString path, QString pathReplay) {
+    if (!m_temporaryDir.isValid())
+        return "Could not create a temporary directory for the benchmarks.";
+    QString error = QFileInfo(path).isDir() ? copyProject(path)
+                                            : generateProject(path);
+    if (error != NULL)
+        return error;
+    error = checkProject();
+    if (error != NULL)
+        return error;
+
+    Project* previousProject = Wanok::get()->project();
+    Project* project = new Project;
+    Wanok::get()->setProject(project);
+
+    // Project open (the usages and minimaps are loaded in background)
+    startTiming();
+    bool ok = project->read(m_pathProject);
+    stopTiming("projectOpen");
+    if (!ok)
+        error = "Could not read the project " + m_pathProject + ".";
+
+    if (error == NULL)
+        error = benchmarkMap(biggestMapId());
+    if (error == NULL && !pathReplay.isEmpty())
+        error = benchmarkReplay(pathReplay);
+    if (error == NULL) {
+        benchmarkSave(project);
+        error = benchmarkExport(project);
+    }
+    if (error == NULL)
+        benchmarkMigration(project);
+    if (error == NULL)
+        error = benchmarkDatabases(project);
+    if (error == NULL)
+        error = benchmarkBoxesBatch();
+
+    // Restoring project
+    Wanok::get()->setProject(previousProject);
+    delete project;
+
+    return error;
+}
+
+// -------------------------------------------------------
+
+QString ProjectBenchmark::generateProject(QString pathSettings) {
+    ProjectGenerator generator;
+    if (!QFile(pathSettings).exists())
+        return "The file " + pathSettings + " does not exist.";
+    Wanok::readJSON(pathSettings, generator);
+    QString dirName = QFileInfo(pathSettings).completeBaseName();
+    QString error = generator.generate(dirName, m_temporaryDir.path());
+    if (error != NULL)
+        return error;
+    m_pathProject = Wanok::pathCombine(m_temporaryDir.path(), dirName);
+
+    return NULL;
+}
+
+// -------------------------------------------------------
+
+QString ProjectBenchmark::copyProject(QString path) {
+    m_pathProject = Wanok::pathCombine(m_temporaryDir.path(),
+                                       QDir(path).dirName());
+    if (!Wanok::copyPath(path, m_pathProject))
+        return "Error while copying the project " + path + ".";
+
+    return NULL;
+}
+
+// -------------------------------------------------------
+//  checkProject: opening a project of another version or OS asks the user
+//  to convert it, so it has to be opened once in the editor before
+
+QString ProjectBenchmark::checkProject() const {
+    QFile file(Wanok::pathCombine(m_pathProject, "game.rpm"));
+    if (!file.open(QIODevice::ReadOnly))
+        return "Could not open " + file.fileName() + ".";
+    QString version = QTextStream(&file).readLine();
+    file.close();
+    if (ProjectUpdater::versionDifferent(version, Project::ENGINE_VERSION)
+        != 0)
+    {
+        return "This project is under " + version + " version, open it once "
+               "in the editor to convert it to " + Project::ENGINE_VERSION +
+               " before running the benchmarks.";
+    }
+
+    QString execName;
+    #ifdef Q_OS_WIN
+        execName = "Game.exe";
+    #elif __linux__
+        execName = "Game.sh";
+    #endif
+    if (!execName.isEmpty() &&
+        !QFile(Wanok::pathCombine(m_pathProject, execName)).exists())
+    {
+        return "This project is configured for another OS, open it once in "
+               "the editor to convert it before running the benchmarks.";
+    }
+
+    return NULL;
+}
+
+// -------------------------------------------------------
+
+int ProjectBenchmark::biggestMapId() const {
+    QString pathMaps = Wanok::pathCombine(m_pathProject, Wanok::pathMaps);
+    QDirIterator directories(pathMaps, QDir::Dirs | QDir::NoDotAndDotDot);
+    int id = -1, size = 0;
+
+    while (directories.hasNext()) {
+        directories.next();
+        if (directories.fileName() != Wanok::TEMP_MAP_FOLDER_NAME) {
+            MapProperties properties(directories.filePath());
+            if (properties.length() * properties.width() > size) {
+                size = properties.length() * properties.width();
+                id = properties.id();
+            }
+        }
+    }
+
+    return id;
+}
+
+// -------------------------------------------------------
+//  benchmarkMap: open the map in an offscreen context and move the cursor
+//  square by square along the diagonal of the map, so that portions are
+//  streamed in both directions
+
+QString ProjectBenchmark::benchmarkMap(int idMap) {
+    if (idMap == -1)
+        return "There is no map in the project.";
+    QOffscreenSurface surface;
+    surface.create();
+    QOpenGLContext context;
+    if (!context.create() || !context.makeCurrent(&surface))
+        return "Could not create an OpenGL context.";
+    QOpenGLFunctions* functions = context.functions();
+    ControlMapEditor control;
+    QVector3D position, positionObject;
+
+    // Map open
+    startTiming();
+    control.loadMap(idMap, &position, &positionObject,
+                    Camera::defaultDistance, Camera::defaultHAngle,
+                    Camera::defaultVAngle);
+    functions->glFinish();
+    stopTiming("mapOpen");
+
+    // Portions streaming
+    MapProperties* properties = control.map()->mapProperties();
+    int steps = qMin(properties->length(), properties->width());
+    QElapsedTimer timer;
+    qint64 maxStep = 0;
+    control.teleportCursor(0, 0);
+    startTiming();
+    for (int i = 1; i < steps; i++) {
+        timer.start();
+        control.cursor()->setX(i);
+        control.cursor()->setZ(i);
+        control.updateMovingPortions();
+        functions->glFinish();
+        maxStep = qMax(maxStep, timer.nsecsElapsed());
+    }
+    stopTiming("portionsStreaming", steps - 1);
+    addTiming("portionsStreamingMaxStep", maxStep / 1000000.0);
+
+    control.deleteMap(false);
+    context.doneCurrent();
+
+    return NULL;
+}
+
+// -------------------------------------------------------
+//  benchmarkReplay: replay the recorded inputs in a map editor of the
+//  recorded size. The replay file is copied in the temporary directory,
+//  where its timings are written
+
+QString ProjectBenchmark::benchmarkReplay(QString pathReplay) {
+    QString path = Wanok::pathCombine(m_temporaryDir.path(),
+                                      QFileInfo(pathReplay).fileName());
+    if (!QFile::copy(pathReplay, path))
+        return "Could not copy the replay file " + pathReplay + ".";
+    MapEditorReplay replay;
+    Wanok::readJSON(path, replay);
+    if (replay.framesCount() == 0)
+        return "There is no frame to replay in " + pathReplay + ".";
+
+    WidgetMenuBarMapEditor menuBar(nullptr, true);
+    PanelTextures panelTextures;
+    WidgetMapEditor widget;
+    QVector3D position, positionObject;
+    QEventLoop loop;
+    QTimer timer;
+    timer.setSingleShot(true);
+    QObject::connect(&timer, SIGNAL(timeout()), &loop, SLOT(quit()));
+    widget.setMenuBar(&menuBar);
+    widget.setPanelTextures(&panelTextures);
+    widget.resize(replay.size());
+
+    // The map is opened once the widget has its OpenGL context
+    QObject::connect(&widget, SIGNAL(mapLoaded()), &loop, SLOT(quit()));
+    widget.needUpdateMap(replay.idMap(), &position, &positionObject,
+                         replay.cameraDistance(),
+                         replay.cameraHorizontalAngle(),
+                         replay.cameraVerticalAngle());
+    widget.show();
+    if (widget.getMap() == nullptr) {
+        timer.start(REPLAY_FRAME_TIMEOUT * 10);
+        loop.exec();
+    }
+    if (widget.getMap() == nullptr) {
+        return "The map editor could not open the map " +
+                QString::number(replay.idMap()) + ".";
+    }
+
+    // Replay
+    QString message;
+    if (!widget.startReplay(path, message))
+        return message;
+    QObject::connect(&widget, SIGNAL(replayFinished(QString)),
+                     &loop, SLOT(quit()));
+    timer.start(REPLAY_FRAME_TIMEOUT * replay.framesCount());
+    loop.exec();
+    if (widget.replay().isReplaying()) {
+        widget.deleteMap();
+        return "The replay did not finish in time.";
+    }
+    m_replayTimings = QJsonObject();
+    widget.replay().writeTimings(m_replayTimings);
+    m_replayText = widget.replay().timingsToString();
+    widget.deleteMap();
+    Wanok::mapsToSave.remove(replay.idMap());
+
+    return NULL;
+}
+
+// -------------------------------------------------------
+//  benchmarkSave: save the datas, and all the maps as if all their portions
+//  were modified (written in the temp folder and then copied)
+
+void ProjectBenchmark::benchmarkSave(Project* project) {
+    QString pathMaps = Wanok::pathCombine(m_pathProject, Wanok::pathMaps);
+    QDirIterator directories(pathMaps, QDir::Dirs | QDir::NoDotAndDotDot);
+    qint64 total = 0;
+    int count = 0;
+
+    startTiming();
+    project->write(m_pathProject);
+    stopTiming("datasSave");
+
+    while (directories.hasNext()) {
+        directories.next();
+        if (directories.fileName() == Wanok::TEMP_MAP_FOLDER_NAME)
+            continue;
+        QString pathMap = directories.filePath();
+        QString pathTemp = Wanok::pathCombine(pathMap,
+                                              Wanok::TEMP_MAP_FOLDER_NAME);
+
+        // Reading is not part of the save
+        QList<MapPortion*> portions;
+        QStringList names;
+        QDirIterator files(pathMap, QDir::Files);
+        while (files.hasNext()) {
+            files.next();
+            QStringList coords = files.fileInfo().baseName().split("_");
+            if (coords.size() == 3) {
+                Portion portion(coords.at(0).toInt(), coords.at(1).toInt(),
+                                coords.at(2).toInt());
+                MapPortion* mapPortion = new MapPortion(portion);
+                Wanok::readJSON(files.filePath(), *mapPortion);
+                portions.append(mapPortion);
+                names.append(files.fileName());
+            }
+        }
+
+        m_timer.start();
+        for (int i = 0; i < portions.size(); i++) {
+            QString path = Wanok::pathCombine(pathTemp, names.at(i));
+            if (portions.at(i)->isEmpty()) {
+                QJsonObject obj;
+                Wanok::writeOtherJSON(path, obj);
+            }
+            else
+                Wanok::writeJSON(path, *portions.at(i));
+        }
+        Wanok::copyAllFiles(pathTemp, pathMap);
+        Wanok::deleteAllFiles(pathTemp);
+        total += m_timer.nsecsElapsed();
+        count += portions.size();
+        qDeleteAll(portions);
+    }
+    addTiming("mapsSave", total / 1000000.0, count);
+}
+
+// -------------------------------------------------------
+
+QString ProjectBenchmark::benchmarkExport(Project* project) {
+    QString path = Wanok::pathCombine(m_temporaryDir.path(), "Export");
+    if (!QDir(m_temporaryDir.path()).mkdir("Export"))
+        return "Could not create a directory for the export.";
+    ControlExport control(project);
+
+    startTiming();
+    QString message = control.createBrowser(path);
+    stopTiming("export");
+
+    return message;
+}
+
+// -------------------------------------------------------
+//  benchmarkMigration: update all the portions of the copy as the last
+//  migration does. The updater checks its progress every 50 ms, which is the
+//  precision of this timing
+
+void ProjectBenchmark::benchmarkMigration(Project* project) {
+    ProjectUpdater updater(project, "");
+    updater.getAllPathsMapsPortions();
+
+    startTiming();
+    updater.updatePortions(&ProjectUpdater::updatePortion_0_4_0);
+    stopTiming("migration");
+}
+
+// -------------------------------------------------------
+//  benchmarkDatabases: change the id of every item (as a dialog does) and
+//  find it by its new id, then the same to put the ids back. Use generator
+//  settings with a big "databases" for it to be significant
+
+QString ProjectBenchmark::benchmarkDatabases(Project* project) {
+    SuperListItemModel* model = qobject_cast<SuperListItemModel*>(
+                project->gameDatas()->itemsDatas()->model());
+    if (model == nullptr)
+        return "The items model is not indexed.";
+    int l = model->rowCount();
+    int offset = model->getNewId() + l;
+
+    startTiming();
+    for (int k = 0; k < 2; k++) {
+        for (int i = 0; i < l; i++) {
+            SuperListItem* super = model->superItem(i);
+            int id = super->id() + (k == 0 ? offset : -offset);
+            super->setId(id);
+            model->item(i)->setText(super->toString());
+            if (model->getById(id) != super)
+                return "Could not find the item " + QString::number(id) + ".";
+        }
+    }
+    stopTiming("databasesEdit", 2 * l);
+
+    return NULL;
+}
+
+// -------------------------------------------------------
+//  benchmarkBoxesBatch: the same rays against the same boxes with and without
+//  SSE. The boxes and rays are always the same (fixed seed) so that the
+//  timings of several runs can be compared
+
+QString ProjectBenchmark::benchmarkBoxesBatch() {
+    BoxesBatch boxes;
+    QVector<QRay3D> rays;
+    qsrand(0);
+    boxes.reserve(BOXES_COUNT);
+    for (int i = 0; i < BOXES_COUNT; i++) {
+        QVector3D corner(qrand() % 1000, qrand() % 100, qrand() % 1000);
+        boxes.append(corner, corner + QVector3D(1 + qrand() % 16,
+                                                1 + qrand() % 16,
+                                                1 + qrand() % 16));
+    }
+    for (int i = 0; i < BOXES_RAYS; i++) {
+        QVector3D origin(qrand() % 1000, 200, qrand() % 1000);
+        QVector3D target(qrand() % 1000, 0, qrand() % 1000);
+        rays.append(QRay3D(origin, target - origin));
+    }
+
+    QVector<int> indexes(BOXES_RAYS), indexesScalar(BOXES_RAYS);
+    float distance;
+    startTiming();
+    for (int i = 0; i < BOXES_RAYS; i++)
+        indexes[i] = boxes.intersection(rays.at(i), &distance);
+    stopTiming("boxesBatch", BOXES_RAYS);
+    startTiming();
+    for (int i = 0; i < BOXES_RAYS; i++)
+        indexesScalar[i] = boxes.intersectionScalar(rays.at(i), &distance);
+    stopTiming("boxesBatchScalar", BOXES_RAYS);
+
+    if (indexes != indexesScalar)
+        return "The boxes batch results are different with SSE.";
+
+    return NULL;
+}
+
+// -------------------------------------------------------
+
+QString ProjectBenchmark::timingsToString() const {
+    QString text;
+    for (int i = 0; i < m_names.size(); i++) {
+        text += m_names.at(i) + ": " +
+                QString::number(m_timings.at(i), 'f', 1) + " ms";
+        if (m_counts.at(i) > 1)
+            text += " (" + QString::number(m_counts.at(i)) + ")";
+        text += "\n";
+    }
+    if (!m_replayText.isEmpty())
+        text += "replay:\n" + m_replayText + "\n";
+
+    return text;
+}
+
+// -------------------------------------------------------
+//
+//  READ / WRITE
+//
+// -------------------------------------------------------
+
+void ProjectBenchmark::read(const QJsonObject &json) {
+    m_names.clear();
+    m_timings.clear();
+    m_counts.clear();
+
+    QJsonArray tab = json["timings"].toArray();
+    for (int i = 0; i < tab.size(); i++) {
+        QJsonObject obj = tab.at(i).toObject();
+        addTiming(obj["name"].toString(), obj["ms"].toDouble(),
+                  obj["count"].toInt(1));
+    }
+    m_replayTimings = json["replay"].toObject();
+}
+
+// -------------------------------------------------------
+
+void ProjectBenchmark::write(QJsonObject &json) const {
+    json["v"] = Project::ENGINE_VERSION;
+    json["date"] = QDateTime::currentDateTime().toString(Qt::ISODate);
+    json["project"] = QDir(m_pathProject).dirName();
+
+    // Settings of the generated project, if any
+    QString pathSettings = Wanok::pathCombine(m_pathProject,
+                                              ProjectGenerator::PATH_SETTINGS);
+    if (QFile(pathSettings).exists()) {
+        QJsonDocument document;
+        Wanok::readOtherJSON(pathSettings, document);
+        json["generator"] = document.object();
+    }
+
+    QJsonArray tab;
+    for (int i = 0; i < m_names.size(); i++) {
+        QJsonObject obj;
+        obj["name"] = m_names.at(i);
+        obj["ms"] = m_timings.at(i);
+        obj["count"] = m_counts.at(i);
+        tab.append(obj);
+    }
+    json["timings"] = tab;
+    if (!m_replayTimings.isEmpty())
+        json["replay"] = m_replayTimings;
+}
@@ -0,0 +1,84 @@
+/*
+    RPG Paper Maker Copyright (C) 2017 Marie Laporte
+
+    This file is part of RPG Paper Maker.
+
+    RPG Paper Maker is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    RPG Paper Maker is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with Foobar.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#ifndef PROJECTBENCHMARK_H
+#define PROJECTBENCHMARK_H
+
+#include <QElapsedTimer>
+#include <QTemporaryDir>
+#include <QStringList>
+#include <QVector>
+#include "project.h"
+
+// -------------------------------------------------------
+//
+//  CLASS ProjectBenchmark
+//
+//  The timings of the main operations on a project (open, map open,
+//  portions streaming, replay of recorded map editor inputs, save, export
+//  and migration). It runs without the editor window, on a copy of the
+//  project or on a project generated in a temporary directory, so that the
+//  benchmarked project is never modified. The results are written in a JSON
+//  file with the engine version and the generator settings of the project,
+//  so that the results of several versions can be compared.
+//
+// -------------------------------------------------------
+
+class ProjectBenchmark : public Serializable
+{
+public:
+    ProjectBenchmark();
+    virtual ~ProjectBenchmark();
+    static const int REPLAY_FRAME_TIMEOUT;
+    static const int BOXES_COUNT;
+    static const int BOXES_RAYS;
+
+    QString run(QString path, QString pathReplay = "");
+    QString timingsToString() const;
+
+    virtual void read(const QJsonObject &json);
+    virtual void write(QJsonObject &json) const;
+
+protected:
+    QTemporaryDir m_temporaryDir;
+    QString m_pathProject;
+    QElapsedTimer m_timer;
+    QStringList m_names;
+    QVector<double> m_timings;
+    QVector<int> m_counts;
+    QJsonObject m_replayTimings;
+    QString m_replayText;
+
+    void startTiming();
+    void stopTiming(QString name, int count = 1);
+    void addTiming(QString name, double ms, int count = 1);
+    QString generateProject(QString pathSettings);
+    QString copyProject(QString path);
+    QString checkProject() const;
+    int biggestMapId() const;
+    QString benchmarkMap(int idMap);
+    QString benchmarkReplay(QString pathReplay);
+    void benchmarkSave(Project* project);
+    QString benchmarkExport(Project* project);
+    void benchmarkMigration(Project* project);
+    QString benchmarkDatabases(Project* project);
+    QString benchmarkBoxesBatch();
+};
+
+#endif // PROJECTBENCHMARK_H
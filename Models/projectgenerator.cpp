@@ -0,0 +1,331 @@
+/*
+    RPG Paper Maker Copyright (C) 2017 Marie Laporte
+
+    This file is part of RPG Paper Maker.
+
+    RPG Paper Maker is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    RPG Paper Maker is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with Foobar.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include "projectgenerator.h"
+#include "controlnewproject.h"
+#include "map.h"
+#include "treemaptag.h"
+#include "systemitem.h"
+#include "systemskill.h"
+#include "systemweapon.h"
+#include "systemarmor.h"
+#include "systemmonster.h"
+#include "systemmapobject.h"
+#include "systemobjectevent.h"
+#include "systemreaction.h"
+#include "superlistitemmodel.h"
+#include "wanok.h"
+
+const QString ProjectGenerator::PATH_SETTINGS = "generator.json";
+
+// -------------------------------------------------------
+//
+//  CONSTRUCTOR / DESTRUCTOR / GET / SET
+//
+// -------------------------------------------------------
+
+ProjectGenerator::ProjectGenerator()
+{
+    setDefault();
+}
+
+ProjectGenerator::~ProjectGenerator()
+{
+
+}
+
+int ProjectGenerator::mapsCount() const { return m_mapsCount; }
+
+// -------------------------------------------------------
+//
+//  INTERMEDIARY FUNCTIONS
+//
+// -------------------------------------------------------
+
+void ProjectGenerator::setDefault() {
+    m_mapsCount = 10;
+    m_length = 128;
+    m_width = 128;
+    m_height = 16;
+    m_floorsDensity = 100;
+    m_spritesDensity = 10;
+    m_wallsDensity = 5;
+    m_objectsDensity = 1;
+    m_eventsPerObject = 2;
+    m_commandsPerEvent = 10;
+    m_databasesSize = 500;
+    m_seed = 0;
+}
+
+// -------------------------------------------------------
+//  generate: create a new project and fill it. Returns a string if errors.
+
+QString ProjectGenerator::generate(QString dirName, QString location) {
+    ControlNewproject control;
+    QString error = control.createNewProject(dirName, location);
+    if (error != NULL)
+        return error;
+    QString pathDir = Wanok::pathCombine(location, dirName);
+
+    // The new project datas are the default ones, no need to read them
+    Project* previousProject = Wanok::get()->project();
+    Project* project = new Project;
+    Wanok::get()->setProject(project);
+    project->setDefault();
+    project->setPathCurrentProject(pathDir);
+
+    // Always the same project for the same settings
+    m_random.seed(m_seed);
+    generateDatabases(project);
+    for (int i = 0; i < m_mapsCount; i++)
+        generateMap(pathDir);
+    project->writeGameDatas();
+    project->writeTreeMapDatas();
+    Wanok::writeJSON(Wanok::pathCombine(pathDir, PATH_SETTINGS), *this);
+
+    // Restoring project
+    Wanok::get()->setProject(previousProject);
+    delete project;
+
+    return NULL;
+}
+
+// -------------------------------------------------------
+//  generateDatabase: copy the last item of the model until the model has
+//  the databases size
+
+template <class T>
+void ProjectGenerator::generateDatabase(QStandardItemModel* model) {
+    SuperListItemModel* indexedModel = qobject_cast<SuperListItemModel*>(
+                model);
+    int count = model->invisibleRootItem()->rowCount();
+    if (indexedModel == nullptr || count == 0)
+        return;
+
+    QJsonObject json;
+    SuperListItem* last = indexedModel->superItem(count - 1);
+    last->write(json);
+    QList<SuperListItem*> list;
+    for (int i = 1; i <= m_databasesSize - count; i++) {
+        T* super = new T;
+        super->read(json);
+        super->setId(last->id() + i);
+        super->setName(last->name() + " " + QString::number(i));
+        list.append(super);
+    }
+    indexedModel->appendSuperItems(list);
+}
+
+// -------------------------------------------------------
+
+void ProjectGenerator::generateDatabases(Project* project) {
+    GameDatas* datas = project->gameDatas();
+
+    generateDatabase<SystemItem>(datas->itemsDatas()->model());
+    generateDatabase<SystemSkill>(datas->skillsDatas()->model());
+    generateDatabase<SystemWeapon>(datas->weaponsDatas()->model());
+    generateDatabase<SystemArmor>(datas->armorsDatas()->model());
+    generateDatabase<SystemMonster>(datas->monstersDatas()->model());
+}
+
+// -------------------------------------------------------
+
+void ProjectGenerator::generateMap(QString path) {
+    TreeMapDatas* treeMapDatas = Wanok::get()->project()->treeMapDatas();
+    MapProperties properties;
+    properties.names()->updateNames();
+    int id = Wanok::generateMapId();
+    properties.setId(id);
+    properties.names()->setAllNames(Wanok::generateMapName(id));
+    properties.setLength(m_length);
+    properties.setWidth(m_width);
+    properties.setHeight(m_height);
+    QJsonArray objects;
+    QString pathMap = Map::writeMap(path, properties, objects);
+
+    // Only the portions of the ground are filled, the others stay empty
+    int idObject = 1;
+    int lx = (m_length - 1) / Wanok::portionSize;
+    int lz = (m_width - 1) / Wanok::portionSize;
+    for (int i = 0; i <= lx; i++) {
+        for (int k = 0; k <= lz; k++) {
+            Portion portion(i, 0, k);
+            MapPortion mapPortion(portion);
+            generatePortion(mapPortion, portion, objects, idObject);
+            if (!mapPortion.isEmpty()) {
+                Wanok::writeJSON(Wanok::pathCombine(
+                                     pathMap, Map::getPortionPathMap(i, 0, k)),
+                                 mapPortion);
+            }
+        }
+    }
+
+    // Objects
+    QJsonObject json;
+    json["objs"] = objects;
+    Wanok::writeOtherJSON(Wanok::pathCombine(pathMap, Wanok::fileMapObjects),
+                          json);
+
+    // Tree
+    TreeMapDatas::addMap(treeMapDatas->root(),
+                         treeMapDatas->root()->rowCount(),
+                         TreeMapTag::createMap(properties.name(), id));
+}
+
+// -------------------------------------------------------
+
+void ProjectGenerator::generatePortion(MapPortion& mapPortion,
+                                       Portion& portion, QJsonArray& objects,
+                                       int& idObject)
+{
+    QJsonObject previous;
+    MapEditorSubSelectionKind previousType;
+    QSet<Portion> portionsOverflow;
+    int beginX = portion.x() * Wanok::portionSize;
+    int beginZ = portion.z() * Wanok::portionSize;
+    int endX = qMin(beginX + Wanok::portionSize, m_length);
+    int endZ = qMin(beginZ + Wanok::portionSize, m_width);
+
+    for (int x = beginX; x < endX; x++) {
+        for (int z = beginZ; z < endZ; z++) {
+            Position position(x, 0, 0, z, 0);
+
+            // Floors and sprites of one square, so that nothing overflows
+            if (isGenerated(m_floorsDensity)) {
+                QRect rect(m_random() % 4, 0, 1, 1);
+                mapPortion.addLand(position, new FloorDatas(rect), previous,
+                                   previousType);
+            }
+            if (isGenerated(m_spritesDensity)) {
+                QRect rect(m_random() % 4, 1, 1, 1);
+                MapEditorSubSelectionKind kind = m_random() % 2 == 0
+                        ? MapEditorSubSelectionKind::SpritesFace
+                        : MapEditorSubSelectionKind::SpritesFix;
+                mapPortion.addSprite(portionsOverflow, position,
+                                     new SpriteDatas(kind, rect, true),
+                                     previous, previousType);
+            }
+            if (isGenerated(m_wallsDensity)) {
+                Position positionWall(x, 0, 0, z, 0, 50, 0, 0);
+                mapPortion.addSpriteWall(positionWall, new SpriteWallDatas(1),
+                                         previous, previousType);
+            }
+            if (isGenerated(m_objectsDensity)) {
+                QJsonObject json;
+                SystemCommonObject* object = generateObject(idObject);
+                SystemMapObject super(idObject, object->name(), position);
+                super.write(json);
+                objects.append(json);
+                mapPortion.addObject(position, object, previous,
+                                     previousType);
+                idObject++;
+            }
+        }
+    }
+    mapPortion.updateSpriteWalls();
+}
+
+// -------------------------------------------------------
+
+SystemCommonObject* ProjectGenerator::generateObject(int id) {
+    SystemCommonObject* object = new SystemCommonObject(
+                id, Map::generateObjectName(id), 1, new QStandardItemModel,
+                new QStandardItemModel);
+    QStandardItemModel* modelEventsUser = Wanok::get()->project()
+            ->gameDatas()->commonEventsDatas()->modelEventsUser();
+    QString name = ((SystemObjectEvent*) modelEventsUser->item(0)->data()
+                    .value<quintptr>())->name();
+    QVector<QString> command({"0"});
+
+    for (int i = 0; i < m_eventsPerObject; i++) {
+        SystemObjectEvent* event = new SystemObjectEvent(
+                    1, name, new QStandardItemModel, false);
+        event->setDefault();
+        QStandardItem* root = event->reactionAt(1)->modelCommands()
+                ->invisibleRootItem();
+        for (int j = 0; j < m_commandsPerEvent; j++) {
+            SystemReaction::addCommandWithoutText(
+                        root, new EventCommand(EventCommandKind::Wait,
+                                               command));
+        }
+        object->modelEvents()->appendRow(event->getModelRow());
+    }
+    QStandardItem* item = new QStandardItem;
+    item->setText(SuperListItem::beginningText);
+    object->modelEvents()->appendRow(item);
+
+    return object;
+}
+
+// -------------------------------------------------------
+
+bool ProjectGenerator::isGenerated(int density) {
+    return (int) (m_random() % 100) < density;
+}
+
+// -------------------------------------------------------
+//
+//  READ / WRITE
+//
+// -------------------------------------------------------
+
+void ProjectGenerator::read(const QJsonObject &json) {
+    setDefault();
+    if (json.contains("maps"))
+        m_mapsCount = json["maps"].toInt();
+    if (json.contains("l"))
+        m_length = json["l"].toInt();
+    if (json.contains("w"))
+        m_width = json["w"].toInt();
+    if (json.contains("h"))
+        m_height = json["h"].toInt();
+    if (json.contains("floors"))
+        m_floorsDensity = json["floors"].toInt();
+    if (json.contains("sprites"))
+        m_spritesDensity = json["sprites"].toInt();
+    if (json.contains("walls"))
+        m_wallsDensity = json["walls"].toInt();
+    if (json.contains("objects"))
+        m_objectsDensity = json["objects"].toInt();
+    if (json.contains("events"))
+        m_eventsPerObject = json["events"].toInt();
+    if (json.contains("commands"))
+        m_commandsPerEvent = json["commands"].toInt();
+    if (json.contains("databases"))
+        m_databasesSize = json["databases"].toInt();
+    if (json.contains("seed"))
+        m_seed = json["seed"].toInt();
+}
+
+// -------------------------------------------------------
+
+void ProjectGenerator::write(QJsonObject &json) const {
+    json["maps"] = m_mapsCount;
+    json["l"] = m_length;
+    json["w"] = m_width;
+    json["h"] = m_height;
+    json["floors"] = m_floorsDensity;
+    json["sprites"] = m_spritesDensity;
+    json["walls"] = m_wallsDensity;
+    json["objects"] = m_objectsDensity;
+    json["events"] = m_eventsPerObject;
+    json["commands"] = m_commandsPerEvent;
+    json["databases"] = m_databasesSize;
+    json["seed"] = (int) m_seed;
+}
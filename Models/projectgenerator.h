@@ -0,0 +1,80 @@
+/*
+    RPG Paper Maker Copyright (C) 2017 Marie Laporte
+
+    This file is part of RPG Paper Maker.
+
+    RPG Paper Maker is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    RPG Paper Maker is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with Foobar.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#ifndef PROJECTGENERATOR_H
+#define PROJECTGENERATOR_H
+
+#include <QStandardItemModel>
+#include <random>
+#include "project.h"
+#include "mapportion.h"
+
+// -------------------------------------------------------
+//
+//  CLASS ProjectGenerator
+//
+//  Generates a new project filled with synthetic maps and databases, used
+//  for benchmarking the engine on projects of a known size. The settings
+//  are read from and written to a JSON file so that the same project can
+//  be generated again with another version.
+//
+// -------------------------------------------------------
+
+class ProjectGenerator : public Serializable
+{
+public:
+    ProjectGenerator();
+    virtual ~ProjectGenerator();
+    static const QString PATH_SETTINGS;
+    int mapsCount() const;
+
+    void setDefault();
+    QString generate(QString dirName, QString location);
+    void generateDatabases(Project* project);
+    void generateMap(QString path);
+    void generatePortion(MapPortion& mapPortion, Portion& portion,
+                         QJsonArray& objects, int& idObject);
+    SystemCommonObject* generateObject(int id);
+
+    virtual void read(const QJsonObject &json);
+    virtual void write(QJsonObject &json) const;
+
+protected:
+    int m_mapsCount;
+    int m_length;
+    int m_width;
+    int m_height;
+
+    // Densities in percent of the squares of a map
+    int m_floorsDensity;
+    int m_spritesDensity;
+    int m_wallsDensity;
+    int m_objectsDensity;
+
+    int m_eventsPerObject;
+    int m_commandsPerEvent;
+    int m_databasesSize;
+    unsigned int m_seed;
+    std::mt19937 m_random;
+
+    bool isGenerated(int density);
+    template <class T> void generateDatabase(QStandardItemModel* model);
+};
+
+#endif // PROJECTGENERATOR_H
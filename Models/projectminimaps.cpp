@@ -0,0 +1,368 @@
+/*
+    RPG Paper Maker Copyright (C) 2017 Marie Laporte
+
+    This file is part of RPG Paper Maker.
+
+    RPG Paper Maker is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    RPG Paper Maker is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with Foobar.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include <QtConcurrent>
+#include <QDir>
+#include <QFileInfo>
+#include <QSaveFile>
+#include <QPainter>
+#include <functional>
+#include "projectminimaps.h"
+#include "mapproperties.h"
+#include "lands.h"
+#include "sprites.h"
+#include "wanok.h"
+
+// -------------------------------------------------------
+//
+//  CONSTRUCTOR / DESTRUCTOR / GET / SET
+//
+// -------------------------------------------------------
+
+ProjectMinimaps::ProjectMinimaps()
+{
+
+}
+
+ProjectMinimaps::~ProjectMinimaps()
+{
+    QHash<QFutureWatcher<QImage>*, int>::iterator i;
+    for (i = m_watchers.begin(); i != m_watchers.end(); i++) {
+        i.key()->waitForFinished();
+        delete i.key();
+    }
+}
+
+// -------------------------------------------------------
+//
+//  INTERMEDIARY FUNCTIONS
+//
+// -------------------------------------------------------
+
+void ProjectMinimaps::load(const QString& pathProject) {
+    QHash<QFutureWatcher<QImage>*, int>::iterator i;
+    for (i = m_watchers.begin(); i != m_watchers.end(); i++) {
+        i.key()->disconnect(this);
+        i.key()->waitForFinished();
+        i.key()->deleteLater();
+    }
+    m_watchers.clear();
+    m_running.clear();
+    m_pending.clear();
+    m_images.clear();
+    m_pathProject = pathProject;
+}
+
+// -------------------------------------------------------
+
+QString ProjectMinimaps::getPathImage(int idMap) const {
+    return Wanok::pathCombine(Wanok::pathCombine(m_pathProject,
+                                                 Wanok::PATH_MINIMAPS),
+                              Wanok::generateMapName(idMap) + ".png");
+}
+
+// -------------------------------------------------------
+//  image: the last generated minimap (can be null or not up to date, call
+//  refresh to be notified when it is)
+
+QImage ProjectMinimaps::image(int idMap) {
+    QHash<int, QImage>::iterator i = m_images.find(idMap);
+    if (i != m_images.end())
+        return i.value();
+
+    QImage image(getPathImage(idMap));
+    m_images.insert(idMap, image);
+
+    return image;
+}
+
+// -------------------------------------------------------
+//  refresh: generate the minimap in background, updated() is emitted when
+//  it is done. If already generating, it will be generated again after
+
+void ProjectMinimaps::refresh(int idMap) {
+    if (m_running.contains(idMap)) {
+        m_pending.insert(idMap);
+        return;
+    }
+
+    QString pathMap = Wanok::pathCombine(
+                Wanok::pathCombine(m_pathProject, Wanok::pathMaps),
+                Wanok::generateMapName(idMap));
+    if (!QFile::exists(Wanok::pathCombine(pathMap, Wanok::fileMapInfos)))
+        return;
+
+    // Everything depending on the project is read here, in the main thread
+    MapProperties properties(pathMap);
+    SystemTileset* tileset = properties.tileset();
+    QString pathTileset = tileset == nullptr ? "" : tileset->picture()
+                                                    ->getPath(
+                                                        PictureKind::Tilesets);
+    QString pathImage = getPathImage(idMap);
+    int squareSize = Wanok::get()->getSquareSize();
+    int length = properties.length();
+    int width = properties.width();
+    bool isTemp = Wanok::mapsToSave.contains(idMap);
+
+    QFutureWatcher<QImage>* watcher = new QFutureWatcher<QImage>;
+    m_watchers.insert(watcher, idMap);
+    m_running.insert(idMap);
+    connect(watcher, SIGNAL(finished()), this, SLOT(on_generateFinished()));
+    watcher->setFuture(QtConcurrent::run(std::function<QImage()>([=]() {
+        return generate(pathMap, pathImage, pathTileset, squareSize, length,
+                        width, isTemp);
+    })));
+}
+
+// -------------------------------------------------------
+//  generate: only the columns of portions (same x and z) where a portion was
+//  modified, added or removed since the cached minimap are drawn again
+
+QImage ProjectMinimaps::generate(const QString& pathMap,
+                                 const QString& pathImage,
+                                 const QString& pathTileset, int squareSize,
+                                 int length, int width, bool isTemp)
+{
+    if (length <= 0 || width <= 0)
+        return QImage();
+
+    QString pathStamps = pathImage.left(pathImage.size() - 4) + ".json";
+    QString config = pathTileset + ":" + QString::number(squareSize);
+    QJsonObject stamps = Wanok::parseJSON(pathStamps).object();
+    QJsonObject previousPortions;
+    QImage image(pathImage);
+    if (!image.isNull() && image.width() == length &&
+        image.height() == width && stamps["config"].toString() == config)
+    {
+        previousPortions = stamps["portions"].toObject();
+        image = image.convertToFormat(QImage::Format_ARGB32);
+    }
+    else {
+        image = QImage(length, width, QImage::Format_ARGB32);
+        image.fill(Qt::transparent);
+    }
+
+    // Modified columns
+    QHash<QString, QString> files;
+    getPortionsFiles(pathMap, isTemp, files);
+    QSet<QPair<int, int>> columns;
+    QPair<int, int> column;
+    QJsonObject portions;
+    QHash<QString, QString>::const_iterator i;
+    for (i = files.begin(); i != files.end(); i++) {
+        QString stamp = QString::number(QFileInfo(i.value()).lastModified()
+                                        .toMSecsSinceEpoch());
+        if (i.value() != Wanok::pathCombine(pathMap, i.key()))
+            stamp += "t";
+        portions[i.key()] = stamp;
+        if (previousPortions.value(i.key()).toString() != stamp &&
+            getPortionColumn(i.key(), column))
+        {
+            columns.insert(column);
+        }
+    }
+    QJsonObject::const_iterator j;
+    for (j = previousPortions.begin(); j != previousPortions.end(); j++) {
+        if (!files.contains(j.key()) && getPortionColumn(j.key(), column))
+            columns.insert(column);
+    }
+    if (columns.isEmpty() && !previousPortions.isEmpty())
+        return image;
+
+    // Draw
+    QHash<QPair<int, int>, QStringList> pathsByColumn;
+    for (i = files.begin(); i != files.end(); i++) {
+        if (getPortionColumn(i.key(), column) && columns.contains(column))
+            pathsByColumn[column] << i.value();
+    }
+    QImage tileset = QImage(pathTileset).convertToFormat(
+                QImage::Format_ARGB32);
+    QHash<QPair<int, int>, QRgb> colors;
+    QSet<QPair<int, int>>::const_iterator k;
+    for (k = columns.begin(); k != columns.end(); k++) {
+        drawColumn(image, *k, pathsByColumn.value(*k), tileset, squareSize,
+                   colors);
+    }
+
+    // Cache
+    QDir().mkpath(QFileInfo(pathImage).path());
+    QSaveFile file(pathImage);
+    if (file.open(QIODevice::WriteOnly) && image.save(&file, "PNG"))
+        file.commit();
+    stamps = QJsonObject();
+    stamps["config"] = config;
+    stamps["portions"] = portions;
+    Wanok::writeOtherJSON(pathStamps, stamps);
+
+    return image;
+}
+
+// -------------------------------------------------------
+//  getPortionsFiles: file name -> path of the current version of each
+//  portion (the temp one if the map is not saved)
+
+void ProjectMinimaps::getPortionsFiles(const QString& pathMap, bool isTemp,
+                                       QHash<QString, QString>& files)
+{
+    QStringList filters;
+    filters << "*.json";
+    QStringList names = QDir(pathMap).entryList(filters, QDir::Files);
+    for (int i = 0; i < names.size(); i++)
+        files.insert(names.at(i), Wanok::pathCombine(pathMap, names.at(i)));
+    if (isTemp) {
+        QString pathTemp = Wanok::pathCombine(pathMap,
+                                              Wanok::TEMP_MAP_FOLDER_NAME);
+        names = QDir(pathTemp).entryList(filters, QDir::Files);
+        for (int i = 0; i < names.size(); i++) {
+            files.insert(names.at(i), Wanok::pathCombine(pathTemp,
+                                                         names.at(i)));
+        }
+    }
+    files.remove(Wanok::fileMapInfos);
+    files.remove(Wanok::fileMapObjects);
+}
+
+// -------------------------------------------------------
+
+bool ProjectMinimaps::getPortionColumn(const QString& fileName,
+                                       QPair<int, int>& column)
+{
+    QStringList values = QFileInfo(fileName).completeBaseName().split("_");
+    if (values.size() != 3)
+        return false;
+
+    bool okX, okZ;
+    column.first = values.at(0).toInt(&okX);
+    column.second = values.at(2).toInt(&okZ);
+
+    return okX && okZ;
+}
+
+// -------------------------------------------------------
+//  drawColumn: for each square, the color of the highest floor or sprite
+
+void ProjectMinimaps::drawColumn(QImage& image, const QPair<int, int>& column,
+                                 const QStringList& paths,
+                                 const QImage& tileset, int squareSize,
+                                 QHash<QPair<int, int>, QRgb>& colors)
+{
+    QRect rect(column.first * Wanok::portionSize,
+               column.second * Wanok::portionSize, Wanok::portionSize,
+               Wanok::portionSize);
+    QPainter painter(&image);
+    painter.setCompositionMode(QPainter::CompositionMode_Source);
+    painter.fillRect(rect, Qt::transparent);
+    painter.end();
+
+    QHash<QPair<int, int>, QPair<int, QRgb>> squares;
+    for (int i = 0; i < paths.size(); i++) {
+        QJsonObject json = Wanok::parseJSON(paths.at(i)).object();
+        if (!json.contains("lands"))
+            continue;
+
+        QList<QPair<Position, QRect>> textures;
+        Lands lands;
+        lands.read(json["lands"].toObject());
+        lands.getTexturesRects(textures);
+        int countFloors = textures.size();
+        Sprites sprites;
+        sprites.read(json["sprites"].toObject());
+        sprites.getTexturesRects(textures);
+
+        for (int j = 0; j < textures.size(); j++) {
+            const Position& position = textures.at(j).first;
+            const QRect& texture = textures.at(j).second;
+            QPair<int, int> key(texture.x(), texture.y());
+            QHash<QPair<int, int>, QRgb>::iterator itColor = colors.find(key);
+            if (itColor == colors.end()) {
+                itColor = colors.insert(key, averageColor(tileset, texture,
+                                                          squareSize));
+            }
+            if (qAlpha(itColor.value()) == 0)
+                continue;
+
+            // Sprites are above the floors at the same height
+            int height = (position.getY(squareSize) * 100 + position.layer())
+                    * 2 + (j >= countFloors ? 1 : 0);
+            QPair<int, int> square(position.x(), position.z());
+            QHash<QPair<int, int>, QPair<int, QRgb>>::iterator itSquare =
+                    squares.find(square);
+            if (itSquare == squares.end() || itSquare.value().first <= height)
+                squares[square] = QPair<int, QRgb>(height, itColor.value());
+        }
+    }
+
+    QHash<QPair<int, int>, QPair<int, QRgb>>::const_iterator i;
+    for (i = squares.begin(); i != squares.end(); i++) {
+        if (rect.contains(i.key().first, i.key().second) &&
+            image.rect().contains(i.key().first, i.key().second))
+        {
+            image.setPixel(i.key().first, i.key().second, i.value().second);
+        }
+    }
+}
+
+// -------------------------------------------------------
+//  averageColor: of the first square of the texture, transparent pixels
+//  excluded
+
+QRgb ProjectMinimaps::averageColor(const QImage& tileset, const QRect& rect,
+                                   int squareSize)
+{
+    QRect square = QRect(rect.x() * squareSize, rect.y() * squareSize,
+                         squareSize, squareSize).intersected(tileset.rect());
+    qint64 r = 0, g = 0, b = 0, a = 0;
+    for (int y = square.top(); y <= square.bottom(); y++) {
+        const QRgb* line = reinterpret_cast<const QRgb*>(
+                    tileset.constScanLine(y));
+        for (int x = square.left(); x <= square.right(); x++) {
+            int alpha = qAlpha(line[x]);
+            r += qRed(line[x]) * alpha;
+            g += qGreen(line[x]) * alpha;
+            b += qBlue(line[x]) * alpha;
+            a += alpha;
+        }
+    }
+    if (a == 0)
+        return qRgba(0, 0, 0, 0);
+
+    return qRgb(r / a, g / a, b / a);
+}
+
+// -------------------------------------------------------
+//
+//  SLOTS
+//
+// -------------------------------------------------------
+
+void ProjectMinimaps::on_generateFinished() {
+    QFutureWatcher<QImage>* watcher =
+            static_cast<QFutureWatcher<QImage>*>(sender());
+    int idMap = m_watchers.take(watcher);
+    QImage image = watcher->result();
+    watcher->deleteLater();
+    m_running.remove(idMap);
+
+    if (!image.isNull()) {
+        m_images.insert(idMap, image);
+        emit updated(idMap);
+    }
+    if (m_pending.remove(idMap))
+        refresh(idMap);
+}
@@ -0,0 +1,80 @@
+/*
+    RPG Paper Maker Copyright (C) 2017 Marie Laporte
+
+    This file is part of RPG Paper Maker.
+
+    RPG Paper Maker is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    RPG Paper Maker is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with Foobar.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#ifndef PROJECTMINIMAPS_H
+#define PROJECTMINIMAPS_H
+
+#include <QObject>
+#include <QHash>
+#include <QSet>
+#include <QImage>
+#include <QFutureWatcher>
+
+// -------------------------------------------------------
+//
+//  CLASS ProjectMinimaps
+//
+//  The top-down minimaps of the maps (one pixel per square, colored with
+//  the average color of the floors and sprites textures). They are drawn
+//  on the CPU in the background and cached in the project. Only the
+//  portions modified since the last time (saved or temp) are drawn again.
+//
+// -------------------------------------------------------
+
+class ProjectMinimaps : public QObject
+{
+    Q_OBJECT
+
+public:
+    ProjectMinimaps();
+    virtual ~ProjectMinimaps();
+    void load(const QString& pathProject);
+    QString getPathImage(int idMap) const;
+    QImage image(int idMap);
+    void refresh(int idMap);
+    static QImage generate(const QString& pathMap, const QString& pathImage,
+                           const QString& pathTileset, int squareSize,
+                           int length, int width, bool isTemp);
+
+protected:
+    QString m_pathProject;
+    QHash<int, QImage> m_images;
+    QHash<QFutureWatcher<QImage>*, int> m_watchers;
+    QSet<int> m_running;
+    QSet<int> m_pending;
+
+    static void getPortionsFiles(const QString& pathMap, bool isTemp,
+                                 QHash<QString, QString>& files);
+    static bool getPortionColumn(const QString& fileName,
+                                 QPair<int, int>& column);
+    static void drawColumn(QImage& image, const QPair<int, int>& column,
+                           const QStringList& paths, const QImage& tileset,
+                           int squareSize,
+                           QHash<QPair<int, int>, QRgb>& colors);
+    static QRgb averageColor(const QImage& tileset, const QRect& rect,
+                             int squareSize);
+
+signals:
+    void updated(int idMap);
+
+protected slots:
+    void on_generateFinished();
+};
+
+#endif // PROJECTMINIMAPS_H
@@ -20,12 +20,16 @@
 #include "projectupdater.h"
 #include "wanok.h"
 #include <QDirIterator>
+#include <QSaveFile>
+#include <QtConcurrent>
 
 const int ProjectUpdater::incompatibleVersionsCount = 2;
 
 QString ProjectUpdater::incompatibleVersions[incompatibleVersionsCount]
     {"0.3.1", "0.4.0"};
 
+const QString ProjectUpdater::fileResume = "updater.log";
+
 // -------------------------------------------------------
 //
 //  CONSTRUCTOR / DESTRUCTOR / GET / SET
@@ -34,15 +38,16 @@ QString ProjectUpdater::incompatibleVersions[incompatibleVersionsCount]
 
 ProjectUpdater::ProjectUpdater(Project* project, QString previous) :
     m_project(project),
-    m_previousFolderName(previous)
+    m_previousFolderName(previous),
+    m_progressMin(0),
+    m_progressMax(100)
 {
 
 }
 
 ProjectUpdater::~ProjectUpdater()
 {
-    clearListMapPaths();
-    clearListMapPortions();
+
 }
 
 // -------------------------------------------------------
@@ -109,22 +114,6 @@ int ProjectUpdater::versionDifferent(QString projectVersion,
 
 // -------------------------------------------------------
 
-void ProjectUpdater::clearListMapPaths() {
-    for (int i = 0; i < m_listMapPortionsPaths.size(); i++)
-        delete m_listMapPortionsPaths.at(i);
-    m_listMapPortionsPaths.clear();
-}
-
-// -------------------------------------------------------
-
-void ProjectUpdater::clearListMapPortions() {
-    for (int i = 0; i < m_listMapPortions.size(); i++)
-        delete m_listMapPortions.at(i);
-    m_listMapPortions.clear();
-}
-
-// -------------------------------------------------------
-
 void ProjectUpdater::copyPreviousProject() {
     QDir dirProject(m_project->pathCurrentProject());
     dirProject.cdUp();
@@ -144,12 +133,10 @@ void ProjectUpdater::getAllPathsMapsPortions()
 
     // Clear
     m_listMapPaths.clear();
-    m_listMapProperties.clear();
     m_listMapPropertiesPaths.clear();
-    clearListMapPaths();
-    clearListMapPortions();
+    m_listMapPortionsPaths.clear();
 
-    // Fill
+    // Fill (only the paths, the portions are read one by one when updating)
     while (directories.hasNext()) {
         directories.next();
         QString mapName = directories.fileName();
@@ -157,29 +144,14 @@ void ProjectUpdater::getAllPathsMapsPortions()
             QString dirMap = Wanok::pathCombine(pathMaps, mapName);
             m_listMapPaths.append(dirMap);
             QDirIterator files(dirMap, QDir::Files);
-            QList<QJsonObject>* mapPortions = new QList<QJsonObject>;
-            QList<QString>* paths = new QList<QString>;
-            m_listMapPortions.append(mapPortions);
-            m_listMapPortionsPaths.append(paths);
 
             while (files.hasNext()) {
                 files.next();
                 QString fileName = files.fileName();
-                QString path = files.filePath();
-                QJsonDocument document;
-                if (fileName == "infos.json") {
-                    Wanok::readOtherJSON(path, document);
-                    m_listMapProperties.append(document.object());
-                    m_listMapPropertiesPaths.append(path);
-                }
-                else if (fileName != "objects.json") {
-                    Wanok::readOtherJSON(path, document);
-                    QJsonObject object = document.object();
-                    if (!object.isEmpty()) {
-                        paths->append(path);
-                        mapPortions->append(object);
-                    }
-                }
+                if (fileName == Wanok::fileMapInfos)
+                    m_listMapPropertiesPaths.append(files.filePath());
+                else if (fileName != Wanok::fileMapObjects)
+                    m_listMapPortionsPaths.append(files.filePath());
             }
         }
     }
@@ -188,6 +160,7 @@ void ProjectUpdater::getAllPathsMapsPortions()
 // -------------------------------------------------------
 
 void ProjectUpdater::updateVersion(QString& version) {
+    m_currentVersion = version;
     getAllPathsMapsPortions();
 
     QString str = "updateVersion_" + version.replace(".", "_");
@@ -196,6 +169,96 @@ void ProjectUpdater::updateVersion(QString& version) {
     QMetaObject::invokeMethod(this, c_str, Qt::DirectConnection);
 }
 
+// -------------------------------------------------------
+// Each portion is read, updated and written by the global thread pool so that
+// only a few portions are kept in memory at the same time
+
+void ProjectUpdater::updatePortions(void (*update)(QJsonObject&)) {
+    QFuture<void> future = QtConcurrent::map(
+                m_listMapPortionsPaths, [this, update](const QString& path) {
+        updateFile(path, update);
+    });
+
+    while (!future.isFinished()) {
+        int maximum = future.progressMaximum();
+        if (maximum > 0) {
+            emit progress(m_progressMin + ((m_progressMax - m_progressMin) *
+                                           future.progressValue()) / maximum,
+                          "Updating maps portions for version " +
+                          m_currentVersion + " (" +
+                          QString::number(future.progressValue()) + "/" +
+                          QString::number(maximum) + ")...");
+        }
+        QThread::msleep(50);
+    }
+}
+
+// -------------------------------------------------------
+// The update functions have to be idempotent: if interrupted between the
+// commit and addResume, the file is updated a second time when resuming
+
+void ProjectUpdater::updateFile(const QString& path,
+                                void (*update)(QJsonObject&))
+{
+    QString key = m_currentVersion + ":" +
+            QDir(m_project->pathCurrentProject()).relativeFilePath(path);
+
+    // Already updated before an interruption
+    if (m_resumeDone.contains(key))
+        return;
+
+    QJsonDocument document;
+    Wanok::readOtherJSON(path, document);
+    QJsonObject obj = document.object();
+    if (!obj.isEmpty()) {
+        update(obj);
+
+        // Never leave a half written portion if interrupted
+        QSaveFile saveFile(path);
+        if (!saveFile.open(QIODevice::WriteOnly))
+            return;
+        saveFile.write(QJsonDocument(obj).toJson(QJsonDocument::Compact));
+        if (!saveFile.commit())
+            return;
+    }
+    addResume(key);
+}
+
+// -------------------------------------------------------
+
+void ProjectUpdater::readResume() {
+    QFile file(Wanok::pathCombine(m_project->pathCurrentProject(),
+                                  fileResume));
+    m_resumeDone.clear();
+    if (!file.open(QIODevice::ReadOnly | QIODevice::Text))
+        return;
+
+    QTextStream in(&file);
+    while (!in.atEnd())
+        m_resumeDone.insert(in.readLine());
+}
+
+// -------------------------------------------------------
+
+void ProjectUpdater::addResume(QString line) {
+    QMutexLocker locker(&m_mutexResume);
+    QFile file(Wanok::pathCombine(m_project->pathCurrentProject(),
+                                  fileResume));
+    if (!file.open(QIODevice::WriteOnly | QIODevice::Append |
+                   QIODevice::Text))
+        return;
+
+    QTextStream out(&file);
+    out << line << "\n";
+}
+
+// -------------------------------------------------------
+
+void ProjectUpdater::removeResume() {
+    QFile(Wanok::pathCombine(m_project->pathCurrentProject(), fileResume))
+            .remove();
+}
+
 // -------------------------------------------------------
 
 void ProjectUpdater::copyExecutable() {
@@ -232,9 +295,15 @@ void ProjectUpdater::copySystemScripts() {
 // -------------------------------------------------------
 
 void ProjectUpdater::check() {
-    emit progress(10, "Copying the previous project...");
-    copyPreviousProject();
-    emit progress(80, "Checking incompatible versions...");
+    readResume();
+
+    // If resuming an interrupted update, the copy was already done
+    if (!m_resumeDone.contains("copy")) {
+        emit progress(10, "Copying the previous project...");
+        copyPreviousProject();
+        addResume("copy");
+    }
+    emit progress(15, "Checking incompatible versions...");
 
     // Updating for incompatible versions
     int index = incompatibleVersionsCount;
@@ -249,16 +318,24 @@ void ProjectUpdater::check() {
     }
 
     // Updating for each version
+    int count = incompatibleVersionsCount - index;
     for (int i = index; i < incompatibleVersionsCount; i++) {
-        emit progress(80, "Checking version " + incompatibleVersions[i] +
-                      "...");
-        updateVersion(incompatibleVersions[i]);
+        m_progressMin = 20 + (70 * (i - index)) / count;
+        m_progressMax = 20 + (70 * (i - index + 1)) / count;
+        if (m_resumeDone.contains(incompatibleVersions[i]))
+            continue;
+        emit progress(m_progressMin, "Checking version " +
+                      incompatibleVersions[i] + "...");
+        QString version = incompatibleVersions[i];
+        updateVersion(version);
+        addResume(incompatibleVersions[i]);
     }
 
     // Copy recent executable and scripts
     emit progress(95, "Copying recent executable and scripts");
     copyExecutable();
     copySystemScripts();
+    removeResume();
     emit progress(100, "");
     QThread::sleep(1);
 
@@ -267,88 +344,96 @@ void ProjectUpdater::check() {
 
 // -------------------------------------------------------
 
-void ProjectUpdater::updateVersion_0_3_1() {
+void ProjectUpdater::updatePortion_0_3_1(QJsonObject& obj) {
+    QJsonObject objSprites = obj["sprites"].toObject();
+    QJsonArray tabSprites = objSprites["list"].toArray();
 
-    for (int i = 0; i < m_listMapPortions.size(); i++) {
-        QList<QJsonObject>* mapPortions = m_listMapPortions.at(i);
-        QList<QString>* paths = m_listMapPortionsPaths.at(i);
+    for (int k = 0; k < tabSprites.size(); k++) {
+        QJsonObject objSprite = tabSprites.at(k).toObject();
 
-        for (int j = 0; j < mapPortions->size(); j++) {
-            QJsonObject obj = mapPortions->at(j);
-            QJsonObject objSprites = obj["sprites"].toObject();
-            QJsonArray tabSprites = objSprites["list"].toArray();
+        // Replace Position3D by Position
+        QJsonArray tabKey = objSprite["k"].toArray();
+        if (tabKey.size() == 4) {
+            tabKey.append(0);
+            objSprite["k"] = tabKey;
+        }
 
-            for (int k = 0; k < tabSprites.size(); k++) {
-                QJsonObject objSprite = tabSprites.at(k).toObject();
+        // Remove key layer from sprites objects
+        if (objSprite["v"].isArray()) {
+            QJsonObject objVal = objSprite["v"].toArray()[0].toObject();
+            objVal.remove("l");
+            objSprite["v"] = objVal;
+        }
 
-                // Replace Position3D by Position
-                QJsonArray tabKey = objSprite["k"].toArray();
-                tabKey.append(0);
-                objSprite["k"] = tabKey;
+        tabSprites[k] = objSprite;
+    }
 
-                // Remove key layer from sprites objects
-                QJsonObject objVal = objSprite["v"].toArray()[0].toObject();
-                objVal.remove("l");
-                objSprite["v"] = objVal;
+    objSprites["list"] = tabSprites;
+    obj["sprites"] = objSprites;
+}
 
-                tabSprites[j] = objSprite;
-            }
+// -------------------------------------------------------
 
-            objSprites["list"] = tabSprites;
-            obj["sprites"] = objSprites;
-            Wanok::writeOtherJSON(paths->at(j), obj);
-        }
+void ProjectUpdater::updatePortion_0_4_0(QJsonObject& obj) {
+
+    // Add lands and floors inside and removing width and angle for
+    // each sprite
+    QJsonObject objSprites = obj["sprites"].toObject();
+    if (!objSprites.contains("walls"))
+        objSprites["walls"] = QJsonArray();
+    if (!objSprites.contains("overflow"))
+        objSprites["overflow"] = QJsonArray();
+    QJsonArray tabSprites = objSprites["list"].toArray();
+    for (int k = 0; k < tabSprites.size(); k++){
+        QJsonObject obj = tabSprites.at(k).toObject();
+        QJsonObject objSprite = obj["v"].toObject();
+        objSprite.remove("p");
+        objSprite.remove("a");
+        obj["v"] = objSprite;
+        tabSprites[k] = obj;
+    }
+    objSprites["list"] = tabSprites;
+    obj["sprites"] = objSprites;
+
+    // Add lands and floors inside
+    if (obj.contains("floors")) {
+        QJsonObject objFloors = obj["floors"].toObject();
+        QJsonObject objLands;
+        objLands["floors"] = objFloors;
+        obj["lands"] = objLands;
+        obj.remove("floors");
     }
 }
 
 // -------------------------------------------------------
 
+void ProjectUpdater::updateMapProperties_0_4_0(QJsonObject& obj) {
+
+    // Adding ofSprites field for overflow
+    if (!obj.contains("ofsprites"))
+        obj["ofsprites"] = QJsonArray();
+}
+
+// -------------------------------------------------------
+
+void ProjectUpdater::updateVersion_0_3_1() {
+    updatePortions(&ProjectUpdater::updatePortion_0_3_1);
+}
+
+// -------------------------------------------------------
+
 void ProjectUpdater::updateVersion_0_4_0() {
 
     // Create walls directory
     QDir(m_project->pathCurrentProject()).mkpath(Wanok::PATH_SPRITE_WALLS);
 
-    for (int i = 0; i < m_listMapPortions.size(); i++) {
-        QList<QJsonObject>* mapPortions = m_listMapPortions.at(i);
-        QList<QString>* paths = m_listMapPortionsPaths.at(i);
-        QJsonObject objMapProperties = m_listMapProperties.at(i);
-
-        // Adding ofSprites field for overflow
-        objMapProperties["ofsprites"] = QJsonArray();
-        QString pathMapProperties = m_listMapPropertiesPaths.at(i);
-        Wanok::writeOtherJSON(pathMapProperties, objMapProperties);
-
-        for (int j = 0; j < mapPortions->size(); j++) {
-            QJsonObject obj = mapPortions->at(j);
-
-            // Add lands and floors inside and removing width and angle for
-            // each sprite
-            QJsonObject objSprites = obj["sprites"].toObject();
-            objSprites["walls"] = QJsonArray();
-            objSprites["overflow"] = QJsonArray();
-            QJsonArray tabSprites = objSprites["list"].toArray();
-            for (int k = 0; k < tabSprites.size(); k++){
-                QJsonObject obj = tabSprites.at(k).toObject();
-                QJsonObject objSprite = obj["v"].toObject();
-                objSprite.remove("p");
-                objSprite.remove("a");
-                obj["v"] = objSprite;
-                tabSprites[k] = obj;
-            }
-            objSprites["list"] = tabSprites;
-            obj["sprites"] = objSprites;
-
-            // Add lands and floors inside
-            QJsonObject objFloors = obj["floors"].toObject();
-            QJsonObject objLands;
-            objLands["floors"] = objFloors;
-            obj["lands"] = objLands;
-            obj.remove("floors");
-
-            Wanok::writeOtherJSON(paths->at(j), obj);
-        }
+    for (int i = 0; i < m_listMapPropertiesPaths.size(); i++) {
+        updateFile(m_listMapPropertiesPaths.at(i),
+                   &ProjectUpdater::updateMapProperties_0_4_0);
     }
 
+    updatePortions(&ProjectUpdater::updatePortion_0_4_0);
+
     // Adding a default special elements datas to the project
     SpecialElementsDatas specialElementsDatas;
     specialElementsDatas.setDefault();
@@ -20,6 +20,8 @@
 #ifndef PROJECTUPDATER_H
 #define PROJECTUPDATER_H
 
+#include <QMutex>
+#include <QSet>
 #include "project.h"
 
 // -------------------------------------------------------
@@ -43,22 +45,32 @@ public:
     static bool getSubVersions(QString& version, int& m, int& f, int& b);
     static int versionDifferent(QString projectVersion, QString otherVersion
                                 = Project::ENGINE_VERSION);
-    void clearListMapPaths();
-    void clearListMapPortions();
+    static const QString fileResume;
+    static void updatePortion_0_3_1(QJsonObject& obj);
+    static void updatePortion_0_4_0(QJsonObject& obj);
+    static void updateMapProperties_0_4_0(QJsonObject& obj);
     void copyPreviousProject();
     void getAllPathsMapsPortions();
     void updateVersion(QString& version);
+    void updatePortions(void (*update)(QJsonObject&));
+    void updateFile(const QString& path, void (*update)(QJsonObject&));
+    void readResume();
+    void addResume(QString line);
+    void removeResume();
     void copyExecutable();
     void copySystemScripts();
 
 protected:
     Project* m_project;
     QString m_previousFolderName;
+    QString m_currentVersion;
+    int m_progressMin;
+    int m_progressMax;
     QList<QString> m_listMapPaths;
-    QList<QJsonObject> m_listMapProperties;
     QList<QString> m_listMapPropertiesPaths;
-    QList<QList<QJsonObject>*> m_listMapPortions;
-    QList<QList<QString>*> m_listMapPortionsPaths;
+    QList<QString> m_listMapPortionsPaths;
+    QSet<QString> m_resumeDone;
+    QMutex m_mutexResume;
 
 public slots:
     void check();
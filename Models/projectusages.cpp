@@ -0,0 +1,455 @@
+/*
+    RPG Paper Maker Copyright (C) 2017 Marie Laporte
+
+    This file is part of RPG Paper Maker.
+
+    RPG Paper Maker is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    RPG Paper Maker is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with Foobar.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include <QtConcurrent>
+#include <QDir>
+#include <QDirIterator>
+#include <QFile>
+#include <QFileInfo>
+#include <functional>
+#include "projectusages.h"
+#include "eventcommand.h"
+#include "mapeditorsubselectionkind.h"
+#include "wanok.h"
+
+// -------------------------------------------------------
+//
+//  CONSTRUCTOR / DESTRUCTOR / GET / SET
+//
+// -------------------------------------------------------
+
+ProjectUsages::ProjectUsages() :
+    m_isDirty(false),
+    m_isSaveQueued(false)
+{
+    connect(&m_watcher, SIGNAL(finished()), this, SLOT(on_indexingFinished()));
+}
+
+ProjectUsages::~ProjectUsages()
+{
+    cancel();
+    save();
+}
+
+QString ProjectUsages::key(UsageKind kind, int id) {
+    return QString::number(static_cast<int>(kind)) + ":" +
+            QString::number(id);
+}
+
+// -------------------------------------------------------
+//
+//  INTERMEDIARY FUNCTIONS
+//
+// -------------------------------------------------------
+
+void ProjectUsages::load(const QString& pathProject) {
+    m_pathProject = pathProject;
+    Wanok::readJSON(Wanok::pathCombine(m_pathProject, Wanok::PATH_USAGES),
+                    *this);
+    refresh();
+}
+
+// -------------------------------------------------------
+//  refresh: index again (in background) all the files modified since the
+//  last time, and remove the files that don't exist anymore
+
+void ProjectUsages::refresh() {
+    QString pathMaps = Wanok::pathCombine(m_pathProject, Wanok::pathMaps);
+    QStringList files;
+    files << Wanok::pathCommonEvents;
+
+    QDirIterator directories(pathMaps, QDir::Dirs | QDir::NoDotAndDotDot);
+    while (directories.hasNext())
+        files << getMapFiles(directories.next());
+
+    refreshFiles(files, "");
+}
+
+// -------------------------------------------------------
+
+void ProjectUsages::refreshMap(const QString& pathMap) {
+    refreshFiles(getMapFiles(pathMap), relativePath(pathMap) + "/");
+}
+
+// -------------------------------------------------------
+
+void ProjectUsages::refreshCommonEvents() {
+    refreshFiles(QStringList() << Wanok::pathCommonEvents,
+                 Wanok::pathCommonEvents);
+}
+
+// -------------------------------------------------------
+
+QStringList ProjectUsages::findUsages(UsageKind kind, int id) {
+    join();
+
+    QStringList locations;
+    QString k = key(kind, id);
+    QSet<QString> files = m_filesByKey.value(k);
+    for (QSet<QString>::const_iterator i = files.begin(); i != files.end();
+         i++)
+    {
+        if (!QFile::exists(Wanok::pathCombine(m_pathProject, *i)))
+            continue;
+        const FileUsages& usages = m_usagesByFile[*i];
+        for (int j = 0; j < usages.size(); j++) {
+            if (usages.at(j).first == k)
+                locations << usages.at(j).second;
+        }
+    }
+    locations.removeDuplicates();
+    locations.sort();
+
+    return locations;
+}
+
+// -------------------------------------------------------
+
+bool ProjectUsages::isUsed(UsageKind kind, int id) {
+    return !findUsages(kind, id).isEmpty();
+}
+
+// -------------------------------------------------------
+//  save: if indexing, the save is done when it is finished
+
+void ProjectUsages::save() {
+    if (!m_pendingFiles.isEmpty()) {
+        m_isSaveQueued = true;
+        return;
+    }
+    m_isSaveQueued = false;
+    if (m_isDirty && !m_pathProject.isEmpty()) {
+        Wanok::writeJSON(Wanok::pathCombine(m_pathProject, Wanok::PATH_USAGES),
+                         *this);
+        m_isDirty = false;
+    }
+}
+
+// -------------------------------------------------------
+//  join: wait for the background indexing and the queued refreshes, and
+//  merge their results
+
+void ProjectUsages::join() {
+    while (!m_pendingFiles.isEmpty()) {
+        m_watcher.waitForFinished();
+        merge();
+    }
+}
+
+// -------------------------------------------------------
+//  merge: merge the results of the finished indexing, and start the next
+//  queued refresh. The finished signal can come after join already merged
+//  them, or while the next indexing is running: nothing is done then
+
+void ProjectUsages::merge() {
+    if (m_pendingFiles.isEmpty() || !m_watcher.isFinished())
+        return;
+
+    QList<FileUsages> results = m_watcher.future().results();
+    for (int i = 0; i < m_pendingFiles.size(); i++) {
+        const QString& file = m_pendingFiles.at(i);
+        setFileUsages(file, results.at(i));
+        m_modified[file] = m_pendingModified.at(i);
+    }
+    m_pendingFiles.clear();
+    m_pendingModified.clear();
+    m_isDirty = true;
+
+    while (m_pendingFiles.isEmpty() && !m_queuedRefreshes.isEmpty()) {
+        QPair<QStringList, QString> refresh = m_queuedRefreshes.takeFirst();
+        startRefresh(refresh.first, refresh.second);
+    }
+    if (m_pendingFiles.isEmpty() && m_isSaveQueued)
+        save();
+}
+
+// -------------------------------------------------------
+//  cancel: stop the background indexing without waiting for it, the files
+//  not merged yet keep their previous modification time and are indexed
+//  again at the next refresh
+
+void ProjectUsages::cancel() {
+    m_queuedRefreshes.clear();
+    if (m_pendingFiles.isEmpty())
+        return;
+
+    m_watcher.cancel();
+    m_pendingFiles.clear();
+    m_pendingModified.clear();
+}
+
+// -------------------------------------------------------
+//  refreshFiles: if indexing, the refresh is queued (replacing a queued
+//  refresh of the same directory)
+
+void ProjectUsages::refreshFiles(const QStringList& files,
+                                 const QString& directory)
+{
+    if (m_pathProject.isEmpty())
+        return;
+    if (m_pendingFiles.isEmpty()) {
+        startRefresh(files, directory);
+        return;
+    }
+
+    for (int i = 0; i < m_queuedRefreshes.size(); i++) {
+        if (m_queuedRefreshes.at(i).second == directory) {
+            m_queuedRefreshes[i].first = files;
+            return;
+        }
+    }
+    m_queuedRefreshes.append(qMakePair(files, directory));
+}
+
+// -------------------------------------------------------
+
+void ProjectUsages::startRefresh(const QStringList& files,
+                                 const QString& directory)
+{
+    // Files removed from this directory
+    QSet<QString> existing = files.toSet();
+    QStringList indexed = m_modified.keys();
+    for (int i = 0; i < indexed.size(); i++) {
+        const QString& file = indexed.at(i);
+        if (file.startsWith(directory) && !existing.contains(file))
+            removeFile(file);
+    }
+
+    // Modified files
+    for (int i = 0; i < files.size(); i++) {
+        const QString& file = files.at(i);
+        QFileInfo info(Wanok::pathCombine(m_pathProject, file));
+        qint64 modified = info.exists() ? info.lastModified()
+                                          .toMSecsSinceEpoch() : -1;
+        if (m_modified.value(file, -2) != modified) {
+            m_pendingFiles << file;
+            m_pendingModified << modified;
+        }
+    }
+
+    if (!m_pendingFiles.isEmpty()) {
+        QString path = m_pathProject;
+        m_watcher.setFuture(QtConcurrent::mapped(
+                    m_pendingFiles, std::function<FileUsages(const QString&)>(
+                        [path](const QString& file)
+        {
+            return indexFile(path, file);
+        })));
+    }
+}
+
+// -------------------------------------------------------
+
+void ProjectUsages::setFileUsages(const QString& file,
+                                  const FileUsages& usages)
+{
+    removeFile(file);
+    m_usagesByFile.insert(file, usages);
+    for (int i = 0; i < usages.size(); i++)
+        m_filesByKey[usages.at(i).first].insert(file);
+}
+
+// -------------------------------------------------------
+
+void ProjectUsages::removeFile(const QString& file) {
+    const FileUsages usages = m_usagesByFile.take(file);
+    for (int i = 0; i < usages.size(); i++) {
+        QHash<QString, QSet<QString>>::iterator it =
+                m_filesByKey.find(usages.at(i).first);
+        if (it != m_filesByKey.end()) {
+            it.value().remove(file);
+            if (it.value().isEmpty())
+                m_filesByKey.erase(it);
+        }
+    }
+    if (m_modified.remove(file) > 0)
+        m_isDirty = true;
+}
+
+// -------------------------------------------------------
+
+QString ProjectUsages::relativePath(const QString& path) const {
+    return QDir(m_pathProject).relativeFilePath(path);
+}
+
+// -------------------------------------------------------
+
+QStringList ProjectUsages::getMapFiles(const QString& pathMap) const {
+    QStringList files;
+    QStringList portions = QDir(pathMap).entryList(
+                QStringList() << "*_*_*.json", QDir::Files);
+    for (int i = 0; i < portions.size(); i++)
+        files << relativePath(Wanok::pathCombine(pathMap, portions.at(i)));
+
+    return files;
+}
+
+// -------------------------------------------------------
+//  indexFile: called on the thread pool, only reads the json file
+
+ProjectUsages::FileUsages ProjectUsages::indexFile(const QString& pathProject,
+                                                   const QString& file)
+{
+    FileUsages usages;
+    QJsonObject json = Wanok::parseJSON(Wanok::pathCombine(pathProject, file))
+            .object();
+    QJsonArray tab;
+
+    // Common events
+    if (file == Wanok::pathCommonEvents) {
+        tab = json["commonReactors"].toArray();
+        for (int i = 0; i < tab.size(); i++) {
+            QJsonObject obj = tab.at(i).toObject();
+            indexJSON(obj, "Common reactor " + obj["name"].toString(),
+                      usages);
+        }
+        tab = json["commonObjects"].toArray();
+        for (int i = 0; i < tab.size(); i++) {
+            QJsonObject obj = tab.at(i).toObject();
+            indexJSON(obj, "Common object " + obj["name"].toString(), usages);
+        }
+
+        return usages;
+    }
+
+    // Map portion
+    QString map = QFileInfo(file).dir().dirName();
+    tab = json["sprites"].toObject()["walls"].toArray();
+    for (int i = 0; i < tab.size(); i++) {
+        int id = tab.at(i).toObject()["v"].toObject()["w"].toInt();
+        usages.append(qMakePair(key(UsageKind::SpriteWall, id), map));
+    }
+    tab = json["objs"].toObject()["list"].toArray();
+    for (int i = 0; i < tab.size(); i++) {
+        QJsonObject obj = tab.at(i).toObject()["v"].toObject();
+        indexJSON(obj, map + ": object " + obj["name"].toString(), usages);
+    }
+
+    return usages;
+}
+
+// -------------------------------------------------------
+//  indexJSON: go through an object, a reaction... and add the ids used by
+//  its commands and its states graphics
+
+void ProjectUsages::indexJSON(const QJsonValue& value, const QString& label,
+                              FileUsages& usages)
+{
+    if (value.isArray()) {
+        QJsonArray tab = value.toArray();
+        for (int i = 0; i < tab.size(); i++)
+            indexJSON(tab.at(i), label, usages);
+    }
+    else if (value.isObject()) {
+        QJsonObject obj = value.toObject();
+
+        // Command
+        if (obj.contains("kind") && obj.contains("command")) {
+            EventCommand command;
+            QVector<QPair<UsageKind, int>> ids;
+            command.read(obj);
+            command.getUsages(ids);
+            for (int i = 0; i < ids.size(); i++) {
+                usages.append(qMakePair(key(ids.at(i).first,
+                                            ids.at(i).second), label));
+            }
+            indexJSON(obj["children"], label, usages);
+            return;
+        }
+
+        // State graphics
+        if (obj.contains("gk") && obj.contains("gid")) {
+            MapEditorSubSelectionKind kind =
+                    static_cast<MapEditorSubSelectionKind>(obj["gk"].toInt());
+            if (kind == MapEditorSubSelectionKind::SpritesFix ||
+                kind == MapEditorSubSelectionKind::SpritesFace)
+            {
+                usages.append(qMakePair(key(UsageKind::Character,
+                                            obj["gid"].toInt()), label));
+            }
+        }
+
+        for (QJsonObject::const_iterator i = obj.begin(); i != obj.end(); i++)
+            indexJSON(i.value(), label, usages);
+    }
+}
+
+// -------------------------------------------------------
+//
+//  SLOTS
+//
+// -------------------------------------------------------
+
+void ProjectUsages::on_indexingFinished() {
+    merge();
+}
+
+// -------------------------------------------------------
+//
+//  READ / WRITE
+//
+// -------------------------------------------------------
+
+void ProjectUsages::read(const QJsonObject &json) {
+    QJsonArray tab = json["files"].toArray();
+
+    m_modified.clear();
+    m_usagesByFile.clear();
+    m_filesByKey.clear();
+    for (int i = 0; i < tab.size(); i++) {
+        QJsonObject obj = tab.at(i).toObject();
+        QString file = obj["f"].toString();
+        QJsonArray tabUsages = obj["u"].toArray();
+        FileUsages usages;
+        usages.reserve(tabUsages.size());
+        for (int j = 0; j < tabUsages.size(); j++) {
+            QJsonArray tabUsage = tabUsages.at(j).toArray();
+            usages.append(qMakePair(tabUsage.at(0).toString(),
+                                    tabUsage.at(1).toString()));
+        }
+        setFileUsages(file, usages);
+        m_modified[file] = static_cast<qint64>(obj["m"].toDouble());
+    }
+    m_isDirty = false;
+}
+
+// -------------------------------------------------------
+
+void ProjectUsages::write(QJsonObject &json) const {
+    QJsonArray tab;
+
+    for (QHash<QString, FileUsages>::const_iterator i =
+         m_usagesByFile.begin(); i != m_usagesByFile.end(); i++)
+    {
+        QJsonObject obj;
+        QJsonArray tabUsages;
+        const FileUsages& usages = i.value();
+        for (int j = 0; j < usages.size(); j++) {
+            QJsonArray tabUsage;
+            tabUsage.append(usages.at(j).first);
+            tabUsage.append(usages.at(j).second);
+            tabUsages.append(tabUsage);
+        }
+        obj["f"] = i.key();
+        obj["m"] = static_cast<double>(m_modified.value(i.key()));
+        obj["u"] = tabUsages;
+        tab.append(obj);
+    }
+    json["files"] = tab;
+}
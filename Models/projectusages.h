@@ -0,0 +1,98 @@
+/*
+    RPG Paper Maker Copyright (C) 2017 Marie Laporte
+
+    This file is part of RPG Paper Maker.
+
+    RPG Paper Maker is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    RPG Paper Maker is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with Foobar.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#ifndef PROJECTUSAGES_H
+#define PROJECTUSAGES_H
+
+#include <QObject>
+#include <QHash>
+#include <QSet>
+#include <QVector>
+#include <QPair>
+#include <QFutureWatcher>
+#include <QStringList>
+#include "serializable.h"
+#include "usagekind.h"
+
+// -------------------------------------------------------
+//
+//  CLASS ProjectUsages
+//
+//  An inverted index of the ids referenced by the maps portions and the
+//  common events (id -> locations). The files are parsed in parallel in
+//  the background, and only again if they were modified since they were
+//  indexed. The refreshes asked while indexing are queued and started when
+//  it is finished, only findUsages waits for it. The index is saved in the
+//  project so that opening it doesn't need to parse everything again.
+//
+// -------------------------------------------------------
+
+class ProjectUsages : public QObject, public Serializable
+{
+    Q_OBJECT
+
+public:
+    ProjectUsages();
+    virtual ~ProjectUsages();
+    static QString key(UsageKind kind, int id);
+    void load(const QString& pathProject);
+    void refresh();
+    void refreshMap(const QString& pathMap);
+    void refreshCommonEvents();
+    QStringList findUsages(UsageKind kind, int id);
+    bool isUsed(UsageKind kind, int id);
+    void save();
+
+    virtual void read(const QJsonObject &json);
+    virtual void write(QJsonObject &json) const;
+
+protected:
+    // For each file: the list of (key, label)
+    typedef QVector<QPair<QString, QString>> FileUsages;
+
+    QString m_pathProject;
+    QHash<QString, qint64> m_modified;
+    QHash<QString, FileUsages> m_usagesByFile;
+    QHash<QString, QSet<QString>> m_filesByKey;
+    QStringList m_pendingFiles;
+    QVector<qint64> m_pendingModified;
+    QFutureWatcher<FileUsages> m_watcher;
+    QList<QPair<QStringList, QString>> m_queuedRefreshes;
+    bool m_isDirty;
+    bool m_isSaveQueued;
+
+    void join();
+    void merge();
+    void cancel();
+    void refreshFiles(const QStringList& files, const QString& directory);
+    void startRefresh(const QStringList& files, const QString& directory);
+    void setFileUsages(const QString& file, const FileUsages& usages);
+    void removeFile(const QString& file);
+    QString relativePath(const QString& path) const;
+    QStringList getMapFiles(const QString& pathMap) const;
+    static FileUsages indexFile(const QString& pathProject,
+                                const QString& file);
+    static void indexJSON(const QJsonValue& value, const QString& label,
+                          FileUsages& usages);
+
+protected slots:
+    void on_indexingFinished();
+};
+
+#endif // PROJECTUSAGES_H
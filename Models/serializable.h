@@ -22,6 +22,7 @@
 
 #include <QJsonObject>
 #include <QJsonArray>
+#include "jsonstreamreader.h"
 
 // -------------------------------------------------------
 //
@@ -29,7 +30,8 @@
 //
 //  All the classes that can be written/read with json should
 //  inherit this class in order to call Wanok::read and Wanok::write
-//  methods.
+//  methods. The ones read from big files can also be read directly from
+//  the file stream by overriding canReadStream and readStream.
 //
 // -------------------------------------------------------
 
@@ -38,6 +40,11 @@ class Serializable
 public:
     virtual void read(const QJsonObject &json) = 0;
     virtual void write(QJsonObject &json) const = 0;
+
+    virtual bool canReadStream() const { return false; }
+    virtual void readStream(JsonStreamReader& reader) {
+        read(reader.readValue().toObject());
+    }
 };
 
 #endif // SERIALIALIZABLE_H
@@ -18,6 +18,7 @@
 */
 
 #include "superlistitem.h"
+#include "superlistitemmodel.h"
 #include "wanok.h"
 #include "dialogsystemname.h"
 
@@ -125,6 +126,10 @@ void SuperListItem::deleteModelTree(QStandardItem* item){
 // -------------------------------------------------------
 
 int SuperListItem::getIndexById(QStandardItem* item, int id){
+    SuperListItemModel* model = getIndexedModel(item);
+    if (model != nullptr)
+        return model->getIndexById(id);
+
     int l = item->rowCount()-1;
     SuperListItem* s;
 
@@ -161,6 +166,14 @@ int SuperListItem::getIdByIndex(QStandardItemModel* model, int index){
 // -------------------------------------------------------
 
 SuperListItem* SuperListItem::getById(QStandardItem* item, int id, bool first){
+    SuperListItemModel* model = getIndexedModel(item);
+    if (model != nullptr) {
+        SuperListItem* s = model->getById(id);
+        if (s == nullptr && first)
+            s = model->superItem(0);
+        return s;
+    }
+
     int l = item->rowCount()-1;
 
     if (l > -1){
@@ -188,6 +201,16 @@ SuperListItem* SuperListItem::getById(QStandardItem* item, int id, bool first){
 
 // -------------------------------------------------------
 
+SuperListItemModel* SuperListItem::getIndexedModel(QStandardItem* item) {
+    SuperListItemModel* model = qobject_cast<SuperListItemModel*>(
+                item->model());
+
+    return (model != nullptr && item == model->invisibleRootItem()) ? model
+                                                                   : nullptr;
+}
+
+// -------------------------------------------------------
+
 void SuperListItem::fillComboBox(QComboBox* comboBox,
                                  QStandardItemModel* model)
 {
@@ -199,13 +222,13 @@ void SuperListItem::fillComboBox(QComboBox* comboBox,
         for (int i = 0; i < l; i++){
             item = model->item(i);
             sys = ((SuperListItem*) item->data().value<quintptr>());
-            comboBox->addItem(item->text());
+            comboBox->addItem(model->data(item->index()).toString());
         }
 
         item = model->item(l);
         sys = ((SuperListItem*) item->data().value<quintptr>());
         if (sys != nullptr)
-            comboBox->addItem(item->text());
+            comboBox->addItem(model->data(item->index()).toString());
     }
 }
 
@@ -26,6 +26,8 @@
 #include <QComboBox>
 #include "serializable.h"
 
+class SuperListItemModel;
+
 // -------------------------------------------------------
 //
 //  CLASS SuperListItem
@@ -60,6 +62,7 @@ public:
     static int getIdByIndex(QStandardItemModel* model, int index);
     static SuperListItem* getById(QStandardItem* item, int id,
                                   bool first = true);
+    static SuperListItemModel* getIndexedModel(QStandardItem* item);
     static void fillComboBox(QComboBox* comboBox, QStandardItemModel* model);
     static void copyModel(QStandardItemModel* model,
                           QStandardItemModel* baseModel);
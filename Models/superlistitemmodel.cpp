@@ -0,0 +1,293 @@
+/*
+    RPG Paper Maker Copyright (C) 2017 Marie Laporte
+
+    This file is part of RPG Paper Maker.
+
+    RPG Paper Maker is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    RPG Paper Maker is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with Foobar.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include "superlistitemmodel.h"
+#include <limits>
+
+const int SuperListItemModel::NO_ID = std::numeric_limits<int>::min();
+
+// -------------------------------------------------------
+//
+//  CONSTRUCTOR / DESTRUCTOR / GET / SET
+//
+// -------------------------------------------------------
+
+SuperListItemModel::SuperListItemModel(QObject *parent) :
+    QStandardItemModel(parent),
+    m_duplicatesCount(0),
+    m_isIndexDirty(true),
+    m_freeId(1)
+{
+    connect(this, SIGNAL(rowsInserted(QModelIndex, int, int)),
+            this, SLOT(onRowsInserted(QModelIndex, int, int)));
+    connect(this, SIGNAL(rowsRemoved(QModelIndex, int, int)),
+            this, SLOT(invalidateIndex()));
+    connect(this, SIGNAL(rowsMoved(QModelIndex, int, int, QModelIndex, int)),
+            this, SLOT(invalidateIndex()));
+    connect(this, SIGNAL(modelReset()), this, SLOT(invalidateIndex()));
+    connect(this, SIGNAL(layoutChanged()), this, SLOT(invalidateIndex()));
+    connect(this, SIGNAL(itemChanged(QStandardItem*)),
+            this, SLOT(onItemChanged(QStandardItem*)));
+}
+
+SuperListItemModel::~SuperListItemModel()
+{
+
+}
+
+SuperListItem* SuperListItemModel::superItem(int row) const {
+    QStandardItem* standardItem = item(row);
+
+    return standardItem == nullptr ? nullptr : (SuperListItem*) standardItem
+                                               ->data().value<quintptr>();
+}
+
+// -------------------------------------------------------
+//
+//  INTERMEDIARY FUNCTIONS
+//
+// -------------------------------------------------------
+
+SuperListItem* SuperListItemModel::getById(int id) {
+    int row = getIndexById(id);
+
+    return row == -1 ? nullptr : superItem(row);
+}
+
+// -------------------------------------------------------
+
+int SuperListItemModel::getIndexById(int id) {
+    if (m_isIndexDirty)
+        updateIndex();
+    int row = getRowById(id);
+
+    // The id of an item can be changed without notifying the model, in that
+    // case the index is rebuilt once
+    if (row != -1 && !isRowId(row, id)) {
+        updateIndex();
+        row = getRowById(id);
+        if (!isRowId(row, id))
+            return -1;
+    }
+
+    return row;
+}
+
+// -------------------------------------------------------
+
+int SuperListItemModel::getNewId() {
+    if (m_isIndexDirty)
+        updateIndex();
+
+    return m_freeId;
+}
+
+// -------------------------------------------------------
+
+void SuperListItemModel::appendSuperItems(const QList<SuperListItem*>& list) {
+    QList<QStandardItem*> items;
+    items.reserve(list.size());
+    for (int i = 0; i < list.size(); i++)
+        items.append(createItem(list.at(i)));
+
+    // Only one rows insertion for the whole list
+    invisibleRootItem()->appendRows(items);
+}
+
+// -------------------------------------------------------
+
+QStandardItem* SuperListItemModel::createItem(SuperListItem* super) {
+    QStandardItem* item = new QStandardItem;
+    item->setData(QVariant::fromValue(reinterpret_cast<quintptr>(super)));
+    item->setFlags(item->flags() ^ (Qt::ItemIsDropEnabled));
+
+    return item;
+}
+
+// -------------------------------------------------------
+
+QVariant SuperListItemModel::data(const QModelIndex &index, int role) const {
+    QVariant value = QStandardItemModel::data(index, role);
+
+    // Lazy display text
+    if (role == Qt::DisplayRole && value.isNull() && index.column() == 0 &&
+        !index.parent().isValid())
+    {
+        SuperListItem* super = superItem(index.row());
+        if (super != nullptr)
+            return super->toString();
+    }
+
+    return value;
+}
+
+// -------------------------------------------------------
+
+void SuperListItemModel::updateIndex() {
+    int l = rowCount();
+    m_rowsById.fill(-1, l + 1);
+    m_rowsByIdSparse.clear();
+    m_idsByRow.fill(NO_ID, l);
+    m_duplicatesCount = 0;
+    for (int i = 0; i < l; i++)
+        addToIndex(i);
+    m_freeId = 1;
+    updateFreeId();
+    m_isIndexDirty = false;
+}
+
+// -------------------------------------------------------
+
+void SuperListItemModel::addToIndex(int row) {
+    SuperListItem* super = superItem(row);
+    if (super == nullptr)
+        return;
+
+    // Ids are most of the time 1..n, the other ones go in a hash
+    int id = super->id();
+    m_idsByRow[row] = id;
+    if (getRowById(id) != -1)
+        m_duplicatesCount++;
+    else if (id >= 0 && id < m_rowsById.size())
+        m_rowsById[id] = row;
+    else
+        m_rowsByIdSparse.insert(id, row);
+}
+
+// -------------------------------------------------------
+
+void SuperListItemModel::removeFromIndex(int row) {
+    int id = m_idsByRow.at(row);
+    m_idsByRow[row] = NO_ID;
+    if (id == NO_ID || getRowById(id) != row)
+        return;
+
+    if (id >= 0 && id < m_rowsById.size())
+        m_rowsById[id] = -1;
+    else
+        m_rowsByIdSparse.remove(id);
+    if (id > 0 && id < m_freeId)
+        m_freeId = id;
+}
+
+// -------------------------------------------------------
+
+void SuperListItemModel::updateFreeId() {
+    while (getRowById(m_freeId) != -1)
+        m_freeId++;
+}
+
+// -------------------------------------------------------
+
+int SuperListItemModel::getRowById(int id) const {
+    if (id >= 0 && id < m_rowsById.size())
+        return m_rowsById.at(id);
+
+    return m_rowsByIdSparse.value(id, -1);
+}
+
+// -------------------------------------------------------
+
+bool SuperListItemModel::isRowId(int row, int id) const {
+    SuperListItem* super = row == -1 ? nullptr : superItem(row);
+
+    return super != nullptr && super->id() == id;
+}
+
+// -------------------------------------------------------
+//
+//  SLOTS
+//
+// -------------------------------------------------------
+
+void SuperListItemModel::invalidateIndex() {
+    m_isIndexDirty = true;
+}
+
+// -------------------------------------------------------
+
+void SuperListItemModel::onRowsInserted(const QModelIndex &parent, int first,
+                                        int last)
+{
+    if (parent.isValid() || m_isIndexDirty)
+        return;
+
+    // Rows inserted before existing items shift them: rebuild later
+    int l = rowCount();
+    for (int i = last + 1; i < l; i++) {
+        if (superItem(i) != nullptr) {
+            invalidateIndex();
+            return;
+        }
+    }
+
+    // Otherwise, only index the new rows
+    m_idsByRow.resize(l);
+    for (int i = first; i <= last; i++)
+        m_idsByRow[i] = NO_ID;
+    int previousSize = m_rowsById.size();
+    if (l + 1 > previousSize) {
+        m_rowsById.resize(l + 1);
+        for (int i = previousSize; i < l + 1; i++)
+            m_rowsById[i] = -1;
+
+        // Sparse ids that now fit in the vector
+        QHash<int, int>::iterator it = m_rowsByIdSparse.begin();
+        while (it != m_rowsByIdSparse.end()) {
+            if (it.key() >= 0 && it.key() < m_rowsById.size()) {
+                m_rowsById[it.key()] = it.value();
+                it = m_rowsByIdSparse.erase(it);
+            }
+            else
+                it++;
+        }
+    }
+    for (int i = first; i <= last; i++)
+        addToIndex(i);
+    updateFreeId();
+}
+
+// -------------------------------------------------------
+//  onItemChanged: only the row of the item is indexed again. With duplicated
+//  ids, the row of the other item with the same id is not known: rebuild
+//  later
+
+void SuperListItemModel::onItemChanged(QStandardItem* item) {
+    if (m_isIndexDirty || item->parent() != nullptr || item->column() != 0)
+        return;
+
+    int row = item->row();
+    if (row >= m_idsByRow.size()) {
+        invalidateIndex();
+        return;
+    }
+    SuperListItem* super = superItem(row);
+    int id = super == nullptr ? NO_ID : super->id();
+    if (m_idsByRow.at(row) == id)
+        return;
+    if (m_duplicatesCount > 0) {
+        invalidateIndex();
+        return;
+    }
+
+    removeFromIndex(row);
+    if (super != nullptr)
+        addToIndex(row);
+    updateFreeId();
+}
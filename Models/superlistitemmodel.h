@@ -0,0 +1,78 @@
+/*
+    RPG Paper Maker Copyright (C) 2017 Marie Laporte
+
+    This file is part of RPG Paper Maker.
+
+    RPG Paper Maker is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    RPG Paper Maker is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with Foobar.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#ifndef SUPERLISTITEMMODEL_H
+#define SUPERLISTITEMMODEL_H
+
+#include <QStandardItemModel>
+#include <QVector>
+#include <QHash>
+#include "superlistitem.h"
+
+// -------------------------------------------------------
+//
+//  CLASS SuperListItemModel
+//
+//  A model of super list items (one per root row) keeping an id to row
+//  index, so that an item or the first free id can be found without going
+//  through all the rows. A changed item only updates the index of its row.
+//  The display text of a row is generated from the
+//  item only when a view asks for it, unless it was explicitly set.
+//
+// -------------------------------------------------------
+
+class SuperListItemModel : public QStandardItemModel
+{
+    Q_OBJECT
+public:
+    SuperListItemModel(QObject* parent = nullptr);
+    virtual ~SuperListItemModel();
+    static const int NO_ID;
+    SuperListItem* superItem(int row) const;
+    SuperListItem* getById(int id);
+    int getIndexById(int id);
+    int getNewId();
+    void appendSuperItems(const QList<SuperListItem*>& list);
+    static QStandardItem* createItem(SuperListItem* super);
+
+    virtual QVariant data(const QModelIndex &index,
+                          int role = Qt::DisplayRole) const;
+
+protected:
+    QVector<int> m_rowsById;
+    QHash<int, int> m_rowsByIdSparse;
+    QVector<int> m_idsByRow;
+    int m_duplicatesCount;
+    bool m_isIndexDirty;
+    int m_freeId;
+
+    void updateIndex();
+    void addToIndex(int row);
+    void removeFromIndex(int row);
+    void updateFreeId();
+    int getRowById(int id) const;
+    bool isRowId(int row, int id) const;
+
+protected slots:
+    void invalidateIndex();
+    void onRowsInserted(const QModelIndex &parent, int first, int last);
+    void onItemChanged(QStandardItem* item);
+};
+
+#endif // SUPERLISTITEMMODEL_H
@@ -130,8 +130,8 @@ void TreeMapTag::copyItem(const QStandardItem* from,
             QString pathMapTarget = Wanok::pathCombine(pathMapsTemp, mapName);
             QDir(pathMapsTemp).mkdir(mapName);
 
-            // Copy content
-            Wanok::copyPath(pathMapSource, pathMapTarget);
+            // Copy content (files shared until modified)
+            Wanok::linkPath(pathMapSource, pathMapTarget);
 
             // Remove temp
             QDir(Wanok::pathCombine(
@@ -185,7 +185,7 @@ void TreeMapTag::copyTree(const QStandardItem* from, QStandardItem* to){
             QDir(pathMaps).mkdir(newMapName);
             copyTag->setId(newId);
             QString newPathMap = Wanok::pathCombine(pathMaps, newMapName);
-            Wanok::copyPath(pathMap, newPathMap);
+            Wanok::linkPath(pathMap, newPathMap);
             Wanok::writeJSON(Wanok::pathCombine(newPathMap,
                                                 Wanok::fileMapInfos),
                              properties);
@@ -0,0 +1,20 @@
+#version 130
+
+in highp vec2 coordTiles;
+in highp vec4 rectTexture;
+
+uniform sampler2D texture;
+uniform float alpha_threshold;
+
+out highp vec4 fColor;
+
+void main()
+{
+    // Repeat the tile texture rectangle along the merged quad
+    vec2 coordTexture = rectTexture.xy + fract(coordTiles) * rectTexture.zw;
+    vec4 color = texture2D(texture, coordTexture);
+    if (color.a <= alpha_threshold)
+        discard;
+
+    fColor = color;
+}
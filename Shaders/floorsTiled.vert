@@ -0,0 +1,19 @@
+#version 130
+
+in vec3 position;
+in vec2 texCoord0;
+in vec4 texRect;
+in vec4 unpack; // Origin and step of the packed positions
+
+uniform mat4 modelviewProjection;
+
+out vec2 coordTiles;
+out vec4 rectTexture;
+
+void main()
+{
+    vec3 positionWorld = unpack.xyz + position * unpack.w;
+    gl_Position = modelviewProjection * vec4(positionWorld, 1.0);
+    coordTiles = texCoord0;
+    rectTexture = texRect;
+}
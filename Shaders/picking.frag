@@ -0,0 +1,20 @@
+#version 130
+
+in highp vec2 coordTexture;
+flat in int quad;
+
+uniform sampler2D texture;
+uniform uint kind;
+uniform uint portion;
+uniform uint extra;
+
+out uvec4 fId;
+
+void main()
+{
+    vec4 color = texture2D(texture, coordTexture);
+    if (color.a <= 0.0)
+        discard;
+
+    fId = uvec4(kind, portion, uint(quad), extra);
+}
@@ -0,0 +1,20 @@
+#version 130
+
+in vec3 position;
+in vec2 texCoord0;
+in vec4 unpack; // Origin and step of the packed positions
+
+uniform mat4 modelviewProjection;
+
+out vec2 coordTexture;
+flat out int quad;
+
+void main()
+{
+    vec3 positionWorld = unpack.xyz + position * unpack.w;
+    gl_Position = modelviewProjection * vec4(positionWorld, 1.0);
+    coordTexture = texCoord0;
+
+    // Each quad has its own 4 vertices in the buffer
+    quad = gl_VertexID / 4;
+}
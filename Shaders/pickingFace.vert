@@ -0,0 +1,29 @@
+#version 130
+
+in vec3 centerPosition;
+in vec2 texCoord0;
+in vec3 corner; // Model scaled by the size
+in vec4 unpack; // Origin and step of the packed positions
+
+uniform vec3 cameraRightWorldspace;
+uniform vec3 cameraUpWorldspace; // Used for full billboard
+uniform vec3 cameraDeepWorldspace;
+uniform mat4 modelViewProjection;
+
+out vec2 coordTexture;
+flat out int quad;
+
+void main()
+{
+    vec3 vertexPositionWorldspace =
+        unpack.xyz + (centerPosition
+        + cameraRightWorldspace * corner.x
+        + vec3(0.0, 1.0, 0.0) * corner.y
+        + cameraDeepWorldspace * corner.z) * unpack.w;
+
+    gl_Position = modelViewProjection * vec4(vertexPositionWorldspace, 1.0);
+    coordTexture = texCoord0;
+
+    // Each quad has its own 4 vertices in the buffer
+    quad = gl_VertexID / 4;
+}
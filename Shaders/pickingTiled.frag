@@ -0,0 +1,23 @@
+#version 130
+
+in highp vec2 coordTiles;
+in highp vec4 rectTexture;
+flat in int quad;
+
+uniform sampler2D texture;
+uniform uint kind;
+uniform uint portion;
+
+out uvec4 fId;
+
+void main()
+{
+    vec2 coordTexture = rectTexture.xy + fract(coordTiles) * rectTexture.zw;
+    vec4 color = texture2D(texture, coordTexture);
+    if (color.a <= 0.0)
+        discard;
+
+    // The tile of the merged quad under the fragment, x in the low bits
+    uvec2 tile = uvec2(floor(coordTiles));
+    fId = uvec4(kind, portion, uint(quad), tile.x | (tile.y << 16u));
+}
@@ -2,8 +2,8 @@
 
 in vec3 centerPosition;
 in vec2 texCoord0;
-in vec2 size;
-in vec3 model;
+in vec3 corner; // Model scaled by the size
+in vec4 unpack; // Origin and step of the packed positions
 
 uniform vec3 cameraRightWorldspace;
 uniform vec3 cameraUpWorldspace; // Used for full billboard
@@ -15,10 +15,10 @@ out vec2 coordTexture;
 void main()
 {
     vec3 vertexPositionWorldspace =
-        centerPosition
-        + cameraRightWorldspace * model.x * size.x
-        + vec3(0.0, 1.0, 0.0) * model.y * size.y
-        + cameraDeepWorldspace * model.z;
+        unpack.xyz + (centerPosition
+        + cameraRightWorldspace * corner.x
+        + vec3(0.0, 1.0, 0.0) * corner.y
+        + cameraDeepWorldspace * corner.z) * unpack.w;
 
     gl_Position = modelViewProjection * vec4(vertexPositionWorldspace, 1.0);
     coordTexture = texCoord0;
@@ -2,6 +2,7 @@
 
 in vec3 position;
 in vec2 texCoord0;
+in vec4 unpack; // Origin and step of the packed positions
 
 uniform mat4 modelviewProjection;
 
@@ -9,6 +10,7 @@ out vec2 coordTexture;
 
 void main()
 {
-    gl_Position = modelviewProjection * vec4(position, 1.0);
+    vec3 positionWorld = unpack.xyz + position * unpack.w;
+    gl_Position = modelviewProjection * vec4(positionWorld, 1.0);
     coordTexture = texCoord0;
 }
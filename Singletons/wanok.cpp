@@ -23,11 +23,20 @@
 #include <QDebug>
 #include <QStandardPaths>
 #include <QDirIterator>
+#include <QSaveFile>
+#include <QtConcurrent/QtConcurrent>
 #include <math.h>
 #include "wanok.h"
+#ifdef Q_OS_WIN
+    #include <windows.h>
+#else
+    #include <unistd.h>
+#endif
 
 QSet<int> Wanok::mapsToSave;
 QSet<int> Wanok::mapsUndoRedo;
+QHash<QString, QFuture<QJsonDocument>> Wanok::preloadedJSON;
+QMutex Wanok::mutexPreloadedJSON;
 
 // PATHS DATAS
 const QString Wanok::pathBasic = pathCombine("Content", "basic");
@@ -57,6 +66,8 @@ const QString Wanok::pathClasses = pathCombine(pathDatas, "classes.json");
 const QString Wanok::PATH_TILESETS = pathCombine(pathDatas, "tilesets.json");
 const QString Wanok::PATH_SPECIAL_ELEMENTS =
         pathCombine(pathDatas, "specialElements.json");
+const QString Wanok::PATH_USAGES = pathCombine(pathDatas, "usages.json");
+const QString Wanok::PATH_MINIMAPS = pathCombine(pathDatas, "Minimaps");
 const QString Wanok::pathTreeMap = pathCombine(pathDatas, "treeMap.json");
 const QString Wanok::pathLangs = pathCombine(pathDatas, "langs.json");
 const QString Wanok::pathScripts = pathCombine(pathDatas, "scripts.json");
@@ -168,38 +179,95 @@ void Wanok::writeJSON(QString path, const Serializable &obj){
 // -------------------------------------------------------
 
 void Wanok::readJSON(QString path, Serializable &obj){
+
+    // Read directly from the file without building the whole document. If
+    // the stream parser fails, the file is read again with QJsonDocument
+    if (obj.canReadStream()) {
+        QFile loadFile(path);
+        if (!loadFile.open(QIODevice::ReadOnly)) {
+            obj.read(QJsonObject());
+            return;
+        }
+        JsonStreamReader reader(&loadFile);
+        obj.readStream(reader);
+        if (!reader.hasError())
+            return;
+    }
+
     QJsonDocument loadDoc;
     readOtherJSON(path, loadDoc);
     obj.read(loadDoc.object());
 }
 
 // -------------------------------------------------------
+//  The file is never written in place but replaced by a new one, so that a
+//  file shared by several maps (see linkFile) is only modified for this path
 
 void Wanok::writeOtherJSON(QString path, const QJsonObject &obj,
                            QJsonDocument::JsonFormat format)
 {
-    QFile saveFile(path);
+    QSaveFile saveFile(path);
     if (!saveFile.open(QIODevice::WriteOnly)) { return; }
     QJsonDocument saveDoc(obj);
     saveFile.write(saveDoc.toJson(format));
+    saveFile.commit();
 }
 
 // -------------------------------------------------------
 
 void Wanok::readOtherJSON(QString path, QJsonDocument& loadDoc){
+
+    // If preloaded, only wait for the end of its parsing
+    QFuture<QJsonDocument> future;
+    mutexPreloadedJSON.lock();
+    bool isPreloaded = preloadedJSON.contains(path);
+    if (isPreloaded)
+        future = preloadedJSON.take(path);
+    mutexPreloadedJSON.unlock();
+
+    loadDoc = isPreloaded ? future.result() : parseJSON(path);
+}
+
+// -------------------------------------------------------
+
+QJsonDocument Wanok::parseJSON(const QString& path){
     QFile loadFile(path);
     loadFile.open(QIODevice::ReadOnly);
     QByteArray saveData = loadFile.readAll();
-    loadDoc = QJsonDocument::fromJson(saveData);
+
+    return QJsonDocument::fromJson(saveData);
+}
+
+// -------------------------------------------------------
+
+void Wanok::preloadJSON(const QStringList& paths){
+    QMutexLocker locker(&mutexPreloadedJSON);
+    for (int i = 0; i < paths.size(); i++) {
+        const QString& path = paths.at(i);
+        if (!preloadedJSON.contains(path))
+            preloadedJSON.insert(path, QtConcurrent::run(&Wanok::parseJSON,
+                                                       path));
+    }
+}
+
+// -------------------------------------------------------
+
+void Wanok::clearPreloadedJSON(){
+    QMutexLocker locker(&mutexPreloadedJSON);
+    QHash<QString, QFuture<QJsonDocument>>::iterator i;
+    for (i = preloadedJSON.begin(); i != preloadedJSON.end(); i++)
+        i.value().waitForFinished();
+    preloadedJSON.clear();
 }
 
 // -------------------------------------------------------
 
 void Wanok::writeArrayJSON(QString path, const QJsonArray &tab){
-    QFile saveFile(path);
+    QSaveFile saveFile(path);
     if (!saveFile.open(QIODevice::WriteOnly)) { return; }
     QJsonDocument saveDoc(tab);
     saveFile.write(saveDoc.toJson(QJsonDocument::Compact));
+    saveFile.commit();
 }
 
 // -------------------------------------------------------
@@ -233,6 +301,55 @@ bool Wanok::copyPath(QString src, QString dst)
     return true;
 }
 
+// -------------------------------------------------------
+//  Same as copyPath, but the files are hard linked instead of copied. The
+//  JSON files are always replaced when written, so a linked file is only
+//  duplicated on disk the first time one of its paths is modified
+
+bool Wanok::linkPath(QString src, QString dst)
+{
+    QDir dir(src);
+    if (!dir.exists())
+        return false;
+
+    foreach (QString d, dir.entryList(QDir::Dirs | QDir::NoDotAndDotDot)) {
+        QString dst_path = pathCombine(dst, d);
+        if (!dir.mkpath(dst_path)) return false;
+        if (!linkPath(pathCombine(src, d), dst_path)) return false;
+    }
+
+    foreach (QString f, dir.entryList(QDir::Files)) {
+        if (!linkFile(pathCombine(src, f), pathCombine(dst, f)))
+            return false;
+    }
+
+    return true;
+}
+
+// -------------------------------------------------------
+//  Falls back to a copy if the file system doesn't support hard links
+
+bool Wanok::linkFile(QString src, QString dst) {
+    #ifdef Q_OS_WIN
+        if (CreateHardLinkW(reinterpret_cast<LPCWSTR>(
+                                QDir::toNativeSeparators(dst).utf16()),
+                            reinterpret_cast<LPCWSTR>(
+                                QDir::toNativeSeparators(src).utf16()),
+                            nullptr))
+        {
+            return true;
+        }
+    #else
+        if (link(QFile::encodeName(src).constData(),
+                 QFile::encodeName(dst).constData()) == 0)
+        {
+            return true;
+        }
+    #endif
+
+    return QFile::copy(src, dst);
+}
+
 // -------------------------------------------------------
 
 QString Wanok::getDirectoryPath(QString& file){
@@ -23,6 +23,8 @@
 #include <QString>
 #include <QKeyEvent>
 #include <QJsonDocument>
+#include <QFuture>
+#include <QMutex>
 #include "singleton.h"
 #include "project.h"
 #include "map.h"
@@ -77,6 +79,8 @@ public:
     const static QString pathClasses;
     const static QString PATH_TILESETS;
     const static QString PATH_SPECIAL_ELEMENTS;
+    const static QString PATH_USAGES;
+    const static QString PATH_MINIMAPS;
     const static QString pathTreeMap;
     const static QString pathLangs;
     const static QString pathScripts;
@@ -116,9 +120,14 @@ public:
                                QJsonDocument::JsonFormat format
                                = QJsonDocument::Compact);
     static void readOtherJSON(QString path, QJsonDocument& loadDoc);
+    static QJsonDocument parseJSON(const QString& path);
+    static void preloadJSON(const QStringList& paths);
+    static void clearPreloadedJSON();
     static void writeArrayJSON(QString path, const QJsonArray &tab);
     static void readArrayJSON(QString path, QJsonDocument& loadDoc);
     static bool copyPath(QString src, QString dst);
+    static bool linkPath(QString src, QString dst);
+    static bool linkFile(QString src, QString dst);
     static QString getDirectoryPath(QString& file);
     static bool isDirEmpty(QString path);
     static void copyAllFiles(QString pathSource, QString pathTarget);
@@ -138,6 +147,8 @@ public:
 protected:
     Project* p_project;
     EngineSettings* m_engineSettings;
+    static QHash<QString, QFuture<QJsonDocument>> preloadedJSON;
+    static QMutex mutexPreloadedJSON;
 };
 
 #endif // WANOK_H
@@ -22,9 +22,54 @@
 #include <QStyleFactory>
 #include <QStandardPaths>
 #include <QDir>
+#include <QTextStream>
 #include "mainwindow.h"
+#include "projectbenchmark.h"
 #include "wanok.h"
 
+//-------------------------------------------------
+//
+//  BENCHMARK
+//
+//  RPG-Paper-Maker --benchmark <project | generator settings.json>
+//                  [--replay <inputs.json>] [--output <results.json>]
+//
+//  Runs the benchmarks without the editor window (e.g. with
+//  QT_QPA_PLATFORM=offscreen) and returns 0 if they all ran. The paths are
+//  relative to the directory the engine was called from.
+//
+//-------------------------------------------------
+
+int benchmark(const QStringList& arguments, const QDir& workingDirectory) {
+    QTextStream out(stdout), err(stderr);
+    QString path, pathReplay, pathResults;
+    for (int i = 0; i < arguments.size() - 1; i++) {
+        QString value = workingDirectory.absoluteFilePath(arguments.at(i + 1));
+        if (arguments.at(i) == "--benchmark")
+            path = value;
+        else if (arguments.at(i) == "--replay")
+            pathReplay = value;
+        else if (arguments.at(i) == "--output")
+            pathResults = value;
+    }
+    if (path.isEmpty()) {
+        err << "Missing project or generator settings after --benchmark.\n";
+        return 1;
+    }
+
+    ProjectBenchmark benchmark;
+    QString error = benchmark.run(path, pathReplay);
+    out << benchmark.timingsToString();
+    if (!pathResults.isEmpty())
+        Wanok::writeJSON(pathResults, benchmark);
+    if (error != NULL) {
+        err << error << "\n";
+        return 1;
+    }
+
+    return 0;
+}
+
 //-------------------------------------------------
 //
 //  MAIN
@@ -36,6 +81,7 @@ int main(int argc, char *argv[])
     QApplication a(argc, argv);
 
     // The application can now be used even if called from another directory
+    QDir workingDirectory(QDir::currentPath());
     QDir bin(qApp->applicationDirPath());
     #ifdef Q_OS_MAC
         bin.cdUp();
@@ -101,6 +147,10 @@ int main(int argc, char *argv[])
     }
     Wanok::get()->setEngineSettings(engineSettings);
 
+    // Benchmarks without the editor window
+    if (a.arguments().contains("--benchmark"))
+        return benchmark(a.arguments(), workingDirectory);
+
     // Opening window
     MainWindow w;
     w.showMaximized();